@@ -0,0 +1,57 @@
+import socket
+import struct
+
+
+# Dummy agent for AiProcessorSetupAsync: answers each batch of states with
+# an action per state, cycling through the actions.
+if __name__ == "__main__":
+    localIP = "127.0.0.1"
+    localPort = 9292
+    sock = socket.socket(family=socket.AF_INET)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.bind((localIP, localPort))
+    sock.listen(5)
+
+    def recv_exactly(clientsocket, size):
+        r = b""
+        while len(r) < size:
+            chunk = clientsocket.recv(size - len(r))
+            if not chunk:
+                raise ConnectionError("connection closed")
+            r += chunk
+        return r
+
+    while True:
+        print("TCP server up and listening on", localIP, localPort)
+        (clientsocket, address) = sock.accept()
+        clientsocket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        print("connection", address)
+        num_state = 0
+        num_actions = 1
+        act = 0
+
+        try:
+            while True:
+                command = clientsocket.recv(1)
+                if not command or command == b"Q":
+                    print("end")
+                    break
+                if command == b"I":
+                    num_state, num_actions = recv_exactly(clientsocket, 2)
+                    state_unpack_fmt = "!l" + "l" * num_state
+                    state_size = 1 + struct.calcsize(state_unpack_fmt)
+                    print("setup", num_state, num_actions)
+                elif command == b"B":
+                    cycle, count = struct.unpack("!LH", recv_exactly(clientsocket, 6))
+                    answer = bytearray(b"A" + struct.pack("!LH", cycle, count))
+                    data = recv_exactly(clientsocket, count * state_size)
+                    for i in range(count):
+                        player = data[i * state_size]
+                        reward, *state = struct.unpack_from(state_unpack_fmt, data, i * state_size + 1)
+                        print("cycle", cycle, "player", player, "reward", reward, "state", state, "action", act)
+                        answer += bytes([player, act])
+                        act = (act + 1) % num_actions
+                    clientsocket.sendall(answer)
+        except ConnectionError as e:
+            print(e)
+        clientsocket.close()
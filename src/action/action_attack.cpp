@@ -120,7 +120,7 @@ void AnimateActionAttack(CUnit &unit, COrder &order)
 
 	auto order = std::make_unique<COrder_Attack>(false);
 
-	if (Map.WallOnMap(dest) && Map.Field(dest)->playerInfo.IsExplored(*attacker.Player)) {
+	if (Map.WallOnMap(dest) && Map.Field(dest)->playerInfo().IsExplored(*attacker.Player)) {
 		// FIXME: look into action_attack.cpp about this ugly problem
 		order->goalPos = dest;
 		order->Range = attacker.Stats->Variables[ATTACKRANGE_INDEX].Max;
@@ -62,7 +62,7 @@ static void GetExplorationTarget(const CUnit &unit, Vec2i &dest)
 
 	while (triesLeft > 0) {
 		field = Map.Field(dest);
-		if (field && !field->playerInfo.IsExplored(player))
+		if (field && !field->playerInfo().IsExplored(player))
 			return; // unexplored, go here!
 		dest.x = SyncRand(Map.Info.MapWidth - 1) + 1;
 		dest.y = SyncRand(Map.Info.MapHeight - 1) + 1;
@@ -177,6 +177,10 @@ int DoActionMove(CUnit &unit)
 		UnmarkUnitFieldFlags(unit);
 		std::tie(d, posd) = NextPathElement(unit);
 		MarkUnitFieldFlags(unit);
+		if (d == PF_WAIT && unit.pathFinderData->output.Queued) {
+			// The path is found at the end of the cycle, stand still until then
+			return PF_MOVE;
+		}
 		switch (d) {
 			case PF_UNREACHABLE: // Can't reach, stop
 				if (unit.Player->AiEnabled) {
@@ -229,7 +233,7 @@ int DoActionMove(CUnit &unit)
 		unit.MoveToXY(pos);
 
 		// Remove unit from the current selection
-		if (unit.Selected && !Map.Field(pos)->playerInfo.IsTeamVisible(*ThisPlayer)) {
+		if (unit.Selected && !Map.Field(pos)->playerInfo().IsTeamVisible(*ThisPlayer)) {
 			if (IsOnlySelected(unit)) { //  Remove building cursor
 				CancelBuildingMode();
 			}
@@ -114,7 +114,7 @@ class NearReachableTerrainFinder
 
 VisitResult NearReachableTerrainFinder::Visit(TerrainTraversal &terrainTraversal, const Vec2i &pos, const Vec2i &from)
 {
-	if (!player.AiEnabled && !Map.Field(pos)->playerInfo.IsExplored(player)) {
+	if (!player.AiEnabled && !Map.Field(pos)->playerInfo().IsExplored(player)) {
 		return VisitResult::DeadEnd;
 	}
 	// Look if found what was required.
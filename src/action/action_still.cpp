@@ -47,6 +47,7 @@
 #include "settings.h"
 #include "spells.h"
 #include "tileset.h"
+#include "ui.h"
 #include "unit.h"
 #include "unit_find.h"
 #include "unittype.h"
@@ -153,7 +154,10 @@ void COrder_Still::OnAnimationAttack(CUnit &unit) /* override */
 
 void UnHideUnit(CUnit &unit)
 {
-	unit.Variable[INVISIBLE_INDEX].Value = 0;
+	if (unit.Variable[INVISIBLE_INDEX].Value) {
+		unit.Variable[INVISIBLE_INDEX].Value = 0;
+		UI.Minimap.UpdateUnit(unit);
+	}
 }
 
 /**
@@ -45,6 +45,7 @@
 #include "script.h"
 #include "spells.h"
 #include "translate.h"
+#include "ui.h"
 #include "unit.h"
 #include "unittype.h"
 
@@ -155,8 +156,17 @@ static int TransformUnitIntoType(CUnit &unit, const CUnitType &newtype)
 		}
 	}
 
+	// Left on the map by the shortcut above: count the threat of the new type,
+	// and draw it on the minimap
+	if (!unit.Removed) {
+		Map.Influence.Remove(unit);
+	}
 	unit.Type = const_cast<CUnitType *>(&newtype);
 	unit.Stats = const_cast<CUnitStats *>(&unit.Type->Stats[player.Index]);
+	if (!unit.Removed) {
+		Map.Influence.Insert(unit);
+		UI.Minimap.UpdateUnit(unit);
+	}
 
 	if (!newtype.CanCastSpell.empty() && unit.AutoCastSpell.empty()) {
 		unit.AutoCastSpell.resize(SpellTypeTable.size());
@@ -66,6 +66,7 @@
 #include "script.h"
 #include "spells.h"
 #include "stratagus.h"
+#include "ui.h"
 #include "unit.h"
 #include "unit_find.h"
 #include "unit_manager.h"
@@ -333,11 +334,15 @@ static void HandleBuffsEachCycle(CUnit &unit)
 	}
 
 	const int SpellEffects[] = {BLOODLUST_INDEX, HASTE_INDEX, SLOW_INDEX, INVISIBLE_INDEX, UNHOLYARMOR_INDEX, POISON_INDEX};
+	const bool invisible = unit.Variable[INVISIBLE_INDEX].Value > 0;
 	//  decrease spells effects time.
 	for (int index : SpellEffects) {
 		unit.Variable[index].Increase = -1;
 		IncreaseVariable(unit, index);
 	}
+	if (invisible && unit.Variable[INVISIBLE_INDEX].Value == 0) {
+		UI.Minimap.UpdateUnit(unit);
+	}
 }
 
 /**
@@ -619,6 +624,8 @@ void UnitActions()
 	}
 	// Do all actions
 	UnitActionsEachCycle(units);
+	// Find the paths asked for by these actions
+	PathfinderSolveBatch();
 }
 
 //@}
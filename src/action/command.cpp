@@ -42,6 +42,7 @@
 #include "action/action_train.h"
 #include "action/action_upgradeto.h"
 #include "commands.h"
+#include "fow.h"
 #include "map.h"
 #include "pathfinder.h"
 #include "player.h"
@@ -936,7 +937,7 @@ void CommandSharedVision(int playerIndex, bool state, int opponentIndex)
 		const size_t fieldsNum = Map.Info.MapWidth * Map.Info.MapHeight;
 		for (size_t i = 0; i != fieldsNum; ++i) {
 			CMapField &mf = *Map.Field(i);
-			CMapFieldPlayerInfo &mfp = mf.playerInfo;
+			CMapFieldPlayerInfo &mfp = mf.playerInfo();
 
 			if (mfp.Visible[playerIndex] && !mfp.Visible[opponentIndex]) {
 				mfp.Visible[opponentIndex] = 1;
@@ -946,6 +947,7 @@ void CommandSharedVision(int playerIndex, bool state, int opponentIndex)
 				}
 			}
 		}
+		FogOfWar->InvalidateAll();
 	} else {
 		player->ShareVisionWith(*opponent);
 	}
@@ -956,6 +958,10 @@ void CommandSharedVision(int playerIndex, bool state, int opponentIndex)
 			MapMarkUnitSight(*unit);
 		}
 	}
+	// The invisible units of the player are shown or hidden, wherever they are
+	if (opponent == ThisPlayer) {
+		UI.Minimap.Invalidate();
+	}
 }
 
 /**
@@ -84,11 +84,12 @@
 ** ::AiEachCycle(::Player)
 **
 ** Called each game cycle, to handle quick checks, which needs
-** less CPU.
+** less CPU, and the next slices of the work started each second.
 **
 ** ::AiEachSecond(::Player)
 **
-** Called each second, to handle more CPU intensive things.
+** Called each second, to start more CPU intensive things. They are
+** sliced into tasks, run on the following cycles.
 **
 **
 ** @subsection aiecall Event call-backs
@@ -155,6 +156,8 @@
 #include "unittype.h"
 #include "upgrade.h"
 
+#include <chrono>
+
 /*----------------------------------------------------------------------------
 -- Variables
 ----------------------------------------------------------------------------*/
@@ -354,6 +357,7 @@ static void SaveAiPlayer(CFile &file, int plynr, const PlayerAi &ai)
 	}
 	file.printf("  \"last-exploration-cycle\", %lu,\n", ai.LastExplorationGameCycle);
 	file.printf("  \"last-can-not-move-cycle\", %lu,\n", ai.LastCanNotMoveGameCycle);
+	file.printf("  \"next-task\", %u,\n", ai.NextTask);
 	file.printf("  \"unit-type\", {");
 	for (const auto& requestType : ai.UnitTypeRequests) {
 		file.printf("\"%s\", %d, ", requestType.Type->Ident.c_str(), requestType.Count);
@@ -875,7 +879,7 @@ static void AiMoveUnitInTheWay(CUnit &unit)
 			if (pos == u0) {
 				continue;
 			}
-			if (Map.Field(pos)->UnitCache.size() > 0) {
+			if (Map.Field(pos)->UnitCache().size() > 0) {
 				continue;
 			}
 
@@ -1000,19 +1004,95 @@ void AiResearchComplete(CUnit &unit, const CUpgrade *what)
 	// FIXME: upgrading knights -> paladins, must rebuild lists!
 }
 
+namespace
+{
+
+/// A slice of the work of an AI each second
+struct AiTask {
+	const char *Name;
+	void (*Run)();
+};
+
+/// The work of an AI each second, in the order it is done
+const AiTask AiTasks[] = {
+	{"script", AiExecuteScript},                 // Advance script
+	{"check-units", AiCheckUnits},               // Look if everything is fine.
+	{"resource-work", AiResourceCheckWork},      // Handle the resource manager.
+	{"resource-collect", AiResourceCollect},
+	{"resource-repair", AiResourceCheckRepair},
+	{"forces", [] { AiPlayer->Force.Update(); }}, // Handle the force manager.
+	{"force-assign", [] { AiAssignFreeUnitsToForce(); }},
+	{"magic", AiCheckMagic},                     // Check for magic actions.
+	{"explorers", [] {
+		// At most 1 explorer each 5 seconds
+		if (GameCycle > AiPlayer->LastExplorationGameCycle + 5 * CYCLES_PER_SECOND) {
+			AiSendExplorers();
+		}
+	}}
+};
+static_assert(std::size(AiTasks) == AiTaskCount);
+
+/// Tasks run each cycle by an AI, after the first one of each second
+constexpr unsigned int AiTasksPerCycle = 1;
+
+/// Number of runs of each task, by time taken: < 1us, < 2us, < 4us, ... >= 2^(AiTaskHistogramSize - 2) us
+constexpr int AiTaskHistogramSize = 16;
+using AiTaskHistogram = std::array<uint32_t, AiTaskHistogramSize>;
+
+std::array<AiTaskHistogram, AiTaskCount> AiTaskTimings;
+
+/**
+**  Run the next task of the current AI player, and record its time.
+*/
+void AiRunNextTask()
+{
+	const unsigned int task = AiPlayer->NextTask++;
+	const auto start = std::chrono::steady_clock::now();
+
+	AiTasks[task].Run();
+
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	const auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+	int bucket = 0;
+	while (bucket != AiTaskHistogramSize - 1 && us >= (1LL << bucket)) {
+		++bucket;
+	}
+	++AiTaskTimings[task][bucket];
+}
+
+} // namespace
+
 /**
 **  This is called for each player, each game cycle.
 **
+**  Runs AiTasksPerCycle more tasks of the work started by AiEachSecond.
+**  The tasks depend only on the game cycle, never on the time they take,
+**  so all the clients of a network game and the replays run them at the
+**  same cycles.
+**
 **  @param player  The player structure pointer.
 */
 void AiEachCycle(CPlayer &player)
 {
 	AiPlayer = player.Ai.get();
+#ifdef DEBUG
+	if (!AiPlayer) {
+		return;
+	}
+#endif
+
+	for (unsigned int i = 0; i != AiTasksPerCycle && AiPlayer->NextTask < AiTaskCount; ++i) {
+		AiRunNextTask();
+	}
 }
 
 /**
 **  This is called for each player each second.
 **
+**  Finishes the work of the previous second if needed, then starts the
+**  work of this one: its first task runs now, the other ones on the next
+**  cycles, from AiEachCycle.
+**
 **  @param player  The player structure pointer.
 */
 void AiEachSecond(CPlayer &player)
@@ -1024,25 +1104,37 @@ void AiEachSecond(CPlayer &player)
 	}
 #endif
 
-	//  Advance script
-	AiExecuteScript();
-
-	//  Look if everything is fine.
-	AiCheckUnits();
-
-	//  Handle the resource manager.
-	AiResourceManager();
-
-	//  Handle the force manager.
-	AiForceManager();
+	while (AiPlayer->NextTask < AiTaskCount) {
+		AiRunNextTask();
+	}
+	AiPlayer->NextTask = 0;
+	AiRunNextTask();
+}
 
-	//  Check for magic actions.
-	AiCheckMagic();
+/**
+**  Forget the timings of the AI tasks.
+*/
+void AiResetTaskTimings()
+{
+	AiTaskTimings = {};
+}
 
-	// At most 1 explorer each 5 seconds
-	if (GameCycle > AiPlayer->LastExplorationGameCycle + 5 * CYCLES_PER_SECOND) {
-		AiSendExplorers();
+/**
+**  Print the histograms of the time taken by each AI task, as a JSON
+**  object member: for each task, the number of runs which took less than
+**  1us, 2us, 4us, ... and the number of the longer ones.
+*/
+void AiPrintTaskTimings()
+{
+	printf("\"aiTasks\": {");
+	for (unsigned int task = 0; task != AiTaskCount; ++task) {
+		printf("%s\"%s\": [", task ? ", " : "", AiTasks[task].Name);
+		for (int bucket = 0; bucket != AiTaskHistogramSize; ++bucket) {
+			printf("%s%u", bucket ? ", " : "", AiTaskTimings[task][bucket]);
+		}
+		printf("]");
 	}
+	printf("}");
 }
 
 std::vector<std::vector<CUnitType *>> &AiHelper::Train()
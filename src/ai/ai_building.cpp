@@ -59,7 +59,7 @@ static bool IsPosFree(const Vec2i &pos, const CUnit &exceptionUnit)
 		return false;
 	}
 	const CMapField &mf = *Map.Field(pos);
-	if (ranges::contains(mf.UnitCache, &exceptionUnit)) {
+	if (ranges::contains(mf.UnitCache(), &exceptionUnit)) {
 		return true;
 	}
 	const tile_flags blockedFlag = (MapFieldUnpassable
@@ -68,6 +68,10 @@ class EnemyUnitFinder
 
 	static CUnit *find(const CUnit &unit, EAttackFindType find_type)
 	{
+		// No need to go through the whole map when there is no enemy on it
+		if ((Map.Influence.PlayersOnMap() & unit.Player->GetEnemyMask()) == 0) {
+			return nullptr;
+		}
 		// Terrain traversal by Andrettin
 		TerrainTraversal terrainTraversal;
 		terrainTraversal.SetSize(Map.Info.MapWidth, Map.Info.MapHeight);
@@ -103,7 +107,11 @@ VisitResult EnemyUnitFinder::Visit(TerrainTraversal &terrainTraversal, const Vec
 
 	Vec2i minpos = pos - Vec2i(attackrange, attackrange);
 	Vec2i maxpos = pos + Vec2i(unit.Type->TileWidth - 1 + attackrange, unit.Type->TileHeight - 1 + attackrange);
-	std::vector<CUnit *> table = Select(minpos, maxpos, HasNotSamePlayerAs(Players[PlayerNumNeutral]));
+	if ((Map.Influence.PlayersIn(minpos, maxpos) & unit.Player->GetEnemyMask()) == 0) {
+		return VisitResult::Ok;
+	}
+	std::vector<CUnit *> table =
+		Select(minpos, maxpos, HasNotSamePlayerAs(Players[PlayerNumNeutral]), unit.Player->GetEnemyMask());
 	for (CUnit *dest : table) {
 		const CUnitType &dtype = *dest->Type;
 
@@ -1062,11 +1070,18 @@ void AiForceManager::Update()
 				// Find idle units and order them to defend
 				// Don't attack if there aren't our units near goal point
 				const Vec2i offset(15, 15);
+				const CPlayer &player = *force.Units[0]->Player;
+				unsigned int allies = 0;
+				for (int i = 0; i < PlayerMax; ++i) {
+					if (i == player.Index || Players[i].IsAllied(player)) {
+						allies |= 1u << i;
+					}
+				}
 				maxPathing--;
-				std::vector<CUnit *> nearGoal = Select(force.GoalPos - offset,
-				                                       force.GoalPos + offset,
-				                                       IsAnAlliedUnitOf(*force.Units[0]->Player));
-				if (nearGoal.empty()) {
+				const bool alliesNearGoal =
+					(Map.Influence.PlayersIn(force.GoalPos - offset, force.GoalPos + offset) & allies)
+					&& !Select<1>(force.GoalPos - offset, force.GoalPos + offset, IsAnAlliedUnitOf(player), allies).empty();
+				if (!alliesNearGoal) {
 					force.ReturnToHome();
 				} else {
 					std::vector<CUnit *> idleUnits;
@@ -1098,13 +1113,4 @@ void AiForceManager::Update()
 	}
 }
 
-/**
-**  Entry point of force manager, periodic called.
-*/
-void AiForceManager()
-{
-	AiPlayer->Force.Update();
-	AiAssignFreeUnitsToForce();
-}
-
 //@}
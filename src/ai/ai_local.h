@@ -273,6 +273,9 @@ class AiExplorationRequest
 	int Mask;           /// mask ( ex: MapFieldLandUnit )
 };
 
+/// Number of tasks the work of an AI each second is sliced into, see AiEachSecond
+constexpr unsigned int AiTaskCount = 9;
+
 /**
 **  AI variables.
 */
@@ -308,6 +311,7 @@ class PlayerAi
 	std::vector<CUpgrade *> ResearchRequests;     /// Upgrades requested and priority list
 	std::vector<AiBuildQueue> UnitTypeBuilt;      /// What the resource manager should build
 	int LastRepairBuilding = 0;                   /// Last building checked for repair in this turn
+	unsigned int NextTask = AiTaskCount;          /// Next task of the work of this second, AiTaskCount when done
 };
 
 /**
@@ -401,8 +405,12 @@ extern void AiAddUnitTypeRequest(CUnitType &type, int count);
 extern void AiAddUpgradeToRequest(CUnitType &type);
 /// Add research request to resource manager
 extern void AiAddResearchRequest(CUpgrade *upgrade);
-/// Periodic called resource manager handler
-extern void AiResourceManager();
+/// Resource manager: check what needs to be built or trained
+extern void AiResourceCheckWork();
+/// Resource manager: assign the workers to the resources
+extern void AiResourceCollect();
+/// Resource manager: repair the damaged units
+extern void AiResourceCheckRepair();
 /// Ask the ai to explore around pos
 extern void AiExplore(const Vec2i &pos, int exploreMask);
 /// Make two unittypes be considered equals
@@ -440,9 +448,6 @@ extern void AiAttackWithForce(unsigned int force);
 /// Attack with forces in array
 extern void AiAttackWithForces(int *forces);
 
-/// Periodic called force manager handler
-extern void AiForceManager();
-
 //
 // Plans
 //
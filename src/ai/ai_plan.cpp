@@ -67,7 +67,10 @@ namespace {
 */
 CUnit *EnemyOnMapTile(const CUnit &source, const Vec2i &pos)
 {
-	auto units = Map.Field(pos)->UnitCache;
+	if ((Map.Influence.PlayersIn(pos, pos) & source.Player->GetEnemyMask()) == 0) {
+		return nullptr;
+	}
+	auto units = Map.Field(pos)->UnitCache();
 	ranges::erase_if(units, [&](const CUnit *unit) {
 		const CUnitType &type = *unit->Type;
 		// unusable unit ?
@@ -230,6 +233,9 @@ class EnemyFinderWithTransporter
 
 	static std::optional<Vec2i> find(const CUnit &unit, const TerrainTraversal &terrainTransporter)
 	{
+		if ((Map.Influence.PlayersOnMap() & unit.Player->GetEnemyMask()) == 0) {
+			return std::nullopt;
+		}
 		TerrainTraversal terrainTraversal;
 
 		terrainTraversal.SetSize(Map.Info.MapWidth, Map.Info.MapHeight);
@@ -412,7 +418,7 @@ static std::optional<Vec2i> ChooseRandomUnexploredPositionNear(const Vec2i &cent
 		pos.y = center.y + SyncRand() % (2 * ray + 1) - ray;
 
 		if (Map.Info.IsPointOnMap(pos)
-			&& Map.Field(pos)->playerInfo.IsExplored(*AiPlayer->Player) == false) {
+			&& Map.Field(pos)->playerInfo().IsExplored(*AiPlayer->Player) == false) {
 			return pos;
 		}
 		ray = 3 * ray / 2;
@@ -0,0 +1,353 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name ai_processor.cpp - Asynchronous connection to an external AI agent. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+//@{
+
+/*----------------------------------------------------------------------------
+--  Includes
+----------------------------------------------------------------------------*/
+
+#include "stratagus.h"
+
+#include "ai_processor.h"
+
+#include "net_lowlevel.h"
+#include "network/netsockets.h"
+
+#include <algorithm>
+#include <cstring>
+
+/*----------------------------------------------------------------------------
+--  Variables
+----------------------------------------------------------------------------*/
+
+/// Connected processors, whose batches end with the game cycles
+static std::vector<CAiProcessor *> AiProcessors;
+
+/*----------------------------------------------------------------------------
+--  Functions
+----------------------------------------------------------------------------*/
+
+namespace
+{
+
+bool SendAll(CTCPSocket &socket, const void *data, size_t size)
+{
+	const char *bytes = static_cast<const char *>(data);
+	while (size != 0) {
+		const int sent = socket.Send(bytes, size);
+		if (sent <= 0) {
+			return false;
+		}
+		bytes += sent;
+		size -= sent;
+	}
+	return true;
+}
+
+bool RecvAll(CTCPSocket &socket, void *data, size_t size)
+{
+	char *bytes = static_cast<char *>(data);
+	while (size != 0) {
+		const int received = socket.Recv(bytes, size);
+		if (received <= 0) {
+			return false;
+		}
+		bytes += received;
+		size -= received;
+	}
+	return true;
+}
+
+void Append(std::vector<char> &buffer, const void *data, size_t size)
+{
+	const char *bytes = static_cast<const char *>(data);
+	buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+} // namespace
+
+/**
+**  @param stateSize    Number of values of a state, at most 255.
+**  @param actionCount  Number of actions the agent chooses from, at most 256.
+**  @param delay        Cycles between a state and its action, at least 1.
+*/
+CAiProcessor::CAiProcessor(int stateSize, int actionCount, int delay) :
+	StateSize(std::clamp(stateSize, 0, 255)),
+	ActionCount(std::clamp(actionCount, 1, 256)),
+	Delay(std::max(1, delay))
+{
+	LastTaken.fill(-1);
+}
+
+/**
+**  Tell the agent the game ends, and wait for the I/O thread.
+**  Batches not answered yet are dropped.
+*/
+CAiProcessor::~CAiProcessor()
+{
+	if (Thread.joinable()) {
+		bool idle;
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			Stopping = true;
+			idle = Unsent == 0 && Unanswered == 0;
+		}
+		Changed.notify_all();
+		// The I/O thread may wait for an agent which never answers:
+		// the shut down connection ends its send or receive
+		if (!idle) {
+			Socket->Shutdown();
+		}
+		Thread.join();
+	}
+	if (Socket) {
+		Socket->Close();
+	}
+	AiProcessors.erase(std::remove(AiProcessors.begin(), AiProcessors.end(), this), AiProcessors.end());
+}
+
+/**
+**  Connect to the agent, tell it the size of the states and the number of
+**  actions, and start the I/O thread.
+**
+**  @return false if the agent can't be reached.
+*/
+bool CAiProcessor::Connect(const std::string &host, int port)
+{
+	Assert(!Socket);
+	Socket = std::make_unique<CTCPSocket>();
+	Socket->Open(CHost());
+	if (!Socket->Connect(CHost(host, port))) {
+		Socket.reset();
+		return false;
+	}
+	// Batches are sent before the answers to the previous ones
+	Socket->SetNoDelay();
+	const char init[3] = {'I', char(StateSize), char(ActionCount)};
+	if (!SendAll(*Socket, init, sizeof(init))) {
+		Socket->Close();
+		Socket.reset();
+		return false;
+	}
+	Thread = std::thread(&CAiProcessor::Run, this);
+	AiProcessors.push_back(this);
+	return true;
+}
+
+/**
+**  Add the state of a player to the batch of the cycle. It is sent at the
+**  end of the cycle, by EndCycle.
+*/
+void CAiProcessor::PushState(unsigned long cycle, int player, int32_t reward, const std::vector<int32_t> &state)
+{
+	Assert(0 <= player && player < PlayerMax);
+	Assert(int(state.size()) == StateSize);
+	Assert(Current.Players.empty() || Current.Cycle == cycle);
+	Assert(Current.Players.size() < 0xFFFF);
+
+	Current.Cycle = cycle;
+	Current.Players.push_back(player);
+	Current.Values.push_back(reward);
+	Current.Values.insert(Current.Values.end(), state.begin(), state.end());
+}
+
+/**
+**  Hand the states pushed during the cycle to the I/O thread.
+*/
+void CAiProcessor::EndCycle()
+{
+	if (Current.Players.empty()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		Batches.push_back(std::move(Current));
+		++Unsent;
+	}
+	Changed.notify_all();
+	Current = Batch();
+}
+
+/**
+**  Take the action chosen for the last state of player pushed at most
+**  Delay cycles before cycle. The actions of its older states are dropped,
+**  and each action is taken once.
+**
+**  Batches are freed once all their actions are taken, so each player
+**  pushing states should take their actions.
+**
+**  @return the action, or nothing if no state is due or the connection is lost.
+*/
+std::optional<int> CAiProcessor::TakeAction(int player, unsigned long cycle)
+{
+	Assert(0 <= player && player < PlayerMax);
+	std::unique_lock<std::mutex> lock(Mutex);
+	Batch *due = nullptr;
+	size_t index = 0;
+
+	for (Batch &batch : Batches) {
+		if (batch.Cycle + Delay > cycle) {
+			break;
+		}
+		if (long(batch.Cycle) <= LastTaken[player]) {
+			continue;
+		}
+		for (size_t i = 0; i != batch.Players.size(); ++i) {
+			if (batch.Players[i] == player) {
+				due = &batch;
+				index = i;
+			}
+		}
+	}
+	if (due == nullptr) {
+		return std::nullopt;
+	}
+	LastTaken[player] = due->Cycle;
+	Changed.wait(lock, [&]() { return due->Answered || Broken; });
+	if (!due->Answered) {
+		return std::nullopt;
+	}
+	const int action = due->Actions[index];
+
+	// Free the batches whose actions are all taken
+	while (!Batches.empty() && Batches.front().Answered
+	       && ranges::all_of(Batches.front().Players, [&](uint8_t p) { return long(Batches.front().Cycle) <= LastTaken[p]; })) {
+		Batches.pop_front();
+	}
+	return action;
+}
+
+bool CAiProcessor::IsBroken() const
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	return Broken;
+}
+
+/**
+**  End the cycle of all the connected processors.
+*/
+void CAiProcessor::EndCycleAll()
+{
+	for (CAiProcessor *processor : AiProcessors) {
+		processor->EndCycle();
+	}
+}
+
+bool CAiProcessor::SendBatch(const Batch &batch)
+{
+	std::vector<char> buffer;
+	const uint32_t cycle = htonl(uint32_t(batch.Cycle));
+	const uint16_t count = htons(uint16_t(batch.Players.size()));
+
+	buffer.reserve(7 + batch.Players.size() + 4 * batch.Values.size());
+	buffer.push_back('B');
+	Append(buffer, &cycle, sizeof(cycle));
+	Append(buffer, &count, sizeof(count));
+	for (size_t i = 0; i != batch.Players.size(); ++i) {
+		buffer.push_back(char(batch.Players[i]));
+		for (int j = 0; j != 1 + StateSize; ++j) {
+			const uint32_t value = htonl(uint32_t(batch.Values[i * (1 + StateSize) + j]));
+			Append(buffer, &value, sizeof(value));
+		}
+	}
+	return SendAll(*Socket, buffer.data(), buffer.size());
+}
+
+bool CAiProcessor::ReceiveAnswer(Batch &batch)
+{
+	char header[7];
+	if (!RecvAll(*Socket, header, sizeof(header)) || header[0] != 'A') {
+		return false;
+	}
+	uint32_t cycle;
+	uint16_t count;
+	memcpy(&cycle, header + 1, sizeof(cycle));
+	memcpy(&count, header + 5, sizeof(count));
+	if (ntohl(cycle) != uint32_t(batch.Cycle) || ntohs(count) != batch.Players.size()) {
+		return false;
+	}
+	std::vector<uint8_t> answers(2 * batch.Players.size());
+	if (!RecvAll(*Socket, answers.data(), answers.size())) {
+		return false;
+	}
+	batch.Actions.resize(batch.Players.size());
+	for (size_t i = 0; i != batch.Players.size(); ++i) {
+		if (answers[2 * i] != batch.Players[i] || answers[2 * i + 1] >= ActionCount) {
+			return false;
+		}
+		batch.Actions[i] = answers[2 * i + 1];
+	}
+	return true;
+}
+
+/**
+**  I/O thread: send the batches in order, and read the answers of the
+**  agent. All the queued batches are sent before waiting for an answer.
+*/
+void CAiProcessor::Run()
+{
+	std::unique_lock<std::mutex> lock(Mutex);
+
+	while (true) {
+		Changed.wait(lock, [this]() { return Stopping || Unsent != 0 || Unanswered != 0; });
+		if (Stopping) {
+			lock.unlock();
+			SendAll(*Socket, "Q", 1);
+			lock.lock();
+			break;
+		}
+		if (Unsent != 0) {
+			const Batch &batch = Batches[Batches.size() - Unsent];
+			lock.unlock();
+			const bool sent = SendBatch(batch);
+			lock.lock();
+			if (!sent) {
+				break;
+			}
+			--Unsent;
+			++Unanswered;
+		} else {
+			Batch &batch = Batches[Batches.size() - Unanswered];
+			lock.unlock();
+			const bool received = ReceiveAnswer(batch);
+			lock.lock();
+			if (!received) {
+				break;
+			}
+			batch.Answered = true;
+			--Unanswered;
+			Changed.notify_all();
+		}
+	}
+	Broken = true;
+	Changed.notify_all();
+}
+
+//@}
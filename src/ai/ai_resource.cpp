@@ -203,15 +203,28 @@ bool AiEnemyUnitsInDistance(const CPlayer &player,
 						    const CUnitType *type, const Vec2i &pos, unsigned range)
 {
 	const Vec2i offset(range, range);
+	// The players which are enemy of player: look at the units only where they are
+	unsigned int enemies = 0;
+	for (int i = 0; i < PlayerMax; ++i) {
+		if (Players[i].IsEnemy(player)) {
+			enemies |= 1u << i;
+		}
+	}
 
 	if (type == nullptr) {
-		std::vector<CUnit *> units = Select<1>(pos - offset, pos + offset, IsAEnemyUnitOf<true>(player));
+		if ((Map.Influence.PlayersIn(pos - offset, pos + offset) & enemies) == 0) {
+			return false;
+		}
+		std::vector<CUnit *> units = Select<1>(pos - offset, pos + offset, IsAEnemyUnitOf<true>(player), enemies);
 		return !units.empty();
 	} else {
 		const Vec2i typeSize(type->TileWidth - 1, type->TileHeight - 1);
 		const IsAEnemyUnitWhichCanCounterAttackOf<true> pred(player, *type);
 
-		std::vector<CUnit *> units = Select<1>(pos - offset, pos + typeSize + offset, pred);
+		if ((Map.Influence.ThreatsIn(pos - offset, pos + typeSize + offset) & enemies) == 0) {
+			return false;
+		}
+		std::vector<CUnit *> units = Select<1>(pos - offset, pos + typeSize + offset, pred, enemies);
 		return !units.empty();
 	}
 }
@@ -1386,25 +1399,37 @@ void AiExplore(const Vec2i &pos, int mask)
 }
 
 /**
-**  Entry point of resource manager, periodically called.
+**  First step of the resource manager: check if something needs to be
+**  build / trained.
 */
-void AiResourceManager()
+void AiResourceCheckWork()
 {
-	// Check if something needs to be build / trained.
 	AiCheckingWork();
 
 	// Look if we can build a farm in advance.
 	if (!AiPlayer->NeedSupply && AiPlayer->Player->Supply == AiPlayer->Player->Demand) {
 		AiRequestSupply();
 	}
+}
 
-	// Collect resources.
+/**
+**  Second step of the resource manager: assign the workers to the
+**  resources, every COLLECT_RESOURCES_INTERVAL seconds.
+*/
+void AiResourceCollect()
+{
 	if ((GameCycle / CYCLES_PER_SECOND) % COLLECT_RESOURCES_INTERVAL ==
 		(unsigned long)AiPlayer->Player->Index % COLLECT_RESOURCES_INTERVAL) {
 		AiCollectResources();
 	}
+}
 
-	// Check repair.
+/**
+**  Last step of the resource manager: check repair, and forget the
+**  resources needed during this second.
+*/
+void AiResourceCheckRepair()
+{
 	AiCheckRepair();
 
 	AiPlayer->NeededMask = 0;
@@ -40,6 +40,7 @@
 
 #include "ai.h"
 #include "ai_local.h"
+#include "ai_processor.h"
 
 #include "interface.h"
 #include "pathfinder.h"
@@ -1793,6 +1794,8 @@ static int CclDefineAiPlayer(lua_State *l)
 			ai.LastExplorationGameCycle = LuaToNumber(l, j + 1);
 		} else if (value == "last-can-not-move-cycle") {
 			ai.LastCanNotMoveGameCycle = LuaToNumber(l, j + 1);
+		} else if (value == "next-task") {
+			ai.NextTask = std::min<unsigned int>(LuaToNumber(l, j + 1), AiTaskCount);
 		} else if (value == "unit-type") {
 			if (!lua_istable(l, j + 1)) {
 				LuaError(l, "incorrect argument");
@@ -1935,6 +1938,102 @@ static int CclAiProcessorEnd(lua_State *l)
 	return 0;
 }
 
+/**
+ * AiProcessorSetupAsync(host, port, number_of_state_variables, number_of_actions, delay_in_cycles)
+ *
+ * Connect to an AI agent running at host:port, like AiProcessorSetup, but
+ * without waiting for it: the states pushed during a cycle are sent together
+ * by a background thread, and their actions are given delay_in_cycles later.
+ * See CAiProcessor for the protocol.
+ */
+static int CclAiProcessorSetupAsync(lua_State *l)
+{
+	InitNetwork1();
+	LuaCheckArgs(l, 5);
+	const std::string host{LuaToString(l, 1)};
+	const int port = LuaToNumber(l, 2);
+	const int stateDim = LuaToNumber(l, 3);
+	const int actionDim = LuaToNumber(l, 4);
+	const int delay = LuaToNumber(l, 5);
+
+	auto processor = std::make_unique<CAiProcessor>(stateDim, actionDim, delay);
+	if (processor->Connect(host, port)) {
+		lua_pushlightuserdata(l, processor.release());
+	} else {
+		lua_pushnil(l);
+	}
+	return 1;
+}
+
+static CAiProcessor *AiProcessorFromHandle(lua_State *l)
+{
+	CAiProcessor *processor = static_cast<CAiProcessor *>(lua_touserdata(l, 1));
+	if (processor == nullptr) {
+		LuaError(l, "first argument must be valid handle returned from a previous AiProcessorSetupAsync call");
+	}
+	return processor;
+}
+
+/**
+ * AiProcessorPush(handle, player, reward_since_last_call, table_of_state_variables)
+ *
+ * Add the state of player to the batch sent at the end of this cycle.
+ */
+static int CclAiProcessorPush(lua_State *l)
+{
+	LuaCheckArgs(l, 4);
+	CAiProcessor *processor = AiProcessorFromHandle(l);
+	const int player = LuaToNumber(l, 2);
+	const int32_t reward = LuaToNumber(l, 3);
+	if (player < 0 || player >= PlayerMax) {
+		LuaError(l, "bad player: %d", player);
+	}
+	if (!lua_istable(l, 4)) {
+		LuaError(l, "4th argument to AiProcessorPush must be table");
+	}
+	std::vector<int32_t> state;
+	for (lua_pushnil(l); lua_next(l, 4); lua_pop(l, 1)) {
+		state.push_back(LuaToNumber(l, -1));
+	}
+	if (int(state.size()) != processor->GetStateSize()) {
+		LuaError(l, "expected %d state variables, got %d", processor->GetStateSize(), int(state.size()));
+	}
+	processor->PushState(GameCycle, player, reward, state);
+	return 0;
+}
+
+/**
+ * AiProcessorAction(handle, player)
+ *
+ * Return the action chosen for the last state of player pushed at least
+ * delay_in_cycles ago, or nil if there is none.
+ */
+static int CclAiProcessorAction(lua_State *l)
+{
+	LuaCheckArgs(l, 2);
+	CAiProcessor *processor = AiProcessorFromHandle(l);
+	const int player = LuaToNumber(l, 2);
+	if (player < 0 || player >= PlayerMax) {
+		LuaError(l, "bad player: %d", player);
+	}
+	if (auto action = processor->TakeAction(player, GameCycle)) {
+		lua_pushnumber(l, *action + 1); // +1 since lua tables are 1-indexed
+	} else {
+		lua_pushnil(l);
+	}
+	return 1;
+}
+
+/**
+ * AiProcessorClose(handle)
+ */
+static int CclAiProcessorClose(lua_State *l)
+{
+	LuaCheckArgs(l, 1);
+	delete AiProcessorFromHandle(l);
+	return 0;
+}
+
 /**
 **  Register CCL features for unit-type.
 */
@@ -1984,6 +2083,10 @@ void AiCclRegister()
 	lua_register(Lua, "AiProcessorSetup", CclAiProcessorSetup);
 	lua_register(Lua, "AiProcessorStep", CclAiProcessorStep);
 	lua_register(Lua, "AiProcessorEnd", CclAiProcessorEnd);
+	lua_register(Lua, "AiProcessorSetupAsync", CclAiProcessorSetupAsync);
+	lua_register(Lua, "AiProcessorPush", CclAiProcessorPush);
+	lua_register(Lua, "AiProcessorAction", CclAiProcessorAction);
+	lua_register(Lua, "AiProcessorClose", CclAiProcessorClose);
 }
 
 //@}
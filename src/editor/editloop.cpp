@@ -203,7 +203,7 @@ static void EditorActionPlaceUnit(const Vec2i &pos, const CUnitType &type, CPlay
 
 	CBuildRestrictionOnTop *b = OnTopDetails(*unit, nullptr);
 	if (b && b->ReplaceOnBuild) {
-		auto &unitCache = Map.Field(pos)->UnitCache;
+		auto &unitCache = Map.Field(pos)->UnitCache();
 		auto it = ranges::find_if(unitCache, HasSameTypeAs(*b->Parent));
 
 		if (it != unitCache.end()) {
@@ -1879,7 +1879,7 @@ void CEditor::Init()
 			}
 		}
 
-		Map.Fields.resize(Map.Info.MapWidth * Map.Info.MapHeight);
+		Map.Create();
 
 		const int defaultTile = Map.Tileset.getDefaultTileIndex();
 
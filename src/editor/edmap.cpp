@@ -175,7 +175,7 @@ void CEditor::SetTile(const Vec2i &pos, tile_index tileIdx)
 	CMapField &mf = *Map.Field(pos);
 
 	mf.setTileIndex(Map.Tileset, tileIdx, 0, mf.getElevation());
-	mf.playerInfo.SeenTile = mf.getGraphicTile();
+	mf.playerInfo().SeenTile = mf.getGraphicTile();
 
 	UI.Minimap.UpdateSeenXY(pos);
 	UI.Minimap.UpdateXY(pos);
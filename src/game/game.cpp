@@ -117,6 +117,7 @@ void SaveGameSettings(CFile &file)
 
 /// forward declaration
 void CreateGame(const fs::path &filename, CMap *map);
+extern fs::path ExpandPath(const std::string &path);
 
 void StartMap(const std::string &filename, bool clean)
 {
@@ -155,6 +156,46 @@ void StartMap(const std::string &filename, bool clean)
 	Gui->setTop(oldTop);
 }
 
+/**
+**  Check if a file has the given extension, maybe followed by a compression one.
+*/
+static bool HasGameFileExtension(fs::path filename, std::string_view extension)
+{
+	if (filename.extension() == ".gz" || filename.extension() == ".bz2") {
+		filename.replace_extension();
+	}
+	return filename.extension() == extension;
+}
+
+/**
+**  Play a map, a save game or a replay without display, sound nor input.
+**
+**  @param filename  Map, save game (.sav) or replay (.log) to play.
+**  @param cycles    Maximum number of game cycles to play.
+**
+**  @return false if a replay got out of sync.
+*/
+bool StartHeadlessGame(const std::string &filename, unsigned long cycles)
+{
+	DebugPrint("Creating headless game with: %s\n", filename.c_str());
+	CleanPlayers();
+	if (HasGameFileExtension(filename, ".log")) {
+		LoadReplay(ExpandPath(filename));
+		CreateGame(CurrentMapPath, &Map);
+	} else {
+		if (HasGameFileExtension(filename, ".sav")) {
+			SaveGameLoading = true;
+			LoadGame(ExpandPath(filename));
+		}
+		CreateGame(filename, &Map);
+	}
+
+	const bool inSync = HeadlessGameLoop(cycles);
+
+	CleanGame();
+	return inSync;
+}
+
 /*----------------------------------------------------------------------------
 --  Map loading/saving
 ----------------------------------------------------------------------------*/
@@ -44,6 +44,7 @@
 #include "netconnect.h"
 #include "network.h"
 #include "parameters.h"
+#include "pathfinder.h"
 #include "player.h"
 #include "script.h"
 #include "settings.h"
@@ -82,6 +83,7 @@ class LogEntry
 	std::string Value;
 	int Num = 0;
 	unsigned SyncRandSeed = 0;
+	std::optional<unsigned> SyncHash; /// Not in the replays of older versions
 };
 
 /**
@@ -105,6 +107,8 @@ class FullReplay
 	Settings ReplaySettings;
 	int Engine[3]{};
 	int Network[3]{};
+	int Sync = 1; /// StratagusSyncVersion, not in the replays of older versions
+	unsigned PathCacheEnd = 0; /// Flow fields are used before this GameCycle, see pathcache.cpp
 	std::vector<LogEntry> Commands;
 };
 
@@ -126,6 +130,7 @@ static unsigned long NextLogCycle; /// Next log cycle number
 static bool InitReplay;             /// Initialize replay
 static std::unique_ptr<FullReplay> CurrentReplay;
 static std::optional<std::size_t> ReplayIndex;
+static ReplaySyncCheck SyncCheck;   /// Result of the sync checks of the current replay
 
 //----------------------------------------------------------------------------
 // Log commands
@@ -186,6 +191,9 @@ static std::unique_ptr<FullReplay> StartReplay()
 	replay->Network[0] = NetworkProtocolMajorVersion;
 	replay->Network[1] = NetworkProtocolMinorVersion;
 	replay->Network[2] = NetworkProtocolPatchLevel;
+
+	replay->Sync = StratagusSyncVersion;
+	replay->PathCacheEnd = PathCacheEndCycle;
 	return replay;
 }
 
@@ -212,9 +220,16 @@ static void ApplyReplaySettings()
 
 	Map.NoFogOfWar = GameSettings.NoFogOfWar;
 	FlagRevealMap = GameSettings.RevealMap;
+	PathCacheEndCycle = CurrentReplay->PathCacheEnd;
 
 	GameSettings.Save(+[](std::string s) { DebugPrint("%s\n", s.c_str()); });
 
+	if (CurrentReplay->Sync != StratagusSyncVersion) {
+		ErrorPrint("Replay was recorded with sync version %d, this engine has sync version %d:"
+		           " the game will not play the same\n",
+		           CurrentReplay->Sync,
+		           StratagusSyncVersion);
+	}
 	// FIXME : check engine version
 	// FIXME : FIXME: check network version
 	// FIXME : check mapid
@@ -244,6 +259,9 @@ static void PrintLogCommand(const LogEntry &log, CFile &file)
 	if (log.Num != -1) {
 		file.printf("Num = %d, ", log.Num);
 	}
+	if (log.SyncHash) {
+		file.printf("SyncHash = %d, ", (signed)*log.SyncHash);
+	}
 	file.printf("SyncRandSeed = %d } )\n", (signed)log.SyncRandSeed);
 }
 
@@ -280,8 +298,10 @@ static void SaveFullLog(CFile &file)
 	}, false);
 	file.printf("  Engine = { %d, %d, %d },\n",
 				CurrentReplay->Engine[0], CurrentReplay->Engine[1], CurrentReplay->Engine[2]);
-	file.printf("  Network = { %d, %d, %d }\n",
+	file.printf("  Network = { %d, %d, %d },\n",
 				CurrentReplay->Network[0], CurrentReplay->Network[1], CurrentReplay->Network[2]);
+	file.printf("  Sync = %d,\n", CurrentReplay->Sync);
+	file.printf("  PathCacheEnd = %u\n", CurrentReplay->PathCacheEnd);
 	file.printf("} )\n");
 	for (const auto &command : CurrentReplay->Commands) {
 		PrintLogCommand(command, file);
@@ -405,6 +425,7 @@ void CommandLog(const char *action,
 	log.Num = num;
 
 	log.SyncRandSeed = SyncRandSeed;
+	log.SyncHash = SyncHash;
 
 	// Append it to ReplayLog list
 	AppendLog(std::move(log), *LogFile);
@@ -453,6 +474,8 @@ static int CclLog(lua_State *l)
 			log.Num = LuaToNumber(l, -1);
 		} else if (value == "SyncRandSeed") {
 			log.SyncRandSeed = lua_tointeger(l, -1);
+		} else if (value == "SyncHash") {
+			log.SyncHash = lua_tointeger(l, -1);
 		} else {
 			LuaError(l, "Unsupported key: %s", value.data());
 		}
@@ -543,6 +566,10 @@ static int CclReplayLog(lua_State *l)
 			replay->Network[0] = LuaToNumber(l, -1, 1);
 			replay->Network[1] = LuaToNumber(l, -1, 2);
 			replay->Network[2] = LuaToNumber(l, -1, 3);
+		} else if (value == "Sync") {
+			replay->Sync = LuaToNumber(l, -1);
+		} else if (value == "PathCacheEnd") {
+			replay->PathCacheEnd = LuaToUnsignedNumber(l, -1);
 		} else {
 			if (!replay->ReplaySettings.SetField({value.data(), value.size()}, LuaToNumber(l, -1))) {
 				LuaError(l, "Unsupported key: %s", value.data());
@@ -557,6 +584,8 @@ static int CclReplayLog(lua_State *l)
 	if (!SaveGameLoading) {
 		ApplyReplaySettings();
 	} else {
+		// The flow fields are not saved, the loaded game no longer uses them
+		CurrentReplay->PathCacheEnd = std::min<unsigned long>(CurrentReplay->PathCacheEnd, GameCycle);
 		CommandLogDisabled = false;
 	}
 
@@ -581,12 +610,28 @@ void SaveReplayList(CFile &file)
 	SaveFullLog(file);
 }
 
+/**
+**  Check if all the commands of the replayed game were played
+*/
+bool IsReplayOver()
+{
+	return IsReplayGame() && CurrentReplay && !InitReplay && !ReplayIndex;
+}
+
+/**
+**  Get the result of the sync checks of the replayed game
+*/
+const ReplaySyncCheck &GetReplaySyncCheck()
+{
+	return SyncCheck;
+}
+
 /**
 **  Load a log file to replay a game
 **
 **  @param name  name of file to load.
 */
-static void LoadReplay(const fs::path &name)
+void LoadReplay(const fs::path &name)
 {
 	CleanReplayLog();
 	ReplayGameType = EReplayType::SinglePlayer;
@@ -631,6 +676,7 @@ void CleanReplayLog()
 	GameObserve = false;
 	NetPlayers = 0;
 	ReplayGameType = EReplayType::NoReplay;
+	SyncCheck = {};
 }
 
 /**
@@ -660,7 +706,17 @@ static void DoNextReplay()
 
 	Assert(unitSlot == -1 || ReplayStep.UnitIdent == unit->Type->Ident);
 
+	if (ReplayStep.SyncRandSeed) {
+		++SyncCheck.CheckedSteps;
+	}
+	if (ReplayStep.SyncHash && *ReplayStep.SyncHash != SyncHash && !SyncCheck.DesyncCycle) {
+		ErrorPrint("OUT OF SYNC hash %X != %X at GameCycle %lu\n", SyncHash, *ReplayStep.SyncHash, GameCycle);
+		SyncCheck.DesyncCycle = GameCycle;
+	}
 	if (SyncRandSeed != ReplayStep.SyncRandSeed) {
+		if (ReplayStep.SyncRandSeed && !SyncCheck.DesyncCycle) {
+			SyncCheck.DesyncCycle = GameCycle;
+		}
 #ifdef DEBUG
 		if (!ReplayStep.SyncRandSeed) {
 			// Replay without the 'sync info
@@ -54,7 +54,9 @@
 #include "upgrade.h"
 #include "version.h"
 
+#include <chrono>
 #include <ctime>
+#include <thread>
 
 extern void StartMap(const std::string &filename, bool clean);
 
@@ -63,6 +65,21 @@ extern void StartMap(const std::string &filename, bool clean);
 --  Variables
 ----------------------------------------------------------------------------*/
 
+/// Thread writing the file of the last SaveGameInBackground, joined before the next save or load
+static struct BackgroundSave
+{
+	~BackgroundSave() { Wait(); }
+
+	void Wait()
+	{
+		if (Thread.joinable()) {
+			Thread.join();
+		}
+	}
+
+	std::thread Thread;
+} BackgroundSave;
+
 /*----------------------------------------------------------------------------
 --  Functions
 ----------------------------------------------------------------------------*/
@@ -95,24 +112,13 @@ static fs::path GetSaveDir()
 }
 
 /**
-**  Save a game to file.
+**  Write the state of the game.
 **
+**  @param file      File to write to.
 **  @param filename  File name to be stored.
-**  @return  -1 if saving failed, 0 if all OK
-**
-**  @note  Later we want to store in a more compact binary format.
 */
-int SaveGame(const std::string &filename)
+static void WriteGame(CFile &file, const std::string &filename)
 {
-	CFile file;
-	fs::path fullpath(GetSaveDir());
-
-	fullpath /= filename;
-	if (file.open(fullpath.string().c_str(), CL_WRITE_GZ | CL_OPEN_WRITE) == -1) {
-		ErrorPrint("Can't save to '%s'\n", filename.c_str());
-		return -1;
-	}
-
 	time_t now;
 	char dateStr[64];
 
@@ -172,7 +178,108 @@ int SaveGame(const std::string &filename)
 		file.printf("-- Lua state\n\n%s\n", s.c_str());
 	}
 	SaveTriggers(file); //Triggers are saved in SaveGlobal, so load it after Global
+}
+
+/**
+**  Save a game to file.
+**
+**  @param filename  File name to be stored.
+**  @return  -1 if saving failed, 0 if all OK
+**
+**  @note  Later we want to store in a more compact binary format.
+*/
+int SaveGame(const std::string &filename)
+{
+	CFile file;
+	fs::path fullpath(GetSaveDir());
+
+	BackgroundSave.Wait();
+	fullpath /= filename;
+	if (file.open(fullpath.string().c_str(), CL_WRITE_GZ | CL_OPEN_WRITE) == -1) {
+		ErrorPrint("Can't save to '%s'\n", filename.c_str());
+		return -1;
+	}
+	WriteGame(file, filename);
+	file.close();
+	return 0;
+}
+
+/**
+**  Compress and write the state of a game into a temporary file, then
+**  rename it, so that an interrupted write leaves the previous save intact.
+**
+**  @param fullpath  Path of the save file.
+**  @param data      State of the game, as written by WriteGame.
+*/
+static void WriteSaveFile(const fs::path &fullpath, const std::string &data)
+{
+	const auto start = std::chrono::steady_clock::now();
+	fs::path partpath(fullpath);
+	partpath += ".part";
+
+	// CFile appends the extension of the compression to the file name
+	std::error_code ec;
+	for (const char *extension : {"", ".gz", ".bz2"}) {
+		fs::remove(fs::path(partpath) += extension, ec);
+	}
+	CFile file;
+	if (file.open(partpath.string().c_str(), CL_WRITE_GZ | CL_OPEN_WRITE) == -1) {
+		ErrorPrint("Can't save to '%s'\n", partpath.u8string().c_str());
+		return;
+	}
+	file.write(data);
+	if (file.close() != 0) {
+		ErrorPrint("Can't save to '%s'\n", partpath.u8string().c_str());
+		return;
+	}
+	for (const char *extension : {"", ".gz", ".bz2"}) {
+		const fs::path written = fs::path(partpath) += extension;
+		if (fs::exists(written, ec)) {
+			fs::rename(written, fs::path(fullpath) += extension, ec);
+			if (ec) {
+				ErrorPrint("Can't rename '%s': %s\n", written.u8string().c_str(), ec.message().c_str());
+				return;
+			}
+			break;
+		}
+	}
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	LogPrint("Save game '%s' written in %ld ms\n",
+	         fullpath.filename().u8string().c_str(),
+	         long(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+}
+
+/**
+**  Save a game to file, without waiting for the file.
+**
+**  The state of the game is written into memory, then compressed and
+**  written to the file by another thread while the game goes on.
+**
+**  @param filename  File name to be stored.
+**  @return  -1 if saving failed, 0 if all OK
+*/
+int SaveGameInBackground(const std::string &filename)
+{
+	const auto start = std::chrono::steady_clock::now();
+	CFile file;
+
+	BackgroundSave.Wait();
+	if (file.open(filename.c_str(), CL_WRITE_MEMORY | CL_OPEN_WRITE) == -1) {
+		ErrorPrint("Can't save to '%s'\n", filename.c_str());
+		return -1;
+	}
+	WriteGame(file, filename);
 	file.close();
+	std::string data = file.takeData();
+
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	LogPrint("Save game '%s' snapshot of %zu bytes taken in %ld ms\n",
+	         filename.c_str(), data.size(),
+	         long(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+
+	BackgroundSave.Thread = std::thread([fullpath = GetSaveDir() / filename, data = std::move(data)]() {
+		WriteSaveFile(fullpath, data);
+	});
 	return 0;
 }
 
@@ -197,6 +304,7 @@ void DeleteSaveGame(const std::string &filename)
 void StartSavedGame(const std::string &filename)
 {
 	SaveGameLoading = true;
+	BackgroundSave.Wait();
 	CleanPlayers();
 	LoadGame(ExpandPath(filename));
 
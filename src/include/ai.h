@@ -55,6 +55,9 @@ extern int AiSleepCycles;  /// Ai sleeps # cycles
 extern void AiEachCycle(CPlayer &player);   /// Called each game cycle
 extern void AiEachSecond(CPlayer &player);  /// Called each second
 
+extern void AiResetTaskTimings();  /// Forget the timings of the AI tasks
+extern void AiPrintTaskTimings();  /// Print the timings of the AI tasks as JSON
+
 extern void InitAiModule();       /// Init AI global structures
 extern void AiInit(CPlayer &player);   /// Init AI for this player
 extern void CleanAi();            /// Cleanup the AI module
@@ -0,0 +1,136 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name ai_processor.h - Asynchronous connection to an external AI agent. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+#ifndef __AI_PROCESSOR_H__
+#define __AI_PROCESSOR_H__
+
+//@{
+
+/*----------------------------------------------------------------------------
+--  Includes
+----------------------------------------------------------------------------*/
+
+#include "settings.h"
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+class CTCPSocket;
+
+/*----------------------------------------------------------------------------
+--  Declarations
+----------------------------------------------------------------------------*/
+
+/**
+**  Asynchronous connection to an external AI agent.
+**
+**  The states pushed by the AI players during a game cycle are sent as one
+**  batch at the end of the cycle, by a background thread which also reads
+**  the answers of the agent, so the game never waits for the network while
+**  it plays. The action chosen for a state pushed at cycle c is given at
+**  cycle c + Delay: if the agent has not answered by then, TakeAction waits
+**  for it, so the game plays the same whatever the latency of the agent.
+**
+**  Protocol, in network byte order, after the connection:
+**  - 'I', state size (u8), action count (u8): once, as for AiProcessorSetup.
+**  - 'B', cycle (u32), count (u16), then for each state: player (u8),
+**    reward (i32), state (state size x i32): a batch of states.
+**  - 'A', cycle (u32), count (u16), then for each state: player (u8),
+**    action (u8): the answer of the agent to each batch, in order.
+**  - 'Q': the game closes the connection. When the game ends before the
+**    agent answered all the batches, the connection is shut down instead.
+*/
+class CAiProcessor
+{
+public:
+	CAiProcessor(int stateSize, int actionCount, int delay);
+	~CAiProcessor();
+	CAiProcessor(const CAiProcessor &) = delete;
+	CAiProcessor &operator=(const CAiProcessor &) = delete;
+
+	/// Connect to the agent and start the I/O thread
+	bool Connect(const std::string &host, int port);
+
+	/// Add the state of a player at cycle to the batch of the cycle
+	void PushState(unsigned long cycle, int player, int32_t reward, const std::vector<int32_t> &state);
+	/// Give the batch of the cycle to the I/O thread
+	void EndCycle();
+	/// Action for the last state of player due at cycle, if any, waiting for the agent when needed
+	std::optional<int> TakeAction(int player, unsigned long cycle);
+
+	int GetStateSize() const { return StateSize; }
+	bool IsBroken() const;
+
+	/// End the batches of the cycle of all the connections
+	static void EndCycleAll();
+
+private:
+	/// States sent together, and the actions of the agent for them
+	struct Batch {
+		unsigned long Cycle = 0;
+		std::vector<uint8_t> Players;
+		std::vector<int32_t> Values;   /// Reward and state of each player, one after the other
+		std::vector<uint8_t> Actions;  /// Filled by the I/O thread
+		bool Answered = false;
+	};
+
+	void Run();
+	bool SendBatch(const Batch &batch);
+	bool ReceiveAnswer(Batch &batch);
+
+private:
+	const int StateSize;
+	const int ActionCount;
+	const int Delay;                   /// Cycles between a state and its action
+
+	std::unique_ptr<CTCPSocket> Socket;
+	std::thread Thread;
+	mutable std::mutex Mutex;
+	std::condition_variable Changed;   /// A batch was queued, answered, or the connection ended
+
+	Batch Current;                     /// States of the cycle, game thread only
+	std::deque<Batch> Batches;         /// Batches not yet consumed, oldest first
+	size_t Unsent = 0;                 /// Number of batches at the end of Batches to send
+	size_t Unanswered = 0;             /// Number of sent batches waiting for their answer
+	bool Stopping = false;
+	bool Broken = false;
+	std::array<long, PlayerMax> LastTaken; /// Cycle of the last state whose action was taken, by player
+};
+
+//@}
+
+#endif // !__AI_PROCESSOR_H__
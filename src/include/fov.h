@@ -32,9 +32,12 @@
 #ifndef __FOV_H__
 #define __FOV_H__
 
+#include <deque>
 #include <functional>
+#include <map>
 #include <queue>
 #include <set>
+#include <tuple>
 #include "vec2i.h"
 #include "map.h"
 #include "tileset.h"
@@ -48,11 +51,18 @@ class CFieldOfView
 	void Clean()
 	{
 		MarkedTilesCache.clear();
+		CachedViews.clear();
 	}
 
 	/// Refresh field of view
 	void Refresh(const CPlayer &player, const CUnit &unit, const Vec2i &pos, const uint16_t width,
 				 const uint16_t height, const uint16_t range, MapMarkerFunc *marker);
+	/// Refresh only the edges of the field of view of a spectator which moved to a neighbour tile
+	void RefreshStep(const CPlayer &player, const CUnit &unit, const Vec2i &oldPos, const Vec2i &pos,
+					 const uint16_t width, const uint16_t height, const uint16_t range,
+					 MapMarkerFunc *unmarker, MapMarkerFunc *marker);
+	/// Opacity of the map fields changed: the cached fields of view are outdated
+	void TerrainChanged() { ++TerrainGeneration; }
 
 	bool SetType(const FieldOfViewTypes fov_type);
 	FieldOfViewTypes GetType() const;
@@ -73,9 +83,34 @@ class CFieldOfView
 		Vec2i BottomVector;
 	};
 
+	/// Field of view computed by shadow casting for a spectator, kept until it is refreshed again
+	struct SCachedView {
+		Vec2i Pos {-1, -1};
+		uint16_t Width {0};
+		uint16_t Height {0};
+		uint16_t Range {0};
+		tile_flags OpaqueFields {0};
+		unsigned int Generation {0};
+		std::vector<unsigned int> Tiles; /// Indexes of the visible tiles
+	};
+	/// Offsets of the tiles a simple radial field of view loses and gains with a step
+	struct SStepMask {
+		std::vector<Vec2i> Leaving;  /// Relative to the position before the step
+		std::vector<Vec2i> Entering; /// Relative to the position after the step
+	};
+
 	/// Calc whole simple radial field of view
 	void ProceedSimpleRadial(const CPlayer &player, const Vec2i &pos, const int16_t w, const int16_t h,
 							 int16_t range, MapMarkerFunc *marker) const;
+	/// Calc the edges of simple radial field of view changed by a step
+	void ProceedSimpleRadialStep(const CPlayer &player, const Vec2i &oldPos, const Vec2i &pos,
+								 const int16_t w, const int16_t h, const int16_t range,
+								 MapMarkerFunc *unmarker, MapMarkerFunc *marker);
+	/// Get (and compute once) the tiles left and entered by a step of a simple radial field of view
+	const SStepMask &GetStepMask(const int16_t w, const int16_t h, const int16_t range, const Vec2i &step);
+	/// Get the visible tiles by shadow casting, from the cache of the unit when possible
+	const std::vector<unsigned int> &ShadowCastTiles(const CUnit &unit, const Vec2i &pos, const uint16_t width,
+													 const uint16_t height, const uint16_t range);
 	/// Calc whole shadow casting field of view
 	void ProceedShadowCasting(const Vec2i &spectatorPos, const uint16_t width, const uint16_t height, const uint16_t range);
 	/// Calc field of view for set of lines along x or y.
@@ -97,9 +132,9 @@ class CFieldOfView
 	void MarkTile();
 
 	/// Setup ShadowCaster for current refreshing of FoV
-	void PrepareShadowCaster(const CPlayer &player, const CUnit &unit, const Vec2i &pos, MapMarkerFunc *marker);
+	void PrepareShadowCaster(const Vec2i &pos, std::vector<unsigned int> &tiles);
 	void ResetShadowCaster();
-	void PrepareCache(const Vec2i pos, const uint16_t width, const uint16_t height, const uint16_t range);
+	void PrepareCache();
 
 	/// Update values of Octant and Origin for current working set
 	void SetEnvironment(const uint8_t octant, const Vec2i &origin);
@@ -119,13 +154,18 @@ class CFieldOfView
 	uint8_t		Elevation		{0};	/// highground elevation level of origin
 	tile_flags	OpaqueFields	{0};	/// Flags for opaque MapTiles for current calculation
 
-	const CPlayer   *Player 	  {nullptr}; /// Pointer to player to set FoV for
-	const CUnit     *Unit 		  {nullptr}; /// Pointer to unit to calculate FoV for
-	MapMarkerFunc	*map_setFoV   {nullptr}; /// Pointer to external function for setting tiles visibility
+	std::vector<unsigned int> *ViewTiles {nullptr}; /// Visible tiles found by the current calculation
 
-	std::vector<uint8_t> MarkedTilesCache;	/// To prevent multiple calls of map_setFoV for single tile
+	std::vector<uint8_t> MarkedTilesCache;	/// To prevent multiple marks for single tile
 											/// (for tiles on the vertical, horizontal and diagonal lines it calls twice)
-											/// we use cache table to count already marked tiles
+											/// we use cache table to count already marked tiles.
+											/// It is cleared after each use.
+
+	std::deque<SCachedView> CachedViews;    /// Last shadow casting field of view of each unit slot
+	SCachedView UncachedView;               /// Field of view of a unit without slot
+	std::vector<unsigned int> StepTiles;    /// Field of view before the step being refreshed
+	std::map<std::tuple<int16_t, int16_t, int16_t, int16_t, int16_t>, SStepMask> StepMasks; /// By w, h, range and step
+	unsigned int TerrainGeneration {0};     /// Incremented each time the opacity of fields changes
 };
 
 /*----------------------------------------------------------------------------
@@ -163,7 +203,7 @@ inline void CFieldOfView::MarkTile()
 {
 	const size_t index = Map.getIndex(currTilePos.x, currTilePos.y);
 	if (!MarkedTilesCache[index]) {
-		map_setFoV(*Player, index);
+		ViewTiles->push_back(index);
 		MarkedTilesCache[index] = 1;
 	}
 }
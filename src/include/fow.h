@@ -37,6 +37,7 @@
 #include "settings.h"
 #include "video.h"
 
+#include <bitset>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -60,6 +61,17 @@ class CFogOfWar
     enum States       { cFirstEntry = 0, cGenerateFog, cGenerateTexture, cBlurTexture, cReady };
     enum UpscaleTypes { cSimple = 0, cBilinear };
 
+    /// Time spent in the stages of the fog generation, accumulated since the last reset
+    struct StageTimings
+    {
+        uint64_t GenerateFog    {0}; /// Microseconds spent to fill the vision table
+        uint64_t Upscale        {0}; /// Microseconds spent to upscale the vision table into the texture
+        uint64_t Blur           {0}; /// Microseconds spent to blur the texture
+        uint64_t Deltas         {0}; /// Microseconds spent to switch the texture frames
+        uint32_t Generations    {0}; /// Number of generated fog frames
+        uint32_t PartialUpdates {0}; /// Number of frames regenerated only around the changed tiles
+    };
+
     static void SetTiledFogGraphic(const fs::path &fogGraphicFile);
 
     void Init();
@@ -77,6 +89,9 @@ class CFogOfWar
     void ShowVisionFor(const CPlayer &player) { VisionFor.insert(player.Index); }
     void HideVisionFor(const CPlayer &player) { VisionFor.erase(player.Index); }
 
+    void MarkDirty(const CPlayer &player, const unsigned int index);
+    void InvalidateAll() { DirtyAll = true; }
+
     void SetFogColor(const uint8_t r, const uint8_t g, const uint8_t b);
     void SetFogColor(const CColor color);
     void SetEasingSteps(const uint8_t num);
@@ -89,6 +104,10 @@ class CFogOfWar
     void Draw(CViewport &viewport);
 
     uint8_t GetVisibilityForTile(const Vec2i tilePos) const;
+    SDL_Rect TakeChangedTiles();
+
+    const StageTimings &GetTimings() const { return Timings; }
+    void ResetTimings() { Timings = {}; }
 
 private:
     void InitEnhanced();
@@ -98,16 +117,17 @@ class CFogOfWar
 	                           const uint8_t alphaFrom,
 	                           const uint8_t alphaTo);
 
-    void GenerateFog();
-    void FogUpscale4x4();
+    SDL_Rect GenerateFog();
+    void AddUpdatedTiles(const SDL_Rect &tiles);
+    void FogUpscale4x4(uint32_t *const texture, const uint16_t textureWidth, const SDL_Rect &blocks);
+    void GenerateTexture();
+    void BlurTexture();
+    void PushTexture(const bool forcedShowNext = false);
 
     uint8_t DeterminePattern(const size_t index, const uint8_t visFlag) const;
     void FillUpscaledRec(uint32_t *texture, const uint16_t textureWidth, size_t index,
                          const uint8_t patternVisible, const uint8_t patternExplored) const;
 
-    void UpscaleBilinear(const uint8_t *const src, const SDL_Rect &srcRect, const int16_t srcWidth,
-                         SDL_Surface *const trgSurface, const SDL_Rect &trgRect) const;
-
     void UpscaleSimple(const uint8_t *src, const SDL_Rect &srcRect, const int16_t srcWidth,
                        SDL_Surface *const trgSurface, const SDL_Rect &trgRect) const;
 
@@ -146,6 +166,17 @@ class CFogOfWar
                                     /// ThisPlayer and his allies in normal games
                                     /// Any set of players for observers and in the replays
 
+    std::bitset<PlayerMax> RenderedPlayers;   /// VisionFor and players who share vision with them
+    uint8_t  VisibleThreshold {2};            /// Visible[] value since which tiles are shown as visible
+    bool     DirtyAll {true};                 /// The whole fog has to be regenerated
+    Vec2i    DirtyMin {0, 0};                 /// Bounds of the tiles where the vision of the rendered players
+    Vec2i    DirtyMax {-1, -1};               /// has changed since the last fog generation
+    SDL_Rect UpdatedTiles {0, 0, 0, 0};       /// Tiles regenerated in the vision table and not pushed to the texture yet
+    SDL_Rect UpdatedTexels {0, 0, 0, 0};      /// Area of the fog texture changed by UpdatedTiles (blur included)
+    SDL_Rect UpscaledTexels {0, 0, 0, 0};     /// Area of the fog texture upscaled into PartialTexture
+    SDL_Rect ChangedTiles {0, 0, 0, 0};       /// Tiles regenerated in the vision table and not taken by the minimap yet
+    StageTimings Timings;                     /// Time spent in the stages of the fog generation
+
     static std::shared_ptr<CGraphic> TiledFogSrc; /// Graphic for tiled fog of war
     std::shared_ptr<CGraphic> TiledAlphaFog;      /// Working set of graphic for tiled fog of war with alpha channel
     SDL_Surface *TileOfFogOnly {nullptr};   /// Tile contains only fog. Used for legacy rendering of tiled fog
@@ -161,6 +192,8 @@ class CFogOfWar
     CEasedTexture        FogTexture;          /// Upscaled fog texture (alpha-channel values only) for whole map
                                               /// + 1 tile to the left and up (for simplification of upscale algorithm purposes).
     std::vector<uint8_t> RenderedFog;         /// Back buffer for bilinear upscaling in to viewports
+    std::vector<uint8_t> PartialTexture;      /// Fog texture around changed tiles, upscaled and blurred before copying into FogTexture
+    std::vector<uint8_t> UpscalePatterns;     /// Visible and explored patterns of a row of blocks for each thread, used by FogUpscale4x4
     CBlurrer             Blurrer;             /// Blurrer for fog of war texture
 
     /// Tables with patterns to generate fog of war texture from vision table
@@ -257,8 +290,53 @@ inline void CFogOfWar::FillUpscaledRec(uint32_t *texture, const uint16_t texture
     }
 }
 
+/**
+**  Remember that the vision of the player has changed for the tile
+**
+**  @param  player  player whose vision has changed
+**  @param  index   index of the tile on the map
+**
+*/
+inline void CFogOfWar::MarkDirty(const CPlayer &player, const unsigned int index)
+{
+    if (DirtyAll || !RenderedPlayers.test(player.Index)) {
+        return;
+    }
+    const Vec2i pos(index % Map.Info.MapWidth, index / Map.Info.MapWidth);
+    DirtyMin.x = std::min(DirtyMin.x, pos.x);
+    DirtyMin.y = std::min(DirtyMin.y, pos.y);
+    DirtyMax.x = std::max(DirtyMax.x, pos.x);
+    DirtyMax.y = std::max(DirtyMax.y, pos.y);
+}
+
+/**
+**  Add refilled tiles of the vision table to the ones to be upscaled into the fog texture
+**
+**  @param  tiles   rectangle of the refilled tiles
+**
+*/
+inline void CFogOfWar::AddUpdatedTiles(const SDL_Rect &tiles)
+{
+    SDL_Rect merged;
+    SDL_UnionRect(&tiles, &UpdatedTiles, &merged);
+    UpdatedTiles = merged;
+}
+
 inline uint8_t CFogOfWar::GetVisibilityForTile(const Vec2i tilePos) const
 {
     return VisTable[VisTable_Index0 + tilePos.x + VisTableWidth * tilePos.y];
 }
+
+/**
+**  Get the tiles regenerated in the vision table since the last call, and forget them
+**
+**  @return rectangle of the tiles whose visibility may have changed
+**
+*/
+inline SDL_Rect CFogOfWar::TakeChangedTiles()
+{
+    const SDL_Rect tiles = ChangedTiles;
+    ChangedTiles = {0, 0, 0, 0};
+    return tiles;
+}
 #endif // !__FOW_H__
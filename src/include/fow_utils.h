@@ -43,6 +43,18 @@ class CViewport;
 /*----------------------------------------------------------------------------
 --  Declarations
 ----------------------------------------------------------------------------*/
+/// Instruction sets for the fog of war kernels. All of them give the same results.
+enum class FogSimdTypes { cScalar, cSSE2, cAVX2 };
+
+FogSimdTypes GetFogSimdType();
+bool SetFogSimdType(const FogSimdTypes type);
+
+void FogUpscalePatterns(const uint8_t *visRow, const uint8_t *nextVisRow, const uint16_t count,
+                        uint8_t *patternsVisible, uint8_t *patternsExplored);
+
+void FogUpscaleBilinear(const uint8_t *const src, const SDL_Rect &srcRect, const int16_t srcWidth,
+                        SDL_Surface *const trgSurface, const SDL_Rect &trgRect, const uint32_t fogColor);
+
 class CEasedTexture
 {
 public:
@@ -51,6 +63,8 @@ class CEasedTexture
 
     void SetNumOfSteps(const uint8_t num);
     void PushNext(const bool forcedShowNext = false);
+    void PushNext(const SDL_Rect &changedRect, const bool forcedShowNext = false);
+    void SyncNext();
     void DrawRegion(uint8_t *target, const uint16_t trgWidth, const uint16_t x0, const uint16_t y0, const SDL_Rect &srcRect);
     uint8_t GetPixel(const uint16_t x, const uint16_t y);
 
@@ -63,7 +77,7 @@ class CEasedTexture
     uint16_t GetHeight() const { return Height; }
 
 private:
-    void CalcDeltas();
+    void CalcDeltas(const SDL_Rect &rect);
     void SwapFrames() { const uint8_t swap = Prev; Prev = Curr; Curr = Next; Next = swap; }
 
 private:
@@ -79,6 +93,9 @@ class CEasedTexture
     uint8_t              Next  {2};
 
     std::vector<int16_t> Deltas;
+
+    SDL_Rect LastChanged {0, 0, 0, 0}; /// Area where the current frame differs from the previous one
+    SDL_Rect NextStale   {0, 0, 0, 0}; /// Area where the next frame still differs from the current one
 };
 
 /// Class for box blur algorithm. Used to blur 4x4 upscaled FOW texture.
@@ -90,8 +107,15 @@ class CBlurrer
 
     void Clean();
     void Blur(uint8_t *const texture);
+    void Blur(uint8_t *const texture, const uint16_t width, const uint16_t height);
+
+    uint16_t GetMargin() const;
 private:
-    void ProceedIteration(uint8_t *source, uint8_t *target, const uint8_t radius);
+    void ProceedIteration(uint8_t *source, uint8_t *target, const uint16_t width, const uint16_t height,
+                          const uint8_t radius);
+    void BlurRow(const uint8_t *source, uint8_t *target, const uint16_t width, const uint8_t radius) const;
+    void BlurColumns(const uint8_t *source, uint8_t *target, const uint16_t width, const uint16_t height,
+                     const uint16_t from, const uint16_t to, const uint8_t radius) const;
 
 private:
     float   Radius          {2}; /// From 1 to 3 is optimal. With 3 result is very smooth,
@@ -37,7 +37,9 @@ class CFile;
 
 extern void LoadGame(const fs::path &filename); /// Load saved game
 extern int SaveGame(const std::string &filename); /// Save game
+extern int SaveGameInBackground(const std::string &filename); /// Save game, writing the file from another thread
 extern void DeleteSaveGame(const std::string &filename); /// Delete save game
+extern bool StartHeadlessGame(const std::string &filename, unsigned long cycles); /// Play a map, save game or replay without display
 extern bool SaveGameLoading;                 /// Save game is in progress of loading
 
 extern void InitModules();              /// Initialize all modules
@@ -0,0 +1,104 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name influence_map.h - The presence and threat of the players on the map. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+#ifndef __INFLUENCE_MAP_H__
+#define __INFLUENCE_MAP_H__
+
+//@{
+
+#include "settings.h"
+#include "vec2i.h"
+
+#include <array>
+#include <vector>
+
+class CUnit;
+
+/**
+**  Number of units of each player on squares of CellSize x CellSize tiles.
+**
+**  The units which can target something are also counted apart, as the
+**  threat of the player. Whether a unit is a threat is decided when it is
+**  inserted, and kept until it is removed, even if its type changes.
+**  Each unit counts in every cell it covers.
+**
+**  It is kept by CMap::Insert, CMap::Remove and CMap::ChangeOwner, so it
+**  follows the units which move, die or change side. The AI asks it whether
+**  enemies may be around before searching them unit by unit: no units in the
+**  cells of an area means no units in the area.
+*/
+class CInfluenceMap
+{
+public:
+	static constexpr int CellShift = 2;
+	static constexpr int CellSize = 1 << CellShift; /// Side of a cell in tiles
+
+	bool IsInitialized() const { return !Players.empty(); }
+	/// Allocate the cells for a map
+	void Init(int mapWidth, int mapHeight);
+	/// Remove all the units
+	void Clean();
+
+	/// Count a unit placed on the map
+	void Insert(CUnit &unit);
+	/// Uncount a unit placed on the map (before it moves)
+	void Remove(const CUnit &unit);
+	/// Move the count of a unit placed on the map to its new owner
+	void ChangeOwner(const CUnit &unit, int oldPlayer);
+
+	/// Mask of the players with units on the map
+	unsigned int PlayersOnMap() const { return OnMap; }
+	/// Mask of the players with units on the cells covering the area
+	unsigned int PlayersIn(const Vec2i &ltPos, const Vec2i &rbPos) const { return MaskIn(Players, ltPos, rbPos); }
+	/// Mask of the players with units which can target something on the cells covering the area
+	unsigned int ThreatsIn(const Vec2i &ltPos, const Vec2i &rbPos) const { return MaskIn(Threats, ltPos, rbPos); }
+
+private:
+	/// Counts of one cell
+	struct Cell {
+		std::array<uint16_t, PlayerMax> Units{};
+		std::array<uint16_t, PlayerMax> Threats{};
+	};
+
+	void Update(const CUnit &unit, int player, int delta, bool threat);
+	unsigned int MaskIn(const std::vector<uint16_t> &masks, const Vec2i &ltPos, const Vec2i &rbPos) const;
+
+private:
+	int Width = 0;                    /// Width of the map in cells
+	int Height = 0;                   /// Height of the map in cells
+	std::vector<Cell> Cells;
+	std::vector<uint16_t> Players;    /// Mask of the players with units, for each cell
+	std::vector<uint16_t> Threats;    /// Mask of the players with threatening units, for each cell
+	std::array<int, PlayerMax> Totals{}; /// Units of each player on the map
+	unsigned int OnMap = 0;           /// Mask of the players with units on the map
+};
+
+//@}
+
+#endif // !__INFLUENCE_MAP_H__
@@ -41,6 +41,7 @@
 
 #include <SDL.h>
 #include <memory>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -125,6 +126,8 @@ class CFile
 	static SDL_RWops *to_SDL_RWops(std::unique_ptr<CFile> file);
 
 	void write(std::string_view);
+	/// Take the data written into a file opened with CL_WRITE_MEMORY
+	std::string takeData();
 
 	template <typename... Ts>
 	void printf(const char* format, Ts... args)
@@ -140,6 +143,7 @@ class CFile
 #define CL_OPEN_WRITE 0x2
 #define CL_WRITE_GZ 0x4
 #define CL_WRITE_BZ2 0x8
+#define CL_WRITE_MEMORY 0x10 /// Write into a buffer of the CFile instead of a file
 
 /*----------------------------------------------------------------------------
 --  Functions
@@ -50,7 +50,33 @@
 **  CMap::Fields
 **
 **    An array CMap::Info::Width * CMap::Info::Height of all fields
-**    belonging to this map.
+**    belonging to this map. It only holds what the pathfinder and the
+**    unit placement read: the flags, the move cost and the tiles.
+**
+**  CMap::FieldsPlayerInfo
+**
+**    What the players know of each field (fog of war, radar), in the
+**    order of CMap::Fields. Reached with CMapField::playerInfo().
+**
+**  CMap::FieldsUnitCache
+**
+**    The units on each field, in the order of CMap::Fields. Reached with
+**    CMapField::UnitCache().
+**
+**  CMap::UnitGrid
+**
+**    The units on the map, by squares of tiles and by owner, for the
+**    proximity queries. See ::CUnitGrid.
+**
+**  CMap::Influence
+**
+**    The players with units around each square of tiles, for the AI.
+**    See ::CInfluenceMap.
+**
+**  CMap::ForestRegrowth
+**
+**    The indexes of the fields whose wood was removed, which may grow
+**    again. CMap::RegenerateForest only visits them, in index order.
 **
 **  CMap::NoFogOfWar
 **
@@ -82,6 +108,7 @@
 --  Includes
 ----------------------------------------------------------------------------*/
 
+#include <set>
 #include <string>
 
 #ifndef __MAP_TILE_H__
@@ -90,7 +117,9 @@
 
 #include "color.h"
 #include "filesystem.h"
+#include "influence_map.h"
 #include "settings.h"
+#include "unit_grid.h"
 #include "vec2i.h"
 
 /*----------------------------------------------------------------------------
@@ -176,6 +205,8 @@ class CMap
 
 	/// Allocate and initialise map table.
 	void Create();
+	/// Free the map table.
+	void ClearFields();
 	/// Build tables for map
 	void Init();
 	/// Clean the map
@@ -195,6 +226,10 @@ class CMap
 
 	/// Regenerate the forest.
 	void RegenerateForest();
+	/// Regenerate the forest on one field.
+	void RegenerateForestTile(const Vec2i &pos);
+	/// Find the fields whose wood was removed on the whole map.
+	void InitForestRegrowth();
 	/// Set map reveal mode: hidden/known/fully explored.
 	void Reveal(MapRevealModes mode = MapRevealModes::cKnown);
 	/// Save the map.
@@ -225,6 +260,9 @@ class CMap
 	/// Remove unit from cache
 	void Remove(CUnit &unit);
 
+	/// Move unit in cache to its new owner
+	void ChangeOwner(CUnit &unit, int oldPlayer);
+
 	void Clamp(Vec2i &pos) const;
 
 	//Warning: we expect typical usage as xmin = x - range
@@ -248,11 +286,13 @@ class CMap
 	/// Correct the seen wood field, depending on the surrounding
 	void FixTile(tile_flags type, int seen, const Vec2i &pos);
 
-	/// Regenerate the forest.
-	void RegenerateForestTile(const Vec2i &pos);
-
 public:
 	std::vector<CMapField> Fields; /// fields on map
+	std::vector<CMapFieldPlayerInfo> FieldsPlayerInfo; /// what the players know of each field
+	std::vector<std::vector<CUnit *>> FieldsUnitCache; /// units on each field
+	CUnitGrid UnitGrid;            /// units on map, by area and owner
+	CInfluenceMap Influence;       /// presence and threat of the players on map
+	std::set<unsigned int> ForestRegrowth; /// fields whose wood was removed, which may grow again
 	bool NoFogOfWar = false;     /// fog of war disabled
 
 	CTileset Tileset; /// tileset data
@@ -269,6 +309,7 @@ class CMap
 ----------------------------------------------------------------------------*/
 
 extern CMap Map;  /// The current map
+
 extern char CurrentMapPath[1024]; /// Path to the current map
 
 /// Forest regeneration
@@ -283,6 +324,14 @@ extern bool ReplayRevealMap;
 /*----------------------------------------------------------------------------
 --  Functions
 ----------------------------------------------------------------------------*/
+
+// The fields of the map are the only CMapField, their other parts are in the
+// arrays of the map at the same index.
+inline CMapFieldPlayerInfo &CMapField::playerInfo() { return Map.FieldsPlayerInfo[this - Map.Fields.data()]; }
+inline const CMapFieldPlayerInfo &CMapField::playerInfo() const { return Map.FieldsPlayerInfo[this - Map.Fields.data()]; }
+inline std::vector<CUnit *> &CMapField::UnitCache() { return Map.FieldsUnitCache[this - Map.Fields.data()]; }
+inline const std::vector<CUnit *> &CMapField::UnitCache() const { return Map.FieldsUnitCache[this - Map.Fields.data()]; }
+
 //
 // in map_fog.c
 //
@@ -304,6 +353,9 @@ extern MapMarkerFunc MapUnmarkTileDetectCloak;
 /// Mark sight changes
 extern void MapSight(const CPlayer &player, const CUnit &unit, const Vec2i &pos, int w,
 					 int h, int range, MapMarkerFunc *marker);
+/// Mark sight changes of a step to a neighbour tile
+extern void MapSightStep(const CPlayer &player, const CUnit &unit, const Vec2i &oldPos, const Vec2i &pos,
+						 int w, int h, int range, MapMarkerFunc *unmarker, MapMarkerFunc *marker);
 /// Update fog of war
 extern void UpdateFogOfWarChange();
 
@@ -379,6 +431,8 @@ extern void PreprocessMap();
 void MapMarkUnitSight(CUnit &unit);
 /// Unmark on vision table the Sight of the unit.
 void MapUnmarkUnitSight(CUnit &unit);
+/// Move on vision table the Sight of the unit which stepped to a neighbour tile.
+void MapStepUnitSight(CUnit &unit, const Vec2i &oldPos);
 ///Mark/Unmark on vision table the Sight for the units around the tilePos
 void MapRefreshUnitsSight(const Vec2i &tilePos, const bool resetSight = false);
 ///Mark/Unmark on vision table the Sight for all units on the map
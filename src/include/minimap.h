@@ -35,9 +35,13 @@
 #include "color.h"
 #include "vec2i.h"
 
-class CViewport;
+#include <SDL.h>
+#include <tuple>
+#include <vector>
 
-struct SDL_Surface;
+class CPlayer;
+class CUnit;
+class CViewport;
 
 /*----------------------------------------------------------------------------
 --  Declarations
@@ -54,6 +58,13 @@ class CMinimap
 	template <const int BPP>
 	void UpdateSeen(void *const pixels, const int pitch);
 
+	SDL_Rect TilesToMinimapRect(const SDL_Rect &tiles) const;
+	SDL_Rect UnitArea(const CUnit &unit) const;
+	void AddDirtyArea(const SDL_Rect &area);
+	void AddDirtyUnits(const SDL_Rect &tiles);
+	void UpdateFog(const SDL_Rect &tiles);
+	void Compose(const SDL_Rect &area, int red_phase);
+
 public:
 	CMinimap() = default;
 
@@ -61,6 +72,9 @@ class CMinimap
 
 	void UpdateXY(const Vec2i &pos);
 	void UpdateSeenXY(const Vec2i &) {}
+	void UpdateUnit(const CUnit &unit);
+	void UpdateUnitsXY(const Vec2i &pos);
+	void Invalidate() { DirtyAll = true; }
 	void Update();
 	void Create();
 	void Destroy();
@@ -91,6 +105,17 @@ class CMinimap
 	int MinimapScaleX = 0;                  /// Minimap scale to fit into window
 	int MinimapScaleY = 0;                  /// Minimap scale to fit into window
 
+	// The minimap is composed of the terrain, the fog and the units layers.
+	// Only the blocks of pixels where a layer has changed are composed again.
+	std::vector<uint8_t> DirtyBlocks;       /// Blocks of pixels to compose again
+	int DirtyBlocksWidth = 0;               /// Number of blocks in a row
+	int NumDirtyBlocks = 0;                 /// Number of blocks to compose again
+	bool DirtyAll = true;                   /// The whole minimap has to be composed again
+	std::vector<const CUnit *> Highlighted; /// Units drawn in red or white at the last update
+	/// Settings of the last composition: terrain, transparency, revealed replay,
+	/// revealed map, selected units, player and fog color
+	std::tuple<bool, bool, bool, bool, bool, const CPlayer *, uint32_t> ComposedWith;
+
 private:
 	struct MinimapSettings
 	{
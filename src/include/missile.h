@@ -421,6 +421,10 @@ class Missile
 public:
 	virtual ~Missile() = default;
 
+	// Missiles are allocated from a pool, see MissileBlocks
+	static void *operator new(size_t size);
+	static void operator delete(void *ptr, size_t size);
+
 	static std::unique_ptr<Missile>
 	Init(const MissileType &mtype, const PixelPos &startPos, const PixelPos &destPos);
 
@@ -608,10 +612,13 @@ extern int CalculateDamage(const CUnit &attacker, const CUnit &goal, const INumb
 /// fire a missile
 extern void FireMissile(CUnit &unit, CUnit *goal, const Vec2i &goalPos);
 
-extern std::vector<Missile *> FindAndSortMissiles(const CViewport &);
+/// Collect the missiles visible in a viewport, sorted by draw level
+extern void FindAndSortMissiles(const CViewport &, std::vector<Missile *> &);
 
 /// handle all missiles
 extern void MissileActions();
+/// number of missiles on the map
+extern size_t MissilesCount();
 /// distance from view point to missile
 extern int ViewPointDistanceToMissile(const Missile &missile);
 
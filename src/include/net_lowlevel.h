@@ -132,6 +132,8 @@ extern int NetRecvUDP(Socket sockfd, void *buf, int len, unsigned long *hostFrom
 extern Socket NetOpenTCP(const char *addr, int port);
 /// Close a TCP socket port.
 extern void NetCloseTCP(Socket sockfd);
+/// Shut down both directions of a TCP connection.
+extern int NetShutdownTCP(Socket sockfd);
 /// Open a TCP connection.
 extern int NetConnectTCP(Socket sockfd, unsigned long addr, int port);
 /// Send through a TCP socket
@@ -146,6 +148,8 @@ extern Socket NetAcceptTCP(Socket sockfd, unsigned long *clientHost, int *client
 
 /// Set socket to non-blocking
 extern int NetSetNonBlocking(Socket sockfd);
+/// Send the data of a TCP socket without delay
+extern int NetSetNoDelay(Socket sockfd);
 /// Wait for socket ready.
 extern int NetSocketReady(Socket sockfd, int timeout);
 
@@ -107,10 +107,12 @@ class CTCPSocket
 	~CTCPSocket();
 	bool Open(const CHost &host);
 	void Close();
+	void Shutdown();
 	bool Connect(const CHost &host);
 	int Send(const void *buf, unsigned int len);
 	int Recv(void *buf, int len);
 	void SetNonBlocking();
+	void SetNoDelay();
 	//
 	int HasDataToRead(int timeout);
 	bool IsValid() const;
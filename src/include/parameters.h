@@ -59,6 +59,7 @@ class Parameters
 	std::string luaScriptArguments;
 	std::string LocalPlayerName;        /// Name of local player
 	bool benchmark = false;             /// If true, run as fast as possible and report fps at the end of a game
+	unsigned long headlessCycles = 0;   /// If not 0, run this number of game cycles without display, sound nor input
 private:
 	fs::path userDirectory;          /// Directory containing user settings and data
 public:
@@ -33,6 +33,7 @@
 //@{
 
 void DrawLastAStar(const class CViewport &vp);
+void DrawRegions(const class CViewport &vp);
 #if defined(DEBUG_ASTAR)
 #define AstarDebugPrint(format, ...) DebugPrint(format, ##__VA_ARGS__)
 #else
@@ -43,9 +44,11 @@ void DrawLastAStar(const class CViewport &vp);
 --  Declarations
 ----------------------------------------------------------------------------*/
 
-#include <queue>
+#include <cstdint>
+#include <memory>
 #include <sys/types.h>
 #include <utility>
+#include <vector>
 #include "vec2i.h"
 
 class CUnit;
@@ -116,6 +119,9 @@ class PathFinderOutput
 	uint16_t Cycles;               /// how much Cycles we move.
 	unsigned Fast:4; /// Flag fast move (one step). Fits at most MAX_FAST
 	unsigned OverflowLength:4;      /// overflow length not stored in Path (may be more). Fits at most MAX_OVERFLOW
+	unsigned Queued:1;              /// waiting for PathfinderSolveBatch
+	unsigned Ready:1;               /// new path found by PathfinderSolveBatch, not used yet
+	unsigned ReadyReached:1;        /// the new path is: goal already reached
 	uint8_t Length;                /// stored path length
 	char Path[MAX_PATH_LENGTH];     /// directions of stored path
 };
@@ -139,11 +145,27 @@ enum class VisitResult {
 	Cancel
 };
 
+/**
+**  Breadth first flood fill of the map, from some start positions.
+**
+**  The marks and the frontier live in a storage taken from a pool of the
+**  thread at construction and given back at destruction, so a traversal
+**  per call costs no allocation once the pool holds enough storages for
+**  the map. The marks are stamped with the generation of Init: Init only
+**  starts a new generation, and the marks of the older ones read as not
+**  visited. Each tile enters the frontier at most once per generation, so
+**  the frontier is an array of the size of the map, read from m_head.
+*/
 class TerrainTraversal
 {
 public:
 	using dataType = short int;
 public:
+	TerrainTraversal();
+	~TerrainTraversal();
+	TerrainTraversal(const TerrainTraversal &) = delete;
+	TerrainTraversal &operator=(const TerrainTraversal &) = delete;
+
 	void SetSize(unsigned int width, unsigned int height);
 	void Init();
 
@@ -154,34 +176,62 @@ class TerrainTraversal
 	template <typename T>
 	bool Run(T &context);
 
-	bool IsVisited(const Vec2i &pos) const;
-	bool IsReached(const Vec2i &pos) const;
-	bool IsInvalid(const Vec2i &pos) const;
+	bool IsVisited(const Vec2i &pos) const { return Get(pos) != 0; }
+	bool IsReached(const Vec2i &pos) const { return Get(pos) != 0 && Get(pos) != -1; }
+	bool IsInvalid(const Vec2i &pos) const { return Get(pos) != -1; }
 
 	// Accept pos to be at one inside the real map
-	dataType Get(const Vec2i &pos) const;
+	dataType Get(const Vec2i &pos) const
+	{
+		const Mark &mark = m_marks[Index(pos)];
+		return mark.generation >= m_generation ? mark.value : 0;
+	}
+
+	/// Number of storages kept in the pool of the calling thread
+	static size_t PoolSize();
 
 private:
-	void Set(const Vec2i &pos, dataType value);
+	void Set(const Vec2i &pos, dataType value) { m_marks[Index(pos)] = {m_generation, value}; }
+	unsigned int Index(const Vec2i &pos) const { return m_extented_width + 1 + pos.y * m_extented_width + pos.x; }
 
 	struct PosNode {
-		PosNode(const Vec2i &pos, const Vec2i &from) : pos(pos), from(from) {}
 		Vec2i pos;
 		Vec2i from;
 	};
 
+public:
+	/// Value of a tile, valid when its generation is the current one
+	struct Mark {
+		uint16_t generation;
+		dataType value;
+	};
+	/// Generation of the border, always current
+	static constexpr uint16_t BorderGeneration = 0xFFFF;
+
+	/// Marks and frontier of a traversal, reused from one to the next
+	struct Storage {
+		std::vector<Mark> marks;
+		std::vector<PosNode> frontier;
+		uint16_t generation = 0;
+		unsigned int extented_width = 0;
+		unsigned int height = 0;
+	};
+
 private:
-	std::vector<dataType> m_values;
-	std::queue<PosNode> m_queue;
+	std::unique_ptr<Storage> m_storage;
+	Mark *m_marks = nullptr;
+	PosNode *m_frontier = nullptr;
+	unsigned int m_head = 0;
+	unsigned int m_tail = 0;
+	uint16_t m_generation = 0;
 	unsigned int m_extented_width = 0;
-	unsigned int m_height = 0;
 };
 
 template <typename T>
 bool TerrainTraversal::Run(T &context)
 {
-	for (; m_queue.empty() == false; m_queue.pop()) {
-		const PosNode &posNode = m_queue.front();
+	for (; m_head != m_tail; ++m_head) {
+		const PosNode &posNode = m_frontier[m_head];
 
 		switch (context.Visit(*this, posNode.pos, posNode.from)) {
 			case VisitResult::Finished: return true;
@@ -194,7 +244,6 @@ bool TerrainTraversal::Run(T &context)
 	return false;
 }
 
-
 /*----------------------------------------------------------------------------
 --  Variables
 ----------------------------------------------------------------------------*/
@@ -209,6 +258,32 @@ extern bool AStarKnowUnseenTerrain;
 extern int AStarUnknownTerrainCost;
 /// Maximum number of iterations of A* before giving up.
 extern int AStarMaxSearchIterations;
+/// Whether long paths are first planned on the hierarchical (cluster) graph
+extern bool AStarHierarchical;
+/// Size in tiles of the clusters of the hierarchical graph
+extern int AStarHierarchicalClusterSize;
+/// Number of abstract nodes expanded by the last hierarchical search
+extern unsigned int HPAStarAbstractNodes;
+/// Number of a* nodes expanded to refine the last hierarchical search
+extern unsigned int HPAStarRefinedNodes;
+/// Whether units going to the same goal share a flow field
+extern bool AStarPathCache;
+/// Maximum number of goals kept in the flow field cache
+extern int AStarPathCacheSize;
+/// Flow field cache statistics
+extern unsigned int PathCacheHits;
+extern unsigned int PathCacheMisses;
+extern unsigned int PathCacheEvictions;
+/// Flow fields are only used before this GameCycle, UINT_MAX for the whole game
+extern unsigned int PathCacheEndCycle;
+/// Whether searches between disconnected regions of the map are skipped
+extern bool AStarRegions;
+/// Number of searches skipped because of the regions
+extern unsigned int RegionRejectedSearches;
+/// Whether the paths are found once per cycle for all the units which need one
+extern bool PathfinderBatch;
+/// Whether the batched paths are found by several threads
+extern bool PathfinderBatchParallel;
 
 //
 //  Convert heading into direction.
@@ -236,6 +311,13 @@ extern int CalcPathLengthToUnit(const CUnit &src, const CUnit &dst,
 /// Can the unit 'src' reach the place x,y
 extern int PlaceReachable(const CUnit &src, const Vec2i &pos, int w, int h,
 						  int minrange, int maxrange, bool from_outside_container);
+/// Passability of the map area changed (terrain, wall or building)
+extern void PathfinderTerrainChanged(const Vec2i &pos, int w = 1, int h = 1);
+/// Find the paths requested during this cycle
+extern void PathfinderSolveBatch();
+/// Whether the unit may walk from the start area to the goal area
+extern bool RegionsMayConnect(const CUnit &unit, const Vec2i &startPos, const Vec2i &startSize,
+							  const Vec2i &goalPos, const Vec2i &goalSize);
 
 //
 // in astar.cpp
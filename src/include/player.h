@@ -189,6 +189,8 @@ class CPlayer
 	**  Check if the player index is an enemy
 	*/
 	bool IsEnemy(const int index) const { return (Index != index && (Enemy & (1 << index)) != 0); }
+	/// Bit field of the players this player is enemy of
+	unsigned int GetEnemyMask() const { return Enemy & ~(1u << Index); }
 
 	/**
 	**  Check if the player index is an enemy
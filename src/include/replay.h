@@ -35,6 +35,9 @@
 --  Includes
 ----------------------------------------------------------------------------*/
 
+#include "filesystem.h"
+
+#include <optional>
 #include <string>
 
 /*----------------------------------------------------------------------------
@@ -52,6 +55,13 @@ class CUnit;
 
 enum class EFlushMode;
 
+/// Result of the comparisons of the game state with the one logged in a replay
+struct ReplaySyncCheck
+{
+	unsigned long CheckedSteps = 0;           /// Number of logged commands with sync info
+	std::optional<unsigned long> DesyncCycle; /// First cycle where the game got out of sync
+};
+
 /*----------------------------------------------------------------------------
 --  Variables
 ----------------------------------------------------------------------------*/
@@ -80,6 +90,12 @@ extern void MultiPlayerReplayEachCycle();
 extern void EndReplayLog();
 /// Clean replay
 extern void CleanReplayLog();
+/// Load a log file to replay a game
+extern void LoadReplay(const fs::path &name);
+/// Check if all the commands of the replayed game were played
+extern bool IsReplayOver();
+/// Get the result of the sync checks of the replayed game
+extern const ReplaySyncCheck &GetReplaySyncCheck();
 /// Save the replay list to file
 extern void SaveReplayList(CFile &file);
 /// Register ccl functions related to network
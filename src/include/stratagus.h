@@ -38,6 +38,7 @@
 #else
 #define omp_get_thread_num() 0
 #define omp_get_num_threads() 1
+#define omp_get_max_threads() 1
 #endif
 
 //@{
@@ -205,6 +206,7 @@ extern void Exit(int err);                  /// Exit
 
 extern void UpdateDisplay();            /// Game display update
 extern void GameMainLoop();             /// Game main loop
+extern bool HeadlessGameLoop(unsigned long cycles); /// Game logic loop without display, sound nor input
 extern int stratagusMain(int argc, char **argv); /// main entry
 
 //@}
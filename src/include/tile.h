@@ -119,7 +119,7 @@
 **    walls, contains the remaining hit points of the wall and
 **    for forest, contains the frames until they grow.
 **
-**  CMapField::UnitCache
+**  CMapField::UnitCache()
 **
 **    Contains a vector of all units currently on this field.
 **    Note: currently units are only inserted at the insert point.
@@ -250,11 +250,15 @@ class CMapField
 public:
 	tile_flags Flags = 0;        /// field flags
 
+	/// Stuff related to player, kept apart in CMap::FieldsPlayerInfo
+	CMapFieldPlayerInfo &playerInfo();
+	const CMapFieldPlayerInfo &playerInfo() const;
+	/// Units on the map field, kept apart in CMap::FieldsUnitCache
+	std::vector<CUnit *> &UnitCache();
+	const std::vector<CUnit *> &UnitCache() const;
+
 public:
 	unsigned int Value = 0;         /// HP for walls/Wood Regeneration, value of stored resource for forest or harvestable terrain
-	std::vector<CUnit *> UnitCache; /// A unit on the map field.
-
-	CMapFieldPlayerInfo playerInfo; /// stuff related to player
 
 private:
 	tile_index tilesetTile = 0;	/// tileset tile number
@@ -373,6 +373,7 @@ class CUnit
 	unsigned Active : 1;         /// Unit is active for AI
 	unsigned Boarded : 1;        /// Unit is on board a transporter.
 	unsigned CacheLock : 1;      /// Unit is on lock by unitcache operations.
+	unsigned InfluenceThreat : 1; /// Unit is counted as a threat by Map.Influence.
 
 	unsigned Waiting : 1;        /// Unit is waiting and playing its still animation
 	unsigned MineLow : 1;        /// This mine got a notification about its resources being low
@@ -680,9 +681,6 @@ extern void CleanDecorations();
 
 /// Draw unit's shadow
 extern void DrawShadow(const CUnitType &type, int frame, const PixelPos &screenPos, char zDisplacement = 0);
-/// Collect all units visible on map in viewport
-extern std::vector<CUnit *> FindAndSortUnits(const CViewport &);
-
 /// Show a unit's orders.
 extern void ShowOrder(const CUnit &unit);
 
@@ -237,60 +237,67 @@ std::vector<CUnit *> Select(const Vec2i &ltPos, const Vec2i &rbPos);
 std::vector<CUnit *> SelectFixed(const Vec2i &ltPos, const Vec2i &rbPos);
 std::vector<CUnit *> SelectAroundUnit(const CUnit &unit, int range);
 
+/**
+**  Select the units of the players of playerMask on the area.
+**
+**  The units are returned in the order of a scan of the UnitCache of each
+**  tile of the area, row by row: the game logic depends on it to choose
+**  between equivalent units, so it must not change.
+*/
 template <int selectMax = 0, typename Pred>
-std::vector<CUnit *> SelectFixed(const Vec2i &ltPos, const Vec2i &rbPos, Pred pred)
+std::vector<CUnit *> SelectFixed(const Vec2i &ltPos, const Vec2i &rbPos, Pred pred,
+                                 unsigned int playerMask = CUnitGrid::AllPlayers)
 {
 	Assert(Map.Info.IsPointOnMap(ltPos));
 	Assert(Map.Info.IsPointOnMap(rbPos));
 
-	std::vector<CUnit *> units;
-	units.reserve(selectMax << 1);
-	int max = selectMax ? selectMax : INT_MAX;
+	// Order of the first tile of the unit in the area, then of the unit in the UnitCache of that tile
+	std::vector<std::pair<uint64_t, CUnit *>> found;
+	Map.UnitGrid.ForEach(ltPos, rbPos, playerMask, [&](const CUnitGrid::Entry &entry) {
+		if (pred(entry.Unit)) {
+			const Vec2i first(std::max(entry.Pos.x, ltPos.x), std::max(entry.Pos.y, ltPos.y));
+			const auto &cache = Map.Field(first)->UnitCache();
+			const uint64_t cacheIndex = ranges::find(cache, entry.Unit) - cache.begin();
 
-	for (Vec2i posIt = ltPos; posIt.y != rbPos.y + 1; ++posIt.y) {
-		for (posIt.x = ltPos.x; posIt.x != rbPos.x + 1; ++posIt.x) {
-			const CMapField &mf = *Map.Field(posIt);
-
-			for (CUnit *unit : mf.UnitCache) {
-				if ((selectMax == 1 || unit->CacheLock == 0) && pred(unit)) {
-					if constexpr (selectMax == 1) {
-						return {unit};
-					} else {
-						unit->CacheLock = 1;
-						units.push_back(unit);
-						if (--max == 0) {
-							break;
-						}
-					}
-				}
-			}
+			found.emplace_back(uint64_t(Map.getIndex(first)) << 32 | cacheIndex, entry.Unit);
 		}
+	});
+
+	const size_t max = selectMax ? std::min<size_t>(selectMax, found.size()) : found.size();
+	if (max < found.size()) {
+		std::partial_sort(found.begin(), found.begin() + max, found.end());
+	} else {
+		std::sort(found.begin(), found.end());
 	}
-	for (auto* unit : units) {
-		unit->CacheLock = 0;
+	std::vector<CUnit *> units(max);
+	for (size_t i = 0; i != max; ++i) {
+		units[i] = found[i].second;
 	}
 	return units;
 }
 
 template <int selectMax = 0, typename Pred>
-std::vector<CUnit *> Select(const Vec2i &ltPos, const Vec2i &rbPos, Pred pred)
+std::vector<CUnit *> Select(const Vec2i &ltPos, const Vec2i &rbPos, Pred pred,
+                            unsigned int playerMask = CUnitGrid::AllPlayers)
 {
 	Vec2i minPos = ltPos;
 	Vec2i maxPos = rbPos;
 
 	Map.FixSelectionArea(minPos, maxPos);
-	return SelectFixed<selectMax>(minPos, maxPos, pred);
+	return SelectFixed<selectMax>(minPos, maxPos, pred, playerMask);
 }
 
 template <int selectMax = 0, typename Pred>
-std::vector<CUnit *> SelectAroundUnit(const CUnit &unit, int range, Pred pred)
+std::vector<CUnit *> SelectAroundUnit(const CUnit &unit, int range, Pred pred,
+                                      unsigned int playerMask = CUnitGrid::AllPlayers)
 {
 	const Vec2i offset(range, range);
 	const Vec2i typeSize(unit.Type->TileWidth - 1, unit.Type->TileHeight - 1);
 
 	return Select<selectMax>(unit.tilePos - offset,
 	                         unit.tilePos + typeSize + offset,
-	                         MakeAndPredicate(IsNotTheSameUnitAs(unit), pred));
+	                         MakeAndPredicate(IsNotTheSameUnitAs(unit), pred),
+	                         playerMask);
 }
 
 template <typename Pred>
@@ -302,7 +309,7 @@ CUnit *FindUnit_IfFixed(const Vec2i &ltPos, const Vec2i &rbPos, Pred pred)
 	for (Vec2i posIt = ltPos; posIt.y != rbPos.y + 1; ++posIt.y) {
 		for (posIt.x = ltPos.x; posIt.x != rbPos.x + 1; ++posIt.x) {
 			const CMapField &mf = *Map.Field(posIt);
-			const auto &units = mf.UnitCache;
+			const auto &units = mf.UnitCache();
 
 			const auto it = ranges::find_if(units, pred);
 			if (it != units.end()) {
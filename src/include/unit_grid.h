@@ -0,0 +1,151 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name unit_grid.h - The coarse index of the units on the map. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+#ifndef __UNIT_GRID_H__
+#define __UNIT_GRID_H__
+
+//@{
+
+#include "settings.h"
+#include "vec2i.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+class CUnit;
+
+/**
+**  Units on the map, bucketed by squares of BucketSize x BucketSize tiles and
+**  by owner.
+**
+**  Each unit is stored once, in the bucket of its top left tile, with the
+**  tiles it covers. So a query visits the buckets of its area (plus the ones
+**  of the biggest unit size on their top left) and only the units of the
+**  requested players, instead of the UnitCache of each tile of the area.
+**
+**  It is kept by CMap::Insert and CMap::Remove, so it holds the same units as
+**  the UnitCache of the map fields. The order of the units in a bucket is
+**  not meaningful.
+*/
+class CUnitGrid
+{
+public:
+	static constexpr int BucketShift = 3;
+	static constexpr int BucketSize = 1 << BucketShift; /// Side of a bucket in tiles
+
+	/// Player mask of all the players
+	static constexpr unsigned int AllPlayers = (1u << PlayerMax) - 1;
+
+	/// A unit with the tiles it covers
+	struct Entry {
+		CUnit *Unit;
+		Vec2i Pos;     /// Top left tile
+		Vec2i End;     /// Bottom right tile + 1
+	};
+
+	bool IsInitialized() const { return !Buckets.empty(); }
+	/// Allocate the buckets for a map
+	void Init(int mapWidth, int mapHeight);
+	/// Remove all the units
+	void Clean();
+
+	/// Insert a unit placed on the map
+	void Insert(CUnit &unit);
+	/// Remove a unit placed on the map (before it moves)
+	void Remove(CUnit &unit);
+	/// Move a unit placed on the map to the partition of its new owner
+	void ChangeOwner(CUnit &unit, int oldPlayer);
+
+	/**
+	**  Call func with the entry of each unit of the players of playerMask
+	**  which covers a tile of the area. Units are visited once, in no
+	**  particular order.
+	*/
+	template <typename Func>
+	void ForEach(const Vec2i &ltPos, const Vec2i &rbPos, unsigned int playerMask, Func func) const
+	{
+		AnyOf(ltPos, rbPos, playerMask, [&](const Entry &entry) {
+			func(entry);
+			return false;
+		});
+	}
+
+	/**
+	**  Like ForEach, but stop at the first entry for which pred returns true.
+	**
+	**  @return  true if pred returned true for an entry.
+	*/
+	template <typename Pred>
+	bool AnyOf(const Vec2i &ltPos, const Vec2i &rbPos, unsigned int playerMask, Pred pred) const
+	{
+		const int minX = std::max(0, ltPos.x - MaxUnitSize.x + 1) >> BucketShift;
+		const int minY = std::max(0, ltPos.y - MaxUnitSize.y + 1) >> BucketShift;
+		const int maxX = std::min(Width - 1, rbPos.x >> BucketShift);
+		const int maxY = std::min(Height - 1, rbPos.y >> BucketShift);
+
+		for (int y = minY; y <= maxY; ++y) {
+			for (int x = minX; x <= maxX; ++x) {
+				const Bucket &bucket = Buckets[y * Width + x];
+
+				for (unsigned int mask = bucket.Players & playerMask, player = 0; mask; mask >>= 1, ++player) {
+					if ((mask & 1) == 0) {
+						continue;
+					}
+					for (const Entry &entry : bucket.Units[player]) {
+						if (entry.Pos.x <= rbPos.x && entry.End.x > ltPos.x
+						    && entry.Pos.y <= rbPos.y && entry.End.y > ltPos.y && pred(entry)) {
+							return true;
+						}
+					}
+				}
+			}
+		}
+		return false;
+	}
+
+private:
+	struct Bucket {
+		unsigned int Players = 0; /// Mask of the players with units in the bucket
+		std::array<std::vector<Entry>, PlayerMax> Units;
+	};
+
+	Bucket &BucketOf(const Vec2i &pos) { return Buckets[(pos.y >> BucketShift) * Width + (pos.x >> BucketShift)]; }
+	void RemoveEntry(Bucket &bucket, int player, const CUnit &unit);
+
+private:
+	int Width = 0;                 /// Width of the map in buckets
+	int Height = 0;                /// Height of the map in buckets
+	std::vector<Bucket> Buckets;
+	Vec2i MaxUnitSize{1, 1};       /// Biggest unit size inserted so far
+};
+
+//@}
+
+#endif // !__UNIT_GRID_H__
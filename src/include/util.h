@@ -153,6 +153,8 @@ std::string to_utf8(std::uint32_t unicode);
 ----------------------------------------------------------------------------*/
 bool supportsSSE2();
 bool supportsAVX();
+bool supportsAVX2();
+bool supportsNEON();
 void *aligned_malloc(size_t alignment, size_t size);
 void aligned_free(void *block);
 
@@ -162,6 +164,12 @@ void aligned_free(void *block);
 
 fs::path GetExecutablePath();
 
+/*----------------------------------------------------------------------------
+--  Memory usage
+----------------------------------------------------------------------------*/
+
+/// Peak resident memory of the process, in KiB (0 if unknown)
+size_t GetPeakResidentMemory();
 
 /*----------------------------------------------------------------------------
 --  Ranges
@@ -31,6 +31,10 @@
 /// Stratagus version (1,2,3) -> 10203
 #define StratagusVersion (StratagusMajorVersion * 10000 + StratagusMinorVersion * 100 + StratagusPatchLevel)
 
+/// Version of the game simulation, raised when the same commands give another game.
+/// 2: A* breaks the ties between paths of equal cost in another order.
+#define StratagusSyncVersion 2
+
 /// Homepage
 #define HOMEPAGE "https://github.com/Wargus/stratagus"
 
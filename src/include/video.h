@@ -456,6 +456,18 @@ extern void SetClipping(int left, int top, int right, int bottom);
 /// Realize video memory.
 extern void RealizeVideoMemory();
 
+/// Uploads of the screen to the texture
+struct VideoUploadStats {
+	unsigned long Frames = 0;         /// Frames uploaded
+	unsigned long FullUploads = 0;    /// Frames which uploaded the whole screen
+	unsigned long long Bytes = 0;     /// Bytes uploaded
+};
+
+/// Uploads of the screen to the texture since the last reset
+extern VideoUploadStats GetVideoUploadStats();
+/// Reset the counts of the uploads of the screen
+extern void ResetVideoUploadStats();
+
 /// Save a screenshot to a PNG file
 extern void SaveScreenshotPNG(const char *name);
 
@@ -546,6 +558,19 @@ extern void RestoreColorCyclingSurface();
 
 /// Does ColorCycling..
 extern void ColorCycle();
+/// Number of color cycling steps applied to the palettes so far
+extern unsigned int GetColorCycleCount();
+
+/// Instruction sets of the 32bpp blending kernels
+enum class BlendSimdTypes { cScalar, cSSE2, cAVX2, cNEON };
+
+extern BlendSimdTypes GetBlendSimdType();
+extern bool SetBlendSimdType(const BlendSimdTypes type);
+
+/// Blend a row of 32bpp pixels into another one with their alpha
+extern void BlendRowAlpha_32bpp(const uint32_t *src, uint32_t *dst, size_t count);
+/// Blend a color into a row of 32bpp pixels with a constant alpha
+extern void BlendRowColor_32bpp(uint32_t color, unsigned char alpha, uint32_t *dst, size_t count);
 
 /// Blit a surface into another with alpha blending
 extern void BlitSurfaceAlphaBlending_32bpp(const SDL_Surface *srcSurface, const SDL_Rect *srcRect,
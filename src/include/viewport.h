@@ -33,8 +33,40 @@
 //@{
 #include "fow.h"
 #include "vec2i.h"
+
+#include <cstdint>
+#include <vector>
+
+class CGraphic;
 class CUnit;
 class CMapField;
+class CViewport;
+class Missile;
+
+/**
+**  Units to draw in a viewport, sorted by draw level, kept from one frame
+**  to the next.
+**
+**  Between two frames, few units enter or leave the viewport and few change
+**  their draw order. So the list of the previous frame, without the units
+**  which left, is nearly sorted and an insertion sort repairs it in about
+**  linear time. The ones which entered, which are all the units after a
+**  jump of the camera, are sorted apart and merged. The units are kept by
+**  slot, so a unit which died since the previous frame is never touched.
+*/
+class CUnitDrawList
+{
+public:
+	/// Update the list to the units visible in the viewport and return it
+	const std::vector<CUnit *> &Update(const CViewport &vp);
+
+private:
+	std::vector<CUnit *> Units;    /// Units in draw order
+	std::vector<int> Slots;        /// Slot of each unit of Units
+	std::vector<CUnit *> Visible;  /// Units visible in the current frame
+	std::vector<uint32_t> Stamps;  /// Last frame each slot was visible in
+	uint32_t Stamp = 0;            /// Current frame
+};
 
 /**
 **  A map viewport.
@@ -143,7 +175,13 @@ class CViewport
 	 * specialized variant of the method.
 	 */
 	template<bool graphicalTileIsLogicalTile>
-	void DrawMapBackgroundInViewport(const fieldHighlightChecker highlightChecker = nullptr) const;
+	void DrawMapBackgroundInViewport(const fieldHighlightChecker highlightChecker = nullptr);
+	/// Draw the map background through the background cache, false if it can't be allocated
+	bool DrawMapBackgroundFromCache(bool canShortcut);
+	/// Move the background cache to a new top left tile, keeping the tiles it still covers
+	void ScrollBackgroundCache(const Vec2i &origin);
+	/// Clean the background cache
+	void CleanBackground();
 	/// Draw the map fog of war
 	void DrawMapFogOfWar();
 	/// Adjust fog of war surface to viewport
@@ -165,6 +203,14 @@ class CViewport
 	CUnit *Unit = nullptr;        /// Bound to this unit
 private:
 	SDL_Surface *FogSurface { nullptr }; /// Texture for fog of war. Viewport sized.
+	SDL_Surface *BackgroundSurface = nullptr; /// Tiles drawn around the viewport, kept between frames
+	Vec2i BackgroundOrigin;              /// Map tile at the top left of BackgroundSurface
+	Vec2i BackgroundSize;                /// Size of BackgroundSurface in tiles
+	std::vector<int> BackgroundTiles;    /// Graphic tile drawn on each tile of BackgroundSurface
+	const CGraphic *BackgroundGraphic = nullptr; /// Tile graphic BackgroundSurface was drawn with
+	unsigned int BackgroundCycle = 0;    /// Color cycle BackgroundSurface was drawn with
+	CUnitDrawList DrawUnits;             /// Units to draw, in draw order
+	std::vector<Missile *> DrawMissiles; /// Missiles to draw, in draw order
 
 	static bool ShowGrid;
 	static bool ShowAStarPassability;
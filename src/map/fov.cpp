@@ -138,20 +138,119 @@ void CFieldOfView::Refresh(const CPlayer &player, const CUnit &unit, const Vec2i
 		return;
 	}
 	if (GameSettings.FoV == FieldOfViewTypes::cShadowCasting && !unit.Type->AirUnit) {
-
-		OpaqueFields = unit.Type->BoolFlag[ELEVATED_INDEX].value ? 0 : this->Settings.OpaqueFields;
-		if (GameSettings.Inside) {
-			OpaqueFields &= ~(MapFieldRocks); /// because of rocks-flag is used as an obstacle for ranged attackers
+		for (const unsigned int index : ShadowCastTiles(unit, pos, width, height, range)) {
+			marker(player, index);
 		}
-		PrepareShadowCaster(player, unit, pos, marker);
-		PrepareCache(pos, width, height, range);
-		ProceedShadowCasting(pos, width, height, range + 1);
-		ResetShadowCaster();
 	} else {
 		ProceedSimpleRadial(player, pos, width, height, range, marker);
 	}
 }
 
+/**
+**  Refresh the field of view of a unit which moved to a neighbour tile.
+**  Only the tiles it stops seeing are unmarked and the tiles it starts seeing
+**  are marked, the counters end as with a whole unmark followed by a whole mark.
+**
+**  @param player    player to mark the sight for
+**	@param unit      unit to mark the sight for
+**  @param oldPos    location before the step
+**  @param pos       location after the step
+**  @param width     width to mark, in square
+**  @param height    height to mark, in square
+**  @param range     Radius to mark.
+**  @param unmarker  Function to unmark sight
+**  @param marker    Function to mark sight
+*/
+void CFieldOfView::RefreshStep(const CPlayer &player, const CUnit &unit, const Vec2i &oldPos, const Vec2i &pos,
+							   const uint16_t width, const uint16_t height, const uint16_t range,
+							   MapMarkerFunc *unmarker, MapMarkerFunc *marker)
+{
+	if (unit.ReleaseCycle) return;
+	Assert(unit.Type != nullptr);
+	Assert(abs(pos.x - oldPos.x) <= 1 && abs(pos.y - oldPos.y) <= 1);
+	// Units under construction have no sight range.
+	if (!range) {
+		return;
+	}
+	if (GameSettings.FoV == FieldOfViewTypes::cShadowCasting && !unit.Type->AirUnit) {
+		StepTiles = ShadowCastTiles(unit, oldPos, width, height, range);
+		const std::vector<unsigned int> &tiles = ShadowCastTiles(unit, pos, width, height, range);
+
+		PrepareCache();
+		for (const unsigned int index : tiles) {
+			MarkedTilesCache[index] = 1;
+		}
+		for (const unsigned int index : StepTiles) {
+			if (MarkedTilesCache[index]) {
+				MarkedTilesCache[index] = 2;
+			} else {
+				unmarker(player, index);
+			}
+		}
+		for (const unsigned int index : tiles) {
+			if (MarkedTilesCache[index] == 1) {
+				marker(player, index);
+			}
+			MarkedTilesCache[index] = 0;
+		}
+	} else {
+		ProceedSimpleRadialStep(player, oldPos, pos, width, height, range, unmarker, marker);
+	}
+}
+
+/**
+**  Get the tiles seen by a unit, computed by shadow casting.
+**
+**  The result is kept for the unit until it asks for another position, range
+**  or opacity, or the opacity of fields changes. So a static unit whose sight
+**  is unmarked and marked again, or which also detects cloaked units, computes
+**  it once.
+**
+**  @param unit    unit to get the sight for
+**  @param pos     location of the unit
+**  @param width   width of the unit, in square
+**  @param height  height of the unit, in square
+**  @param range   sight range of the unit
+**
+**  @return        Indexes of the visible tiles, valid until the next call.
+*/
+const std::vector<unsigned int> &CFieldOfView::ShadowCastTiles(const CUnit &unit, const Vec2i &pos,
+																const uint16_t width, const uint16_t height,
+																const uint16_t range)
+{
+	tile_flags opaqueFields = unit.Type->BoolFlag[ELEVATED_INDEX].value ? 0 : this->Settings.OpaqueFields;
+	if (GameSettings.Inside) {
+		opaqueFields &= ~(MapFieldRocks); /// because of rocks-flag is used as an obstacle for ranged attackers
+	}
+
+	const int slot = UnitNumber(unit);
+	if (slot >= 0 && size_t(slot) >= CachedViews.size()) {
+		CachedViews.resize(slot + 1);
+	}
+	SCachedView &view = slot >= 0 ? CachedViews[slot] : UncachedView;
+	if (&view != &UncachedView && view.Pos == pos && view.Width == width && view.Height == height
+		&& view.Range == range && view.OpaqueFields == opaqueFields && view.Generation == TerrainGeneration) {
+		return view.Tiles;
+	}
+	view.Pos = pos;
+	view.Width = width;
+	view.Height = height;
+	view.Range = range;
+	view.OpaqueFields = opaqueFields;
+	view.Generation = TerrainGeneration;
+	view.Tiles.clear();
+
+	OpaqueFields = opaqueFields;
+	PrepareShadowCaster(pos, view.Tiles);
+	PrepareCache();
+	ProceedShadowCasting(pos, width, height, range + 1);
+	ResetShadowCaster();
+	for (const unsigned int index : view.Tiles) {
+		MarkedTilesCache[index] = 0;
+	}
+	return view.Tiles;
+}
+
 /**
 **  Refresh the whole sight of unit by SimpleRadial algorithm. (Explore and make visible.)
 **
@@ -204,6 +303,94 @@ void CFieldOfView::ProceedSimpleRadial(const CPlayer &player, const Vec2i &pos,
 	}
 }
 
+/**
+**  Refresh the edges of the sight of unit by SimpleRadial algorithm after a step.
+**
+**  @param player    player to mark the sight for (not unit owner)
+**  @param oldPos    location before the step
+**  @param pos       location after the step
+**  @param w         width to mark, in square
+**  @param h         height to mark, in square
+**  @param range     Radius to mark (sight range)
+**  @param unmarker  Function to unmark sight
+**  @param marker    Function to mark sight
+*/
+void CFieldOfView::ProceedSimpleRadialStep(const CPlayer &player, const Vec2i &oldPos, const Vec2i &pos,
+										   const int16_t w, const int16_t h, const int16_t range,
+										   MapMarkerFunc *unmarker, MapMarkerFunc *marker)
+{
+	const SStepMask &mask = GetStepMask(w, h, range, pos - oldPos);
+
+	for (const Vec2i &offset : mask.Leaving) {
+		const Vec2i mpos = oldPos + offset;
+		if (Map.Info.IsPointOnMap(mpos)) {
+			unmarker(player, Map.getIndex(mpos));
+		}
+	}
+	for (const Vec2i &offset : mask.Entering) {
+		const Vec2i mpos = pos + offset;
+		if (Map.Info.IsPointOnMap(mpos)) {
+			marker(player, Map.getIndex(mpos));
+		}
+	}
+}
+
+/**
+**  Check if a tile is in the simple radial field of view of a spectator,
+**  with the same rows as ProceedSimpleRadial.
+**
+**  @param offset  Tile position relative to the top left tile of the spectator
+**  @param w       Spectator's width in tiles
+**  @param h       Spectator's height in tiles
+**  @param range   Spectator's sight range in tiles
+*/
+static bool IsInSimpleRadialView(const Vec2i &offset, const int16_t w, const int16_t h, const int16_t range)
+{
+	if (offset.y < -range || offset.y >= h + range) {
+		return false;
+	}
+	int16_t offsetx = range;
+	if (offset.y < 0) {
+		offsetx = isqrt(square(range + 1) - square(offset.y) - 1);
+	} else if (offset.y >= h) {
+		offsetx = isqrt(square(range + 1) - square(offset.y - h + 1) - 1);
+	}
+	return offset.x >= -offsetx && offset.x < w + offsetx;
+}
+
+/**
+**  Get the tiles a simple radial field of view loses and gains with a step.
+**  Each combination of size, range and step is computed once.
+**
+**  @param w      Spectator's width in tiles
+**  @param h      Spectator's height in tiles
+**  @param range  Spectator's sight range in tiles
+**  @param step   Move of the spectator, at most one tile in each direction
+*/
+const CFieldOfView::SStepMask &CFieldOfView::GetStepMask(const int16_t w, const int16_t h, const int16_t range,
+														 const Vec2i &step)
+{
+	auto [it, inserted] = StepMasks.try_emplace({w, h, range, step.x, step.y});
+	SStepMask &mask = it->second;
+
+	if (inserted && step != Vec2i(0, 0)) {
+		for (Vec2i offset(0, -range); offset.y < h + range; ++offset.y) {
+			for (offset.x = -range; offset.x < w + range; ++offset.x) {
+				if (!IsInSimpleRadialView(offset, w, h, range)) {
+					continue;
+				}
+				if (!IsInSimpleRadialView(offset - step, w, h, range)) {
+					mask.Leaving.push_back(offset);
+				}
+				if (!IsInSimpleRadialView(offset + step, w, h, range)) {
+					mask.Entering.push_back(offset);
+				}
+			}
+		}
+	}
+	return mask;
+}
+
 /**
 ** Mark the sight of unit by ShadowCaster algorithm. (Explore and make visible.)
 **
@@ -409,51 +596,28 @@ int16_t CFieldOfView::CalcRow_ByVector(const bool isTop, const int16_t col, cons
 	return row;
 }
 
-void CFieldOfView::PrepareShadowCaster(const CPlayer &player, const CUnit &unit, const Vec2i &pos, MapMarkerFunc *marker)
+void CFieldOfView::PrepareShadowCaster(const Vec2i &pos, std::vector<unsigned int> &tiles)
 {
-	Player 		= &player;
-	Unit 		= &unit;
 	/// TODO: maybe should set current level + 1 for units with 'elevated' flag (f.e. towers)
 	Elevation 	= Map.Field(pos.x, pos.y)->getElevation();
-	map_setFoV 	= marker;
+	ViewTiles 	= &tiles;
 }
 
 void CFieldOfView::ResetShadowCaster()
 {
-	Player 		= nullptr;
-	Unit 		= nullptr;
 	Elevation	= 0;
-	map_setFoV 	= nullptr;
+	ViewTiles 	= nullptr;
 	currTilePos = { 0, 0 };
 
 	ResetEnvironment();
 }
 
-void CFieldOfView::PrepareCache(const Vec2i pos, const uint16_t width, const uint16_t height, const uint16_t range)
+void CFieldOfView::PrepareCache()
 {
-	/// Init cache table if it's uninitialized yet
-	if (!MarkedTilesCache.size()) {
-		MarkedTilesCache.resize(Map.Info.MapWidth * Map.Info.MapWidth);
-		std::fill_n(MarkedTilesCache.begin(), MarkedTilesCache.size(), 0);
-	}
-	/// Clean cache for sight-sized frame
-	Vec2i upperLeft;
-	upperLeft.x = pos.x - range;
-	upperLeft.y = pos.y - range;
-	Map.Clamp(upperLeft);
-
-	Vec2i bottomRight;
-	bottomRight.x =  pos.x + width + range;
-	bottomRight.y =  pos.y + height + range;
-	Map.Clamp(bottomRight);
-
-	const uint16_t sightRecWidth = bottomRight.x - upperLeft.x + 1;
-
-	size_t index = upperLeft.x + upperLeft.y * Map.Info.MapWidth;
-
-	for (uint16_t y = upperLeft.y; y <= bottomRight.y; y++ ) {
-		std::fill_n(&MarkedTilesCache[index], sightRecWidth, 0);
-		index += Map.Info.MapWidth;
+	/// Init cache table if it's uninitialized yet. Its users clear what they mark.
+	const size_t size = Map.Info.MapWidth * Map.Info.MapHeight;
+	if (MarkedTilesCache.size() != size) {
+		MarkedTilesCache.assign(size, 0);
 	}
 }
 
@@ -45,6 +45,7 @@
 #include "viewport.h"
 
 #include <algorithm>
+#include <chrono>
 
 /*----------------------------------------------------------------------------
 --  Defines
@@ -60,6 +61,26 @@ std::shared_ptr<CGraphic> CFogOfWar::TiledFogSrc; // Graphic tiles set for tiled
 /*----------------------------------------------------------------------------
 -- Functions
 ----------------------------------------------------------------------------*/
+namespace
+{
+
+/// Adds the time elapsed during its lifetime to the given counter (in microseconds)
+class CStageTimer
+{
+public:
+    explicit CStageTimer(uint64_t &counter) : Counter(counter), Start(std::chrono::steady_clock::now()) {}
+    ~CStageTimer()
+    {
+        Counter += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - Start).count();
+    }
+
+private:
+    uint64_t &Counter;
+    const std::chrono::steady_clock::time_point Start;
+};
+
+} // namespace
+
 void CFogOfWar::SetTiledFogGraphic(const fs::path &fogGraphicFile)
 {
 	CFogOfWar::TiledFogSrc = CGraphic::New(fogGraphicFile.string(), PixelTileSize.x, PixelTileSize.y);
@@ -122,6 +143,14 @@ void CFogOfWar::Init()
     VisionFor.clear();
     ShowVisionFor(*ThisPlayer);
 
+    DirtyAll       = true;
+    DirtyMin       = Vec2i(Map.Info.MapWidth, Map.Info.MapHeight);
+    DirtyMax       = Vec2i(-1, -1);
+    UpdatedTiles   = {0, 0, 0, 0};
+    UpdatedTexels  = {0, 0, 0, 0};
+    ChangedTiles   = {0, 0, 0, 0};
+    UpscaledTexels = {0, 0, 0, 0};
+
     this->State = cFirstEntry;
 }
 
@@ -170,6 +199,9 @@ void CFogOfWar::InitEnhanced()
     RenderedFog.resize(Map.Info.MapWidth * Map.Info.MapHeight * 16);
     ranges::fill(RenderedFog, 0xFF);
 
+    UpscalePatterns.clear();
+    UpscalePatterns.resize(2 * VisTableWidth * omp_get_max_threads());
+
     Blurrer.Init(fogTextureWidth, fogTextureHeight, Settings.BlurRadius[Settings.UpscaleType], Settings.BlurIterations);
 
     SetFogColor(Settings.FogColor);
@@ -215,6 +247,8 @@ void CFogOfWar::Clean(const bool isHardClean /*= false*/)
             }
             FogTexture.Clean();
             RenderedFog.clear();
+            PartialTexture.clear();
+            UpscalePatterns.clear();
             Blurrer.Clean();
             break;
 
@@ -261,6 +295,7 @@ void CFogOfWar::SetOpacityLevels(const uint8_t explored, const uint8_t revealed,
     GenerateUpscaleTables(UpscaleTableVisible, 0, explored);
     GenerateUpscaleTables(UpscaleTableExplored, explored, unseen);
     GenerateUpscaleTables(UpscaleTableRevealed, explored, revealed);
+    InvalidateAll();
 }
 
 /**
@@ -275,6 +310,7 @@ void CFogOfWar::EnableBilinearUpscale(const bool enable)
     Settings.UpscaleType = enable ? UpscaleTypes::cBilinear : UpscaleTypes::cSimple;
     if (prev != Settings.UpscaleType) {
         Blurrer.PrecalcParameters(Settings.BlurRadius[Settings.UpscaleType], Settings.BlurIterations);
+        InvalidateAll();
     }
 }
 
@@ -284,15 +320,22 @@ void CFogOfWar::InitBlurrer(const float radius1, const float radius2, const uint
     Settings.BlurRadius[cBilinear] = radius2;
     Settings.BlurIterations        = numOfIterations;
     Blurrer.PrecalcParameters(Settings.BlurRadius[Settings.UpscaleType], numOfIterations);
+    InvalidateAll();
 }
 
 /**
 ** Generate fog of war:
-** fill map-sized table with values of visibility for current player/players
+** fill map-sized table with values of visibility for current player/players.
+** Only tiles whose vision has changed since the previous call are refilled,
+** unless the set of rendered players or the way they see the map has changed.
+**
+** @return rectangle of the refilled tiles
 **
 */
-void CFogOfWar::GenerateFog()
+SDL_Rect CFogOfWar::GenerateFog()
 {
+    CStageTimer timer(Timings.GenerateFog);
+
     /// FIXME: Maybe to update this with every change of shared vision
     std::set<uint8_t> playersToRenderView;
     for (const uint8_t player : VisionFor) {
@@ -301,29 +344,61 @@ void CFogOfWar::GenerateFog()
             playersToRenderView.insert(playersSharedVision);
         }
     }
-    CurrUpscaleTableExplored = GameSettings.RevealMap != MapRevealModes::cHidden ? UpscaleTableRevealed : UpscaleTableExplored;
-
+    std::bitset<PlayerMax> renderedPlayers;
+    for (const uint8_t player : playersToRenderView) {
+        renderedPlayers.set(player);
+    }
+    const uint32_t (*const upscaleTableExplored)[4] = GameSettings.RevealMap != MapRevealModes::cHidden
+                                                      ? UpscaleTableRevealed : UpscaleTableExplored;
     const uint8_t visibleThreshold = Map.NoFogOfWar ? 1 : 2;
 
+    /// Changes of vision are tracked only for the rendered players
+    if (renderedPlayers != RenderedPlayers || upscaleTableExplored != CurrUpscaleTableExplored
+        || visibleThreshold != VisibleThreshold) {
+        DirtyAll = true;
+    }
+    RenderedPlayers          = renderedPlayers;
+    CurrUpscaleTableExplored = upscaleTableExplored;
+    VisibleThreshold         = visibleThreshold;
+
+    SDL_Rect tiles {0, 0, Map.Info.MapWidth, Map.Info.MapHeight};
+    if (!DirtyAll) {
+        tiles = {DirtyMin.x, DirtyMin.y, DirtyMax.x - DirtyMin.x + 1, DirtyMax.y - DirtyMin.y + 1};
+        if (SDL_RectEmpty(&tiles)) {
+            tiles = {0, 0, 0, 0};
+        }
+    }
+    Timings.Generations++;
+    if (tiles.w != Map.Info.MapWidth || tiles.h != Map.Info.MapHeight) {
+        Timings.PartialUpdates++;
+    }
+    DirtyAll = false;
+    DirtyMin = Vec2i(Map.Info.MapWidth, Map.Info.MapHeight);
+    DirtyMax = Vec2i(-1, -1);
+
+    SDL_Rect changed;
+    SDL_UnionRect(&tiles, &ChangedTiles, &changed);
+    ChangedTiles = changed;
+
     #pragma omp parallel
     {
         const uint16_t thisThread   = omp_get_thread_num();
         const uint16_t numOfThreads = omp_get_num_threads();
-        const uint16_t lBound = (thisThread    ) * Map.Info.MapHeight / numOfThreads;
-        const uint16_t uBound = (thisThread + 1) * Map.Info.MapHeight / numOfThreads;
+        const uint16_t lBound = tiles.y + (thisThread    ) * tiles.h / numOfThreads;
+        const uint16_t uBound = tiles.y + (thisThread + 1) * tiles.h / numOfThreads;
 
         for (uint16_t row = lBound; row < uBound; row++) {
 
             const size_t visIndex = VisTable_Index0 + row * VisTableWidth;
             const size_t mapIndex = size_t(row) * Map.Info.MapWidth;
 
-            for (uint16_t col = 0; col < Map.Info.MapWidth; col++) {
+            for (uint16_t col = tiles.x; col < tiles.x + tiles.w; col++) {
 
                 uint8_t &visCell = VisTable[visIndex + col];
                 visCell = 0; /// Clear it before check for players
-                const CMapField *mapField = Map.Field(mapIndex + col);
+                const CMapFieldPlayerInfo &playerInfo = Map.FieldsPlayerInfo[mapIndex + col];
                 for (const uint8_t player : playersToRenderView) {
-                    visCell = std::max<uint8_t>(visCell, mapField->playerInfo.Visible[player]);
+                    visCell = std::max<uint8_t>(visCell, playerInfo.Visible[player]);
                     if (visCell >= visibleThreshold) {
                         visCell = 2;
                         break;
@@ -332,6 +407,99 @@ void CFogOfWar::GenerateFog()
             }
         }
     }
+    return tiles;
+}
+
+/**
+**  Upscale the refilled part of the vision table into the next frame of the fog texture.
+**  If only a part of the map has changed, it is upscaled together with enough surroundings for the blur
+**  into a separate buffer. The rest of the next frame is made equal to the current one.
+**
+*/
+void CFogOfWar::GenerateTexture()
+{
+    CStageTimer timer(Timings.Upscale);
+
+    UpdatedTexels  = {0, 0, 0, 0};
+    UpscaledTexels = {0, 0, 0, 0};
+    if (SDL_RectEmpty(&UpdatedTiles)) {
+        return;
+    }
+    const SDL_Rect wholeTexture {0, 0, FogTexture.GetWidth(), FogTexture.GetHeight()};
+    const int margin = Blurrer.GetMargin();
+
+    /// Map tile [x:y] is [x+1:y+1] in the vision table, which is used by the 4x4 blocks from [x:y] to [x+1:y+1]
+    const SDL_Rect changedTexels {UpdatedTiles.x * 4 - margin,
+                                  UpdatedTiles.y * 4 - margin,
+                                  (UpdatedTiles.w + 1) * 4 + 2 * margin,
+                                  (UpdatedTiles.h + 1) * 4 + 2 * margin};
+    SDL_IntersectRect(&changedTexels, &wholeTexture, &UpdatedTexels);
+
+    /// Blurred texels are exact only farther than the margin from the borders of the blurred area
+    const int x0 = (UpdatedTexels.x - margin) & ~3;
+    const int y0 = (UpdatedTexels.y - margin) & ~3;
+    const int x1 = (UpdatedTexels.x + UpdatedTexels.w + margin + 3) & ~3;
+    const int y1 = (UpdatedTexels.y + UpdatedTexels.h + margin + 3) & ~3;
+    const SDL_Rect upscaledTexels {x0, y0, x1 - x0, y1 - y0};
+    SDL_IntersectRect(&upscaledTexels, &wholeTexture, &UpscaledTexels);
+
+    const SDL_Rect blocks {UpscaledTexels.x / 4, UpscaledTexels.y / 4, UpscaledTexels.w / 4, UpscaledTexels.h / 4};
+
+    if (SDL_RectEquals(&UpscaledTexels, &wholeTexture)) {
+        FogUpscale4x4((uint32_t*)FogTexture.GetNext(), blocks.w, blocks);
+    } else {
+        FogTexture.SyncNext();
+        PartialTexture.resize(size_t(UpscaledTexels.w) * UpscaledTexels.h);
+        FogUpscale4x4((uint32_t*)PartialTexture.data(), blocks.w, blocks);
+    }
+}
+
+/**
+**  Blur the upscaled fog texture and put the changed part of it into the next frame
+**
+*/
+void CFogOfWar::BlurTexture()
+{
+    CStageTimer timer(Timings.Blur);
+
+    if (SDL_RectEmpty(&UpscaledTexels)) {
+        return;
+    }
+    if (UpscaledTexels.w == FogTexture.GetWidth() && UpscaledTexels.h == FogTexture.GetHeight()) {
+        Blurrer.Blur(FogTexture.GetNext());
+        return;
+    }
+    Blurrer.Blur(PartialTexture.data(), UpscaledTexels.w, UpscaledTexels.h);
+
+    uint8_t *const next = FogTexture.GetNext();
+    size_t srcIndex = size_t(UpdatedTexels.y - UpscaledTexels.y) * UpscaledTexels.w + UpdatedTexels.x - UpscaledTexels.x;
+    size_t trgIndex = size_t(UpdatedTexels.y) * FogTexture.GetWidth() + UpdatedTexels.x;
+    for (uint16_t row = 0; row < UpdatedTexels.h; row++) {
+        std::copy_n(&PartialTexture[srcIndex], UpdatedTexels.w, &next[trgIndex]);
+        srcIndex += UpscaledTexels.w;
+        trgIndex += FogTexture.GetWidth();
+    }
+}
+
+/**
+**  Start easing to the generated frame of the fog texture
+**
+**  @param forcedShowNext   cmd to show the generated frame without easing
+**
+*/
+void CFogOfWar::PushTexture(const bool forcedShowNext /*= false*/)
+{
+    CStageTimer timer(Timings.Deltas);
+
+    /// Nothing has changed, keep the current frame
+    if (SDL_RectEmpty(&UpdatedTexels)) {
+        return;
+    }
+    FogTexture.PushNext(UpdatedTexels, forcedShowNext);
+
+    UpdatedTiles   = {0, 0, 0, 0};
+    UpdatedTexels  = {0, 0, 0, 0};
+    UpscaledTexels = {0, 0, 0, 0};
 }
 
 /**
@@ -368,32 +536,33 @@ void CFogOfWar::Update(bool doAtOnce /*= false*/)
 
     if (Settings.NumOfEasingSteps < States::cReady) doAtOnce = true;
 
+    /// Tiles regenerated by an interrupted pass are kept in UpdatedTiles until they are pushed
     if (doAtOnce || this->State == States::cFirstEntry) {
-        GenerateFog();
-        FogUpscale4x4();
-        Blurrer.Blur(FogTexture.GetNext());
-        FogTexture.PushNext(doAtOnce);
+        AddUpdatedTiles(GenerateFog());
+        GenerateTexture();
+        BlurTexture();
+        PushTexture(doAtOnce);
         this->State = States::cGenerateFog;
     } else {
         switch (this->State) {
             case States::cGenerateFog:
-                GenerateFog();
+                AddUpdatedTiles(GenerateFog());
                 this->State++;
                 break;
 
             case States::cGenerateTexture:
-                FogUpscale4x4();
+                GenerateTexture();
                 this->State++;
                 break;
 
             case States::cBlurTexture:
-                Blurrer.Blur(FogTexture.GetNext());
+                BlurTexture();
                 this->State++;
                 break;
 
             case States::cReady:
                 if (FogTexture.isFullyEased()) {
-                    FogTexture.PushNext();
+                    PushTexture();
                     this->State = cGenerateFog;
                 }
                 break;
@@ -458,7 +627,8 @@ void CFogOfWar::DrawEnhanced(CViewport &viewport)
 
     switch (this->Settings.UpscaleType) {
         case cBilinear:
-            UpscaleBilinear(RenderedFog.data(), srcRect, Map.Info.MapWidth * 4, viewport.GetFogSurface(), trgRect);
+            FogUpscaleBilinear(RenderedFog.data(), srcRect, Map.Info.MapWidth * 4, viewport.GetFogSurface(), trgRect,
+                               Settings.FogColorSDL);
             break;
         case cSimple:
         default:
@@ -470,8 +640,12 @@ void CFogOfWar::DrawEnhanced(CViewport &viewport)
 /**
 **  4x4 upscale generated fog of war texture
 **
+**  @param  texture         texture to fill, its top left block is the top left one of the blocks to upscale
+**  @param  textureWidth    width of the texture in 4x4 blocks
+**  @param  blocks          4x4 blocks of the whole fog texture to upscale
+**
 */
-void CFogOfWar::FogUpscale4x4()
+void CFogOfWar::FogUpscale4x4(uint32_t *const texture, const uint16_t textureWidth, const SDL_Rect &blocks)
 {
     /*
     **  For all fields from VisTable in the given rectangle to calculate two patterns - Visible and Explored.
@@ -491,11 +665,6 @@ void CFogOfWar::FogUpscale4x4()
     */
 
     /// Because we work with 4x4 scaled map tiles here, the textureIndex is in 32bits chunks (byte * 4)
-    uint32_t *const fogTexture = (uint32_t*)FogTexture.GetNext();
-
-    /// Fog texture width and height in 32bit chunks
-    const uint16_t textureWidth  = FogTexture.GetWidth()  / 4;
-    const uint16_t textureHeight = FogTexture.GetHeight() / 4;
     const uint16_t nextRowOffset = textureWidth * 4;
 
     #pragma omp parallel
@@ -504,91 +673,42 @@ void CFogOfWar::FogUpscale4x4()
         const uint16_t thisThread   = omp_get_thread_num();
         const uint16_t numOfThreads = omp_get_num_threads();
 
-        const uint16_t lBound = (thisThread    ) * textureHeight / numOfThreads;
-        const uint16_t uBound = (thisThread + 1) * textureHeight / numOfThreads;
+        const uint16_t lBound = (thisThread    ) * blocks.h / numOfThreads;
+        const uint16_t uBound = (thisThread + 1) * blocks.h / numOfThreads;
 
         /// in fact it's viewport.MapPos.y -1 & viewport.MapPos.x -1 because of VisTable starts from [-1:-1]
-        size_t visIndex      = lBound * VisTableWidth;
+        size_t visIndex      = (blocks.y + lBound) * VisTableWidth + blocks.x;
         size_t textureIndex  = lBound * nextRowOffset;
 
-        for (uint16_t row = lBound; row < uBound; row++) {
-            for (uint16_t col = 0; col < textureWidth; col++) {
-                /// Fill the 4x4 scaled tile
-                FillUpscaledRec(fogTexture, textureWidth, textureIndex + col,
-                                DeterminePattern(visIndex + col, VisionType::cVisible),
-                                DeterminePattern(visIndex + col, VisionType::cVisible | VisionType::cExplored));
+        if (GetFogSimdType() == FogSimdTypes::cScalar) {
+            for (uint16_t row = lBound; row < uBound; row++) {
+                for (uint16_t col = 0; col < blocks.w; col++) {
+                    /// Fill the 4x4 scaled tile
+                    FillUpscaledRec(texture, textureWidth, textureIndex + col,
+                                    DeterminePattern(visIndex + col, VisionType::cVisible),
+                                    DeterminePattern(visIndex + col, VisionType::cVisible | VisionType::cExplored));
+                }
+                visIndex     += VisTableWidth;
+                textureIndex += nextRowOffset;
             }
-            visIndex     += VisTableWidth;
-            textureIndex += nextRowOffset;
-        }
-    } // pragma omp parallel
-}
-
-/**
-** Bilinear zoom Fog Of War texture into SDL surface
-**
-**  @param src          Image src.
-**  @param srcRect      Rectangle in the src image to render
-**  @param srcWidth     Image width
-**  @param trgSurface   Where to render
-**  @param trgRect      Scale src rectangle to this rectangle
-**
-*/
-void CFogOfWar::UpscaleBilinear(const uint8_t *const src, const SDL_Rect &srcRect, const int16_t srcWidth,
-                                SDL_Surface *const trgSurface, const SDL_Rect &trgRect) const
-{
-    constexpr int32_t fixedOne = 65536;
-
-    uint32_t *const target = (uint32_t*)trgSurface->pixels;
-    const uint16_t AShift = trgSurface->format->Ashift;
-
-    /// FIXME: '-1' shouldn't be here, but without it the resulting fog has a shift to the left and upward
-    const int32_t xRatio = (int32_t(srcRect.w - 1) << 16) / trgRect.w;
-    const int32_t yRatio = (int32_t(srcRect.h - 1) << 16) / trgRect.h;
-
-    #pragma omp parallel
-    {
-        const uint16_t thisThread   = omp_get_thread_num();
-        const uint16_t numOfThreads = omp_get_num_threads();
-
-        const uint16_t lBound = (thisThread    ) * trgRect.h / numOfThreads;
-        const uint16_t uBound = (thisThread + 1) * trgRect.h / numOfThreads;
-
-        size_t  trgIndex = size_t(trgRect.y + lBound) * trgSurface->w + trgRect.x;
-        int64_t y        = ((int32_t)srcRect.y << 16) + lBound * yRatio;
-
-        for (uint16_t yTrg = lBound; yTrg < uBound; yTrg++) {
-
-            const int32_t ySrc          = int32_t(y >> 16);
-            const int64_t yDiff         = y - (ySrc << 16);
-            const int64_t one_min_yDiff = fixedOne - yDiff;
-            const size_t  yIndex        = ySrc * srcWidth;
-                  int64_t x             = int32_t(srcRect.x) << 16;
-
-            for (uint16_t xTrg = 0; xTrg < trgRect.w; xTrg++) {
-
-                const int32_t xSrc          = int32_t(x >> 16);
-                const int64_t xDiff         = x - (xSrc << 16);
-                const int64_t one_min_xDiff = fixedOne - xDiff;
-                const size_t  srcIndex      = yIndex + xSrc;
-
-                const uint8_t A = src[srcIndex];
-                const uint8_t B = src[srcIndex + 1];
-                const uint8_t C = src[srcIndex + srcWidth];
-                const uint8_t D = src[srcIndex + srcWidth + 1];
-
-                const uint32_t alpha = ((  A * one_min_xDiff * one_min_yDiff
-                                         + B * xDiff * one_min_yDiff
-                                         + C * yDiff * one_min_xDiff
-                                         + D * xDiff * yDiff ) >> 32 );
-
-                target[trgIndex + xTrg] = (alpha << AShift) | Settings.FogColorSDL;
-                x += xRatio;
+        } else {
+            /// Patterns of the whole row of blocks are determined by the vector kernels
+            Assert(size_t(numOfThreads) * 2 * VisTableWidth <= UpscalePatterns.size() && size_t(blocks.w) <= VisTableWidth);
+            uint8_t *const patternsVisible  = &UpscalePatterns[thisThread * 2 * VisTableWidth];
+            uint8_t *const patternsExplored = patternsVisible + VisTableWidth;
+
+            for (uint16_t row = lBound; row < uBound; row++) {
+                FogUpscalePatterns(&VisTable[visIndex], &VisTable[visIndex + VisTableWidth], blocks.w,
+                                   patternsVisible, patternsExplored);
+                for (uint16_t col = 0; col < blocks.w; col++) {
+                    FillUpscaledRec(texture, textureWidth, textureIndex + col,
+                                    patternsVisible[col], patternsExplored[col]);
+                }
+                visIndex     += VisTableWidth;
+                textureIndex += nextRowOffset;
             }
-            y += yRatio;
-            trgIndex += trgSurface->w;
         }
-    } /// pragma omp parallel
+    } // pragma omp parallel
 }
 
 /**
@@ -0,0 +1,317 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name fow_simd.cpp - SSE2 and AVX2 kernels for the fog of war. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+// The kernels give exactly the same results as the scalar code in
+// fow_utils.cpp, which selects them at runtime. Each one processes as many
+// elements as fit in whole vectors and returns where the scalar code has to
+// continue.
+//
+// Box blur: the sums of the boxes are exact integers whichever way they are
+// computed, and (iarr * sum + 0.5) >> 16 is computed on 16 bit lanes as
+// mulhi(iarr, sum) + (mullo(iarr, sum) >> 15).
+//
+// Bilinear upscale: the value is (top * (1 - yDiff) + bottom * yDiff) >> 32,
+// where top and bottom are the horizontally interpolated source rows (less
+// than 2^24). The products need 41 bits, so SSE2 computes them with doubles,
+// which are exact below 2^53. AVX2 splits top and bottom into 16 bit halves,
+// so that every product fits in 32 bits.
+
+//@{
+
+/*----------------------------------------------------------------------------
+--  Includes
+----------------------------------------------------------------------------*/
+
+#include "stratagus.h"
+
+#include <cstdint>
+
+#ifdef __x86_64__
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+/*----------------------------------------------------------------------------
+--  Functions
+----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------
+--  SSE2
+----------------------------------------------------------------------------*/
+
+static inline __m128i LoadBytesSSE2(const uint8_t *src)
+{
+    return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src)), _mm_setzero_si128());
+}
+
+static inline void StoreBoxesSSE2(uint8_t *trg, const __m128i sum, const __m128i iarr)
+{
+    const __m128i hi = _mm_mulhi_epu16(sum, iarr);
+    const __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(sum, iarr), 15);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(trg), _mm_packus_epi16(_mm_add_epi16(hi, lo), _mm_setzero_si128()));
+}
+
+/**
+**  Horizontal box blur of the pixels [from, to) of a row, whose boxes lie inside the row.
+*/
+uint16_t FogBlurRowSSE2(const uint8_t *source, uint8_t *target, uint16_t from, const uint16_t to,
+                        const uint8_t radius, const uint16_t iarr)
+{
+    const __m128i mult = _mm_set1_epi16(iarr);
+    for (; from + 8 <= to; from += 8) {
+        __m128i sum = _mm_setzero_si128();
+        for (const uint8_t *src = &source[from - radius]; src <= &source[from + radius]; ++src) {
+            sum = _mm_add_epi16(sum, LoadBytesSSE2(src));
+        }
+        StoreBoxesSSE2(&target[from], sum, mult);
+    }
+    return from;
+}
+
+/**
+**  Vertical box blur of the columns [from, to), the same running sums as the scalar code.
+*/
+uint16_t FogBlurColumnsSSE2(const uint8_t *source, uint8_t *target, const uint16_t width, const uint16_t height,
+                            uint16_t from, const uint16_t to, const uint8_t radius, const uint16_t iarr)
+{
+    const __m128i mult = _mm_set1_epi16(iarr);
+    for (; from + 8 <= to; from += 8) {
+        size_t ti = from;
+        size_t li = ti;
+        size_t ri = ti + radius * width;
+
+        const __m128i leftBorder  = LoadBytesSSE2(&source[ti]);
+        const __m128i rightBorder = LoadBytesSSE2(&source[ti + width * (height - 1)]);
+        __m128i sum = _mm_mullo_epi16(leftBorder, _mm_set1_epi16(radius + 1));
+
+        for (uint16_t j = 0; j < radius; j++) {
+            sum = _mm_add_epi16(sum, LoadBytesSSE2(&source[ti + j * width]));
+        }
+        for (uint16_t j = 0; j <= radius; j++) {
+            sum = _mm_add_epi16(sum, _mm_sub_epi16(LoadBytesSSE2(&source[ri]), leftBorder));
+            StoreBoxesSSE2(&target[ti], sum, mult);
+            ri += width;
+            ti += width;
+        }
+        for (uint16_t j = radius + 1; j < height - radius; j++) {
+            sum = _mm_add_epi16(sum, _mm_sub_epi16(LoadBytesSSE2(&source[ri]), LoadBytesSSE2(&source[li])));
+            StoreBoxesSSE2(&target[ti], sum, mult);
+            li += width;
+            ri += width;
+            ti += width;
+        }
+        for (uint16_t j = height - radius; j < height; j++) {
+            sum = _mm_add_epi16(sum, _mm_sub_epi16(rightBorder, LoadBytesSSE2(&source[li])));
+            StoreBoxesSSE2(&target[ti], sum, mult);
+            li += width;
+            ti += width;
+        }
+    }
+    return from;
+}
+
+/**
+**  Upscale patterns of the 4x4 blocks: 4 bits, one for each of the 2x2 vision table cells used by a block.
+*/
+uint16_t FogUpscalePatternsSSE2(const uint8_t *visRow, const uint8_t *nextVisRow, uint16_t from, const uint16_t to,
+                                uint8_t *patternsVisible, uint8_t *patternsExplored)
+{
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i two = _mm_set1_epi8(2);
+    for (; from + 16 <= to; from += 16) {
+        const __m128i n[4] = {_mm_loadu_si128(reinterpret_cast<const __m128i *>(&visRow[from])),
+                              _mm_loadu_si128(reinterpret_cast<const __m128i *>(&visRow[from + 1])),
+                              _mm_loadu_si128(reinterpret_cast<const __m128i *>(&nextVisRow[from])),
+                              _mm_loadu_si128(reinterpret_cast<const __m128i *>(&nextVisRow[from + 1]))};
+        /// ((n1 * 2 + n2) * 2 + n3) * 2 + n4
+        __m128i visible  = _mm_setzero_si128();
+        __m128i explored = _mm_setzero_si128();
+        for (const __m128i &cell : n) {
+            visible  = _mm_add_epi8(_mm_add_epi8(visible, visible), _mm_min_epu8(_mm_and_si128(cell, two), one));
+            explored = _mm_add_epi8(_mm_add_epi8(explored, explored), _mm_min_epu8(cell, one));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&patternsVisible[from]), visible);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&patternsExplored[from]), explored);
+    }
+    return from;
+}
+
+/**
+**  Vertical interpolation of the bilinear upscale between two horizontally interpolated rows.
+*/
+uint16_t FogBilinearRowSSE2(const uint32_t *top, const uint32_t *bottom, uint16_t from, const uint16_t to,
+                            const uint32_t yDiff, uint32_t *target, const uint8_t aShift, const uint32_t fogColor)
+{
+    const __m128d oneMinusY = _mm_set1_pd(double(65536 - yDiff));
+    const __m128d y         = _mm_set1_pd(double(yDiff));
+    const __m128d scale     = _mm_set1_pd(1.0 / 4294967296.0);
+    const __m128i color     = _mm_set1_epi32(fogColor);
+    const __m128i shift     = _mm_cvtsi32_si128(aShift);
+
+    auto interpolate = [&](__m128i t, __m128i b) {
+        const __m128d value = _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(t), oneMinusY), _mm_mul_pd(_mm_cvtepi32_pd(b), y));
+        return _mm_cvttpd_epi32(_mm_mul_pd(value, scale));
+    };
+    for (; from + 4 <= to; from += 4) {
+        const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&top[from]));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&bottom[from]));
+        const __m128i alpha = _mm_unpacklo_epi64(interpolate(t, b),
+                                                 interpolate(_mm_srli_si128(t, 8), _mm_srli_si128(b, 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&target[from]), _mm_or_si128(_mm_sll_epi32(alpha, shift), color));
+    }
+    return from;
+}
+
+/*----------------------------------------------------------------------------
+--  AVX2
+----------------------------------------------------------------------------*/
+
+TARGET_AVX2 static inline __m256i LoadBytesAVX2(const uint8_t *src)
+{
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+}
+
+TARGET_AVX2 static inline void StoreBoxesAVX2(uint8_t *trg, const __m256i sum, const __m256i iarr)
+{
+    const __m256i hi = _mm256_mulhi_epu16(sum, iarr);
+    const __m256i lo = _mm256_srli_epi16(_mm256_mullo_epi16(sum, iarr), 15);
+    const __m256i result = _mm256_add_epi16(hi, lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(trg),
+                     _mm_packus_epi16(_mm256_castsi256_si128(result), _mm256_extracti128_si256(result, 1)));
+}
+
+TARGET_AVX2 uint16_t FogBlurRowAVX2(const uint8_t *source, uint8_t *target, uint16_t from, const uint16_t to,
+                                    const uint8_t radius, const uint16_t iarr)
+{
+    const __m256i mult = _mm256_set1_epi16(iarr);
+    for (; from + 16 <= to; from += 16) {
+        __m256i sum = _mm256_setzero_si256();
+        for (const uint8_t *src = &source[from - radius]; src <= &source[from + radius]; ++src) {
+            sum = _mm256_add_epi16(sum, LoadBytesAVX2(src));
+        }
+        StoreBoxesAVX2(&target[from], sum, mult);
+    }
+    return from;
+}
+
+TARGET_AVX2 uint16_t FogBlurColumnsAVX2(const uint8_t *source, uint8_t *target, const uint16_t width, const uint16_t height,
+                                        uint16_t from, const uint16_t to, const uint8_t radius, const uint16_t iarr)
+{
+    const __m256i mult = _mm256_set1_epi16(iarr);
+    for (; from + 16 <= to; from += 16) {
+        size_t ti = from;
+        size_t li = ti;
+        size_t ri = ti + radius * width;
+
+        const __m256i leftBorder  = LoadBytesAVX2(&source[ti]);
+        const __m256i rightBorder = LoadBytesAVX2(&source[ti + width * (height - 1)]);
+        __m256i sum = _mm256_mullo_epi16(leftBorder, _mm256_set1_epi16(radius + 1));
+
+        for (uint16_t j = 0; j < radius; j++) {
+            sum = _mm256_add_epi16(sum, LoadBytesAVX2(&source[ti + j * width]));
+        }
+        for (uint16_t j = 0; j <= radius; j++) {
+            sum = _mm256_add_epi16(sum, _mm256_sub_epi16(LoadBytesAVX2(&source[ri]), leftBorder));
+            StoreBoxesAVX2(&target[ti], sum, mult);
+            ri += width;
+            ti += width;
+        }
+        for (uint16_t j = radius + 1; j < height - radius; j++) {
+            sum = _mm256_add_epi16(sum, _mm256_sub_epi16(LoadBytesAVX2(&source[ri]), LoadBytesAVX2(&source[li])));
+            StoreBoxesAVX2(&target[ti], sum, mult);
+            li += width;
+            ri += width;
+            ti += width;
+        }
+        for (uint16_t j = height - radius; j < height; j++) {
+            sum = _mm256_add_epi16(sum, _mm256_sub_epi16(rightBorder, LoadBytesAVX2(&source[li])));
+            StoreBoxesAVX2(&target[ti], sum, mult);
+            li += width;
+            ti += width;
+        }
+    }
+    return from;
+}
+
+TARGET_AVX2 uint16_t FogUpscalePatternsAVX2(const uint8_t *visRow, const uint8_t *nextVisRow, uint16_t from, const uint16_t to,
+                                            uint8_t *patternsVisible, uint8_t *patternsExplored)
+{
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i two = _mm256_set1_epi8(2);
+    for (; from + 32 <= to; from += 32) {
+        const __m256i n[4] = {_mm256_loadu_si256(reinterpret_cast<const __m256i *>(&visRow[from])),
+                              _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&visRow[from + 1])),
+                              _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&nextVisRow[from])),
+                              _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&nextVisRow[from + 1]))};
+        __m256i visible  = _mm256_setzero_si256();
+        __m256i explored = _mm256_setzero_si256();
+        for (const __m256i &cell : n) {
+            visible  = _mm256_add_epi8(_mm256_add_epi8(visible, visible), _mm256_min_epu8(_mm256_and_si256(cell, two), one));
+            explored = _mm256_add_epi8(_mm256_add_epi8(explored, explored), _mm256_min_epu8(cell, one));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(&patternsVisible[from]), visible);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(&patternsExplored[from]), explored);
+    }
+    return from;
+}
+
+TARGET_AVX2 uint16_t FogBilinearRowAVX2(const uint32_t *top, const uint32_t *bottom, uint16_t from, const uint16_t to,
+                                        const uint32_t yDiff, uint32_t *target, const uint8_t aShift, const uint32_t fogColor)
+{
+    const __m256i oneMinusY = _mm256_set1_epi32(65536 - yDiff);
+    const __m256i y         = _mm256_set1_epi32(yDiff);
+    const __m256i lowHalf   = _mm256_set1_epi32(0xFFFF);
+    const __m256i color     = _mm256_set1_epi32(fogColor);
+    const __m128i shift     = _mm_cvtsi32_si128(aShift);
+
+    for (; from + 8 <= to; from += 8) {
+        const __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&top[from]));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&bottom[from]));
+
+        /// value = high * 2^16 + low, where high < 2^24 and low < 2^32
+        const __m256i high = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(t, 16), oneMinusY),
+                                              _mm256_mullo_epi32(_mm256_srli_epi32(b, 16), y));
+        const __m256i low  = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_and_si256(t, lowHalf), oneMinusY),
+                                              _mm256_mullo_epi32(_mm256_and_si256(b, lowHalf), y));
+        const __m256i alpha = _mm256_srli_epi32(_mm256_add_epi32(high, _mm256_srli_epi32(low, 16)), 16);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(&target[from]),
+                            _mm256_or_si256(_mm256_sll_epi32(alpha, shift), color));
+    }
+    return from;
+}
+
+#endif // __x86_64__
+
+//@}
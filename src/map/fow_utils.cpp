@@ -36,6 +36,7 @@
 #include "fow_utils.h"
 
 #include "stratagus.h"
+#include "util.h"
 
 #include <algorithm>
 #include <cstring>
@@ -45,14 +46,252 @@
 ----------------------------------------------------------------------------*/
 
 
+/// Radius up to which the box blur of rows is vectorized, the vector kernels sum up the whole boxes
+constexpr uint8_t MaxSimdRowRadius = 16;
+/// Box sums have to fit into 16 bit lanes, like into int16_t of the scalar code
+constexpr uint8_t MaxSimdColumnRadius = 63;
+
 /*----------------------------------------------------------------------------
 --  Variables
 ----------------------------------------------------------------------------*/
 
+static FogSimdTypes FogSimd = supportsAVX2() ? FogSimdTypes::cAVX2
+                              : supportsSSE2() ? FogSimdTypes::cSSE2
+                              : FogSimdTypes::cScalar; /// Instruction set used by the fog of war kernels
+
+#ifdef __x86_64__
+//fow_simd.cpp
+extern uint16_t FogBlurRowSSE2(const uint8_t *source, uint8_t *target, uint16_t from, const uint16_t to,
+                               const uint8_t radius, const uint16_t iarr);
+extern uint16_t FogBlurColumnsSSE2(const uint8_t *source, uint8_t *target, const uint16_t width, const uint16_t height,
+                                   uint16_t from, const uint16_t to, const uint8_t radius, const uint16_t iarr);
+extern uint16_t FogUpscalePatternsSSE2(const uint8_t *visRow, const uint8_t *nextVisRow, uint16_t from, const uint16_t to,
+                                       uint8_t *patternsVisible, uint8_t *patternsExplored);
+extern uint16_t FogBilinearRowSSE2(const uint32_t *top, const uint32_t *bottom, uint16_t from, const uint16_t to,
+                                   const uint32_t yDiff, uint32_t *target, const uint8_t aShift, const uint32_t fogColor);
+extern uint16_t FogBlurRowAVX2(const uint8_t *source, uint8_t *target, uint16_t from, const uint16_t to,
+                               const uint8_t radius, const uint16_t iarr);
+extern uint16_t FogBlurColumnsAVX2(const uint8_t *source, uint8_t *target, const uint16_t width, const uint16_t height,
+                                   uint16_t from, const uint16_t to, const uint8_t radius, const uint16_t iarr);
+extern uint16_t FogUpscalePatternsAVX2(const uint8_t *visRow, const uint8_t *nextVisRow, uint16_t from, const uint16_t to,
+                                       uint8_t *patternsVisible, uint8_t *patternsExplored);
+extern uint16_t FogBilinearRowAVX2(const uint32_t *top, const uint32_t *bottom, uint16_t from, const uint16_t to,
+                                   const uint32_t yDiff, uint32_t *target, const uint8_t aShift, const uint32_t fogColor);
+#endif
+
 
 /*----------------------------------------------------------------------------
 -- Functions
 ----------------------------------------------------------------------------*/
+/**
+**  Instruction set used by the fog of war kernels
+**
+*/
+FogSimdTypes GetFogSimdType()
+{
+    return FogSimd;
+}
+
+/**
+**  Select the instruction set for the fog of war kernels. The best supported one is used by default.
+**
+**  @param type instruction set to use
+**
+**  @return true if success, false if the CPU doesn't support it
+*/
+bool SetFogSimdType(const FogSimdTypes type)
+{
+    switch (type) {
+        case FogSimdTypes::cAVX2:
+            if (!supportsAVX2()) {
+                return false;
+            }
+            break;
+        case FogSimdTypes::cSSE2:
+            if (!supportsSSE2()) {
+                return false;
+            }
+            break;
+        default:
+            break;
+    }
+    FogSimd = type;
+    return true;
+}
+
+/**
+**  Determine upscale patterns (indexes in the upscale tables) of a row of 4x4 blocks
+**  for Visible and Explored layers. The same as CFogOfWar::DeterminePattern does.
+**
+**  @param visRow           row of the vision table
+**  @param nextVisRow       next row of the vision table
+**  @param count            number of the blocks
+**  @param patternsVisible  patterns for Visible layer
+**  @param patternsExplored patterns for Explored layer
+**
+*/
+void FogUpscalePatterns(const uint8_t *visRow, const uint8_t *nextVisRow, const uint16_t count,
+                        uint8_t *patternsVisible, uint8_t *patternsExplored)
+{
+    uint16_t block = 0;
+#ifdef __x86_64__
+    switch (FogSimd) {
+        case FogSimdTypes::cAVX2:
+            block = FogUpscalePatternsAVX2(visRow, nextVisRow, block, count, patternsVisible, patternsExplored);
+            [[fallthrough]];
+        case FogSimdTypes::cSSE2:
+            block = FogUpscalePatternsSSE2(visRow, nextVisRow, block, count, patternsVisible, patternsExplored);
+            break;
+        default:
+            break;
+    }
+#endif
+    /// Vision table cells are 0 (unseen), 1 (explored) or 2 (visible)
+    for (; block < count; block++) {
+        const uint8_t n[4] = {visRow[block], visRow[block + 1], nextVisRow[block], nextVisRow[block + 1]};
+        uint8_t visible  = 0;
+        uint8_t explored = 0;
+        for (const uint8_t cell : n) {
+            visible  = (visible << 1)  | (cell >> 1);
+            explored = (explored << 1) | (cell != 0);
+        }
+        patternsVisible[block]  = visible;
+        patternsExplored[block] = explored;
+    }
+}
+
+/**
+** Bilinear zoom Fog Of War texture into SDL surface
+**
+**  @param src          Image src.
+**  @param srcRect      Rectangle in the src image to render
+**  @param srcWidth     Image width
+**  @param trgSurface   Where to render
+**  @param trgRect      Scale src rectangle to this rectangle
+**  @param fogColor     Fog color in the format of the surface
+**
+*/
+void FogUpscaleBilinear(const uint8_t *const src, const SDL_Rect &srcRect, const int16_t srcWidth,
+                        SDL_Surface *const trgSurface, const SDL_Rect &trgRect, const uint32_t fogColor)
+{
+    constexpr int32_t fixedOne = 65536;
+
+    uint32_t *const target = (uint32_t*)trgSurface->pixels;
+    const uint16_t AShift = trgSurface->format->Ashift;
+
+    /// FIXME: '-1' shouldn't be here, but without it the resulting fog has a shift to the left and upward
+    const int32_t xRatio = (int32_t(srcRect.w - 1) << 16) / trgRect.w;
+    const int32_t yRatio = (int32_t(srcRect.h - 1) << 16) / trgRect.h;
+
+#ifdef __x86_64__
+    if (FogSimd != FogSimdTypes::cScalar) {
+        /// Horizontal interpolation is the same for all the target rows between two source rows,
+        /// so it is done once for them, and the vector kernels do the vertical one
+        std::vector<int32_t>  xSrcs(trgRect.w);
+        std::vector<uint32_t> xDiffs(trgRect.w);
+        int64_t x = int32_t(srcRect.x) << 16;
+        for (uint16_t xTrg = 0; xTrg < trgRect.w; xTrg++) {
+            xSrcs[xTrg]  = int32_t(x >> 16);
+            xDiffs[xTrg] = uint32_t(x - (xSrcs[xTrg] << 16));
+            x += xRatio;
+        }
+
+        #pragma omp parallel
+        {
+            const uint16_t thisThread   = omp_get_thread_num();
+            const uint16_t numOfThreads = omp_get_num_threads();
+
+            const uint16_t lBound = (thisThread    ) * trgRect.h / numOfThreads;
+            const uint16_t uBound = (thisThread + 1) * trgRect.h / numOfThreads;
+
+            size_t  trgIndex = size_t(trgRect.y + lBound) * trgSurface->w + trgRect.x;
+            int64_t y        = ((int32_t)srcRect.y << 16) + lBound * yRatio;
+
+            std::vector<uint32_t> top(trgRect.w);
+            std::vector<uint32_t> bottom(trgRect.w);
+            int32_t interpolatedRow = -1;
+
+            for (uint16_t yTrg = lBound; yTrg < uBound; yTrg++) {
+
+                const int32_t  ySrc  = int32_t(y >> 16);
+                const uint32_t yDiff = uint32_t(y - (ySrc << 16));
+
+                if (ySrc != interpolatedRow) {
+                    const size_t yIndex = ySrc * srcWidth;
+                    for (uint16_t xTrg = 0; xTrg < trgRect.w; xTrg++) {
+                        const size_t   srcIndex      = yIndex + xSrcs[xTrg];
+                        const uint32_t xDiff         = xDiffs[xTrg];
+                        const uint32_t one_min_xDiff = fixedOne - xDiff;
+
+                        top[xTrg]    = src[srcIndex] * one_min_xDiff + src[srcIndex + 1] * xDiff;
+                        bottom[xTrg] = src[srcIndex + srcWidth] * one_min_xDiff + src[srcIndex + srcWidth + 1] * xDiff;
+                    }
+                    interpolatedRow = ySrc;
+                }
+
+                uint32_t *const trgRow = &target[trgIndex];
+                uint16_t xTrg = 0;
+                if (FogSimd == FogSimdTypes::cAVX2) {
+                    xTrg = FogBilinearRowAVX2(top.data(), bottom.data(), xTrg, trgRect.w, yDiff, trgRow, AShift, fogColor);
+                }
+                xTrg = FogBilinearRowSSE2(top.data(), bottom.data(), xTrg, trgRect.w, yDiff, trgRow, AShift, fogColor);
+                for (; xTrg < trgRect.w; xTrg++) {
+                    const uint32_t alpha = (uint64_t(top[xTrg]) * (fixedOne - yDiff) + uint64_t(bottom[xTrg]) * yDiff) >> 32;
+                    trgRow[xTrg] = (alpha << AShift) | fogColor;
+                }
+                y += yRatio;
+                trgIndex += trgSurface->w;
+            }
+        } /// pragma omp parallel
+        return;
+    }
+#endif
+
+    #pragma omp parallel
+    {
+        const uint16_t thisThread   = omp_get_thread_num();
+        const uint16_t numOfThreads = omp_get_num_threads();
+
+        const uint16_t lBound = (thisThread    ) * trgRect.h / numOfThreads;
+        const uint16_t uBound = (thisThread + 1) * trgRect.h / numOfThreads;
+
+        size_t  trgIndex = size_t(trgRect.y + lBound) * trgSurface->w + trgRect.x;
+        int64_t y        = ((int32_t)srcRect.y << 16) + lBound * yRatio;
+
+        for (uint16_t yTrg = lBound; yTrg < uBound; yTrg++) {
+
+            const int32_t ySrc          = int32_t(y >> 16);
+            const int64_t yDiff         = y - (ySrc << 16);
+            const int64_t one_min_yDiff = fixedOne - yDiff;
+            const size_t  yIndex        = ySrc * srcWidth;
+                  int64_t x             = int32_t(srcRect.x) << 16;
+
+            for (uint16_t xTrg = 0; xTrg < trgRect.w; xTrg++) {
+
+                const int32_t xSrc          = int32_t(x >> 16);
+                const int64_t xDiff         = x - (xSrc << 16);
+                const int64_t one_min_xDiff = fixedOne - xDiff;
+                const size_t  srcIndex      = yIndex + xSrc;
+
+                const uint8_t A = src[srcIndex];
+                const uint8_t B = src[srcIndex + 1];
+                const uint8_t C = src[srcIndex + srcWidth];
+                const uint8_t D = src[srcIndex + srcWidth + 1];
+
+                const uint32_t alpha = ((  A * one_min_xDiff * one_min_yDiff
+                                         + B * xDiff * one_min_yDiff
+                                         + C * yDiff * one_min_xDiff
+                                         + D * xDiff * yDiff ) >> 32 );
+
+                target[trgIndex + xTrg] = (alpha << AShift) | fogColor;
+                x += xRatio;
+            }
+            y += yRatio;
+            trgIndex += trgSurface->w;
+        }
+    } /// pragma omp parallel
+}
+
 /**
 **  Init eased texture
 **
@@ -80,6 +319,9 @@ void CEasedTexture::Init(const uint16_t width, const uint16_t height, const uint
 
     EasingStepsNum  = numOfSteps;
     CurrentStep     = numOfSteps;
+
+    LastChanged = {0, 0, 0, 0};
+    NextStale   = {0, 0, 0, 0};
 }
 
 /**
@@ -97,6 +339,9 @@ void CEasedTexture::Clean()
     Height          = 0;
     EasingStepsNum  = 0;
     CurrentStep     = 0;
+
+    LastChanged = {0, 0, 0, 0};
+    NextStale   = {0, 0, 0, 0};
 }
 
 /**
@@ -121,9 +366,47 @@ void CEasedTexture::SetNumOfSteps (const uint8_t num)
 */
 void CEasedTexture::PushNext(const bool forcedShowNext /*= false*/)
 {
-    CalcDeltas();
+    PushNext(SDL_Rect {0, 0, Width, Height}, forcedShowNext);
+}
+
+/**
+**  Switch easing to the new frame of the texture, which differs from the current one
+**  only inside the given rectangle
+**
+**  @param changedRect    area of the texture changed since the current frame
+**  @param forcedShowNext cmd to immediately show next frame without easing
+**
+*/
+void CEasedTexture::PushNext(const SDL_Rect &changedRect, const bool forcedShowNext /*= false*/)
+{
+    /// Deltas of the previous switch are still there and have to be cleared as well
+    SDL_Rect deltasRect;
+    SDL_UnionRect(&changedRect, &LastChanged, &deltasRect);
+
+    CalcDeltas(deltasRect);
     SwapFrames();
     CurrentStep = forcedShowNext ? EasingStepsNum : 0;
+
+    /// The recycled frame is two switches old
+    LastChanged = changedRect;
+    NextStale   = deltasRect;
+}
+
+/**
+**  Make the next frame equal to the current one, so that only changed areas have to be redrawn in it
+**
+*/
+void CEasedTexture::SyncNext()
+{
+    const uint8_t *curr = Frames[Curr].data();
+    uint8_t       *next = Frames[Next].data();
+
+    size_t index = size_t(NextStale.y) * Width + NextStale.x;
+    for (uint16_t y = 0; y < NextStale.h; y++) {
+        std::copy_n(&curr[index], NextStale.w, &next[index]);
+        index += Width;
+    }
+    NextStale = {0, 0, 0, 0};
 }
 
 /**
@@ -166,8 +449,10 @@ void CEasedTexture::DrawRegion(uint8_t *target, const uint16_t trgWidth, const u
 /**
 **  Calculate deltas between next and current frames
 **
+**  @param rect area of the texture to calculate deltas for
+**
 */
-void CEasedTexture::CalcDeltas()
+void CEasedTexture::CalcDeltas(const SDL_Rect &rect)
 {
     const uint8_t *curr   = Frames[Curr].data();
     const uint8_t *next   = Frames[Next].data();
@@ -177,11 +462,15 @@ void CEasedTexture::CalcDeltas()
         const uint16_t thisThread   = omp_get_thread_num();
         const uint16_t numOfThreads = omp_get_num_threads();
 
-        const size_t lBound = TextureSize * (thisThread    ) / numOfThreads;
-        const size_t uBound = TextureSize * (thisThread + 1) / numOfThreads;
+        const uint16_t lBound = rect.h * (thisThread    ) / numOfThreads;
+        const uint16_t uBound = rect.h * (thisThread + 1) / numOfThreads;
 
-        for (size_t index = lBound; index < uBound; index++) {
-            Deltas[index] = (int16_t(next[index]) - curr[index]) / EasingStepsNum;
+        size_t rowIndex = size_t(rect.y + lBound) * Width + rect.x;
+        for (uint16_t row = lBound; row < uBound; row++) {
+            for (size_t index = rowIndex; index < rowIndex + rect.w; index++) {
+                Deltas[index] = (int16_t(next[index]) - curr[index]) / EasingStepsNum;
+            }
+            rowIndex += Width;
         }
     }
 }
@@ -256,8 +545,24 @@ void CBlurrer::Clean()
 **
 */
 void CBlurrer::Blur(uint8_t *const texture)
+{
+    Blur(texture, TextureWidth, TextureHeight);
+}
+
+/**
+** Blur a part of the texture, copied into a separate buffer (optimized for 1 chanel (alpha) textures)
+** Pixels closer than GetMargin() to the borders of the part are not the same as in the blurred whole texture,
+** unless the border is the border of the whole texture.
+**
+** @param  texture texture to blur (uint8_t)
+** @param  width   width of the texture, not greater than the one the blurrer was initialized for
+** @param  height  height of the texture, not greater than the one the blurrer was initialized for
+**
+*/
+void CBlurrer::Blur(uint8_t *const texture, const uint16_t width, const uint16_t height)
 {
     if (Radius * NumOfIterations == 0) { return; }
+    Assert(size_t(width) * height <= WorkingTexture.size());
 
     uint8_t *source = texture;
     uint8_t *target = WorkingTexture.data();
@@ -268,11 +573,26 @@ void CBlurrer::Blur(uint8_t *const texture)
             source = target;
             target = swap;
         }
-        ProceedIteration(source, target, HalfBoxes[i]);
+        ProceedIteration(source, target, width, height, HalfBoxes[i]);
     }
     if (target != texture) {
-        std::copy(WorkingTexture.begin(), WorkingTexture.end(), texture);
+        std::copy_n(WorkingTexture.begin(), size_t(width) * height, texture);
+    }
+}
+
+/**
+**  Distance from the changed pixels beyond which blurring doesn't change anything
+**
+*/
+uint16_t CBlurrer::GetMargin() const
+{
+    if (Radius * NumOfIterations == 0) { return 0; }
+
+    uint16_t margin = 0;
+    for (const uint8_t halfBox : HalfBoxes) {
+        margin += halfBox;
     }
+    return margin;
 }
 
 /**
@@ -280,56 +600,31 @@ void CBlurrer::Blur(uint8_t *const texture)
 **
 **  @param  source  source texture (which has to be blurred)
 **  @param  target  target texture (where result will be)
+**  @param  width   width of the texture
+**  @param  height  height of the texture
 **  @param  radius  blur radius (box size) for current iteration
 **
 */
-void CBlurrer::ProceedIteration(uint8_t *source, uint8_t *target, const uint8_t radius)
+void CBlurrer::ProceedIteration(uint8_t *source, uint8_t *target, const uint16_t width, const uint16_t height,
+                                const uint8_t radius)
 {
-    constexpr uint32_t fixedOneHalf = 32768; // 0.5
-
-    std::copy_n(&source[0], WorkingTexture.size(), target);
+    std::copy_n(&source[0], size_t(width) * height, target);
 
     uint8_t *swap = source;
     source = target;
     target = swap;
 
-    /// *fixed point math
-    const uint32_t iarr = (1 << 16) / (2 * radius + 1);
-
     /// Horizontal blur pass
     #pragma omp parallel
     {
         const uint16_t thisThread   = omp_get_thread_num();
         const uint16_t numOfThreads = omp_get_num_threads();
 
-        const uint16_t lBound = TextureHeight * (thisThread    ) / numOfThreads;
-        const uint16_t uBound = TextureHeight * (thisThread + 1) / numOfThreads;
+        const uint16_t lBound = height * (thisThread    ) / numOfThreads;
+        const uint16_t uBound = height * (thisThread + 1) / numOfThreads;
 
         for (uint16_t i = lBound; i < uBound; i++) {
-
-            size_t ti = size_t(i) * TextureWidth;
-            size_t li = ti;
-            size_t ri = ti + radius;
-
-            const uint8_t leftBorder  = source[ti];
-            const uint8_t rightBorder = source[ti + TextureWidth - 1];
-                  int16_t sum         = int16_t(radius + 1) * leftBorder;
-
-            for (uint16_t j = 0; j < radius; j++) {
-                sum += source[ti + j];
-            }
-            for (uint16_t j = 0; j <= radius; j++) {
-                sum += source[ri++] - leftBorder;
-                target[ti++] = (iarr * sum + fixedOneHalf) >> 16;
-            }
-            for (uint16_t j = radius + 1; j < TextureWidth - radius; j++) {
-                sum += source[ri++] - source[li++];
-                target[ti++] = (iarr * sum + fixedOneHalf) >> 16;
-            }
-            for (uint16_t j = TextureWidth - radius; j < TextureWidth; j++) {
-                sum += rightBorder - source[li++];
-                target[ti++] = (iarr * sum + fixedOneHalf) >> 16;
-            }
+            BlurRow(&source[size_t(i) * width], &target[size_t(i) * width], width, radius);
         }
     } // pragma omp parallel
 
@@ -343,43 +638,142 @@ void CBlurrer::ProceedIteration(uint8_t *source, uint8_t *target, const uint8_t
         const uint16_t thisThread   = omp_get_thread_num();
         const uint16_t numOfThreads = omp_get_num_threads();
 
-        const uint16_t lBound = TextureWidth * (thisThread    ) / numOfThreads;
-        const uint16_t uBound = TextureWidth * (thisThread + 1) / numOfThreads;
+        const uint16_t lBound = width * (thisThread    ) / numOfThreads;
+        const uint16_t uBound = width * (thisThread + 1) / numOfThreads;
 
-        for (uint16_t i = lBound; i < uBound; i++) {
+        BlurColumns(source, target, width, height, lBound, uBound, radius);
+    } // pragma omp parallel
+}
 
-            size_t ti = i;
-            size_t li = ti;
-            size_t ri = ti + radius * TextureWidth;
+/**
+**  Horizontal box blur of one row of the texture
+**
+**  @param  source  row to blur
+**  @param  target  where to put the result
+**  @param  width   width of the row
+**  @param  radius  blur radius (box size)
+**
+*/
+void CBlurrer::BlurRow(const uint8_t *source, uint8_t *target, const uint16_t width, const uint8_t radius) const
+{
+    constexpr uint32_t fixedOneHalf = 32768; // 0.5
 
-            const uint8_t leftBorder  = source[ti];
-            const uint8_t rightBorder = source[ti + TextureWidth * (TextureHeight - 1)];
-                  int16_t sum         = int16_t(radius + 1) * leftBorder;
+    /// *fixed point math
+    const uint32_t iarr = (1 << 16) / (2 * radius + 1);
 
-            for (uint16_t j = 0; j < radius; j++) {
-                sum += source[ti + j * TextureWidth];
-            }
-            for (uint16_t j = 0; j <= radius ; j++) {
-                sum += source[ri] - leftBorder;
-                target[ti] = (iarr * sum + fixedOneHalf) >> 16;
-                ri += TextureWidth;
-                ti += TextureWidth;
-            }
-            for (uint16_t j = radius + 1; j < TextureHeight - radius; j++) {
-                sum += source[ri] - source[li];
-                target[ti] = (iarr * sum + fixedOneHalf) >> 16;
-                li += TextureWidth;
-                ri += TextureWidth;
-                ti += TextureWidth;
-            }
-            for (uint16_t j = TextureHeight - radius; j < TextureHeight; j++) {
-                sum += rightBorder - source[li];
-                target[ti] = (iarr * sum + fixedOneHalf) >> 16;
-                li += TextureWidth;
-                ti += TextureWidth;
+#ifdef __x86_64__
+    if (FogSimd != FogSimdTypes::cScalar && radius > 0 && radius <= MaxSimdRowRadius && width > 2 * radius) {
+        /// Boxes of the pixels near the borders are summed up the same way, with the border pixels repeated
+        auto blurPixel = [&](const uint16_t j) {
+            uint16_t sum = 0;
+            for (int k = j - radius; k <= j + radius; k++) {
+                sum += source[std::clamp(k, 0, width - 1)];
             }
+            target[j] = (iarr * sum + fixedOneHalf) >> 16;
+        };
+        for (uint16_t j = 0; j < radius; j++) {
+            blurPixel(j);
         }
-    } // pragma omp parallel
+        uint16_t j = radius;
+        if (FogSimd == FogSimdTypes::cAVX2) {
+            j = FogBlurRowAVX2(source, target, j, width - radius, radius, iarr);
+        }
+        j = FogBlurRowSSE2(source, target, j, width - radius, radius, iarr);
+        for (; j < width; j++) {
+            blurPixel(j);
+        }
+        return;
+    }
+#endif
+
+    size_t ti = 0;
+    size_t li = ti;
+    size_t ri = ti + radius;
+
+    const uint8_t leftBorder  = source[ti];
+    const uint8_t rightBorder = source[ti + width - 1];
+          int16_t sum         = int16_t(radius + 1) * leftBorder;
+
+    for (uint16_t j = 0; j < radius; j++) {
+        sum += source[ti + j];
+    }
+    for (uint16_t j = 0; j <= radius; j++) {
+        sum += source[ri++] - leftBorder;
+        target[ti++] = (iarr * sum + fixedOneHalf) >> 16;
+    }
+    for (uint16_t j = radius + 1; j < width - radius; j++) {
+        sum += source[ri++] - source[li++];
+        target[ti++] = (iarr * sum + fixedOneHalf) >> 16;
+    }
+    for (uint16_t j = width - radius; j < width; j++) {
+        sum += rightBorder - source[li++];
+        target[ti++] = (iarr * sum + fixedOneHalf) >> 16;
+    }
+}
+
+/**
+**  Vertical box blur of the columns of the texture
+**
+**  @param  source  texture to blur
+**  @param  target  where to put the result
+**  @param  width   width of the texture
+**  @param  height  height of the texture
+**  @param  from    first column to blur
+**  @param  to      column after the last one to blur
+**  @param  radius  blur radius (box size)
+**
+*/
+void CBlurrer::BlurColumns(const uint8_t *source, uint8_t *target, const uint16_t width, const uint16_t height,
+                           const uint16_t from, const uint16_t to, const uint8_t radius) const
+{
+    constexpr uint32_t fixedOneHalf = 32768; // 0.5
+
+    /// *fixed point math
+    const uint32_t iarr = (1 << 16) / (2 * radius + 1);
+
+    uint16_t i = from;
+#ifdef __x86_64__
+    if (FogSimd != FogSimdTypes::cScalar && radius > 0 && radius <= MaxSimdColumnRadius && height > 2 * radius) {
+        if (FogSimd == FogSimdTypes::cAVX2) {
+            i = FogBlurColumnsAVX2(source, target, width, height, i, to, radius, iarr);
+        }
+        i = FogBlurColumnsSSE2(source, target, width, height, i, to, radius, iarr);
+    }
+#endif
+
+    for (; i < to; i++) {
+
+        size_t ti = i;
+        size_t li = ti;
+        size_t ri = ti + radius * width;
+
+        const uint8_t leftBorder  = source[ti];
+        const uint8_t rightBorder = source[ti + width * (height - 1)];
+              int16_t sum         = int16_t(radius + 1) * leftBorder;
+
+        for (uint16_t j = 0; j < radius; j++) {
+            sum += source[ti + j * width];
+        }
+        for (uint16_t j = 0; j <= radius ; j++) {
+            sum += source[ri] - leftBorder;
+            target[ti] = (iarr * sum + fixedOneHalf) >> 16;
+            ri += width;
+            ti += width;
+        }
+        for (uint16_t j = radius + 1; j < height - radius; j++) {
+            sum += source[ri] - source[li];
+            target[ti] = (iarr * sum + fixedOneHalf) >> 16;
+            li += width;
+            ri += width;
+            ti += width;
+        }
+        for (uint16_t j = height - radius; j < height; j++) {
+            sum += rightBorder - source[li];
+            target[ti] = (iarr * sum + fixedOneHalf) >> 16;
+            li += width;
+            ti += width;
+        }
+    }
 }
 
 
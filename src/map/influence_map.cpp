@@ -0,0 +1,169 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name influence_map.cpp - The presence and threat of the players on the map. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+//@{
+
+/*----------------------------------------------------------------------------
+--  Includes
+----------------------------------------------------------------------------*/
+
+#include "stratagus.h"
+
+#include "influence_map.h"
+
+#include "player.h"
+#include "unit.h"
+#include "unittype.h"
+
+/*----------------------------------------------------------------------------
+--  Functions
+----------------------------------------------------------------------------*/
+
+/**
+**  Allocate the cells covering a map.
+**
+**  @param mapWidth   Width of the map in tiles.
+**  @param mapHeight  Height of the map in tiles.
+*/
+void CInfluenceMap::Init(int mapWidth, int mapHeight)
+{
+	Width = (mapWidth + CellSize - 1) >> CellShift;
+	Height = (mapHeight + CellSize - 1) >> CellShift;
+	Cells.assign(Width * Height, Cell());
+	Players.assign(Width * Height, 0);
+	Threats.assign(Width * Height, 0);
+	Totals.fill(0);
+	OnMap = 0;
+}
+
+/**
+**  Remove all the units and the cells.
+*/
+void CInfluenceMap::Clean()
+{
+	Width = 0;
+	Height = 0;
+	Cells.clear();
+	Players.clear();
+	Threats.clear();
+	Totals.fill(0);
+	OnMap = 0;
+}
+
+/**
+**  Add delta to the counts of player on the cells covered by the unit.
+*/
+void CInfluenceMap::Update(const CUnit &unit, int player, int delta, bool threat)
+{
+	const uint16_t bit = 1 << player;
+	const int minX = unit.tilePos.x >> CellShift;
+	const int minY = unit.tilePos.y >> CellShift;
+	const int maxX = std::min(Width - 1, (unit.tilePos.x + unit.Type->TileWidth - 1) >> CellShift);
+	const int maxY = std::min(Height - 1, (unit.tilePos.y + unit.Type->TileHeight - 1) >> CellShift);
+
+	for (int y = minY; y <= maxY; ++y) {
+		for (int x = minX; x <= maxX; ++x) {
+			const int index = y * Width + x;
+			Cell &cell = Cells[index];
+
+			cell.Units[player] += delta;
+			if (cell.Units[player]) {
+				Players[index] |= bit;
+			} else {
+				Players[index] &= ~bit;
+			}
+			if (threat) {
+				cell.Threats[player] += delta;
+				if (cell.Threats[player]) {
+					Threats[index] |= bit;
+				} else {
+					Threats[index] &= ~bit;
+				}
+			}
+		}
+	}
+	Totals[player] += delta;
+	if (Totals[player]) {
+		OnMap |= bit;
+	} else {
+		OnMap &= ~bit;
+	}
+}
+
+/**
+**  Count a unit at its position.
+**
+**  @param unit  Unit placed on the map.
+*/
+void CInfluenceMap::Insert(CUnit &unit)
+{
+	unit.InfluenceThreat = unit.Type->CanTarget != ECanTargetFlag::NulFlag;
+	Update(unit, unit.Player->Index, 1, unit.InfluenceThreat);
+}
+
+/**
+**  Uncount a unit, from the position where it was counted.
+**
+**  @param unit  Unit placed on the map.
+*/
+void CInfluenceMap::Remove(const CUnit &unit)
+{
+	Update(unit, unit.Player->Index, -1, unit.InfluenceThreat);
+}
+
+/**
+**  Move the count of a unit to its new owner.
+**
+**  @param unit       Unit placed on the map, already given to its new owner.
+**  @param oldPlayer  Index of the previous owner.
+*/
+void CInfluenceMap::ChangeOwner(const CUnit &unit, int oldPlayer)
+{
+	Update(unit, oldPlayer, -1, unit.InfluenceThreat);
+	Update(unit, unit.Player->Index, 1, unit.InfluenceThreat);
+}
+
+unsigned int CInfluenceMap::MaskIn(const std::vector<uint16_t> &masks, const Vec2i &ltPos, const Vec2i &rbPos) const
+{
+	const int minX = std::max(0, int(ltPos.x)) >> CellShift;
+	const int minY = std::max(0, int(ltPos.y)) >> CellShift;
+	const int maxX = std::min(Width - 1, rbPos.x >> CellShift);
+	const int maxY = std::min(Height - 1, rbPos.y >> CellShift);
+	unsigned int mask = 0;
+
+	for (int y = minY; y <= maxY; ++y) {
+		const uint16_t *row = &masks[y * Width];
+		for (int x = minX; x <= maxX; ++x) {
+			mask |= row[x];
+		}
+	}
+	return mask;
+}
+
+//@}
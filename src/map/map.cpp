@@ -40,6 +40,7 @@
 
 #include "fov.h"
 #include "iolib.h"
+#include "pathfinder.h"
 #include "player.h"
 #include "tileset.h"
 #include "unit.h"
@@ -71,13 +72,13 @@ char CurrentMapPath[1024];  /// Path of the current map
 void CMap::MarkSeenTile(CMapField &mf)
 {
 	const unsigned int tile = mf.getGraphicTile();
-	const unsigned int seentile = mf.playerInfo.SeenTile;
+	const unsigned int seentile = mf.playerInfo().SeenTile;
 
 	//  Nothing changed? Seeing already the correct tile.
 	if (tile == seentile) {
 		return;
 	}
-	mf.playerInfo.SeenTile = tile;
+	mf.playerInfo().SeenTile = tile;
 
 #ifdef MINIMAP_UPDATE
 	//rb - GRRRRRRRRRRRR
@@ -142,12 +143,13 @@ void CMap::Reveal(MapRevealModes mode /* = MapRevealModes::cKnown */ )
 	if (static_cast<int>(mode) >= static_cast<int>(MapRevealModes::cExplored)) {
 		for (int i = 0; i != this->Info.MapWidth * this->Info.MapHeight; ++i) {
 			CMapField &mf = *this->Field(i);
-			CMapFieldPlayerInfo &playerInfo = mf.playerInfo;
+			CMapFieldPlayerInfo &playerInfo = mf.playerInfo();
 			for (int p = 0; p < PlayerMax; ++p) {
 				playerInfo.Visible[p] = std::max<unsigned short>(1, playerInfo.Visible[p]);
 			}
 			MarkSeenTile(mf);
 		}
+		FogOfWar->InvalidateAll();
 	}
 
 	//  Global seen recount. Simple and effective.
@@ -290,7 +292,7 @@ void PreprocessMap()
 	for (int ix = 0; ix < Map.Info.MapWidth; ++ix) {
 		for (int iy = 0; iy < Map.Info.MapHeight; ++iy) {
 			CMapField &mf = *Map.Field(ix, iy);
-			mf.playerInfo.SeenTile = mf.getGraphicTile();
+			mf.playerInfo().SeenTile = mf.getGraphicTile();
 		}
 	}
 	// it is required for fixing the wood that all tiles are marked as seen!
@@ -303,6 +305,7 @@ void PreprocessMap()
 			}
 		}
 	}
+	Map.InitForestRegrowth();
 }
 
 /**
@@ -325,7 +328,22 @@ void CMapInfo::Clear()
 */
 void CMap::Create()
 {
-	this->Fields.resize(this->Info.MapWidth * this->Info.MapHeight);
+	const size_t size = this->Info.MapWidth * this->Info.MapHeight;
+
+	this->Fields.resize(size);
+	this->FieldsPlayerInfo.resize(size);
+	this->FieldsUnitCache.resize(size);
+}
+
+/**
+**  Free the map table.
+*/
+void CMap::ClearFields()
+{
+	this->Fields.clear();
+	this->FieldsPlayerInfo.clear();
+	this->FieldsUnitCache.clear();
+	this->ForestRegrowth.clear();
 }
 
 /**
@@ -343,7 +361,9 @@ void CMap::Init()
 */
 void CMap::Clean(const bool isHardClean /* = false*/)
 {
-	this->Fields.clear();
+	this->ClearFields();
+	this->UnitGrid.Clean();
+	this->Influence.Clean();
 
 	// Tileset freed by Tileset?
 
@@ -399,6 +419,12 @@ void CMap::Save(CFile &file) const
 			}
 		}
 	}
+	file.printf("},\n");
+	file.printf("  \"forest-regrowth\", {");
+	int count = 0;
+	for (const unsigned int index : this->ForestRegrowth) {
+		file.printf(count++ % 16 ? " %u," : "\n  %u,", index);
+	}
 	file.printf("}})\n");
 }
 
@@ -424,8 +450,8 @@ void CMap::FixTile(tile_flags type, int seen, const Vec2i &pos)
 	unsigned int index = getIndex(pos);
 	CMapField &mf = *this->Field(index);
 
-	if (!((type == MapFieldForest && Tileset.isAWoodTile(mf.playerInfo.SeenTile))
-		  || (type == MapFieldRocks && Tileset.isARockTile(mf.playerInfo.SeenTile)))) {
+	if (!((type == MapFieldForest && Tileset.isAWoodTile(mf.playerInfo().SeenTile))
+		  || (type == MapFieldRocks && Tileset.isARockTile(mf.playerInfo().SeenTile)))) {
 		if (seen) {
 			return;
 		}
@@ -454,51 +480,54 @@ void CMap::FixTile(tile_flags type, int seen, const Vec2i &pos)
 		ttup = -1; //Assign trees in all directions
 	} else {
 		const CMapField &new_mf = *(&mf - this->Info.MapWidth);
-		ttup = seen ? new_mf.playerInfo.SeenTile : new_mf.getGraphicTile();
+		ttup = seen ? new_mf.playerInfo().SeenTile : new_mf.getGraphicTile();
 	}
 	if (pos.x + 1 >= this->Info.MapWidth) {
 		ttright = -1; //Assign trees in all directions
 	} else {
 		const CMapField &new_mf = *(&mf + 1);
-		ttright = seen ? new_mf.playerInfo.SeenTile : new_mf.getGraphicTile();
+		ttright = seen ? new_mf.playerInfo().SeenTile : new_mf.getGraphicTile();
 	}
 	if (pos.y + 1 >= this->Info.MapHeight) {
 		ttdown = -1; //Assign trees in all directions
 	} else {
 		const CMapField &new_mf = *(&mf + this->Info.MapWidth);
-		ttdown = seen ? new_mf.playerInfo.SeenTile : new_mf.getGraphicTile();
+		ttdown = seen ? new_mf.playerInfo().SeenTile : new_mf.getGraphicTile();
 	}
 	if (pos.x - 1 < 0) {
 		ttleft = -1; //Assign trees in all directions
 	} else {
 		const CMapField &new_mf = *(&mf - 1);
-		ttleft = seen ? new_mf.playerInfo.SeenTile : new_mf.getGraphicTile();
+		ttleft = seen ? new_mf.playerInfo().SeenTile : new_mf.getGraphicTile();
 	}
 	int tile = this->Tileset.getTileBySurrounding(type, ttup, ttright, ttdown, ttleft);
 
 	//Update seen tile.
 	if (tile == -1) { // No valid wood remove it.
 		if (seen) {
-			mf.playerInfo.SeenTile = removedtile;
+			mf.playerInfo().SeenTile = removedtile;
 			this->FixNeighbors(type, seen, pos);
 		} else {
 			mf.setGraphicTile(removedtile);
 			mf.resetFlag(flags);
 			mf.Value = 0;
 			UI.Minimap.UpdateXY(pos);
+			if (type == MapFieldForest) {
+				this->ForestRegrowth.insert(index);
+			}
 		}
-	} else if (seen && this->Tileset.isEquivalentTile(tile, mf.playerInfo.SeenTile)) { //Same Type
+	} else if (seen && this->Tileset.isEquivalentTile(tile, mf.playerInfo().SeenTile)) { //Same Type
 		return;
 	} else {
 		if (seen) {
-			mf.playerInfo.SeenTile = tile;
+			mf.playerInfo().SeenTile = tile;
 		} else {
 			mf.setGraphicTile(tile);
 		}
 	}
 
 	//maybe isExplored
-	if (mf.playerInfo.IsTeamVisible(*ThisPlayer)) {
+	if (mf.playerInfo().IsTeamVisible(*ThisPlayer)) {
 		UI.Minimap.UpdateSeenXY(pos);
 		if (!seen) {
 			MarkSeenTile(mf);
@@ -546,6 +575,7 @@ void CMap::ClearTile(const Vec2i &tilePos)
 	if (isOpaque) {
 		MapRefreshUnitsSight(tilePos, true);
 		mapField.resetFlag(MapFieldOpaque);
+		FieldOfView.TerrainChanged();
 	}
 	if (mapField.ForestOnMap()) {
 		ClearWoodTile(tilePos);
@@ -570,12 +600,16 @@ void CMap::ClearWoodTile(const Vec2i &pos)
 				 | MapFieldForest
 				 | MapFieldUnpassable);
 	mf.Value = 0;
+	this->ForestRegrowth.insert(getIndex(pos));
 
 	UI.Minimap.UpdateXY(pos);
 	FixNeighbors(MapFieldForest, 0, pos);
+	// Neighbors may have lost their resource too
+	PathfinderTerrainChanged(pos - Vec2i(1, 1), 3, 3);
+	FieldOfView.TerrainChanged();
 
 	//maybe isExplored
-	if (mf.playerInfo.IsTeamVisible(*ThisPlayer)) {
+	if (mf.playerInfo().IsTeamVisible(*ThisPlayer)) {
 		UI.Minimap.UpdateSeenXY(pos);
 		MarkSeenTile(mf);
 	}
@@ -592,9 +626,12 @@ void CMap::ClearRockTile(const Vec2i &pos)
 
 	UI.Minimap.UpdateXY(pos);
 	FixNeighbors(MapFieldRocks, 0, pos);
+	// Neighbors may have lost their resource too
+	PathfinderTerrainChanged(pos - Vec2i(1, 1), 3, 3);
+	FieldOfView.TerrainChanged();
 
 	//maybe isExplored
-	if (mf.playerInfo.IsTeamVisible(*ThisPlayer)) {
+	if (mf.playerInfo().IsTeamVisible(*ThisPlayer)) {
 		UI.Minimap.UpdateSeenXY(pos);
 		MarkSeenTile(mf);
 	}
@@ -639,7 +676,7 @@ void CMap::RegenerateForestTile(const Vec2i &pos)
 		DebugPrint("Real place wood\n");
 		topMf.setTileIndex(Map.Tileset, Map.Tileset.getDefaultWoodTileIndex(), 0, mf.getElevation());
 		topMf.setGraphicTile(Map.Tileset.getTopOneTreeTile());
-		topMf.playerInfo.SeenTile = topMf.getGraphicTile();
+		topMf.playerInfo().SeenTile = topMf.getGraphicTile();
 		topMf.Value = 100; // TODO: Should be DefaultResourceAmounts[WoodCost] once all games are migrated
 		topMf.setFlag(MapFieldForest | MapFieldUnpassable);
 		UI.Minimap.UpdateSeenXY(pos + offset);
@@ -648,19 +685,21 @@ void CMap::RegenerateForestTile(const Vec2i &pos)
 
 		mf.setTileIndex(Map.Tileset, Map.Tileset.getDefaultWoodTileIndex(), 0, mf.getElevation());
 		mf.setGraphicTile(Map.Tileset.getBottomOneTreeTile());
-		mf.playerInfo.SeenTile = mf.getGraphicTile();
+		mf.playerInfo().SeenTile = mf.getGraphicTile();
 		mf.Value = 100; // TODO: Should be DefaultResourceAmounts[WoodCost] once all games are migrated
 		mf.setFlag(MapFieldForest | MapFieldUnpassable);
 		UI.Minimap.UpdateSeenXY(pos);
 		UI.Minimap.UpdateXY(pos);
-		if (mf.playerInfo.IsTeamVisible(*ThisPlayer)) {
+		if (mf.playerInfo().IsTeamVisible(*ThisPlayer)) {
 			MarkSeenTile(mf);
 		}
-		if (Map.Field(pos + offset)->playerInfo.IsTeamVisible(*ThisPlayer)) {
+		if (Map.Field(pos + offset)->playerInfo().IsTeamVisible(*ThisPlayer)) {
 			MarkSeenTile(topMf);
 		}
 		FixNeighbors(MapFieldForest, 0, pos + offset);
 		FixNeighbors(MapFieldForest, 0, pos);
+		PathfinderTerrainChanged(pos - Vec2i(1, 2), 3, 4);
+		FieldOfView.TerrainChanged();
 	}
 }
 
@@ -675,10 +714,31 @@ void CMap::RegenerateForest()
 	if (ForestRegenerationFrequency != 1 && (GameCycle / CYCLES_PER_SECOND % ForestRegenerationFrequency) != 0) {
 		return; // not this second
 	}
-	Vec2i pos;
-	for (pos.y = 0; pos.y < Info.MapHeight; ++pos.y) {
-		for (pos.x = 0; pos.x < Info.MapWidth; ++pos.x) {
-			RegenerateForestTile(pos);
+	// In index order, as a scan of the whole map: fields whose wood is
+	// removed during the loop are visited if they come after the current one.
+	for (auto it = ForestRegrowth.begin(); it != ForestRegrowth.end();) {
+		const unsigned int index = *it;
+		RegenerateForestTile(Vec2i(index % Info.MapWidth, index / Info.MapWidth));
+		// Fields which grew (or whose wood was not removed anymore) leave the list
+		if (Field(index)->getGraphicTile() != Tileset.getRemovedTreeTile()) {
+			it = ForestRegrowth.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+/**
+**  Find the fields whose wood was removed on the whole map, for the forest
+**  regeneration.
+*/
+void CMap::InitForestRegrowth()
+{
+	ForestRegrowth.clear();
+	const unsigned int size = Info.MapWidth * Info.MapHeight;
+	for (unsigned int index = 0; index != size; ++index) {
+		if (Field(index)->getGraphicTile() == Tileset.getRemovedTreeTile()) {
+			ForestRegrowth.insert(index);
 		}
 	}
 }
@@ -700,11 +760,19 @@ void CMap::Insert(CUnit &unit)
 		CMapField *mf = Field(index);
 		int j = w;
 		do {
-			mf->UnitCache.push_back(&unit);
+			mf->UnitCache().push_back(&unit);
 			++mf;
 		} while (--j && unit.tilePos.x + (j - w) < Info.MapWidth);
 		index += Info.MapWidth;
 	} while (--i && unit.tilePos.y + (i - h) < Info.MapHeight);
+
+	if (!UnitGrid.IsInitialized()) {
+		UnitGrid.Init(Info.MapWidth, Info.MapHeight);
+		Influence.Init(Info.MapWidth, Info.MapHeight);
+	}
+	UnitGrid.Insert(unit);
+	Influence.Insert(unit);
+	UI.Minimap.UpdateUnit(unit);
 }
 
 /**
@@ -724,11 +792,29 @@ void CMap::Remove(CUnit &unit)
 		CMapField *mf = Field(index);
 		int j = w;
 		do {
-			ranges::erase(mf->UnitCache, &unit);
+			ranges::erase(mf->UnitCache(), &unit);
 			++mf;
 		} while (--j && unit.tilePos.x + (j - w) < Info.MapWidth);
 		index += Info.MapWidth;
 	} while (--i && unit.tilePos.y + (i - h) < Info.MapHeight);
+
+	UnitGrid.Remove(unit);
+	Influence.Remove(unit);
+	UI.Minimap.UpdateUnit(unit);
+}
+
+/**
+**  Move unit in cache to its new owner.
+**
+**  @param unit       Unit placed on the map, already given to its new owner.
+**  @param oldPlayer  Index of the previous owner.
+*/
+void CMap::ChangeOwner(CUnit &unit, int oldPlayer)
+{
+	Assert(!unit.Removed);
+	UnitGrid.ChangeOwner(unit, oldPlayer);
+	Influence.ChangeOwner(unit, oldPlayer);
+	UI.Minimap.UpdateUnit(unit);
 }
 
 void CMap::Clamp(Vec2i &pos) const
@@ -262,8 +262,164 @@ void CViewport::DrawMapGridInViewport() const
 	}
 }
 
+/// Tiles drawn in the background cache beyond each side of the viewport
+static constexpr int BackgroundMargin = 4;
+/// Background cache tile which must be drawn again
+static constexpr int InvalidBackgroundTile = -1;
+/// Background cache tile left black: off the map, or hidden by the fog
+static constexpr int BlankBackgroundTile = -2;
+
+/**
+**  Move the background cache so its top left tile is origin.
+**
+**  The pixels and the tiles still covered are moved within the surface,
+**  the others are marked to be drawn again.
+**
+**  @param origin  New map tile at the top left of the cache.
+*/
+void CViewport::ScrollBackgroundCache(const Vec2i &origin)
+{
+	const Vec2i shift = this->BackgroundOrigin - origin;
+	const Vec2i &size = this->BackgroundSize;
+	const int width = size.x - std::abs(shift.x);
+	const int height = size.y - std::abs(shift.y);
+
+	this->BackgroundOrigin = origin;
+	if (width <= 0 || height <= 0) {
+		ranges::fill(this->BackgroundTiles, InvalidBackgroundTile);
+		return;
+	}
+	SDL_Surface *surface = this->BackgroundSurface;
+	Assert(SDL_MUSTLOCK(surface) == 0);
+	const int bpp = surface->format->BytesPerPixel;
+	const int srcX = std::max(0, -shift.x);
+	const int srcY = std::max(0, -shift.y);
+	const int dstX = std::max(0, int(shift.x));
+	const int dstY = std::max(0, int(shift.y));
+	const size_t lineSize = width * PixelTileSize.x * bpp;
+
+	// Rows move down when shift.y > 0: start from the bottom not to overwrite them
+	for (int i = 0; i != height; ++i) {
+		const int row = shift.y > 0 ? height - 1 - i : i;
+		int *tiles = this->BackgroundTiles.data();
+
+		memmove(&tiles[(dstY + row) * size.x + dstX], &tiles[(srcY + row) * size.x + srcX], width * sizeof(int));
+		for (int line = 0; line != PixelTileSize.y; ++line) {
+			const int pixelLine = shift.y > 0 ? PixelTileSize.y - 1 - line : line;
+			Uint8 *pixels = static_cast<Uint8 *>(surface->pixels);
+			Uint8 *dst = pixels + ((dstY + row) * PixelTileSize.y + pixelLine) * surface->pitch + dstX * PixelTileSize.x * bpp;
+			const Uint8 *src = pixels + ((srcY + row) * PixelTileSize.y + pixelLine) * surface->pitch + srcX * PixelTileSize.x * bpp;
+
+			memmove(dst, src, lineSize);
+		}
+	}
+	for (int y = 0; y != size.y; ++y) {
+		for (int x = 0; x != size.x; ++x) {
+			if (x < dstX || x >= dstX + width || y < dstY || y >= dstY + height) {
+				this->BackgroundTiles[y * size.x + x] = InvalidBackgroundTile;
+			}
+		}
+	}
+}
+
+/**
+**  Draw the map background from the background cache.
+**
+**  The cache is a surface with the tiles of the viewport and of a margin
+**  around it, kept from one frame to the next. Only its tiles whose graphic
+**  changed since they were drawn are blitted again, it is moved with the
+**  viewport when it scrolls out of it, then blitted in one go on the screen.
+**
+**  @param canShortcut  Leave the tiles hidden by the fog black.
+**
+**  @return  false if the cache could not be allocated, and nothing was drawn.
+*/
+bool CViewport::DrawMapBackgroundFromCache(bool canShortcut)
+{
+	const PixelSize pixelSize = this->GetPixelSize();
+	const Vec2i viewSize((this->Offset.x + pixelSize.x) / PixelTileSize.x + 1,
+	                     (this->Offset.y + pixelSize.y) / PixelTileSize.y + 1);
+	const Vec2i margin(BackgroundMargin, BackgroundMargin);
+	const Vec2i cacheSize(pixelSize.x / PixelTileSize.x + 2 + 2 * BackgroundMargin,
+	                      pixelSize.y / PixelTileSize.y + 2 + 2 * BackgroundMargin);
+	const unsigned int colorCycle = GetColorCycleCount();
+
+	if (this->BackgroundSurface == nullptr || this->BackgroundSize != cacheSize
+	    || this->BackgroundSurface->format->format != TheScreen->format->format) {
+		CleanBackground();
+		this->BackgroundSurface =
+			SDL_CreateRGBSurfaceWithFormat(SDL_SWSURFACE, cacheSize.x * PixelTileSize.x, cacheSize.y * PixelTileSize.y,
+			                               TheScreen->format->BitsPerPixel, TheScreen->format->format);
+		if (this->BackgroundSurface == nullptr) {
+			ErrorPrint("Can't create the background cache: %s\n", SDL_GetError());
+			return false;
+		}
+		SDL_SetSurfaceBlendMode(this->BackgroundSurface, SDL_BLENDMODE_NONE);
+		this->BackgroundSize = cacheSize;
+		this->BackgroundOrigin = this->MapPos - margin;
+		this->BackgroundTiles.assign(cacheSize.x * cacheSize.y, InvalidBackgroundTile);
+	} else if (this->BackgroundGraphic != Map.TileGraphic.get() || this->BackgroundCycle != colorCycle) {
+		ranges::fill(this->BackgroundTiles, InvalidBackgroundTile);
+	}
+	this->BackgroundGraphic = Map.TileGraphic.get();
+	this->BackgroundCycle = colorCycle;
+
+	const Vec2i viewEnd = this->MapPos + viewSize;
+	const Vec2i cacheEnd = this->BackgroundOrigin + this->BackgroundSize;
+	if (this->MapPos.x < this->BackgroundOrigin.x || this->MapPos.y < this->BackgroundOrigin.y
+	    || viewEnd.x > cacheEnd.x || viewEnd.y > cacheEnd.y) {
+		ScrollBackgroundCache(this->MapPos - margin);
+	}
+
+	const Uint32 black = SDL_MapRGB(this->BackgroundSurface->format, 0, 0, 0);
+	for (Vec2i pos = this->MapPos; pos.y != viewEnd.y; ++pos.y) {
+		const int cacheY = pos.y - this->BackgroundOrigin.y;
+		int *tiles = &this->BackgroundTiles[cacheY * this->BackgroundSize.x];
+
+		for (pos.x = this->MapPos.x; pos.x != viewEnd.x; ++pos.x) {
+			int tile = BlankBackgroundTile;
+			if (Map.Info.IsPointOnMap(pos) && (!canShortcut || FogOfWar->GetVisibilityForTile(pos))) {
+				const CMapField &mf = *Map.Field(pos);
+				tile = ReplayRevealMap ? mf.getGraphicTile() : mf.playerInfo().SeenTile;
+			}
+			int &cached = tiles[pos.x - this->BackgroundOrigin.x];
+			if (cached == tile) {
+				continue;
+			}
+			cached = tile;
+			const int x = (pos.x - this->BackgroundOrigin.x) * PixelTileSize.x;
+			const int y = cacheY * PixelTileSize.y;
+			if (tile == BlankBackgroundTile) {
+				SDL_Rect rect = {x, y, PixelTileSize.x, PixelTileSize.y};
+				SDL_FillRect(this->BackgroundSurface, &rect, black);
+			} else {
+				Map.TileGraphic->DrawFrame(tile, x, y, this->BackgroundSurface);
+			}
+		}
+	}
+
+	SDL_Rect srcRect = {(this->MapPos.x - this->BackgroundOrigin.x) * PixelTileSize.x + this->Offset.x,
+	                    (this->MapPos.y - this->BackgroundOrigin.y) * PixelTileSize.y + this->Offset.y,
+	                    pixelSize.x + 1,
+	                    pixelSize.y + 1};
+	SDL_Rect dstRect = {this->TopLeftPos.x, this->TopLeftPos.y, 0, 0};
+	SDL_BlitSurface(this->BackgroundSurface, &srcRect, TheScreen, &dstRect);
+	return true;
+}
+
+/**
+**  Free the background cache.
+*/
+void CViewport::CleanBackground()
+{
+	SDL_FreeSurface(this->BackgroundSurface);
+	this->BackgroundSurface = nullptr;
+	this->BackgroundGraphic = nullptr;
+	this->BackgroundTiles.clear();
+}
+
 template<bool graphicalTileIsLogicalTile>
-void CViewport::DrawMapBackgroundInViewport(const fieldHighlightChecker highlightChecker /* = nullptr */) const
+void CViewport::DrawMapBackgroundInViewport(const fieldHighlightChecker highlightChecker /* = nullptr */)
 {
 	int ex = this->BottomRightPos.x;
 	int ey = this->BottomRightPos.y;
@@ -290,6 +446,19 @@ void CViewport::DrawMapBackgroundInViewport(const fieldHighlightChecker highligh
 					  && FogOfWar->GetType() != FogOfWarTypes::cEnhanced
 					  && !ReplayRevealMap;
 	}
+	if constexpr(graphicalTileIsLogicalTile) {
+		// Without overlays on the tiles, draw them through the background cache
+		if (highlightChecker == nullptr && !CViewport::isPassabilityHighlighted()
+		    && this->DrawMapBackgroundFromCache(canShortcut)) {
+#ifdef DEBUG
+			DrawLastAStar(*this);
+#endif
+			if (CViewport::isGridEnabled()) {
+				DrawMapGridInViewport();
+			}
+			return;
+		}
+	}
 
 	while (sy < 0) {
 		if constexpr(graphicalTileIsLogicalTile) {
@@ -329,7 +498,7 @@ void CViewport::DrawMapBackgroundInViewport(const fieldHighlightChecker highligh
 			if (ReplayRevealMap) {
 				tile = mf.getGraphicTile();
 			} else {
-				tile = mf.playerInfo.SeenTile;
+				tile = mf.playerInfo().SeenTile;
 			}
 			Map.TileGraphic->DrawFrameClip(tile, dx, dy);
 #ifdef DEBUG
@@ -372,6 +541,11 @@ void CViewport::DrawMapBackgroundInViewport(const fieldHighlightChecker highligh
 	if (CViewport::isGridEnabled()) {
 		DrawMapGridInViewport();
 	}
+#ifdef DEBUG
+	if (CViewport::isPassabilityHighlighted() && Editor.Running == EditorNotRunning) {
+		DrawRegions(*this);
+	}
+#endif
 }
 
 /**
@@ -437,8 +611,9 @@ void CViewport::Draw(const fieldHighlightChecker highlightChecker /* = nullptr *
 	CurrentViewport = this;
 	{
 		// Now we need to sort units, missiles, particles by draw level and draw them
-		const std::vector<CUnit *> unittable = FindAndSortUnits(*this);
-		const std::vector<Missile *> missiletable = FindAndSortMissiles(*this);
+		const std::vector<CUnit *> &unittable = this->DrawUnits.Update(*this);
+		FindAndSortMissiles(*this, this->DrawMissiles);
+		const std::vector<Missile *> &missiletable = this->DrawMissiles;
 		const std::vector<CParticle *> particletable = ParticleManager.prepareToDraw(*this);
 
 		const size_t nunits = unittable.size();
@@ -527,7 +702,7 @@ void CViewport::Draw(const fieldHighlightChecker highlightChecker /* = nullptr *
 	if (clickMissile != nullptr) {
 		Vec2i pos = Map.MapPixelPosToTilePos(clickMissile->position);
 		Map.Clamp(pos);
-		if (Map.Field(pos.x, pos.y)->playerInfo.TeamVisibilityState(*ThisPlayer) != 2) {
+		if (Map.Field(pos.x, pos.y)->playerInfo().TeamVisibilityState(*ThisPlayer) != 2) {
 			// if this tile is not visible, we want to draw the click on top of
 			// the fog again
 			clickMissile->DrawMissile(*this);
@@ -552,7 +727,7 @@ void CViewport::Draw(const fieldHighlightChecker highlightChecker /* = nullptr *
 	//
 	if (CursorOn == ECursorOn::Map && Preference.ShowNameDelay && (ShowNameDelay < GameCycle) && (GameCycle < ShowNameTime)) {
 		const Vec2i tilePos = this->ScreenToTilePos(CursorScreenPos);
-		const bool isMapFieldVisible = Map.Field(tilePos)->playerInfo.IsTeamVisible(*ThisPlayer);
+		const bool isMapFieldVisible = Map.Field(tilePos)->playerInfo().IsTeamVisible(*ThisPlayer);
 
 		if (UI.MouseViewport->IsInsideMapArea(CursorScreenPos) && UnitUnderCursor
 			&& ((isMapFieldVisible && !UnitUnderCursor->Type->BoolFlag[ISNOTSELECTABLE_INDEX].value) || ReplayRevealMap)) {
@@ -41,6 +41,7 @@
 
 #include "actions.h"
 #include "fov.h"
+#include "fow.h"
 #include "minimap.h"
 #include "player.h"
 #include "tileset.h"
@@ -100,7 +101,7 @@ int MapFogFilterFlags(CPlayer &player, const unsigned int index, int mask)
 	int fogMask = mask;
 
 	_filter_flags filter(player, &fogMask);
-	for (auto* unit : Map.Field(index)->UnitCache) {
+	for (auto* unit : Map.Field(index)->UnitCache()) {
 		filter(unit);
 	}
 	return fogMask;
@@ -186,7 +187,7 @@ class _TileSeen
 static void UnitsOnTileMarkSeen(const CPlayer &player, CMapField &mf, int cloak)
 {
 	_TileSeen<true> seen(player, cloak);
-	for (auto *unit : mf.UnitCache) {
+	for (auto *unit : mf.UnitCache()) {
 		seen(unit);
 	}
 }
@@ -201,7 +202,7 @@ static void UnitsOnTileMarkSeen(const CPlayer &player, CMapField &mf, int cloak)
 static void UnitsOnTileUnmarkSeen(const CPlayer &player, CMapField &mf, int cloak)
 {
 	_TileSeen<false> seen(player, cloak);
-	for (auto* unit : mf.UnitCache) {
+	for (auto* unit : mf.UnitCache()) {
 		seen(unit);
 	}
 }
@@ -215,7 +216,7 @@ static void UnitsOnTileUnmarkSeen(const CPlayer &player, CMapField &mf, int cloa
 void MapMarkTileSight(const CPlayer &player, const unsigned int index)
 {
 	CMapField &mf = *Map.Field(index);
-	unsigned short *v = &(mf.playerInfo.Visible[player.Index]);
+	unsigned short *v = &(mf.playerInfo().Visible[player.Index]);
 
 	if (*v == 0 || *v == 1) { // Unexplored or unseen
 		// When there is no fog only unexplored tiles are marked.
@@ -223,7 +224,8 @@ void MapMarkTileSight(const CPlayer &player, const unsigned int index)
 			UnitsOnTileMarkSeen(player, mf, 0);
 		}
 		*v = 2;
-		if (mf.playerInfo.IsTeamVisible(*ThisPlayer)) {
+		FogOfWar->MarkDirty(player, index);
+		if (mf.playerInfo().IsTeamVisible(*ThisPlayer)) {
 			Map.MarkSeenTile(mf);
 		}
 	} else {
@@ -261,7 +263,7 @@ void MapMarkTileSight(const CPlayer &player, const Vec2i &pos)
 void MapUnmarkTileSight(const CPlayer &player, const unsigned int index)
 {
 	CMapField &mf = *Map.Field(index);
-	unsigned short *v = &mf.playerInfo.Visible[player.Index];
+	unsigned short *v = &mf.playerInfo().Visible[player.Index];
 	switch (*v) {
 		case 0:  // Unexplored
 		case 1:
@@ -272,9 +274,10 @@ void MapUnmarkTileSight(const CPlayer &player, const unsigned int index)
 			if (!Map.NoFogOfWar) {
 				UnitsOnTileUnmarkSeen(player, mf, 0);
 			}
+			FogOfWar->MarkDirty(player, index);
 			// Check visible Tile, then deduct...
 			/// TODO: change ThisPlayer to currently rendered player/players #RenderTargets
-			if (mf.playerInfo.IsTeamVisible(*ThisPlayer)) {
+			if (mf.playerInfo().IsTeamVisible(*ThisPlayer)) {
 				Map.MarkSeenTile(mf);
 			}
 		default:  // seen -> seen
@@ -298,9 +301,10 @@ void MapUnmarkTileSight(const CPlayer &player, const Vec2i &pos)
 void MapMarkTileDetectCloak(const CPlayer &player, const unsigned int index)
 {
 	CMapField &mf = *Map.Field(index);
-	unsigned char *v = &mf.playerInfo.VisCloak[player.Index];
+	unsigned char *v = &mf.playerInfo().VisCloak[player.Index];
 	if (*v == 0) {
 		UnitsOnTileMarkSeen(player, mf, 1);
+		UI.Minimap.UpdateUnitsXY(Vec2i(index % Map.Info.MapWidth, index / Map.Info.MapWidth));
 	}
 	Assert(*v != 255);
 	++*v;
@@ -320,7 +324,7 @@ void MapMarkTileDetectCloak(const CPlayer &player, const Vec2i &pos)
 void MapUnmarkTileDetectCloak(const CPlayer &player, const unsigned int index)
 {
 	CMapField &mf = *Map.Field(index);
-	unsigned char *v = &mf.playerInfo.VisCloak[player.Index];
+	unsigned char *v = &mf.playerInfo().VisCloak[player.Index];
 	///Assert(*v != 0);
 	/// This could happen if shadow caster type of field of view is enabled,
 	/// because of multiple calls for tiles in vertical/horizontal/diagonal lines
@@ -329,6 +333,7 @@ void MapUnmarkTileDetectCloak(const CPlayer &player, const unsigned int index)
 	}
 	if (*v == 1) {
 		UnitsOnTileUnmarkSeen(player, mf, 1);
+		UI.Minimap.UpdateUnitsXY(Vec2i(index % Map.Info.MapWidth, index / Map.Info.MapWidth));
 	}
 	--*v;
 }
@@ -353,6 +358,25 @@ void MapSight(const CPlayer &player, const CUnit &unit, const Vec2i &pos, int w,
 	FieldOfView.Refresh(player, unit, pos, w, h, range, marker);
 }
 
+/**
+**  Move the sight of unit to a neighbour location. Only the tiles which
+**  leave or enter the sight are unmarked or marked.
+**
+**  @param player    player to mark the sight for (not unit owner)
+**  @param oldPos    location before the step
+**  @param pos       location after the step
+**  @param w         width to mark, in square
+**  @param h         height to mark, in square
+**  @param range     Radius to mark.
+**  @param unmarker  Function to unmark sight
+**  @param marker    Function to mark sight
+*/
+void MapSightStep(const CPlayer &player, const CUnit &unit, const Vec2i &oldPos, const Vec2i &pos,
+				  int w, int h, int range, MapMarkerFunc *unmarker, MapMarkerFunc *marker)
+{
+	FieldOfView.RefreshStep(player, unit, oldPos, pos, w, h, range, unmarker, marker);
+}
+
 /**
 **  Update fog of war.
 */
@@ -364,7 +388,7 @@ void UpdateFogOfWarChange()
 		const unsigned int w = Map.Info.MapHeight * Map.Info.MapWidth;
 		for (unsigned int index = 0; index != w; ++index) {
 			CMapField &mf = *Map.Field(index);
-			if (mf.playerInfo.IsExplored(*ThisPlayer)) {
+			if (mf.playerInfo().IsExplored(*ThisPlayer)) {
 				Map.MarkSeenTile(mf);
 			}
 		}
@@ -447,6 +471,7 @@ void CViewport::Clean()
 	if (this->FogSurface) {
 		CleanFog();
 	}
+	CleanBackground();
 }
 
 void CViewport::CleanFog()
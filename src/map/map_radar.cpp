@@ -38,6 +38,7 @@
 #include "map.h"
 
 #include "player.h"
+#include "ui.h"
 #include "unittype.h"
 #include "unit.h"
 
@@ -92,7 +93,7 @@ bool CUnit::IsVisibleOnRadar(const CPlayer &pradar) const
 		const CMapField *mf = Map.Field(index);
 		int i = x_max;
 		do {
-			if (IsTileRadarVisible(pradar, *Player, mf->playerInfo) != 0) {
+			if (IsTileRadarVisible(pradar, *Player, mf->playerInfo()) != 0) {
 				return true;
 			}
 			++mf;
@@ -114,8 +115,10 @@ bool CUnit::IsVisibleOnRadar(const CPlayer &pradar) const
 */
 void MapMarkTileRadar(const CPlayer &player, const unsigned int index)
 {
-	Assert(Map.Field(index)->playerInfo.Radar[player.Index] != 255);
-	Map.Field(index)->playerInfo.Radar[player.Index]++;
+	Assert(Map.FieldsPlayerInfo[index].Radar[player.Index] != 255);
+	if (Map.FieldsPlayerInfo[index].Radar[player.Index]++ == 0) {
+		UI.Minimap.UpdateUnitsXY(Vec2i(index % Map.Info.MapWidth, index / Map.Info.MapWidth));
+	}
 }
 
 void MapMarkTileRadar(const CPlayer &player, int x, int y)
@@ -135,9 +138,11 @@ void MapMarkTileRadar(const CPlayer &player, int x, int y)
 void MapUnmarkTileRadar(const CPlayer &player, const unsigned int index)
 {
 	// Reduce radar coverage if it exists.
-	unsigned char *v = &(Map.Field(index)->playerInfo.Radar[player.Index]);
+	unsigned char *v = &(Map.FieldsPlayerInfo[index].Radar[player.Index]);
 	if (*v) {
-		--*v;
+		if (--*v == 0) {
+			UI.Minimap.UpdateUnitsXY(Vec2i(index % Map.Info.MapWidth, index / Map.Info.MapWidth));
+		}
 	}
 }
 
@@ -157,8 +162,10 @@ void MapUnmarkTileRadar(const CPlayer &player, int x, int y)
 */
 void MapMarkTileRadarJammer(const CPlayer &player, const unsigned int index)
 {
-	Assert(Map.Field(index)->playerInfo.RadarJammer[player.Index] != 255);
-	Map.Field(index)->playerInfo.RadarJammer[player.Index]++;
+	Assert(Map.FieldsPlayerInfo[index].RadarJammer[player.Index] != 255);
+	if (Map.FieldsPlayerInfo[index].RadarJammer[player.Index]++ == 0) {
+		UI.Minimap.UpdateUnitsXY(Vec2i(index % Map.Info.MapWidth, index / Map.Info.MapWidth));
+	}
 }
 
 void MapMarkTileRadarJammer(const CPlayer &player, int x, int y)
@@ -177,9 +184,11 @@ void MapMarkTileRadarJammer(const CPlayer &player, int x, int y)
 void MapUnmarkTileRadarJammer(const CPlayer &player, const unsigned int index)
 {
 	// Reduce radar coverage if it exists.
-	unsigned char *v = &(Map.Field(index)->playerInfo.RadarJammer[player.Index]);
+	unsigned char *v = &(Map.FieldsPlayerInfo[index].RadarJammer[player.Index]);
 	if (*v) {
-		--*v;
+		if (--*v == 0) {
+			UI.Minimap.UpdateUnitsXY(Vec2i(index % Map.Info.MapWidth, index / Map.Info.MapWidth));
+		}
 	}
 }
 
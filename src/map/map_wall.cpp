@@ -35,6 +35,7 @@
 
 #include "fov.h"
 #include "map.h"
+#include "pathfinder.h"
 #include "player.h"
 #include "stratagus.h"
 #include "tileset.h"
@@ -107,7 +108,7 @@ static int GetDirectionFromSurrounding(const Vec2i &pos, bool human, bool seen)
 			dirFlag |= 1 << i;
 		} else {
 			const CMapField &mf = *Map.Field(newpos);
-			const unsigned int tile = seen ? mf.playerInfo.SeenTile : mf.getGraphicTile();
+			const unsigned int tile = seen ? mf.playerInfo().SeenTile : mf.getGraphicTile();
 
 			if (Map.Tileset.isARaceWallTile(tile, human)) {
 				dirFlag |= 1 << i;
@@ -130,7 +131,7 @@ void MapFixSeenWallTile(const Vec2i &pos)
 	}
 	CMapField &mf = *Map.Field(pos);
 	const CTileset &tileset = Map.Tileset;
-	const unsigned tile = mf.playerInfo.SeenTile;
+	const unsigned tile = mf.playerInfo().SeenTile;
 	if (!tileset.isAWallTile(tile)) {
 		return;
 	}
@@ -138,10 +139,10 @@ void MapFixSeenWallTile(const Vec2i &pos)
 	const int dirFlag = GetDirectionFromSurrounding(pos, human, true);
 	const int wallTile = getWallTile(tileset, human, dirFlag, mf.Value, tile);
 
-	if (mf.playerInfo.SeenTile != wallTile) { // Already there!
-		mf.playerInfo.SeenTile = wallTile;
+	if (mf.playerInfo().SeenTile != wallTile) { // Already there!
+		mf.playerInfo().SeenTile = wallTile;
 		// FIXME: can this only happen if seen?
-		if (mf.playerInfo.IsTeamVisible(*ThisPlayer)) {
+		if (mf.playerInfo().IsTeamVisible(*ThisPlayer)) {
 			UI.Minimap.UpdateSeenXY(pos);
 		}
 	}
@@ -186,7 +187,7 @@ void MapFixWallTile(const Vec2i &pos)
 		mf.setGraphicTile(wallTile);
 		UI.Minimap.UpdateXY(pos);
 
-		if (mf.playerInfo.IsTeamVisible(*ThisPlayer)) {
+		if (mf.playerInfo().IsTeamVisible(*ThisPlayer)) {
 			UI.Minimap.UpdateSeenXY(pos);
 			Map.MarkSeenTile(mf);
 		}
@@ -222,8 +223,10 @@ void CMap::RemoveWall(const Vec2i &pos)
 	mf.resetFlag(MapFieldHuman | MapFieldWall | MapFieldUnpassable | MapFieldOpaque);
 	MapFixWallNeighbors(pos);
 	UI.Minimap.UpdateXY(pos);
+	PathfinderTerrainChanged(pos);
+	FieldOfView.TerrainChanged();
 
-	if (mf.playerInfo.IsTeamVisible(*ThisPlayer)) {
+	if (mf.playerInfo().IsTeamVisible(*ThisPlayer)) {
 		UI.Minimap.UpdateSeenXY(pos);
 		this->MarkSeenTile(mf);
 	}
@@ -258,13 +261,15 @@ void CMap::SetWall(const Vec2i &pos, bool humanwall)
 	UI.Minimap.UpdateXY(pos);
 	MapFixWallTile(pos);
 	MapFixWallNeighbors(pos);
+	PathfinderTerrainChanged(pos);
+	FieldOfView.TerrainChanged();
 
 	/// Refresh vision of nearby units in case is walls are set as opaque field
 	if (isOpaque) {
 		MapRefreshUnitsSight(pos);
 	}
 
-	if (mf.playerInfo.IsTeamVisible(*ThisPlayer)) {
+	if (mf.playerInfo().IsTeamVisible(*ThisPlayer)) {
 		UI.Minimap.UpdateSeenXY(pos);
 		this->MarkSeenTile(mf);
 	}
@@ -122,9 +122,9 @@ void CMapField::setTileIndex(const CTileset &tileset,
 
 void CMapField::Save(CFile &file) const
 {
-	file.printf("  {%3d, %3d, %2d, %2d", tile, playerInfo.SeenTile, Value, moveCost);
+	file.printf("  {%3d, %3d, %2d, %2d", tile, playerInfo().SeenTile, Value, moveCost);
 	for (int i = 0; i != PlayerMax; ++i) {
-		if (playerInfo.Visible[i] == 1) {
+		if (playerInfo().Visible[i] == 1) {
 			file.printf(", \"explored\", %d", i);
 		}
 	}
@@ -199,7 +199,7 @@ void CMapField::parse(lua_State *l)
 	}
 
 	this->tile = LuaToNumber(l, -1, 1);
-	this->playerInfo.SeenTile = LuaToNumber(l, -1, 2);
+	this->playerInfo().SeenTile = LuaToNumber(l, -1, 2);
 	this->Value = LuaToNumber(l, -1, 3);
 	this->moveCost = LuaToNumber(l, -1, 4);
 
@@ -208,7 +208,7 @@ void CMapField::parse(lua_State *l)
 
 		if (value == "explored") {
 			++j;
-			this->playerInfo.Visible[LuaToNumber(l, -1, j + 1)] = 1;
+			this->playerInfo().Visible[LuaToNumber(l, -1, j + 1)] = 1;
 		} else if (value == "opaque") {
 			this->Flags |= MapFieldOpaque;
 		} else if (value == "human") {
@@ -38,6 +38,7 @@
 #include "minimap.h"
 
 #include "editor.h"
+#include "fow.h"
 #include "map.h"
 #include "player.h"
 #include "settings.h"
@@ -62,6 +63,9 @@ static constexpr int ATTACK_BLINK_DURATION {7 * CYCLES_PER_SECOND};
 
 static constexpr int SCALE_PRECISION       {100};
 
+/// the minimap is composed again by blocks of 8x8 pixels
+static constexpr int DIRTY_BLOCK_SHIFT     {3};
+
 /*----------------------------------------------------------------------------
 --  Variables
 ----------------------------------------------------------------------------*/
@@ -145,6 +149,12 @@ void CMinimap::Create()
 
 	UpdateTerrain();
 
+	DirtyBlocksWidth = (W + (1 << DIRTY_BLOCK_SHIFT) - 1) >> DIRTY_BLOCK_SHIFT;
+	DirtyBlocks.assign(DirtyBlocksWidth * ((H + (1 << DIRTY_BLOCK_SHIFT) - 1) >> DIRTY_BLOCK_SHIFT), 0);
+	NumDirtyBlocks = 0;
+	DirtyAll = true;
+	Highlighted.clear();
+
 	NumMinimapEvents = 0;
 }
 
@@ -227,6 +237,68 @@ void CMinimap::SetFogOpacityLevels(const uint8_t explored, const uint8_t reveale
     this->Settings.FogExploredOpacity = explored;
     this->Settings.FogRevealedOpacity = revealed;
     this->Settings.FogUnseenOpacity   = unseen;
+    this->DirtyAll = true;
+}
+
+/**
+**  Get the minimap pixels of a rectangle of map tiles
+**
+**  @param tiles  Rectangle of map tiles
+**
+**  @return  Rectangle of minimap pixels, which may cover a part of the neighbour tiles
+*/
+SDL_Rect CMinimap::TilesToMinimapRect(const SDL_Rect &tiles) const
+{
+	const int x0 = XOffset + (tiles.x * MinimapScaleX) / MINIMAP_FAC;
+	const int y0 = YOffset + (tiles.y * MinimapScaleY) / MINIMAP_FAC;
+	const int x1 = XOffset + ((tiles.x + tiles.w) * MinimapScaleX) / MINIMAP_FAC;
+	const int y1 = YOffset + ((tiles.y + tiles.h) * MinimapScaleY) / MINIMAP_FAC;
+	return {x0, y0, x1 - x0 + 1, y1 - y0 + 1};
+}
+
+/**
+**  Mark minimap pixels to be composed again at the next update
+**
+**  @param area  Rectangle of minimap pixels
+*/
+void CMinimap::AddDirtyArea(const SDL_Rect &area)
+{
+	if (DirtyAll) {
+		return;
+	}
+	const SDL_Rect minimap {0, 0, W, H};
+	SDL_Rect rect;
+	if (!SDL_IntersectRect(&area, &minimap, &rect)) {
+		return;
+	}
+	const int bx0 = rect.x >> DIRTY_BLOCK_SHIFT;
+	const int by0 = rect.y >> DIRTY_BLOCK_SHIFT;
+	const int bx1 = (rect.x + rect.w - 1) >> DIRTY_BLOCK_SHIFT;
+	const int by1 = (rect.y + rect.h - 1) >> DIRTY_BLOCK_SHIFT;
+
+	for (int by = by0; by <= by1; ++by) {
+		uint8_t *row = &DirtyBlocks[by * DirtyBlocksWidth];
+		for (int bx = bx0; bx <= bx1; ++bx) {
+			NumDirtyBlocks += !row[bx];
+			row[bx] = 1;
+		}
+	}
+}
+
+/**
+**  Mark the whole units which cover map tiles to be drawn again, as they may
+**  appear or disappear from the minimap.
+**
+**  @param tiles  Rectangle of map tiles
+*/
+void CMinimap::AddDirtyUnits(const SDL_Rect &tiles)
+{
+	const Vec2i ltPos(tiles.x, tiles.y);
+	const Vec2i rbPos(tiles.x + tiles.w - 1, tiles.y + tiles.h - 1);
+
+	Map.UnitGrid.ForEach(ltPos, rbPos, CUnitGrid::AllPlayers, [this](const CUnitGrid::Entry &entry) {
+		AddDirtyArea(UnitArea(*entry.Unit));
+	});
 }
 
 /**
@@ -277,7 +349,7 @@ void CMinimap::UpdateXY(const Vec2i &pos)
 				break;
 			}
 
-			int tile = Map.Fields[x + y].playerInfo.SeenTile;
+			int tile = Map.Fields[x + y].playerInfo().SeenTile;
 			if (!tile) {
 				tile = Map.Fields[x + y].getGraphicTile();
 			}
@@ -300,25 +372,85 @@ void CMinimap::UpdateXY(const Vec2i &pos)
 			}
 		}
 	}
+	AddDirtyArea(TilesToMinimapRect({pos.x, pos.y, 1, 1}));
 }
 
 /**
-**  Draw a unit on the minimap.
+**  Update the units layer after a unit is placed on the map, removed from it
+**  or given to another player.
+**
+**  @param unit  Unit placed on the map, at the position where it is drawn
+*/
+void CMinimap::UpdateUnit(const CUnit &unit)
+{
+	if (!MinimapSurface) {
+		return;
+	}
+	AddDirtyArea(UnitArea(unit));
+}
+
+/**
+**  Update the units layer after the units of a tile may have become visible
+**  or invisible for reasons other than the fog of war (radar, cloak detection).
+**
+**  @param pos  The map position of the tile
 */
-static void DrawUnitOn(const CUnit &unit, int red_phase)
+void CMinimap::UpdateUnitsXY(const Vec2i &pos)
 {
-	const CUnitType *type;
+	if (!MinimapSurface) {
+		return;
+	}
+	AddDirtyUnits({pos.x, pos.y, 1, 1});
+}
 
+/**
+**  Get the type with which a unit is shown on the minimap.
+*/
+static const CUnitType &MinimapType(const CUnit &unit)
+{
 	if (Editor.Running || ReplayRevealMap || unit.IsVisible(*ThisPlayer) || unit.Player->IsRevealed()) {
-		type = unit.Type;
-	} else {
-		type = unit.Seen.Type;
-		// This will happen for radar if the unit has not been seen and we
-		// have it on radar.
-		if (!type) {
-			type = unit.Type;
-		}
+		return *unit.Type;
+	}
+	// This will happen for radar if the unit has not been seen and we
+	// have it on radar.
+	return unit.Seen.Type ? *unit.Seen.Type : *unit.Type;
+}
+
+/**
+**  Check if a unit is drawn in red or white instead of the color of its player.
+*/
+static bool IsHighlighted(const CUnit &unit)
+{
+	return (unit.Attacked && unit.Attacked + ATTACK_BLINK_DURATION > GameCycle)
+	       || (UI.Minimap.ShowSelected && unit.Selected);
+}
+
+/**
+**  Get the minimap pixels where a unit is drawn, whether it is seen with its
+**  type or with the type it had when it was seen.
+*/
+SDL_Rect CMinimap::UnitArea(const CUnit &unit) const
+{
+	int tileWidth = unit.Type->TileWidth;
+	int tileHeight = unit.Type->TileHeight;
+	if (unit.Seen.Type) {
+		tileWidth = std::max<int>(tileWidth, unit.Seen.Type->TileWidth);
+		tileHeight = std::max<int>(tileHeight, unit.Seen.Type->TileHeight);
 	}
+	return {1 + XOffset + Map2MinimapX[unit.tilePos.x], 1 + YOffset + Map2MinimapY[unit.tilePos.y],
+	        Map2MinimapX[tileWidth] + 1, Map2MinimapY[tileHeight] + 1};
+}
+
+/**
+**  Draw a unit on the minimap.
+**
+**  @param unit       Unit to draw
+**  @param red_phase  Whether the attacked units blink red
+**  @param clip       Minimap pixels to draw into
+*/
+static void DrawUnitOn(const CUnit &unit, int red_phase, const SDL_Rect &clip)
+{
+	const CUnitType *type = &MinimapType(unit);
 
 	Uint32 color;
 	if (unit.Player->Index == PlayerNumNeutral) {
@@ -336,86 +468,199 @@ static void DrawUnitOn(const CUnit &unit, int red_phase)
 		color = PlayerColorsRGB[GameSettings.Presets[unit.Player->Index].PlayerColor][0];
 	}
 
-	int mx = 1 + UI.Minimap.XOffset + Map2MinimapX[unit.tilePos.x];
-	int my = 1 + UI.Minimap.YOffset + Map2MinimapY[unit.tilePos.y];
-	int w = Map2MinimapX[type->TileWidth];
-	if (mx + w >= UI.Minimap.W) { // clip right side
-		w = UI.Minimap.W - mx;
-	}
-	int h0 = Map2MinimapY[type->TileHeight];
-	if (my + h0 >= UI.Minimap.H) { // clip bottom side
-		h0 = UI.Minimap.H - my;
-	}
-	int bpp = 0;
-	SDL_Color c;
-	bpp = MinimapSurface->format->BytesPerPixel;
-	SDL_GetRGB(color, TheScreen->format, &c.r, &c.g, &c.b);
-	while (w-- >= 0) {
-		int h = h0;
-		while (h-- >= 0) {
-			const unsigned int index = (mx + w) * bpp + (my + h) * MinimapSurface->pitch;
-			if (bpp == 2) {
-				*(Uint16 *)&((Uint8 *)MinimapSurface->pixels)[index] = color;
-			} else {
-				*(Uint32 *)&((Uint8 *)MinimapSurface->pixels)[index] = color;
-			}
-		}
+	const SDL_Rect area {1 + UI.Minimap.XOffset + Map2MinimapX[unit.tilePos.x],
+	                     1 + UI.Minimap.YOffset + Map2MinimapY[unit.tilePos.y],
+	                     Map2MinimapX[type->TileWidth] + 1,
+	                     Map2MinimapY[type->TileHeight] + 1};
+	SDL_Rect rect;
+	if (SDL_IntersectRect(&area, &clip, &rect)) {
+		SDL_FillRect(MinimapSurface, &rect, color);
 	}
 }
 
 /**
-**  Update the minimap with the current game information
+**  Update the fog layer for the tiles regenerated in the vision table of the
+**  fog of war, and mark the pixels which have changed.
+**
+**  @param tiles  Rectangle of map tiles
 */
-void CMinimap::Update()
+void CMinimap::UpdateFog(const SDL_Rect &tiles)
 {
-	static int red_phase;
+	// The pixels out of the map show the visibility of the first column and row
+	SDL_Rect area = TilesToMinimapRect(tiles);
+	if (tiles.x == 0) {
+		area.w = W;
+		area.x = 0;
+	}
+	if (tiles.y == 0) {
+		area.h = H;
+		area.y = 0;
+	}
+	const SDL_Rect minimap {0, 0, W, H};
+	if (!SDL_IntersectRect(&area, &minimap, &area)) {
+		return;
+	}
 
-	int red_phase_changed = red_phase != (int)((FrameCounter / CYCLES_PER_SECOND) & 1);
-	if (red_phase_changed) {
-		red_phase = !red_phase;
+	const uint32_t fogColorSDL = FogOfWar->GetFogColorSDL();
+	uint32_t *const minimapFog = static_cast<uint32_t *>(MinimapFogSurface->pixels);
+	Vec2i pixelMin(W, H);
+	Vec2i pixelMax(-1, -1);
+	Vec2i tileMin(Map.Info.MapWidth, Map.Info.MapHeight);
+	Vec2i tileMax(-1, -1);
+
+	for (int my = area.y; my < area.y + area.h; ++my) {
+		size_t index = my * W + area.x;
+		for (int mx = area.x; mx < area.x + area.w; ++mx, ++index) {
+
+			const Vec2i tilePos(Minimap2MapX[mx], Minimap2MapY[my] / Map.Info.MapWidth);
+			const uint8_t vis = FogOfWar->GetVisibilityForTile(tilePos);
+
+			const uint32_t fogAlpha = vis == 0 ? (GameSettings.RevealMap != MapRevealModes::cHidden ? Settings.FogRevealedOpacity : Settings.FogUnseenOpacity)
+											   : vis == 1 ? Settings.FogExploredOpacity
+														  : Settings.FogVisibleOpacity;
+			const uint32_t pixel = fogColorSDL | (fogAlpha << ASHIFT);
+
+			if (minimapFog[index] != pixel) {
+				minimapFog[index] = pixel;
+				pixelMin.x = std::min<int>(pixelMin.x, mx);
+				pixelMin.y = std::min<int>(pixelMin.y, my);
+				pixelMax.x = std::max<int>(pixelMax.x, mx);
+				pixelMax.y = std::max<int>(pixelMax.y, my);
+				tileMin.x = std::min(tileMin.x, tilePos.x);
+				tileMin.y = std::min(tileMin.y, tilePos.y);
+				tileMax.x = std::max(tileMax.x, tilePos.x);
+				tileMax.y = std::max(tileMax.y, tilePos.y);
+			}
+		}
+	}
+	if (pixelMax.x < 0) {
+		return;
 	}
+	AddDirtyArea({pixelMin.x, pixelMin.y, pixelMax.x - pixelMin.x + 1, pixelMax.y - pixelMin.y + 1});
+	// Units under the fog which has changed may appear or disappear
+	AddDirtyUnits({tileMin.x, tileMin.y, tileMax.x - tileMin.x + 1, tileMax.y - tileMin.y + 1});
+}
 
+/**
+**  Compose the terrain, the fog and the units layers into an area of the minimap.
+**
+**  @param area       Rectangle of minimap pixels
+**  @param red_phase  Whether the attacked units blink red
+*/
+void CMinimap::Compose(const SDL_Rect &area, int red_phase)
+{
 	// Clear Minimap background if not transparent
 	if (!Transparent) {
-		SDL_FillRect(MinimapSurface, nullptr, SDL_MapRGB(MinimapSurface->format, 0, 0, 0));
+		SDL_FillRect(MinimapSurface, &area, SDL_MapRGB(MinimapSurface->format, 0, 0, 0));
 	}
 
 	//
 	// Draw the terrain
 	//
 	if (WithTerrain) {
-		SDL_BlitSurface(MinimapTerrainSurface, nullptr, MinimapSurface, nullptr);
+		SDL_Rect srcRect = area;
+		SDL_Rect dstRect = area;
+		SDL_BlitSurface(MinimapTerrainSurface, &srcRect, MinimapSurface, &dstRect);
 	}
-	const uint32_t fogColorSDL = FogOfWar->GetFogColorSDL();
 	if (!ReplayRevealMap) {
-		uint32_t *const minimapFog = static_cast<uint32_t *>(MinimapFogSurface->pixels);
-		size_t index = 0;
-		for (uint16_t my = 0; my < H; ++my) {
-			for (uint16_t mx = 0; mx < W; ++mx) {
-
-				const Vec2i tilePos(Minimap2MapX[mx], Minimap2MapY[my] / Map.Info.MapWidth);
-				const uint8_t vis = FogOfWar->GetVisibilityForTile(tilePos);
-
-				const uint32_t fogAlpha = vis == 0 ? (GameSettings.RevealMap != MapRevealModes::cHidden ? Settings.FogRevealedOpacity : Settings.FogUnseenOpacity)
-											   	   : vis == 1 ? Settings.FogExploredOpacity
-										   		   			  : Settings.FogVisibleOpacity;
-
-				minimapFog[index++] = fogColorSDL | (fogAlpha << ASHIFT);
-			}
-		}
 		/// Alpha blending the fog of war texture to minimap
 		/// TODO: switch to hardware rendering
-		const SDL_Rect fogRect {0, 0, W, H};
-		BlitSurfaceAlphaBlending_32bpp(MinimapFogSurface, &fogRect, MinimapSurface, &fogRect);
+		BlitSurfaceAlphaBlending_32bpp(MinimapFogSurface, &area, MinimapSurface, &area);
 	}
 	//
 	// Draw units on map
 	//
-	for (const CUnit *unit : UnitManager->GetUnits()) {
-		if (unit->IsVisibleOnMinimap() && !unit->Removed && !unit->Type->BoolFlag[REVEALER_INDEX].value) {
-			DrawUnitOn(*unit, red_phase);
+	// Units are drawn one pixel right and down of their tile, and a bit wider
+	const auto toTileX = [this](int mx) { return std::clamp(((mx - XOffset) * MINIMAP_FAC) / MinimapScaleX, 0, Map.Info.MapWidth - 1); };
+	const auto toTileY = [this](int my) { return std::clamp(((my - YOffset) * MINIMAP_FAC) / MinimapScaleY, 0, Map.Info.MapHeight - 1); };
+	const Vec2i ltPos(std::max(0, toTileX(area.x - 2) - 1), std::max(0, toTileY(area.y - 2) - 1));
+	const Vec2i rbPos(toTileX(area.x + area.w), toTileY(area.y + area.h));
+
+	Map.UnitGrid.ForEach(ltPos, rbPos, CUnitGrid::AllPlayers, [&](const CUnitGrid::Entry &entry) {
+		const CUnit &unit = *entry.Unit;
+		if (unit.IsVisibleOnMinimap() && !unit.Removed && !unit.Type->BoolFlag[REVEALER_INDEX].value) {
+			DrawUnitOn(unit, red_phase, area);
+		}
+	});
+}
+
+/**
+**  Update the minimap with the current game information
+**
+**  Only the blocks of pixels where the terrain, the fog of war or the units
+**  have changed since the last update are composed again.
+*/
+void CMinimap::Update()
+{
+	static int red_phase;
+
+	int red_phase_changed = red_phase != (int)((FrameCounter / CYCLES_PER_SECOND) & 1);
+	if (red_phase_changed) {
+		red_phase = !red_phase;
+	}
+
+	const auto composedWith = std::make_tuple(WithTerrain, Transparent, ReplayRevealMap,
+	                                          GameSettings.RevealMap != MapRevealModes::cHidden,
+	                                          ShowSelected, ThisPlayer, FogOfWar->GetFogColorSDL());
+	if (composedWith != ComposedWith) {
+		ComposedWith = composedWith;
+		DirtyAll = true;
+	}
+
+	const SDL_Rect fogTiles = FogOfWar->TakeChangedTiles();
+	if (!ReplayRevealMap) {
+		if (DirtyAll) {
+			UpdateFog({0, 0, Map.Info.MapWidth, Map.Info.MapHeight});
+		} else if (!SDL_RectEmpty(&fogTiles)) {
+			UpdateFog(fogTiles);
+		}
+	}
+
+	// The units of the player which blink or are shown selected are drawn
+	// again, as well as the ones which were at the last update
+	for (const CUnit *unit : Highlighted) {
+		AddDirtyArea(UnitArea(*unit));
+	}
+	Highlighted.clear();
+	if (!Editor.Running) {
+		for (const CUnit *unit : ThisPlayer->GetUnits()) {
+			if (!unit->Removed && IsHighlighted(*unit)) {
+				Highlighted.push_back(unit);
+				AddDirtyArea(UnitArea(*unit));
+			}
+		}
+	}
+
+	if (DirtyAll) {
+		Compose({0, 0, W, H}, red_phase);
+		ranges::fill(DirtyBlocks, 0);
+		NumDirtyBlocks = 0;
+		DirtyAll = false;
+		return;
+	}
+	if (NumDirtyBlocks == 0) {
+		return;
+	}
+	// Compose the runs of dirty blocks of each row at once
+	const int blockSize = 1 << DIRTY_BLOCK_SHIFT;
+	const int blocksHeight = DirtyBlocks.size() / DirtyBlocksWidth;
+	for (int by = 0; by < blocksHeight; ++by) {
+		uint8_t *row = &DirtyBlocks[by * DirtyBlocksWidth];
+		for (int bx = 0; bx < DirtyBlocksWidth; ++bx) {
+			if (!row[bx]) {
+				continue;
+			}
+			const int first = bx;
+			while (bx < DirtyBlocksWidth && row[bx]) {
+				row[bx++] = 0;
+			}
+			const SDL_Rect area {first * blockSize, by * blockSize,
+			                     std::min(bx * blockSize, W) - first * blockSize,
+			                     std::min((by + 1) * blockSize, H) - by * blockSize};
+			Compose(area, red_phase);
 		}
 	}
+	NumDirtyBlocks = 0;
 }
 
 /**
@@ -499,6 +744,11 @@ void CMinimap::Destroy()
 	}
 	Minimap2MapX.clear();
 	Minimap2MapY.clear();
+	DirtyBlocks.clear();
+	DirtyBlocksWidth = 0;
+	NumDirtyBlocks = 0;
+	DirtyAll = true;
+	Highlighted.clear();
 }
 
 /**
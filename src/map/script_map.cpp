@@ -41,6 +41,7 @@
 #include "iolib.h"
 #include "netconnect.h"
 #include "network.h"
+#include "pathfinder.h"
 #include "script.h"
 #include "tileset.h"
 #include "translate.h"
@@ -83,6 +84,7 @@ static int CclStratagusMap(lua_State *l)
 				LuaError(l, "incorrect argument");
 			}
 			int subargs = lua_rawlen(l, j + 1);
+			bool hasForestRegrowth = false;
 			for (int k = 0; k < subargs; ++k) {
 				const std::string_view value = LuaToString(l, j + 1, k + 1);
 				++k;
@@ -92,7 +94,7 @@ static int CclStratagusMap(lua_State *l)
 					CclGetPos(l, &Map.Info.MapWidth, &Map.Info.MapHeight);
 					lua_pop(l, 1);
 
-					Map.Fields.resize(Map.Info.MapWidth * Map.Info.MapHeight);
+					Map.Create();
 					// FIXME: this should be CreateMap or InitMap?
 				} else if (value == "fog-of-war") {
 					Map.NoFogOfWar = false;
@@ -120,10 +122,31 @@ static int CclStratagusMap(lua_State *l)
 						lua_pop(l, 1);
 					}
 					lua_pop(l, 1);
+				} else if (value == "forest-regrowth") {
+					lua_rawgeti(l, j + 1, k + 1);
+					if (!lua_istable(l, -1)) {
+						LuaError(l, "incorrect argument");
+					}
+					const int subsubargs = lua_rawlen(l, -1);
+					const int size = Map.Info.MapWidth * Map.Info.MapHeight;
+					Map.ForestRegrowth.clear();
+					for (int i = 0; i < subsubargs; ++i) {
+						const int index = LuaToNumber(l, -1, i + 1);
+						if (index < 0 || index >= size) {
+							LuaError(l, "Wrong forest regrowth index: %d\n", index);
+						}
+						Map.ForestRegrowth.insert(index);
+					}
+					lua_pop(l, 1);
+					hasForestRegrowth = true;
 				} else {
 					LuaError(l, "Unsupported tag: %s", value.data());
 				}
 			}
+			// Saved before the list was kept
+			if (!hasForestRegrowth) {
+				Map.InitForestRegrowth();
+			}
 		} else {
 			LuaError(l, "Unsupported tag: %s", value.data());
 		}
@@ -636,6 +659,42 @@ static int CclGetIsFogOfWarBilinear(lua_State *l)
 	return 1;
 }
 
+/**
+**  Get the time spent in the stages of the fog of war generation.
+**  The counters are reset after reading when the optional argument is true.
+**
+**  @param l  Lua state.
+**
+**  @return   table with the microseconds spent in each stage and the number of generated frames
+*/
+static int CclGetFogOfWarTimings(lua_State *l)
+{
+	const int args = lua_gettop(l);
+	if (args > 1) {
+		LuaError(l, "incorrect argument");
+	}
+	const CFogOfWar::StageTimings &timings = FogOfWar->GetTimings();
+
+	lua_newtable(l);
+	lua_pushnumber(l, timings.GenerateFog);
+	lua_setfield(l, -2, "GenerateFog");
+	lua_pushnumber(l, timings.Upscale);
+	lua_setfield(l, -2, "Upscale");
+	lua_pushnumber(l, timings.Blur);
+	lua_setfield(l, -2, "Blur");
+	lua_pushnumber(l, timings.Deltas);
+	lua_setfield(l, -2, "Deltas");
+	lua_pushnumber(l, timings.Generations);
+	lua_setfield(l, -2, "Generations");
+	lua_pushnumber(l, timings.PartialUpdates);
+	lua_setfield(l, -2, "PartialUpdates");
+
+	if (args == 1 && LuaToBoolean(l, 1)) {
+		FogOfWar->ResetTimings();
+	}
+	return 1;
+}
+
 /**
 ** <b>Description</b>
 **
@@ -826,7 +885,7 @@ void SetTile(const unsigned int tileIndex, const Vec2i &pos, const int value, co
 	}
 
 	if (!Map.Fields.empty()) {
-		int multiplier = Map.Tileset.getLogicalToGraphicalTileSizeMultiplier();
+		const int multiplier = Map.Tileset.getLogicalToGraphicalTileSizeMultiplier();
 		if (multiplier > 1) {
 			// fill subtile fields
 			int subtile = 0;
@@ -834,12 +893,20 @@ void SetTile(const unsigned int tileIndex, const Vec2i &pos, const int value, co
 				for (int j = 0; j < multiplier; j++) {
 					CMapField &mf = *Map.Field(Vec2i(pos.x + j, pos.y + i));
 					mf.setTileIndex(Map.Tileset, tileIndex, value, uint8_t(elevation), subtile++);
+					if (mf.getGraphicTile() == Map.Tileset.getRemovedTreeTile()) {
+						Map.ForestRegrowth.insert(Map.getIndex(pos.x + j, pos.y + i));
+					}
 				}
 			}
 		} else {
 			CMapField &mf = *Map.Field(pos);
 			mf.setTileIndex(Map.Tileset, tileIndex, value, uint8_t(elevation));
+			if (mf.getGraphicTile() == Map.Tileset.getRemovedTreeTile()) {
+				Map.ForestRegrowth.insert(Map.getIndex(pos));
+			}
 		}
+		FieldOfView.TerrainChanged();
+		PathfinderTerrainChanged(pos, std::max(multiplier, 1), std::max(multiplier, 1));
 	}
 }
 
@@ -1202,6 +1269,7 @@ void MapCclRegister()
 	lua_register(Lua, "SetFogOfWarBlur", CclSetFogOfWarBlur);
 	lua_register(Lua, "SetFogOfWarBilinear", CclSetFogOfWarBilinear);
 	lua_register(Lua, "GetIsFogOfWarBilinear", CclGetIsFogOfWarBilinear);
+	lua_register(Lua, "GetFogOfWarTimings", CclGetFogOfWarTimings);
 
 	lua_register(Lua, "SetFogOfWarGraphics", CclSetFogOfWarGraphics);
 	lua_register(Lua, "SetFogOfWarColor", CclSetFogOfWarColor);
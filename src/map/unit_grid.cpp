@@ -0,0 +1,126 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name unit_grid.cpp - The coarse index of the units on the map. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+//@{
+
+/*----------------------------------------------------------------------------
+--  Includes
+----------------------------------------------------------------------------*/
+
+#include "stratagus.h"
+
+#include "unit_grid.h"
+
+#include "player.h"
+#include "unit.h"
+#include "unittype.h"
+
+/*----------------------------------------------------------------------------
+--  Functions
+----------------------------------------------------------------------------*/
+
+/**
+**  Allocate the buckets covering a map.
+**
+**  @param mapWidth   Width of the map in tiles.
+**  @param mapHeight  Height of the map in tiles.
+*/
+void CUnitGrid::Init(int mapWidth, int mapHeight)
+{
+	Width = (mapWidth + BucketSize - 1) >> BucketShift;
+	Height = (mapHeight + BucketSize - 1) >> BucketShift;
+	Buckets.clear();
+	Buckets.resize(Width * Height);
+	MaxUnitSize = Vec2i(1, 1);
+}
+
+/**
+**  Remove all the units and the buckets.
+*/
+void CUnitGrid::Clean()
+{
+	Width = 0;
+	Height = 0;
+	Buckets.clear();
+	MaxUnitSize = Vec2i(1, 1);
+}
+
+/**
+**  Insert a unit at its position.
+**
+**  @param unit  Unit placed on the map.
+*/
+void CUnitGrid::Insert(CUnit &unit)
+{
+	const Vec2i size(unit.Type->TileWidth, unit.Type->TileHeight);
+	const int player = unit.Player->Index;
+	Bucket &bucket = BucketOf(unit.tilePos);
+
+	bucket.Units[player].push_back({&unit, unit.tilePos, unit.tilePos + size});
+	bucket.Players |= 1u << player;
+	MaxUnitSize.x = std::max(MaxUnitSize.x, size.x);
+	MaxUnitSize.y = std::max(MaxUnitSize.y, size.y);
+}
+
+void CUnitGrid::RemoveEntry(Bucket &bucket, int player, const CUnit &unit)
+{
+	std::vector<Entry> &units = bucket.Units[player];
+	auto it = ranges::find(units, &unit, &Entry::Unit);
+
+	Assert(it != units.end());
+	*it = units.back();
+	units.pop_back();
+	if (units.empty()) {
+		bucket.Players &= ~(1u << player);
+	}
+}
+
+/**
+**  Remove a unit, from the position where it was inserted.
+**
+**  @param unit  Unit placed on the map.
+*/
+void CUnitGrid::Remove(CUnit &unit)
+{
+	RemoveEntry(BucketOf(unit.tilePos), unit.Player->Index, unit);
+}
+
+/**
+**  Move a unit into the partition of its new owner.
+**
+**  @param unit       Unit placed on the map, already given to its new owner.
+**  @param oldPlayer  Index of the previous owner.
+*/
+void CUnitGrid::ChangeOwner(CUnit &unit, int oldPlayer)
+{
+	RemoveEntry(BucketOf(unit.tilePos), oldPlayer, unit);
+	Insert(unit);
+}
+
+//@}
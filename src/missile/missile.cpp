@@ -53,6 +53,7 @@
 #include "unittype.h"
 #include "video.h"
 
+#include <algorithm>
 #include <cmath>
 
 /*----------------------------------------------------------------------------
@@ -61,6 +62,10 @@
 
 unsigned int Missile::Count = 0;
 
+/// Memory of the deleted missiles, by size in MissileBlockSize units, reused for the new ones
+static std::vector<std::vector<void *>> MissileBlocks;
+static constexpr size_t MissileBlockSize = 16;
+
 static std::vector<std::unique_ptr<Missile>> GlobalMissiles;    /// all global missiles on map
 static std::vector<std::unique_ptr<Missile>> LocalMissiles;     /// all local missiles on map
 
@@ -213,6 +218,37 @@ Missile::Init(const MissileType &mtype, const PixelPos &startPos, const PixelPos
 	return missile;
 }
 
+/**
+**  Allocate a missile from the memory of the deleted missiles of the same
+**  size, if any. Battles create and delete many missiles of a few types.
+*/
+void *Missile::operator new(size_t size)
+{
+	const size_t blocks = (size + MissileBlockSize - 1) / MissileBlockSize;
+
+	if (blocks < MissileBlocks.size() && !MissileBlocks[blocks].empty()) {
+		void *ptr = MissileBlocks[blocks].back();
+		MissileBlocks[blocks].pop_back();
+		return ptr;
+	}
+	return ::operator new(blocks * MissileBlockSize);
+}
+
+/**
+**  Keep the memory of a deleted missile for the next missiles.
+**
+**  @param size  Size of the actual class of the missile.
+*/
+void Missile::operator delete(void *ptr, size_t size)
+{
+	const size_t blocks = (size + MissileBlockSize - 1) / MissileBlockSize;
+
+	if (blocks >= MissileBlocks.size()) {
+		MissileBlocks.resize(blocks + 1);
+	}
+	MissileBlocks[blocks].push_back(ptr);
+}
+
 /**
 **  Create a new global missile at (x,y).
 **
@@ -446,7 +482,7 @@ static bool MissileVisibleInViewport(const CViewport &vp, const Missile &missile
 	Vec2i pos;
 	for (pos.x = boxmin.x; pos.x <= boxmax.x; ++pos.x) {
 		for (pos.y = boxmin.y; pos.y <= boxmax.y; ++pos.y) {
-			if (ReplayRevealMap || Map.Field(pos)->playerInfo.IsTeamVisible(*ThisPlayer)) {
+			if (ReplayRevealMap || Map.Field(pos)->playerInfo().IsTeamVisible(*ThisPlayer)) {
 				return true;
 			}
 		}
@@ -539,12 +575,16 @@ static bool MissileDrawLevelCompare(const Missile *const l, const Missile *const
 /**
 **  Sort visible missiles on map for display.
 **
+**  The table is kept by the viewport from one frame to the next, so its
+**  memory is reused. Missiles are deleted when they end, so it is filled
+**  again each frame; the missiles are mostly in slot order already.
+**
 **  @param vp         Viewport pointer.
-**  @return array of missile to display sorted by DrawLevel.
+**  @param table      Filled with the missiles to display sorted by DrawLevel.
 */
-std::vector<Missile *> FindAndSortMissiles(const CViewport &vp)
+void FindAndSortMissiles(const CViewport &vp, std::vector<Missile *> &table)
 {
-	std::vector<Missile *> table;
+	table.clear();
 	// Loop through global missiles, then through locals.
 	for (auto& missilePtr : GlobalMissiles) {
 		Missile &missile = *missilePtr;
@@ -565,8 +605,9 @@ std::vector<Missile *> FindAndSortMissiles(const CViewport &vp)
 		// Local missile are visible.
 		table.push_back(&missile);
 	}
-	ranges::sort(table, MissileDrawLevelCompare);
-	return table;
+	if (!std::is_sorted(table.begin(), table.end(), MissileDrawLevelCompare)) {
+		ranges::sort(table, MissileDrawLevelCompare);
+	}
 }
 
 /**
@@ -1122,36 +1163,43 @@ void Missile::NextMissileFrameCycle()
 /**
 **  Handle all missile actions of global/local missiles.
 **
+**  The missiles are handled in the order they were created, including the
+**  ones created during the loop. The ones which end are deleted at once,
+**  and their entries removed from the table together after the loop.
+**
 **  @param missiles  Table of missiles.
 */
 static void MissilesActionLoop(std::vector<std::unique_ptr<Missile>> &missiles)
 {
-	for (size_t i = 0; i != missiles.size(); /* empty */) {
+	bool ended = false;
+
+	for (size_t i = 0; i != missiles.size(); ++i) {
 		Missile &missile = *missiles[i];
 
 		if (missile.Delay) {
 			missile.Delay--;
-			++i;
 			continue;  // delay start of missile
 		}
 		if (missile.TTL > 0) {
 			missile.TTL--;  // overall time to live if specified
 		}
 		if (missile.TTL == 0) {
-			missiles.erase(missiles.begin() + i);
+			missiles[i].reset();
+			ended = true;
 			continue;
 		}
 		Assert(missile.Wait);
 		if (--missile.Wait) {  // wait until time is over
-			++i;
 			continue;
 		}
 		missile.Action(); // may create other missiles, and so modifies the array
 		if (missile.TTL == 0) {
-			missiles.erase(missiles.begin() + i);
-			continue;
+			missiles[i].reset();
+			ended = true;
 		}
-		++i;
+	}
+	if (ended) {
+		missiles.erase(std::remove(missiles.begin(), missiles.end(), nullptr), missiles.end());
 	}
 }
 
@@ -1164,6 +1212,14 @@ void MissileActions()
 	MissilesActionLoop(LocalMissiles);
 }
 
+/**
+**  Number of global and local missiles on the map.
+*/
+size_t MissilesCount()
+{
+	return GlobalMissiles.size() + LocalMissiles.size();
+}
+
 /**
 **  Calculate distance from view-point to missile.
 **
@@ -1308,6 +1364,12 @@ void CleanMissiles()
 {
 	GlobalMissiles.clear();
 	LocalMissiles.clear();
+	for (std::vector<void *> &blocks : MissileBlocks) {
+		for (void *ptr : blocks) {
+			::operator delete(ptr);
+		}
+	}
+	MissileBlocks.clear();
 }
 
 template <typename Range>
@@ -53,8 +53,8 @@ struct LandMineTargetFinder {
 	}
 	CUnit *FindOnTile(const CMapField *const mf) const
 	{
-		auto it = ranges::find_if(mf->UnitCache, *this);
-		return it != mf->UnitCache.end() ? *it : nullptr;
+		auto it = ranges::find_if(mf->UnitCache(), *this);
+		return it != mf->UnitCache().end() ? *it : nullptr;
 	}
 };
 
@@ -60,6 +60,8 @@ using sendtobuftype = const char *;
 using sendbuftype = const char *;
 using socklen_t = int;
 #else
+#include <netinet/tcp.h>
+
 using setsockopttype = const void *;
 using recvfrombuftype = void *;
 using recvbuftype = void *;
@@ -184,6 +186,37 @@ int NetSetNonBlocking(Socket sockfd)
 }
 #endif
 
+/**
+**  Shut down both directions of a TCP connection. Blocked sends and
+**  receives on the socket return, but the socket stays open.
+**
+**  @param sockfd  Socket
+**
+**  @return 0 for success, -1 for error
+*/
+int NetShutdownTCP(Socket sockfd)
+{
+#ifdef USE_WINSOCK
+	return shutdown(sockfd, 2); // SD_BOTH
+#else
+	return shutdown(sockfd, SHUT_RDWR);
+#endif
+}
+
+/**
+**  Send the data written to a TCP socket at once, without gathering it
+**  with the next writes (Nagle's algorithm).
+**
+**  @param sockfd  Socket
+**
+**  @return 0 for success, -1 for error
+*/
+int NetSetNoDelay(Socket sockfd)
+{
+	int opt = 1;
+	return setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, (setsockopttype)&opt, sizeof(opt));
+}
+
 /**
 **  Resolve host in name or dotted quad notation.
 **
@@ -168,6 +168,7 @@ class CTCPSocket_Impl
 	~CTCPSocket_Impl() { if (IsValid()) { Close(); } }
 	bool Open(const CHost &host);
 	void Close() { NetCloseTCP(socket); socket = Socket(-1); }
+	void Shutdown() { NetShutdownTCP(socket); }
 	bool Connect(const CHost &host) { return NetConnectTCP(socket, host.getIp(), host.getPort()) != -1; }
 	int Send(const void *buf, unsigned int len) { return NetSendTCP(socket, buf, len); }
 	int Recv(void *buf, int len)
@@ -176,6 +177,7 @@ class CTCPSocket_Impl
 		return res;
 	}
 	void SetNonBlocking() { NetSetNonBlocking(socket); }
+	void SetNoDelay() { NetSetNoDelay(socket); }
 	int HasDataToRead(int timeout) { return NetSocketReady(socket, timeout); }
 	bool IsValid() const { return socket != Socket(-1); }
 private:
@@ -209,6 +211,11 @@ void CTCPSocket::Close()
 	m_impl->Close();
 }
 
+void CTCPSocket::Shutdown()
+{
+	m_impl->Shutdown();
+}
+
 
 bool CTCPSocket::Connect(const CHost &host)
 {
@@ -231,6 +238,11 @@ void CTCPSocket::SetNonBlocking()
 	m_impl->SetNonBlocking();
 }
 
+void CTCPSocket::SetNoDelay()
+{
+	m_impl->SetNoDelay();
+}
+
 int CTCPSocket::HasDataToRead(int timeout)
 {
 	return m_impl->HasDataToRead(timeout);
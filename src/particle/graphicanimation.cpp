@@ -86,7 +86,7 @@ bool GraphicAnimation::isVisible(const CViewport &vp, const CPosition &pos) cons
 	Vec2i p;
 	for (p.x = minPos.x; p.x <= maxPos.x; ++p.x) {
 		for (p.y = minPos.y; p.y <= maxPos.y; ++p.y) {
-			if (ReplayRevealMap || Map.Field(p)->playerInfo.IsTeamVisible(*ThisPlayer)) {
+			if (ReplayRevealMap || Map.Field(p)->playerInfo().IsTeamVisible(*ThisPlayer)) {
 				return true;
 			}
 		}
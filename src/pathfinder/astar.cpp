@@ -61,11 +61,14 @@
 #endif
 
 #include <cstdio>
+#include <functional>
 
 /*----------------------------------------------------------------------------
 --  Declarations
 ----------------------------------------------------------------------------*/
 
+static constexpr int CacheNotSet = -1;
+
 struct Node {
 	int32_t GetCostFromStart() const;
 	void SetCostFromStart(uint64_t cost);
@@ -80,15 +83,22 @@ struct Node {
 	uint16_t CostToGoal = 0;   /// Estimated cost to goal
 	int8_t InGoal = 0;         /// is this point in the goal
 	int8_t Direction = 0;      /// Direction for trace back
+public:
+	uint32_t Generation = 0;          /// Search which initialized this node
+	int32_t OpenIndex = -1;           /// Position in the open set, -1 if not in it
+	int32_t CostMoveTo = CacheNotSet; /// Cached result of CostMoveTo, +1
 };
 
 struct Open {
 	uint32_t GetCosts() const;
 	void SetCosts(uint64_t costs);
+	uint32_t GetTieBreak() const;
+	void SetTieBreak(int costToGoal, int dist);
 	uint32_t GetOffset() const;
 	Vec2i pos;
 private:
-	uint32_t Costs; /// complete costs to goal
+	uint32_t Costs;    /// complete costs to goal
+	uint32_t TieBreak; /// estimated cost to goal, then distance to goal
 };
 
 /// heuristic cost function for a*
@@ -114,8 +124,25 @@ const int Heading2Y[9] = { -1, -1, 0, +1, +1, +1, 0, -1, 0 };
 int Heading2O[9];//heading to offset
 const int XY2Heading[3][3] = { {7, 6, 5}, {0, 0, 4}, {1, 2, 3}};
 
-/// cost matrix
-static std::vector<Node> AStarMatrix;
+// The search state is per thread, so that PathfinderSolveBatch can run
+// several searches at once. The map and the costs are shared.
+
+/**
+**  The Open set is handled by a binary heap,
+**  the first item of the array is the one with the smallest cost.
+**  Each node knows its position in the heap (Node::OpenIndex).
+*/
+struct AStarSearchState {
+	std::vector<Node> Matrix;  /// cost matrix
+	uint32_t Generation = 0;   /// Current search, nodes of other generations are outdated
+	std::vector<Open> OpenSet; /// The set of Open nodes
+	int OpenSetSize = 0;       /// The size of the open node set
+};
+
+/// Search state of each thread, by OpenMP thread number. Sized on first use by the thread
+static std::vector<AStarSearchState> AStarStates;
+/// Search state of the calling thread, set by AStarPrepareThread
+static thread_local AStarSearchState *AStarState;
 
 /// a list of close nodes, helps to speed up the matrix cleaning
 #define MAX_CLOSE_SET_RATIO 4
@@ -133,21 +160,11 @@ static bool AStarFixedEnemyUnitsUnpassable = false;
 static int AStarMapWidth;
 static int AStarMapHeight;
 
-static int AStarGoalX;
-static int AStarGoalY;
+static thread_local int AStarGoalX;
+static thread_local int AStarGoalY;
 
-/**
-**  The Open set is handled by a stored array
-**  the end of the array holds the item with the smallest cost.
-*/
-
-/// The set of Open nodes
-static std::vector<Open> OpenSet;
-/// The size of the open node set
-static int OpenSetSize;
-
-static std::vector<int32_t> CostMoveToCache;
-static constexpr int CacheNotSet = -1;
+/// Number of nodes expanded by the last search
+static thread_local unsigned int AStarExpandedNodes;
 
 /*----------------------------------------------------------------------------
 --  Profile
@@ -187,17 +204,18 @@ inline int QueryPerformanceFrequency(LARGE_INTEGER *ptr)
 
 #undef max
 #undef min
-static std::map<const char *const, LARGE_INTEGER> functionTimerMap;
+static thread_local std::map<const char *const, LARGE_INTEGER> functionTimerMap;
 struct ProfileData {
 	unsigned long Calls;
 	unsigned long TotalTime;
 };
-static std::map<const char *const, ProfileData> functionProfiles;
+/// Profiles of each thread of PathfinderSolveBatch, by OpenMP thread number, merged when printed
+static std::vector<std::map<const char *const, ProfileData>> threadProfiles;
 
 inline void ProfileInit()
 {
 	functionTimerMap.clear();
-	functionProfiles.clear();
+	threadProfiles.assign(omp_get_max_threads(), {});
 }
 
 inline void ProfileBegin(const char *const function)
@@ -216,7 +234,7 @@ inline void ProfileEnd(const char *const function)
 		return;
 	}
 	unsigned long time = (unsigned long)(counter.QuadPart - functionTimerMap[function].QuadPart);
-	ProfileData *data = &functionProfiles[function];
+	ProfileData *data = &threadProfiles[omp_get_thread_num()][function];
 	data->Calls++;
 	data->TotalTime += time;
 }
@@ -233,9 +251,16 @@ inline void ProfilePrint()
 	if (!QueryPerformanceFrequency(&frequency)) {
 		return;
 	}
+	std::map<const char *const, ProfileData> functionProfiles;
+	for (const auto &profiles : threadProfiles) {
+		for (const auto &[key, data] : profiles) {
+			functionProfiles[key].Calls += data.Calls;
+			functionProfiles[key].TotalTime += data.TotalTime;
+		}
+	}
 	std::vector<ProfileData *> prof;
 	for (auto &[key, data] : functionProfiles) {
-		prof.insert(ranges::upper_bound(prof, &data, compProfileData), &data);
+		prof.insert(std::upper_bound(prof.begin(), prof.end(), &data, compProfileData), &data);
 	}
 
 	FILE *fd = fopen("profile.txt", "wb");
@@ -318,6 +343,14 @@ void Open::SetCosts(uint64_t costs) {
 	}
 }
 
+uint32_t Open::GetTieBreak() const {
+	return this->TieBreak;
+}
+
+void Open::SetTieBreak(int costToGoal, int dist) {
+	this->TieBreak = (uint32_t(std::min(costToGoal, UINT16_MAX)) << 16) | std::min(dist, UINT16_MAX);
+}
+
 uint32_t Open::GetOffset() const {
 	return pos.y * AStarMapWidth + pos.x;
 }
@@ -326,25 +359,40 @@ uint32_t Open::GetOffset() const {
 --  Functions
 ----------------------------------------------------------------------------*/
 
+/**
+**  Select the search state of the calling thread, and size it for the
+**  current map.
+*/
+static void AStarPrepareThread()
+{
+	const size_t thread = omp_get_thread_num();
+	Assert(thread < AStarStates.size());
+	AStarState = &AStarStates[thread];
+
+	if (AStarState->Matrix.size() != size_t(AStarMapWidth * AStarMapHeight)) {
+		AStarState->Matrix.assign(AStarMapWidth * AStarMapHeight, Node{});
+		AStarState->Generation = 0;
+		AStarState->OpenSet.resize(AStarMapWidth * AStarMapHeight / MAX_OPEN_SET_RATIO);
+		AStarState->OpenSetSize = 0;
+	}
+}
+
 /**
 **  Init A* data structures
+**
+**  The search state of the calling thread is sized at once, the ones of the
+**  other threads of PathfinderSolveBatch on their first search.
 */
 void InitAStar(int mapWidth, int mapHeight)
 {
 	// Should only be called once
-	Assert(AStarMatrix.empty());
+	Assert(AStarStates.empty());
 
 	AStarMapWidth = mapWidth;
 	AStarMapHeight = mapHeight;
 
-	AStarMatrix.resize(AStarMapWidth * AStarMapHeight);
-#ifdef DEBUG
-	for (auto& node : AStarMatrix) {
-		node.SetDirection(-1);
-	}
-#endif
-	OpenSet.resize(AStarMapWidth * AStarMapHeight / MAX_OPEN_SET_RATIO);
-	CostMoveToCache.resize(AStarMapWidth * AStarMapHeight, CacheNotSet);
+	AStarStates.resize(omp_get_max_threads());
+	AStarPrepareThread();
 
 	for (int i = 0; i < 9; ++i) {
 		Heading2O[i] = Heading2Y[i] * AStarMapWidth;
@@ -354,53 +402,143 @@ void InitAStar(int mapWidth, int mapHeight)
 }
 
 /**
-**  Free A* data structure
+**  Free A* data structure, the search states of all the threads.
 */
 void FreeAStar()
 {
-	AStarMatrix.clear();
-	OpenSet.clear();
-	OpenSetSize = 0;
-	CostMoveToCache.clear();
+	AStarStates.clear();
+	AStarState = nullptr;
 
 	ProfilePrint();
 }
 
 /**
 **  Prepare pathfinder.
+**
+**  Outdate all the nodes at once, they are reset on first access.
 */
 static void AStarPrepare()
 {
-	ranges::fill(AStarMatrix, Node{});
-#ifdef DEBUG
-	for (auto& node : AStarMatrix) {
-		node.SetDirection(-1);
+	if (++AStarState->Generation == 0) {
+		// Generation wrapped around: reset the nodes for real
+		ranges::fill(AStarState->Matrix, Node{});
+		AStarState->Generation = 1;
 	}
-#endif
 }
 
 /**
 **  Clean up A*
 */
-static void CostMoveToCacheCleanUp();
 static void AStarCleanUp()
 {
 	ProfileBegin("AStarCleanUp");
 	AStarPrepare();
-	CostMoveToCacheCleanUp();
 	ProfileEnd("AStarCleanUp");
 }
 
-static void CostMoveToCacheCleanUp()
+/**
+**  Get the node at offset for the current search.
+*/
+static inline Node &AStarNode(unsigned int offset)
+{
+	Node &node = AStarState->Matrix[offset];
+	if (node.Generation != AStarState->Generation) {
+		node = Node{};
+		node.Generation = AStarState->Generation;
+#ifdef DEBUG
+		node.SetDirection(-1);
+#endif
+	}
+	return node;
+}
+
+/**
+**  Get the node at offset as left by the last search, without resetting it.
+*/
+static inline const Node &AStarLastNode(unsigned int offset)
+{
+	static const Node outdated = [] {
+		Node node;
+#ifdef DEBUG
+		node.SetDirection(-1);
+#endif
+		return node;
+	}();
+	const Node &node = AStarState->Matrix[offset];
+	return node.Generation == AStarState->Generation ? node : outdated;
+}
+
+/**
+**  Order of the open set: total cost, then estimated cost to goal,
+**  then distance to goal, then offset so that the order is total.
+*/
+static inline bool AStarOpenBefore(const Open &lhs, const Open &rhs)
+{
+	if (lhs.GetCosts() != rhs.GetCosts()) {
+		return lhs.GetCosts() < rhs.GetCosts();
+	}
+	if (lhs.GetTieBreak() != rhs.GetTieBreak()) {
+		return lhs.GetTieBreak() < rhs.GetTieBreak();
+	}
+	return lhs.GetOffset() < rhs.GetOffset();
+}
+
+/**
+**  Put open at position pos of the open set.
+*/
+static inline void AStarPlaceNode(int pos, const Open &open)
+{
+	AStarState->OpenSet[pos] = open;
+	AStarState->Matrix[open.GetOffset()].OpenIndex = pos;
+}
+
+/**
+**  Move the node at pos toward the top of the heap.
+*/
+static void AStarSiftUp(int pos)
 {
-	ranges::fill(CostMoveToCache, CacheNotSet);
+	const Open open = AStarState->OpenSet[pos];
+
+	while (pos > 0) {
+		const int parent = (pos - 1) / 2;
+		if (!AStarOpenBefore(open, AStarState->OpenSet[parent])) {
+			break;
+		}
+		AStarPlaceNode(pos, AStarState->OpenSet[parent]);
+		pos = parent;
+	}
+	AStarPlaceNode(pos, open);
+}
+
+/**
+**  Move the node at pos toward the bottom of the heap.
+*/
+static void AStarSiftDown(int pos)
+{
+	const Open open = AStarState->OpenSet[pos];
+
+	while (true) {
+		int child = 2 * pos + 1;
+		if (child >= AStarState->OpenSetSize) {
+			break;
+		}
+		if (child + 1 < AStarState->OpenSetSize && AStarOpenBefore(AStarState->OpenSet[child + 1], AStarState->OpenSet[child])) {
+			++child;
+		}
+		if (!AStarOpenBefore(AStarState->OpenSet[child], open)) {
+			break;
+		}
+		AStarPlaceNode(pos, AStarState->OpenSet[child]);
+		pos = child;
+	}
+	AStarPlaceNode(pos, open);
 }
 
 /**
 **  Find the best node in the current open node set
 **  Returns the position of this node in the open node set
 */
-#define AStarFindMinimum() (OpenSetSize - 1)
+#define AStarFindMinimum() (0)
 
 
 /**
@@ -408,9 +546,16 @@ static void CostMoveToCacheCleanUp()
 */
 static void AStarRemoveMinimum(int pos)
 {
-	Assert(pos == OpenSetSize - 1);
-
-	OpenSetSize--;
+	ProfileBegin("AStarRemoveMinimum");
+	Assert(pos == 0 && AStarState->OpenSetSize > 0);
+
+	AStarState->Matrix[AStarState->OpenSet[0].GetOffset()].OpenIndex = -1;
+	AStarState->OpenSetSize--;
+	if (AStarState->OpenSetSize > 0) {
+		AStarPlaceNode(0, AStarState->OpenSet[AStarState->OpenSetSize]);
+		AStarSiftDown(0);
+	}
+	ProfileEnd("AStarRemoveMinimum");
 }
 
 /**
@@ -422,58 +567,20 @@ static inline int AStarAddNode(const Vec2i &pos, int64_t costs)
 {
 	ProfileBegin("AStarAddNode");
 
-	int32_t bigi = 0, smalli = OpenSetSize;
-	int32_t midi;
-	uint32_t midcost;
-	int32_t midCostToGoal;
-	int32_t midDist;
-	const Open *open;
-
-	if (OpenSetSize + 1 >= OpenSet.size()) {
+	if (AStarState->OpenSetSize + 1 >= AStarState->OpenSet.size()) {
 		ErrorPrint("A* internal error: raise Open Set Max Size (current value %d)\n",
-		           (int)OpenSet.size());
+		           (int)AStarState->OpenSet.size());
 		ProfileEnd("AStarAddNode");
 		return PF_FAILED;
 	}
 
-	const int costToGoal = costs;
-	const int dist = std::abs(pos.x - AStarGoalX) + std::abs(pos.y - AStarGoalY);
-
-	// find where we should insert this node.
-	// binary search where to insert the new node
-	while (bigi < smalli) {
-		midi = (smalli + bigi) >> 1;
-		open = &OpenSet[midi];
-		midcost = open->GetCosts();
-		midCostToGoal = AStarMatrix[open->GetOffset()].GetCostToGoal();
-		midDist = std::abs(open->pos.x - AStarGoalX) + std::abs(open->pos.y - AStarGoalY);
-		if (costs > midcost || (costs == midcost
-								&& (costToGoal > midCostToGoal || (costToGoal == midCostToGoal
-																   && dist > midDist)))) {
-			smalli = midi;
-		} else if (costs < midcost || (costs == midcost
-									   && (costToGoal < midCostToGoal || (costToGoal == midCostToGoal
-											   && dist < midDist)))) {
-			if (bigi == midi) {
-				bigi++;
-			} else {
-				bigi = midi;
-			}
-		} else {
-			bigi = midi;
-			smalli = midi;
-		}
-	}
-
-	if (OpenSetSize > bigi) {
-		// free a the slot for our node
-		memmove(&OpenSet[bigi + 1], &OpenSet[bigi], (OpenSetSize - bigi) * sizeof(Open));
-	}
-
-	// fill our new node
-	OpenSet[bigi].pos = pos;
-	OpenSet[bigi].SetCosts(costs);
-	++OpenSetSize;
+	// fill our new node at the bottom of the heap
+	Open &open = AStarState->OpenSet[AStarState->OpenSetSize];
+	open.pos = pos;
+	open.SetCosts(costs);
+	open.SetTieBreak(AStarState->Matrix[open.GetOffset()].GetCostToGoal(),
+	                 std::abs(pos.x - AStarGoalX) + std::abs(pos.y - AStarGoalY));
+	AStarSiftUp(AStarState->OpenSetSize++);
 
 	ProfileEnd("AStarAddNode");
 
@@ -481,23 +588,17 @@ static inline int AStarAddNode(const Vec2i &pos, int64_t costs)
 }
 
 /**
-**  Change the cost associated to an open node.
-**  Can be further optimized knowing that the new cost MUST BE LOWER
-**  than the old one.
+**  Lower the cost associated to an open node.
+**  The new cost MUST BE LOWER than the old one.
 */
-static void AStarReplaceNode(int pos)
+static void AStarReplaceNode(int pos, int64_t costs)
 {
 	ProfileBegin("AStarReplaceNode");
 
-	Open node;
-
-	// Remove the outdated node
-	node = OpenSet[pos];
-	OpenSetSize--;
-	memmove(&OpenSet[pos], &OpenSet[pos+1], sizeof(Open) * (OpenSetSize-pos));
+	Assert(costs <= AStarState->OpenSet[pos].GetCosts());
+	AStarState->OpenSet[pos].SetCosts(costs);
+	AStarSiftUp(pos);
 
-	// Re-add the node with the new cost
-	AStarAddNode(node.pos, node.GetCosts());
 	ProfileEnd("AStarReplaceNode");
 }
 
@@ -509,16 +610,7 @@ static void AStarReplaceNode(int pos)
 */
 static int AStarFindNode(int eo)
 {
-	ProfileBegin("AStarFindNode");
-
-	for (int i = 0; i < OpenSetSize; ++i) {
-		if (OpenSet[i].GetOffset() == eo) {
-			ProfileEnd("AStarFindNode");
-			return i;
-		}
-	}
-	ProfileEnd("AStarFindNode");
-	return -1;
+	return AStarNode(eo).OpenIndex;
 }
 
 #define GetIndex(x, y) (x) + (y) * AStarMapWidth
@@ -546,7 +638,7 @@ static int CostMoveToCallBack_Default(unsigned int index, const CUnit &unit)
 		int i = w;
 		do {
 			const int flag = mf->Flags & mask;
-			if (flag && (AStarKnowUnseenTerrain || mf->playerInfo.IsExplored(*unit.Player))) {
+			if (flag && (AStarKnowUnseenTerrain || mf->playerInfo().IsExplored(*unit.Player))) {
 				if (flag & ~(MapFieldLandUnit | MapFieldAirUnit | MapFieldSeaUnit)) {
 					// we can't cross fixed units and other unpassable things
 #ifdef DEBUG
@@ -554,8 +646,8 @@ static int CostMoveToCallBack_Default(unsigned int index, const CUnit &unit)
 #endif
 					return -1;
 				}
-				auto it = ranges::find_if(mf->UnitCache, unit_finder);
-				CUnit *goal = it != mf->UnitCache.end() ? *it : nullptr;
+				auto it = ranges::find_if(mf->UnitCache(), unit_finder);
+				CUnit *goal = it != mf->UnitCache().end() ? *it : nullptr;
 				if (!goal) {
 					// Shouldn't happen, mask says there is something on this tile
 					Assert(0);
@@ -591,7 +683,7 @@ static int CostMoveToCallBack_Default(unsigned int index, const CUnit &unit)
 				}
 			}
 			// Add cost of crossing unknown tiles if required
-			if (!AStarKnowUnseenTerrain && !mf->playerInfo.IsExplored(*unit.Player)) {
+			if (!AStarKnowUnseenTerrain && !mf->playerInfo().IsExplored(*unit.Player)) {
 				// Tend against unknown tiles.
 				cost += AStarUnknownTerrainCost;
 			}
@@ -621,9 +713,9 @@ static int CostMoveToCallBack_Default(unsigned int index, const CUnit &unit)
 */
 static inline int CostMoveTo(unsigned int index, const CUnit &unit)
 {
-	int32_t *c = &CostMoveToCache[index];
+	int32_t *c = &AStarNode(index).CostMoveTo;
 	if (*c != CacheNotSet) {
-		// for performance reasons, CostMoveToCache uses -1 to
+		// for performance reasons, the cache uses -1 to
 		// indicate it is unset, but the algorithm is simpler
 		// if the range of costs is [-1, INT_MAX]. so we always
 		// store everything +1
@@ -644,7 +736,7 @@ class AStarGoalMarker
 	void operator()(int offset)
 	{
 		if (CostMoveTo(offset, unit) >= 0) {
-			AStarMatrix[offset].SetInGoal();
+			AStarNode(offset).SetInGoal();
 			goal_reachable = true;
 		}
 	}
@@ -832,7 +924,7 @@ static bool AStarMarkGoal(const Vec2i &goal,
 		}
 		unsigned int offset = GetIndex(goal.x, goal.y);
 		if (CostMoveTo(offset, unit) >= 0) {
-			AStarMatrix[offset].SetInGoal();
+			AStarNode(offset).SetInGoal();
 			ProfileEnd("AStarMarkGoal");
 			return true;
 		} else {
@@ -861,6 +953,27 @@ static bool AStarMarkGoal(const Vec2i &goal,
 	return aStarGoalMarker.isGoalReachable();
 }
 
+/**
+**  Call func with the index of each tile where the top left corner of the
+**  unit is in range of the goal, whatever the passability of the tile.
+*/
+void AStarForEachGoalTile(const Vec2i &goal, int gw, int gh, int tilesizex, int tilesizey,
+                          int minrange, int maxrange, const std::function<void(unsigned int)> &func)
+{
+	if (minrange == 0 && maxrange == 0 && gw == 0 && gh == 0) {
+		if (goal.x + tilesizex <= AStarMapWidth && goal.y + tilesizey <= AStarMapHeight) {
+			func(GetIndex(goal.x, goal.y));
+		}
+		return;
+	}
+	MinMaxRangeVisitor<const std::function<void(unsigned int)>> visitor(func);
+
+	visitor.SetGoal(goal, Vec2i(goal.x + std::max(gw, 1) - 1, goal.y + std::max(gh, 1) - 1));
+	visitor.SetRange(minrange, maxrange);
+	visitor.SetUnitSize(Vec2i(tilesizex, tilesizey));
+	visitor.Visit();
+}
+
 /**
 **  Save the path
 **
@@ -879,7 +992,7 @@ static int AStarSavePath(const Vec2i &startPos, const Vec2i &endPos, char *path,
 	Vec2i curr = endPos;
 	int currO = curr.y * AStarMapWidth;
 	while (curr != startPos) {
-		direction = AStarMatrix[currO + curr.x].GetDirection();
+		direction = AStarState->Matrix[currO + curr.x].GetDirection();
 #ifdef DEBUG
 		Assert(direction >= 0 && direction < 8);
 #endif
@@ -896,7 +1009,7 @@ static int AStarSavePath(const Vec2i &startPos, const Vec2i &endPos, char *path,
 		curr = endPos;
 		currO = curr.y * AStarMapWidth;
 		while (curr != startPos) {
-			direction = AStarMatrix[currO + curr.x].GetDirection();
+			direction = AStarState->Matrix[currO + curr.x].GetDirection();
 #ifdef DEBUG
 			Assert(direction >= 0 && direction < 8);
 #endif
@@ -995,8 +1108,13 @@ int AStarFindPath(const Vec2i &startPos, const Vec2i &goalPosIn, int gw, int gh,
 	const int maxMapX = AStarMapWidth + 1 - tilesizex;
 	const int maxMapY = AStarMapHeight + 1 - tilesizey;
 
+	AStarPrepareThread();
 	AStarGoalX = goalPos.x;
 	AStarGoalY = goalPos.y;
+	AStarExpandedNodes = 0;
+
+	//  Initialize, this also outdates the costs cached by the previous search
+	AStarCleanUp();
 
 	//  Check for simple cases first
 	int ret = AStarFindSimplePath(startPos, goalPos, gw, gh, tilesizex, tilesizey,
@@ -1006,10 +1124,7 @@ int AStarFindPath(const Vec2i &startPos, const Vec2i &goalPosIn, int gw, int gh,
 		return ret;
 	}
 
-	//  Initialize
-	AStarCleanUp();
-
-	OpenSetSize = 0;
+	AStarState->OpenSetSize = 0;
 
 	if (!AStarMarkGoal(goalPos, gw, gh, tilesizex, tilesizey, minrange, maxrange, unit)) {
 		// goal is not reachable
@@ -1019,21 +1134,22 @@ int AStarFindPath(const Vec2i &startPos, const Vec2i &goalPosIn, int gw, int gh,
 	}
 
 	int eo = startPos.y * AStarMapWidth + startPos.x;
+	Node &startNode = AStarNode(eo);
 	// it is quite important to start from 1 rather than 0, because we use
 	// 0 as a way to represent nodes that we have not visited yet.
-	AStarMatrix[eo].SetCostFromStart(1);
+	startNode.SetCostFromStart(1);
 	// 8 to say we are came from nowhere.
-	AStarMatrix[eo].SetDirection(8);
+	startNode.SetDirection(8);
 
 	// place start point in open, it that failed, try another pathfinder
 	int costToGoal = AStarCosts(startPos, goalPos);
-	AStarMatrix[eo].SetCostToGoal(costToGoal);
+	startNode.SetCostToGoal(costToGoal);
 	if (AStarAddNode(startPos, 1 + costToGoal) == PF_FAILED) {
 		ret = PF_FAILED;
 		ProfileEnd("AStarFindPath");
 		return ret;
 	}
-	if (AStarMatrix[eo].IsInGoal()) {
+	if (startNode.IsInGoal()) {
 		ret = PF_REACHED;
 		ProfileEnd("AStarFindPath");
 		return ret;
@@ -1051,14 +1167,16 @@ int AStarFindPath(const Vec2i &startPos, const Vec2i &goalPosIn, int gw, int gh,
 		}
 #endif
 		const int shortest = AStarFindMinimum();
-		const int x = OpenSet[shortest].pos.x;
-		const int y = OpenSet[shortest].pos.y;
-		const int o = OpenSet[shortest].GetOffset();
+		const int x = AStarState->OpenSet[shortest].pos.x;
+		const int y = AStarState->OpenSet[shortest].pos.y;
+		const int o = AStarState->OpenSet[shortest].GetOffset();
 
 		AStarRemoveMinimum(shortest);
+		++AStarExpandedNodes;
+		const Node &current = AStarState->Matrix[o];
 
 		// If we have reached the goal, then exit.
-		if (AStarMatrix[o].IsInGoal()) {
+		if (current.IsInGoal()) {
 			endPos.x = x;
 			endPos.y = y;
 			break;
@@ -1079,10 +1197,10 @@ int AStarFindPath(const Vec2i &startPos, const Vec2i &goalPosIn, int gw, int gh,
 
 		// Node that this node was generated from.
 #ifdef DEBUG
-		Assert(AStarMatrix[o].GetDirection() >= 0 && (AStarMatrix[o].GetDirection() < 8 || (x == startPos.x && y == startPos.y)));
+		Assert(current.GetDirection() >= 0 && (current.GetDirection() < 8 || (x == startPos.x && y == startPos.y)));
 #endif
-		const int px = x - Heading2X[(int)AStarMatrix[o].GetDirection()];
-		const int py = y - Heading2Y[(int)AStarMatrix[o].GetDirection()];
+		const int px = x - Heading2X[(int)current.GetDirection()];
+		const int py = y - Heading2Y[(int)current.GetDirection()];
 
 		for (int i = 0; i < 8; ++i) {
 			endPos.x = x + Heading2X[i];
@@ -1104,7 +1222,7 @@ int AStarFindPath(const Vec2i &startPos, const Vec2i &goalPosIn, int gw, int gh,
 			//eo = GetIndex(ex, ey);
 			eo = o + Heading2X[i] + Heading2O[i];
 
-			if (eo < 0 || eo >= CostMoveToCache.size()) {
+			if (eo < 0 || eo >= AStarState->Matrix.size()) {
 				// inaccessible tile
 				continue;
 			}
@@ -1118,32 +1236,33 @@ int AStarFindPath(const Vec2i &startPos, const Vec2i &goalPosIn, int gw, int gh,
 				continue;
 			}
 
+			Node &next = AStarState->Matrix[eo]; // initialized by CostMoveTo
 			// Add a cost for walking to make paths more realistic for the user.
 			new_cost++;
-			new_cost += AStarMatrix[o].GetCostFromStart();
-			if (AStarMatrix[eo].GetCostFromStart() == 0) {
+			new_cost += current.GetCostFromStart();
+			if (next.GetCostFromStart() == 0) {
 				--counter;
 				// we are sure the current node has not been already visited
-				AStarMatrix[eo].SetCostFromStart(new_cost);
-				AStarMatrix[eo].SetDirection(i);
+				next.SetCostFromStart(new_cost);
+				next.SetDirection(i);
 				costToGoal = AStarCosts(endPos, goalPos);
-				AStarMatrix[eo].SetCostToGoal(costToGoal);
+				next.SetCostToGoal(costToGoal);
 				if (AStarAddNode(endPos, new_cost + costToGoal) == PF_FAILED) {
 					ret = PF_FAILED;
 					ProfileEnd("AStarFindPath");
 					return ret;
 				}
-			} else if (new_cost < AStarMatrix[eo].GetCostFromStart()) {
+			} else if (new_cost < next.GetCostFromStart()) {
 				--counter;
 				// Already visited node, but we have here a better path
 				// I know, it's redundant (but simpler like this)
-				AStarMatrix[eo].SetCostFromStart(new_cost);
-				AStarMatrix[eo].SetDirection(i);
+				next.SetCostFromStart(new_cost);
+				next.SetDirection(i);
 				// this point might be already in the OpenSet
 				const int j = AStarFindNode(eo);
 				if (j == -1) {
 					costToGoal = AStarCosts(endPos, goalPos);
-					AStarMatrix[eo].SetCostToGoal(costToGoal);
+					next.SetCostToGoal(costToGoal);
 					if (AStarAddNode(endPos, new_cost + costToGoal) == PF_FAILED) {
 						ret = PF_FAILED;
 						ProfileEnd("AStarFindPath");
@@ -1151,13 +1270,13 @@ int AStarFindPath(const Vec2i &startPos, const Vec2i &goalPosIn, int gw, int gh,
 					}
 				} else {
 					costToGoal = AStarCosts(endPos, goalPos);
-					AStarMatrix[eo].SetCostToGoal(costToGoal);
-					AStarReplaceNode(j);
+					next.SetCostToGoal(costToGoal);
+					AStarReplaceNode(j, new_cost + costToGoal);
 				}
 				// we don't have to add this point to the close set
 			}
 		}
-		if (OpenSetSize <= 0) { // no new nodes generated
+		if (AStarState->OpenSetSize <= 0) { // no new nodes generated
 			ret = PF_UNREACHABLE;
 			ProfileEnd("AStarFindPath");
 			return ret;
@@ -1176,15 +1295,32 @@ int AStarFindPath(const Vec2i &startPos, const Vec2i &goalPosIn, int gw, int gh,
 	return ret;
 }
 
+/**
+**  Number of nodes expanded by the last search.
+*/
+unsigned int AStarGetExpandedNodes()
+{
+	return AStarExpandedNodes;
+}
+
 void AStarDumpStats()
 {
+	fprintf(stdout, "A* expanded nodes: %u, last hierarchical search: %u abstract / %u refined\n",
+	        AStarExpandedNodes, HPAStarAbstractNodes, HPAStarRefinedNodes);
+	fprintf(stdout, "Searches skipped between disconnected regions: %u\n", RegionRejectedSearches);
+	if (AStarState == nullptr) {
+		return;
+	}
+
 	int32_t maxCostFromHome = 0;
 	int32_t minCostFromHome = INT_MAX;
 	int32_t maxCostToGoal = 0;
 	int32_t minCostToGoal = INT_MAX;
 
-	for (const Node &m : AStarMatrix) {
-		
+	// outdated nodes are shown as not visited, so that only the last search is shown
+	for (unsigned int offset = 0; offset != AStarState->Matrix.size(); ++offset) {
+		const Node &m = AStarLastNode(offset);
+
 		maxCostFromHome = std::max(maxCostFromHome, m.GetCostFromStart());
 		maxCostToGoal = std::max(maxCostToGoal, m.GetCostToGoal());
 		minCostFromHome = m.GetCostFromStart() ? std::min(minCostFromHome, m.GetCostFromStart()) : minCostFromHome;
@@ -1196,7 +1332,8 @@ void AStarDumpStats()
 	if (minCostFromHome) minCostFromHome--;
 
 	int i = 0;
-	for (const Node &m : AStarMatrix) {
+	for (unsigned int offset = 0; offset != AStarState->Matrix.size(); ++offset) {
+		const Node &m = AStarLastNode(offset);
 		int r = 0;
 		int g = 0;
 		if (m.GetCostFromStart() && maxCostFromHome - minCostFromHome) {
@@ -1251,9 +1388,12 @@ void AStarDumpStats()
 void DrawLastAStar(const CViewport& vp)
 {
 #if defined(DEBUG_ASTAR)
+	if (AStarState == nullptr) {
+		return;
+	}
 	for (auto y = vp.MapPos.y; y != vp.MapPos.y + vp.MapHeight; ++y) {
 		for (auto x = vp.MapPos.x; x != vp.MapPos.x + vp.MapWidth; ++x) {
-			const auto &node = AStarMatrix[GetIndex(x, y)];
+			const auto &node = AStarLastNode(GetIndex(x, y));
 			const auto direction = node.GetDirection();
 			if (direction == 255) {
 				continue;
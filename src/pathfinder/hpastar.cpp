@@ -0,0 +1,647 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name hpastar.cpp - The hierarchical a* path finder routines. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+// The map is cut into square clusters. Each pair of neighbour clusters is
+// linked by "portals": passable tiles facing each other across the shared
+// border. Inside a cluster, portals are linked by their real walking cost.
+// A long range query first searches this small abstract graph, then the
+// regular a* only refines the path up to the first abstract node which is
+// farther away than what PathFinderOutput can store. The remaining part is
+// computed again once the unit has walked the refined part.
+//
+// The abstraction only considers static obstacles (terrain, walls and
+// buildings), moving units are left to the refining a*. It is kept up to
+// date by HPAStarTerrainChanged. Whenever the abstraction can't help (close
+// goal, big unit, no abstract path), the caller falls back to the plain a*.
+
+//@{
+
+/*----------------------------------------------------------------------------
+--  Includes
+----------------------------------------------------------------------------*/
+
+#include "stratagus.h"
+
+#include "pathfinder.h"
+
+#include "map.h"
+#include "unit.h"
+#include "unittype.h"
+
+#include <climits>
+#include <map>
+#include <queue>
+#include <unordered_map>
+
+/// Find and a* path for a unit
+extern int AStarFindPath(const Vec2i &startPos, const Vec2i &goalPos, int gw, int gh,
+						 int tilesizex, int tilesizey, int minrange,
+						 int maxrange, char *path, int pathlen, const CUnit &unit);
+/// Number of nodes expanded by the last a* search
+extern unsigned int AStarGetExpandedNodes();
+
+/*----------------------------------------------------------------------------
+--  Declarations
+----------------------------------------------------------------------------*/
+
+namespace
+{
+
+/// Borders owned by a cluster. The others are owned by the neighbour clusters.
+enum EHPABorder {
+	HPABorderEast,
+	HPABorderSouth,
+	HPABorderSouthEast,
+	HPABorderSouthWest,
+	HPABorderCount
+};
+
+/// Runs of passable border tiles at least this long get a portal at each end
+constexpr int HPALongEntranceLength = 6;
+
+struct HPAEdge
+{
+	unsigned int To = 0; /// tile index of the reached portal
+	int Cost = 0;        /// walking cost, in a* cost units
+};
+
+struct HPACluster
+{
+	std::vector<unsigned int> Portals;       /// sorted tile indexes of the entrances
+	std::vector<std::vector<HPAEdge>> Edges; /// intra cluster edges, parallel to Portals
+};
+
+/// Facing tile indexes, the first one is inside the cluster owning the border
+using HPABorder = std::vector<std::pair<unsigned int, unsigned int>>;
+
+/**
+**  Abstraction of the map for one movement mask.
+*/
+class HPALayer
+{
+public:
+	HPALayer(tile_flags mask, int clusterSize);
+
+	void MarkDirty(const Vec2i &pos, int w, int h);
+	bool FindAbstractPath(const Vec2i &startPos, const Vec2i &goalPos, std::vector<unsigned int> &result);
+
+	int ClusterOf(const Vec2i &pos) const
+	{
+		return (pos.y / ClusterSize) * ClustersX + pos.x / ClusterSize;
+	}
+
+private:
+	bool IsPassable(unsigned int index) const { return !Map.Field(index)->CheckMask(Mask); }
+	int EnterCost(unsigned int index) const { return 1 + Map.Field(index)->getMoveCost(); }
+
+	void Refresh();
+	void ComputeBorder(int cx, int cy, EHPABorder dir);
+	void AddEntrance(HPABorder &border, const Vec2i &first, const Vec2i &last, const Vec2i &offset);
+	void ComputeCluster(int cx, int cy);
+	void ClusterDistances(int cluster, unsigned int from, std::vector<int> &dist);
+
+	template <typename F>
+	void ForEachBorderOf(int cluster, F &&f) const;
+
+private:
+	tile_flags Mask;
+	int ClusterSize;
+	int ClustersX;
+	int ClustersY;
+	std::vector<HPACluster> Clusters;
+	std::vector<HPABorder> Borders;  /// indexed by cluster * HPABorderCount + EHPABorder
+	std::vector<bool> Dirty;         /// clusters whose terrain changed
+	bool AnyDirty = true;
+};
+
+} // namespace
+
+/*----------------------------------------------------------------------------
+--  Variables
+----------------------------------------------------------------------------*/
+
+/// see pathfinder.h
+bool AStarHierarchical = false;
+int AStarHierarchicalClusterSize = 16;
+
+/// Number of abstract nodes expanded by the last hierarchical search
+unsigned int HPAStarAbstractNodes;
+/// Number of a* nodes expanded to refine the last hierarchical search
+unsigned int HPAStarRefinedNodes;
+
+/// One abstraction per movement mask, built on demand
+static std::map<tile_flags, HPALayer> HPALayers;
+
+/*----------------------------------------------------------------------------
+--  Methods
+----------------------------------------------------------------------------*/
+
+HPALayer::HPALayer(tile_flags mask, int clusterSize) :
+	Mask(mask),
+	ClusterSize(clusterSize),
+	ClustersX((Map.Info.MapWidth + clusterSize - 1) / clusterSize),
+	ClustersY((Map.Info.MapHeight + clusterSize - 1) / clusterSize)
+{
+	Clusters.resize(ClustersX * ClustersY);
+	Borders.resize(ClustersX * ClustersY * HPABorderCount);
+	Dirty.resize(ClustersX * ClustersY, true);
+}
+
+/**
+**  Call f(border, owned) for each border touching the cluster.
+**  owned is true when the first tile of the border pairs is inside the cluster.
+*/
+template <typename F>
+void HPALayer::ForEachBorderOf(int cluster, F &&f) const
+{
+	const int cx = cluster % ClustersX;
+	const int cy = cluster / ClustersX;
+
+	for (int dir = 0; dir != HPABorderCount; ++dir) {
+		f(Borders[cluster * HPABorderCount + dir], true);
+	}
+	if (cx > 0) {
+		f(Borders[(cluster - 1) * HPABorderCount + HPABorderEast], false);
+	}
+	if (cy > 0) {
+		f(Borders[(cluster - ClustersX) * HPABorderCount + HPABorderSouth], false);
+	}
+	if (cx > 0 && cy > 0) {
+		f(Borders[(cluster - ClustersX - 1) * HPABorderCount + HPABorderSouthEast], false);
+	}
+	if (cx + 1 < ClustersX && cy > 0) {
+		f(Borders[(cluster - ClustersX + 1) * HPABorderCount + HPABorderSouthWest], false);
+	}
+}
+
+/**
+**  Mark the clusters covering the area as needing a rebuild.
+*/
+void HPALayer::MarkDirty(const Vec2i &pos, int w, int h)
+{
+	const int minx = std::max(0, pos.x / ClusterSize);
+	const int miny = std::max(0, pos.y / ClusterSize);
+	const int maxx = std::min(ClustersX - 1, (pos.x + w - 1) / ClusterSize);
+	const int maxy = std::min(ClustersY - 1, (pos.y + h - 1) / ClusterSize);
+
+	for (int cy = miny; cy <= maxy; ++cy) {
+		for (int cx = minx; cx <= maxx; ++cx) {
+			Dirty[cy * ClustersX + cx] = true;
+		}
+	}
+	AnyDirty = true;
+}
+
+/**
+**  Add portals for the run of passable tiles [first, last] of a border.
+*/
+void HPALayer::AddEntrance(HPABorder &border, const Vec2i &first, const Vec2i &last, const Vec2i &offset)
+{
+	const int length = std::max(last.x - first.x, last.y - first.y) + 1;
+
+	if (length >= HPALongEntranceLength) {
+		border.emplace_back(Map.getIndex(first), Map.getIndex(first + offset));
+		border.emplace_back(Map.getIndex(last), Map.getIndex(last + offset));
+	} else {
+		const Vec2i middle((first.x + last.x) / 2, (first.y + last.y) / 2);
+		border.emplace_back(Map.getIndex(middle), Map.getIndex(middle + offset));
+	}
+}
+
+/**
+**  Compute the portals of one border owned by the cluster (cx, cy).
+*/
+void HPALayer::ComputeBorder(int cx, int cy, EHPABorder dir)
+{
+	HPABorder &border = Borders[(cy * ClustersX + cx) * HPABorderCount + dir];
+	border.clear();
+
+	const int x0 = cx * ClusterSize;
+	const int y0 = cy * ClusterSize;
+	const int x1 = std::min(x0 + ClusterSize, Map.Info.MapWidth) - 1;
+	const int y1 = std::min(y0 + ClusterSize, Map.Info.MapHeight) - 1;
+
+	switch (dir) {
+		case HPABorderEast:
+		case HPABorderSouth: {
+			const bool east = dir == HPABorderEast;
+			if ((east && cx + 1 >= ClustersX) || (!east && cy + 1 >= ClustersY)) {
+				return;
+			}
+			const Vec2i offset = east ? Vec2i(1, 0) : Vec2i(0, 1);
+			const Vec2i step = east ? Vec2i(0, 1) : Vec2i(1, 0);
+			const Vec2i end = east ? Vec2i(x1, y1 + 1) : Vec2i(x1 + 1, y1);
+			Vec2i runStart(-1, -1);
+			Vec2i pos = east ? Vec2i(x1, y0) : Vec2i(x0, y1);
+
+			for (; pos != end; pos += step) {
+				const bool open = IsPassable(Map.getIndex(pos)) && IsPassable(Map.getIndex(pos + offset));
+				if (open && runStart.x == -1) {
+					runStart = pos;
+				} else if (!open && runStart.x != -1) {
+					AddEntrance(border, runStart, pos - step, offset);
+					runStart = Vec2i(-1, -1);
+				}
+			}
+			if (runStart.x != -1) {
+				AddEntrance(border, runStart, end - step, offset);
+			}
+			break;
+		}
+		case HPABorderSouthEast:
+		case HPABorderSouthWest: {
+			const bool southEast = dir == HPABorderSouthEast;
+			if (cy + 1 >= ClustersY || (southEast && cx + 1 >= ClustersX) || (!southEast && cx == 0)) {
+				return;
+			}
+			const Vec2i corner(southEast ? x1 : x0, y1);
+			const Vec2i offset(southEast ? 1 : -1, 1);
+			const unsigned int from = Map.getIndex(corner);
+			const unsigned int to = Map.getIndex(corner + offset);
+			if (IsPassable(from) && IsPassable(to)) {
+				border.emplace_back(from, to);
+			}
+			break;
+		}
+		default:
+			Assert(false);
+	}
+}
+
+/**
+**  Compute the walking cost from the tile 'from' to each tile of its cluster.
+**
+**  'from' itself is always accepted, so it may be a goal under a building.
+*/
+void HPALayer::ClusterDistances(int cluster, unsigned int from, std::vector<int> &dist)
+{
+	const int x0 = (cluster % ClustersX) * ClusterSize;
+	const int y0 = (cluster / ClustersX) * ClusterSize;
+	const int x1 = std::min(x0 + ClusterSize, Map.Info.MapWidth) - 1;
+	const int y1 = std::min(y0 + ClusterSize, Map.Info.MapHeight) - 1;
+	const int width = x1 - x0 + 1;
+	const auto local = [&](const Vec2i &pos) { return (pos.y - y0) * width + pos.x - x0; };
+
+	dist.assign(width * (y1 - y0 + 1), INT_MAX);
+
+	using Item = std::pair<int, unsigned int>;
+	std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+	const Vec2i fromPos(from % Map.Info.MapWidth, from / Map.Info.MapWidth);
+
+	dist[local(fromPos)] = 0;
+	open.emplace(0, from);
+	while (!open.empty()) {
+		const auto [cost, index] = open.top();
+		open.pop();
+		const Vec2i pos(index % Map.Info.MapWidth, index / Map.Info.MapWidth);
+		if (cost != dist[local(pos)]) {
+			continue;
+		}
+		for (int i = 0; i != 8; ++i) {
+			const Vec2i next(pos.x + Heading2X[i], pos.y + Heading2Y[i]);
+			if (next.x < x0 || next.x > x1 || next.y < y0 || next.y > y1) {
+				continue;
+			}
+			const unsigned int nextIndex = Map.getIndex(next);
+			if (!IsPassable(nextIndex)) {
+				continue;
+			}
+			const int nextCost = cost + EnterCost(nextIndex);
+			if (nextCost < dist[local(next)]) {
+				dist[local(next)] = nextCost;
+				open.emplace(nextCost, nextIndex);
+			}
+		}
+	}
+}
+
+/**
+**  Collect the portals of the cluster (cx, cy) and link them together.
+*/
+void HPALayer::ComputeCluster(int cx, int cy)
+{
+	const int cluster = cy * ClustersX + cx;
+	HPACluster &c = Clusters[cluster];
+
+	c.Portals.clear();
+	ForEachBorderOf(cluster, [&](const HPABorder &border, bool owned) {
+		for (const auto &[first, second] : border) {
+			c.Portals.push_back(owned ? first : second);
+		}
+	});
+	ranges::sort(c.Portals);
+	c.Portals.erase(std::unique(c.Portals.begin(), c.Portals.end()), c.Portals.end());
+
+	const int x0 = cx * ClusterSize;
+	const int y0 = cy * ClusterSize;
+	const int width = std::min(x0 + ClusterSize, Map.Info.MapWidth) - x0;
+	std::vector<int> dist;
+
+	c.Edges.assign(c.Portals.size(), {});
+	for (size_t i = 0; i != c.Portals.size(); ++i) {
+		ClusterDistances(cluster, c.Portals[i], dist);
+		for (size_t j = 0; j != c.Portals.size(); ++j) {
+			const unsigned int to = c.Portals[j];
+			const int cost = dist[(to / Map.Info.MapWidth - y0) * width + to % Map.Info.MapWidth - x0];
+			if (i != j && cost != INT_MAX) {
+				c.Edges[i].push_back({to, cost});
+			}
+		}
+	}
+}
+
+/**
+**  Rebuild the part of the abstraction touched by terrain changes.
+*/
+void HPALayer::Refresh()
+{
+	if (!AnyDirty) {
+		return;
+	}
+	std::vector<bool> recompute(Clusters.size(), false);
+
+	for (int cy = 0; cy != ClustersY; ++cy) {
+		for (int cx = 0; cx != ClustersX; ++cx) {
+			if (!Dirty[cy * ClustersX + cx]) {
+				continue;
+			}
+			// Borders owned by this cluster and by its west/north neighbours
+			for (int dy = -1; dy <= 1; ++dy) {
+				for (int dx = -1; dx <= 1; ++dx) {
+					const int nx = cx + dx;
+					const int ny = cy + dy;
+					if (nx < 0 || ny < 0 || nx >= ClustersX || ny >= ClustersY) {
+						continue;
+					}
+					recompute[ny * ClustersX + nx] = true;
+				}
+			}
+			for (int dir = 0; dir != HPABorderCount; ++dir) {
+				ComputeBorder(cx, cy, EHPABorder(dir));
+			}
+			if (cx > 0) {
+				ComputeBorder(cx - 1, cy, HPABorderEast);
+			}
+			if (cy > 0) {
+				ComputeBorder(cx, cy - 1, HPABorderSouth);
+			}
+			if (cx > 0 && cy > 0) {
+				ComputeBorder(cx - 1, cy - 1, HPABorderSouthEast);
+			}
+			if (cx + 1 < ClustersX && cy > 0) {
+				ComputeBorder(cx + 1, cy - 1, HPABorderSouthWest);
+			}
+		}
+	}
+	for (int cluster = 0; cluster != int(Clusters.size()); ++cluster) {
+		if (recompute[cluster]) {
+			ComputeCluster(cluster % ClustersX, cluster / ClustersX);
+		}
+	}
+	ranges::fill(Dirty, false);
+	AnyDirty = false;
+}
+
+/**
+**  Search the abstract graph.
+**
+**  @param startPos  Start tile of the unit.
+**  @param goalPos   Goal tile.
+**  @param result    Abstract nodes (tile indexes) from start to goal.
+**
+**  @return true if an abstract path was found.
+*/
+bool HPALayer::FindAbstractPath(const Vec2i &startPos, const Vec2i &goalPos, std::vector<unsigned int> &result)
+{
+	Refresh();
+	result.clear();
+
+	const int startCluster = ClusterOf(startPos);
+	const int goalCluster = ClusterOf(goalPos);
+	std::vector<int> dist;
+
+	// Costs from the goal to the portals of its cluster
+	std::unordered_map<unsigned int, int> goalCosts;
+	ClusterDistances(goalCluster, Map.getIndex(goalPos), dist);
+	{
+		const HPACluster &c = Clusters[goalCluster];
+		const int x0 = (goalCluster % ClustersX) * ClusterSize;
+		const int y0 = (goalCluster / ClustersX) * ClusterSize;
+		const int width = std::min(x0 + ClusterSize, Map.Info.MapWidth) - x0;
+		for (unsigned int portal : c.Portals) {
+			const int cost = dist[(portal / Map.Info.MapWidth - y0) * width + portal % Map.Info.MapWidth - x0];
+			if (cost != INT_MAX) {
+				goalCosts[portal] = cost;
+			}
+		}
+	}
+	if (goalCosts.empty()) {
+		return false;
+	}
+
+	constexpr unsigned int StartNode = UINT_MAX - 1;
+	constexpr unsigned int GoalNode = UINT_MAX;
+	struct NodeInfo {
+		int Cost;
+		unsigned int Parent;
+	};
+	std::unordered_map<unsigned int, NodeInfo> nodes;
+	// (estimated total cost, tile index): the index makes the order deterministic
+	using Item = std::pair<int, unsigned int>;
+	std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+
+	const auto heuristic = [&](unsigned int index) {
+		if (index == GoalNode) {
+			return 0;
+		}
+		const int x = index % Map.Info.MapWidth;
+		const int y = index / Map.Info.MapWidth;
+		return std::max(std::abs(x - goalPos.x), std::abs(y - goalPos.y));
+	};
+	const auto relax = [&](unsigned int from, unsigned int to, int cost) {
+		auto it = nodes.find(to);
+		if (it == nodes.end() || cost < it->second.Cost) {
+			nodes[to] = {cost, from};
+			open.emplace(cost + heuristic(to), to);
+		}
+	};
+
+	// Costs from the start to the portals of its cluster
+	ClusterDistances(startCluster, Map.getIndex(startPos), dist);
+	{
+		const HPACluster &c = Clusters[startCluster];
+		const int x0 = (startCluster % ClustersX) * ClusterSize;
+		const int y0 = (startCluster / ClustersX) * ClusterSize;
+		const int width = std::min(x0 + ClusterSize, Map.Info.MapWidth) - x0;
+		for (unsigned int portal : c.Portals) {
+			const int cost = dist[(portal / Map.Info.MapWidth - y0) * width + portal % Map.Info.MapWidth - x0];
+			if (cost != INT_MAX) {
+				relax(StartNode, portal, cost);
+			}
+		}
+	}
+
+	while (!open.empty()) {
+		const auto [estimate, index] = open.top();
+		open.pop();
+		const NodeInfo info = nodes[index];
+		if (estimate != info.Cost + heuristic(index)) {
+			continue; // outdated entry
+		}
+		++HPAStarAbstractNodes;
+		if (index == GoalNode) {
+			for (unsigned int node = info.Parent; node != StartNode; node = nodes[node].Parent) {
+				result.push_back(node);
+			}
+			ranges::reverse(result);
+			return true;
+		}
+		const Vec2i pos(index % Map.Info.MapWidth, index / Map.Info.MapWidth);
+		const int cluster = ClusterOf(pos);
+		const HPACluster &c = Clusters[cluster];
+		const auto it = ranges::lower_bound(c.Portals, index);
+
+		Assert(it != c.Portals.end() && *it == index);
+		for (const HPAEdge &edge : c.Edges[it - c.Portals.begin()]) {
+			relax(index, edge.To, info.Cost + edge.Cost);
+		}
+		ForEachBorderOf(cluster, [&](const HPABorder &border, bool owned) {
+			for (const auto &[first, second] : border) {
+				const unsigned int from = owned ? first : second;
+				const unsigned int to = owned ? second : first;
+				if (from == index) {
+					relax(index, to, info.Cost + EnterCost(to));
+				}
+			}
+		});
+		if (cluster == goalCluster) {
+			auto goalIt = goalCosts.find(index);
+			if (goalIt != goalCosts.end()) {
+				relax(index, GoalNode, info.Cost + goalIt->second);
+			}
+		}
+	}
+	return false;
+}
+
+/*----------------------------------------------------------------------------
+--  Functions
+----------------------------------------------------------------------------*/
+
+/// Mask of the obstacles considered by the abstraction
+static tile_flags HPAStarStaticMask(tile_flags mask)
+{
+	return mask & ~(MapFieldLandUnit | MapFieldAirUnit | MapFieldSeaUnit);
+}
+
+/**
+**  Init hierarchical A* data structures
+*/
+void InitHPAStar()
+{
+	HPALayers.clear();
+}
+
+/**
+**  Free hierarchical A* data structures
+*/
+void FreeHPAStar()
+{
+	HPALayers.clear();
+}
+
+/**
+**  Passability of the area changed, update the abstractions.
+**
+**  @param pos  Top left tile of the changed area.
+**  @param w    Width of the area.
+**  @param h    Height of the area.
+*/
+void HPAStarTerrainChanged(const Vec2i &pos, int w, int h)
+{
+	for (auto &[mask, layer] : HPALayers) {
+		layer.MarkDirty(pos, w, h);
+	}
+}
+
+/**
+**  Find a path using the abstract graph, refined by a*.
+**
+**  Same parameters as AStarFindPath.
+**
+**  @return  Length of the refined part of the path,
+**           or PF_FAILED when the plain a* should be used.
+*/
+int HPAStarFindPath(const Vec2i &startPos, const Vec2i &goalPos, int gw, int gh,
+					int tilesizex, int tilesizey, int minrange, int maxrange,
+					char *path, int pathlen, const CUnit &unit)
+{
+	HPAStarAbstractNodes = 0;
+	HPAStarRefinedNodes = 0;
+
+	if (!AStarHierarchical || path == nullptr || tilesizex != 1 || tilesizey != 1
+		|| AStarHierarchicalClusterSize <= 0 || !Map.Info.IsPointOnMap(goalPos)) {
+		return PF_FAILED;
+	}
+	// Close goals are cheap enough for the plain a*
+	const int distance = std::max(std::abs(startPos.x - goalPos.x), std::abs(startPos.y - goalPos.y));
+	if (distance - std::max({gw, gh, maxrange}) <= 2 * AStarHierarchicalClusterSize) {
+		return PF_FAILED;
+	}
+
+	const tile_flags mask = HPAStarStaticMask(unit.Type->MovementMask);
+	auto it = HPALayers.find(mask);
+	if (it == HPALayers.end()) {
+		it = HPALayers.try_emplace(mask, mask, AStarHierarchicalClusterSize).first;
+	}
+	HPALayer &layer = it->second;
+
+	std::vector<unsigned int> abstractPath;
+	if (!layer.FindAbstractPath(startPos, goalPos, abstractPath)) {
+		return PF_FAILED;
+	}
+
+	// Refine up to the first node too far away to be stored in the path
+	const int goalCluster = layer.ClusterOf(goalPos);
+	for (unsigned int index : abstractPath) {
+		const Vec2i waypoint(index % Map.Info.MapWidth, index / Map.Info.MapWidth);
+		if (layer.ClusterOf(waypoint) == goalCluster) {
+			break;
+		}
+		if (std::max(std::abs(waypoint.x - startPos.x), std::abs(waypoint.y - startPos.y)) < PathFinderOutput::MAX_PATH_LENGTH) {
+			continue;
+		}
+		const int res = AStarFindPath(startPos, waypoint, 0, 0, 1, 1, 0, 0, path, pathlen, unit);
+		HPAStarRefinedNodes = AStarGetExpandedNodes();
+		return res > 0 ? res : PF_FAILED;
+	}
+	return PF_FAILED;
+}
+
+//@}
@@ -0,0 +1,434 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name pathcache.cpp - Flow fields shared by units going to the same goal. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+// When a group of units is sent to the same place, each of them asks for
+// nearly the same path. The second request for a goal starts a flow field:
+// a reverse search from the goal, storing for each tile the direction of
+// the next step and the remaining number of steps. Any further unit with
+// the same movement mask, size and goal just follows the directions,
+// without running a*.
+//
+// The reverse search is resumed by each request only until it reaches the
+// tile of the unit, and expands at most AStarMaxSearchIterations tiles per
+// request, so the field only grows as far as the units come from and a
+// request never costs more than an a* search.
+//
+// Like the hierarchical layer, flow fields only consider static obstacles,
+// so they are only used far away from the goal, where the crowd is not.
+// They are dropped when the terrain changes in the area they have looked at
+// (see PathfinderTerrainChanged) and after a while, so that the exploration
+// and the fixed units are taken into account again.
+//
+// A path of a flow field is not the path a* would find, and the flow fields
+// are neither saved nor rebuilt on load: the game only stays the same if
+// the flow fields are used from the first cycle, in the same way. So they
+// are used before PathCacheEndCycle only:
+//  - never in network games, where each client has its own AStar options;
+//  - in games started from the map, until the end, if "path-cache" is set;
+//  - no longer once a game is loaded from a save;
+//  - in replays, until the cycle recorded in the replay (see replay.cpp).
+
+//@{
+
+/*----------------------------------------------------------------------------
+--  Includes
+----------------------------------------------------------------------------*/
+
+#include "stratagus.h"
+
+#include "pathfinder.h"
+
+#include "game.h"
+#include "map.h"
+#include "network.h"
+#include "player.h"
+#include "replay.h"
+#include "settings.h"
+#include "unit.h"
+#include "unittype.h"
+
+#include <climits>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <utility>
+
+/// Call func for each tile in range of the goal
+extern void AStarForEachGoalTile(const Vec2i &goal, int gw, int gh, int tilesizex, int tilesizey,
+								 int minrange, int maxrange, const std::function<void(unsigned int)> &func);
+
+/*----------------------------------------------------------------------------
+--  Declarations
+----------------------------------------------------------------------------*/
+
+namespace
+{
+
+/// Everything a flow field depends on
+struct PathCacheKey
+{
+	bool operator==(const PathCacheKey &rhs) const
+	{
+		return std::tie(Mask, Player, UnitSize, Goal, GoalSize, MinRange, MaxRange)
+		       == std::tie(rhs.Mask, rhs.Player, rhs.UnitSize, rhs.Goal, rhs.GoalSize, rhs.MinRange, rhs.MaxRange);
+	}
+
+	tile_flags Mask = 0;
+	int Player = -1;   /// owner of the exploration, -1 when the whole map is known
+	Vec2i UnitSize;
+	Vec2i Goal;
+	Vec2i GoalSize;
+	int MinRange = 0;
+	int MaxRange = 0;
+};
+
+/// (cost, tile index) of the tiles to expand: the index makes the order deterministic
+using PathCacheItem = std::pair<int, unsigned int>;
+
+struct PathCacheEntry
+{
+	PathCacheKey Key;
+	unsigned long CreationCycle = 0;  /// GameCycle when the entry was created
+	unsigned long LastUse = 0;        /// PathCacheRequests at the last use, for LRU eviction
+	std::vector<uint8_t> Direction;   /// heading of the next step, per tile
+	std::vector<uint16_t> Steps;      /// remaining steps to the goal, per tile
+	std::vector<int> Dist;            /// cost to the goal, per tile, final once not above the Open top
+	std::vector<int> EnterCost;       /// cost to step on each tile, INT_MIN until looked at
+	std::priority_queue<PathCacheItem, std::vector<PathCacheItem>, std::greater<PathCacheItem>> Open;
+	Vec2i CostMin;                    /// Bounds of the tiles whose cost was looked at
+	Vec2i CostMax;
+};
+
+/// Direction of the goal tiles
+constexpr uint8_t PathCacheInGoal = 8;
+/// Direction of tiles from which the goal can't be reached
+constexpr uint8_t PathCacheUnreachable = 0xFF;
+
+} // namespace
+
+/*----------------------------------------------------------------------------
+--  Variables
+----------------------------------------------------------------------------*/
+
+/// see pathfinder.h
+bool AStarPathCache = false;
+int AStarPathCacheSize = 16;
+unsigned int PathCacheHits;
+unsigned int PathCacheMisses;
+unsigned int PathCacheEvictions;
+unsigned int PathCacheEndCycle;
+
+/// Flow fields are rebuilt after this many cycles
+static constexpr unsigned long PathCacheMaxAge = 10 * CYCLES_PER_SECOND;
+
+/// Number of requests, used as clock for the LRU eviction
+static unsigned long PathCacheRequests;
+
+/// Known goals, without flow field until the second request
+static std::vector<PathCacheEntry> PathCacheEntries;
+
+/*----------------------------------------------------------------------------
+--  Functions
+----------------------------------------------------------------------------*/
+
+/**
+**  Static cost to put the unit top left corner on a tile.
+**
+**  Mirrors CostMoveToCallBack_Default without the units.
+**
+**  @return  -1 when the tile can't be crossed.
+*/
+static int PathCacheCost(const PathCacheKey &key, unsigned int index, const CPlayer *player)
+{
+	int cost = 0;
+
+	for (int y = 0; y != key.UnitSize.y; ++y) {
+		const CMapField *mf = Map.Field(index + y * Map.Info.MapWidth);
+		for (int x = 0; x != key.UnitSize.x; ++x, ++mf) {
+			const bool explored = player == nullptr || mf->playerInfo().IsExplored(*player);
+			if (explored && mf->CheckMask(key.Mask)) {
+				return -1;
+			}
+			if (!explored) {
+				cost += AStarUnknownTerrainCost;
+			}
+			cost += mf->getMoveCost();
+		}
+	}
+	return cost / (key.UnitSize.x * key.UnitSize.y);
+}
+
+/**
+**  Cost to step on a tile for the flow field of the entry, looked at once.
+*/
+static int PathCacheCostOf(PathCacheEntry &entry, unsigned int index)
+{
+	int &cost = entry.EnterCost[index];
+	if (cost == INT_MIN) {
+		const PathCacheKey &key = entry.Key;
+		const Vec2i pos(index % Map.Info.MapWidth, index / Map.Info.MapWidth);
+
+		cost = PathCacheCost(key, index, key.Player == -1 ? nullptr : &Players[key.Player]);
+		entry.CostMin.x = std::min(entry.CostMin.x, pos.x);
+		entry.CostMin.y = std::min(entry.CostMin.y, pos.y);
+		entry.CostMax.x = std::max<short>(entry.CostMax.x, pos.x + key.UnitSize.x - 1);
+		entry.CostMax.y = std::max<short>(entry.CostMax.y, pos.y + key.UnitSize.y - 1);
+	}
+	return cost;
+}
+
+/**
+**  Start the flow field of the entry: a reverse search from the goal tiles.
+*/
+static void PathCacheStart(PathCacheEntry &entry)
+{
+	const PathCacheKey &key = entry.Key;
+	const size_t size = Map.Info.MapWidth * Map.Info.MapHeight;
+
+	entry.Direction.assign(size, PathCacheUnreachable);
+	entry.Steps.assign(size, 0);
+	entry.Dist.assign(size, INT_MAX);
+	entry.EnterCost.assign(size, INT_MIN);
+	entry.CostMin = Vec2i(Map.Info.MapWidth, Map.Info.MapHeight);
+	entry.CostMax = Vec2i(-1, -1);
+
+	AStarForEachGoalTile(key.Goal, key.GoalSize.x, key.GoalSize.y, key.UnitSize.x, key.UnitSize.y,
+						 key.MinRange, key.MaxRange, [&](unsigned int index) {
+		if (entry.Dist[index] != 0 && PathCacheCostOf(entry, index) >= 0) {
+			entry.Dist[index] = 0;
+			entry.Direction[index] = PathCacheInGoal;
+			entry.Open.emplace(0, index);
+		}
+	});
+}
+
+/**
+**  Check if the flow field of the entry is final for a tile.
+*/
+static bool PathCacheIsFinal(const PathCacheEntry &entry, unsigned int index)
+{
+	// Tiles are expanded by increasing cost, and each step costs at least 1
+	return entry.Open.empty() || entry.Dist[index] <= entry.Open.top().first;
+}
+
+/**
+**  Resume the reverse search of the entry until the flow field is final for
+**  a tile, expanding at most AStarMaxSearchIterations tiles.
+**
+**  @return  true if the flow field is final for the tile.
+*/
+static bool PathCacheGrow(PathCacheEntry &entry, unsigned int target)
+{
+	const PathCacheKey &key = entry.Key;
+	const int width = Map.Info.MapWidth;
+	const int maxx = Map.Info.MapWidth - key.UnitSize.x;
+	const int maxy = Map.Info.MapHeight - key.UnitSize.y;
+
+	for (int counter = AStarMaxSearchIterations; !PathCacheIsFinal(entry, target); --counter) {
+		if (counter == 0) {
+			return false;
+		}
+		const auto [cost, index] = entry.Open.top();
+		entry.Open.pop();
+		if (cost != entry.Dist[index]) {
+			continue;
+		}
+		// a unit on a neighbour pays the cost of this tile to step on it
+		const int stepCost = cost + 1 + PathCacheCostOf(entry, index);
+		const Vec2i pos(index % width, index / width);
+
+		for (int i = 0; i != 8; ++i) {
+			const Vec2i from(pos.x - Heading2X[i], pos.y - Heading2Y[i]);
+			if (from.x < 0 || from.y < 0 || from.x > maxx || from.y > maxy) {
+				continue;
+			}
+			const unsigned int fromIndex = from.y * width + from.x;
+			if (stepCost >= entry.Dist[fromIndex] || PathCacheCostOf(entry, fromIndex) < 0) {
+				continue;
+			}
+			entry.Dist[fromIndex] = stepCost;
+			entry.Direction[fromIndex] = i;
+			entry.Steps[fromIndex] = std::min<int>(entry.Steps[index] + 1, UINT16_MAX);
+			entry.Open.emplace(stepCost, fromIndex);
+		}
+	}
+	return true;
+}
+
+/**
+**  Find the cache entry of the key, dropping the outdated ones.
+**
+**  @return  The entry, or nullptr if the key is not (or no longer) known.
+*/
+static PathCacheEntry *PathCacheFind(const PathCacheKey &key)
+{
+	for (auto it = PathCacheEntries.begin(); it != PathCacheEntries.end();) {
+		if (GameCycle - it->CreationCycle > PathCacheMaxAge) {
+			it = PathCacheEntries.erase(it);
+			++PathCacheEvictions;
+		} else if (it->Key == key) {
+			return &*it;
+		} else {
+			++it;
+		}
+	}
+	return nullptr;
+}
+
+/**
+**  Remember a new goal, evicting the least recently used one if needed.
+*/
+static void PathCacheInsert(const PathCacheKey &key)
+{
+	if (PathCacheEntries.size() >= size_t(std::max(AStarPathCacheSize, 1))) {
+		auto lru = ranges::min_element(PathCacheEntries, std::less<>{}, &PathCacheEntry::LastUse);
+		PathCacheEntries.erase(lru);
+		++PathCacheEvictions;
+	}
+	PathCacheEntry &entry = PathCacheEntries.emplace_back();
+	entry.Key = key;
+	entry.CreationCycle = GameCycle;
+	entry.LastUse = PathCacheRequests;
+}
+
+/**
+**  Forget all the flow fields, and decide until when the game uses them.
+*/
+void InitPathCache()
+{
+	if (SaveGameLoading) {
+		PathCacheEndCycle = 0;
+	} else if (!IsReplayGame()) {
+		PathCacheEndCycle = AStarPathCache && !IsNetworkGame() ? UINT_MAX : 0;
+	}
+	PathCacheEntries.clear();
+	PathCacheHits = 0;
+	PathCacheMisses = 0;
+	PathCacheEvictions = 0;
+}
+
+/**
+**  Free the flow fields.
+*/
+void FreePathCache()
+{
+	PathCacheEntries.clear();
+}
+
+/**
+**  Passability of the map changed, drop the flow fields which have looked
+**  at the area.
+**
+**  @param pos  Top left tile of the area.
+**  @param w    Width of the area.
+**  @param h    Height of the area.
+*/
+void PathCacheTerrainChanged(const Vec2i &pos, int w, int h)
+{
+	for (auto it = PathCacheEntries.begin(); it != PathCacheEntries.end();) {
+		if (!it->Direction.empty()
+			&& pos.x <= it->CostMax.x && pos.x + w > it->CostMin.x
+			&& pos.y <= it->CostMax.y && pos.y + h > it->CostMin.y) {
+			it = PathCacheEntries.erase(it);
+			++PathCacheEvictions;
+		} else {
+			++it;
+		}
+	}
+}
+
+/**
+**  Find a path by following the flow field of the goal.
+**
+**  Same parameters as AStarFindPath.
+**
+**  @return  Full length of the path,
+**           or PF_FAILED when another pathfinder should be used.
+*/
+int PathCacheFindPath(const Vec2i &startPos, const Vec2i &goalPos, int gw, int gh,
+					  int tilesizex, int tilesizey, int minrange, int maxrange,
+					  char *path, int pathlen, const CUnit &unit)
+{
+	if (GameCycle >= PathCacheEndCycle || path == nullptr || !Map.Info.IsPointOnMap(goalPos)) {
+		return PF_FAILED;
+	}
+	// Near the goal, the units are in the way of each other: let a* handle them
+	const int dx = std::max({goalPos.x - startPos.x - tilesizex + 1, startPos.x - goalPos.x - std::max(gw, 1) + 1, 0});
+	const int dy = std::max({goalPos.y - startPos.y - tilesizey + 1, startPos.y - goalPos.y - std::max(gh, 1) + 1, 0});
+	if (std::max(dx, dy) - maxrange <= PathFinderOutput::MAX_PATH_LENGTH) {
+		return PF_FAILED;
+	}
+
+	PathCacheKey key;
+	key.Mask = unit.Type->MovementMask & ~(MapFieldLandUnit | MapFieldAirUnit | MapFieldSeaUnit);
+	key.Player = AStarKnowUnseenTerrain ? -1 : unit.Player->Index;
+	key.UnitSize = Vec2i(tilesizex, tilesizey);
+	key.Goal = goalPos;
+	key.GoalSize = Vec2i(gw, gh);
+	key.MinRange = minrange;
+	key.MaxRange = maxrange;
+
+	++PathCacheRequests;
+	PathCacheEntry *entry = PathCacheFind(key);
+	if (entry == nullptr) {
+		// A single unit going there doesn't deserve a flow field
+		++PathCacheMisses;
+		PathCacheInsert(key);
+		return PF_FAILED;
+	}
+	entry->LastUse = PathCacheRequests;
+	if (entry->Direction.empty()) {
+		PathCacheStart(*entry);
+	}
+	unsigned int index = Map.getIndex(startPos);
+	if (!PathCacheGrow(*entry, index)) {
+		// The field goes on growing at the next request
+		++PathCacheMisses;
+		return PF_FAILED;
+	}
+	++PathCacheHits;
+
+	const int length = entry->Steps[index];
+	const uint8_t first = entry->Direction[index];
+	if (first == PathCacheUnreachable || first == PathCacheInGoal) {
+		// Let a* give the real answer, moving units included
+		return PF_FAILED;
+	}
+	// path[pathlen - 1] is the first step, as stored by AStarFindPath
+	pathlen = std::min(pathlen, length);
+	for (int i = pathlen - 1; i >= 0; --i) {
+		const uint8_t direction = entry->Direction[index];
+		Assert(direction < 8);
+		path[i] = direction;
+		index += Heading2X[direction] + Heading2Y[direction] * Map.Info.MapWidth;
+	}
+	return length;
+}
+
+//@}
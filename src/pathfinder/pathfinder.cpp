@@ -44,6 +44,8 @@
 #include "unittype.h"
 #include "unit.h"
 
+#include <algorithm>
+
 //astar.cpp
 
 /// Init the a* data structures
@@ -57,36 +59,142 @@ extern int AStarFindPath(const Vec2i &startPos, const Vec2i &goalPos, int gw, in
 						 int tilesizex, int tilesizey, int minrange,
 						 int maxrange, char *path, int pathlen, const CUnit &unit);
 
+//hpastar.cpp
+
+/// Init the hierarchical a* data structures
+extern void InitHPAStar();
+
+/// Free the hierarchical a* data structures
+extern void FreeHPAStar();
+
+/// Update the hierarchical graph after a passability change
+extern void HPAStarTerrainChanged(const Vec2i &pos, int w, int h);
+
+/// Find a path for a unit using the hierarchical graph
+extern int HPAStarFindPath(const Vec2i &startPos, const Vec2i &goalPos, int gw, int gh,
+						   int tilesizex, int tilesizey, int minrange,
+						   int maxrange, char *path, int pathlen, const CUnit &unit);
+
+//pathcache.cpp
+
+/// Init the flow field cache
+extern void InitPathCache();
+
+/// Free the flow field cache
+extern void FreePathCache();
+
+/// Invalidate the flow fields after a passability change
+extern void PathCacheTerrainChanged(const Vec2i &pos, int w, int h);
+
+/// Find a path for a unit by following a shared flow field
+extern int PathCacheFindPath(const Vec2i &startPos, const Vec2i &goalPos, int gw, int gh,
+							 int tilesizex, int tilesizey, int minrange,
+							 int maxrange, char *path, int pathlen, const CUnit &unit);
+
+//regions.cpp
+
+/// Init the region labels
+extern void InitRegions();
+
+/// Free the region labels
+extern void FreeRegions();
+
+/// Update the region labels after a passability change
+extern void RegionsTerrainChanged(const Vec2i &pos, int w, int h);
+
+/// Whether a search may reach the goal, false when they are in different regions
+extern bool RegionsMayReach(const Vec2i &startPos, const Vec2i &goalPos, int gw, int gh,
+							int tilesizex, int tilesizey, int maxrange, const CUnit &unit);
+
 /*----------------------------------------------------------------------------
 --  Variables
 ----------------------------------------------------------------------------*/
 
+bool PathfinderBatch = false;
+bool PathfinderBatchParallel = true;
+
+/// Units which asked for a new path during this cycle
+static std::vector<CUnitPtr> PathfinderQueue;
+
+/// Storages of the traversals of the thread which are not in use
+static thread_local std::vector<std::unique_ptr<TerrainTraversal::Storage>> TerrainTraversalPool;
+
+TerrainTraversal::TerrainTraversal()
+{
+	if (TerrainTraversalPool.empty()) {
+		m_storage = std::make_unique<Storage>();
+	} else {
+		m_storage = std::move(TerrainTraversalPool.back());
+		TerrainTraversalPool.pop_back();
+	}
+}
+
+TerrainTraversal::~TerrainTraversal()
+{
+	TerrainTraversalPool.push_back(std::move(m_storage));
+}
+
+size_t TerrainTraversal::PoolSize()
+{
+	return TerrainTraversalPool.size();
+}
+
+/**
+**  Fit the storage to a map, keeping it when it already has the size.
+*/
 void TerrainTraversal::SetSize(unsigned int width, unsigned int height)
 {
-	m_values.resize((width + 2) * (height + 2));
-	m_extented_width = width + 2;
-	m_height = height;
+	Storage &storage = *m_storage;
+
+	if (storage.extented_width != width + 2 || storage.height != height) {
+		const unsigned int width_ext = width + 2;
+
+		storage.marks.assign(width_ext * (height + 2), Mark{0, 0});
+		for (unsigned int x = 0; x != width_ext; ++x) {
+			storage.marks[x] = {BorderGeneration, -1};
+			storage.marks[(height + 1) * width_ext + x] = {BorderGeneration, -1};
+		}
+		for (unsigned int y = 1; y < 1 + height; ++y) {
+			storage.marks[y * width_ext] = {BorderGeneration, -1};
+			storage.marks[y * width_ext + width + 1] = {BorderGeneration, -1};
+		}
+		storage.frontier.resize(width * height);
+		storage.generation = 0;
+		storage.extented_width = width_ext;
+		storage.height = height;
+	}
+	m_marks = storage.marks.data();
+	m_frontier = storage.frontier.data();
+	m_extented_width = storage.extented_width;
 }
 
+/**
+**  Start a new traversal: forget the marks of the previous ones by starting
+**  a new generation, and empty the frontier.
+*/
 void TerrainTraversal::Init()
 {
-	const unsigned int height = m_height;
-	const unsigned int width = m_extented_width - 2;
-	const unsigned int width_ext = m_extented_width;
-
-	memset(&m_values[0], '\xFF', width_ext * sizeof(dataType));
-	for (unsigned i = 1; i < 1 + height; ++i) {
-		m_values[i * width_ext] = -1;
-		memset(&m_values[i * width_ext + 1], '\0', width * sizeof(dataType));
-		m_values[i * width_ext + width + 1] = -1;
+	Storage &storage = *m_storage;
+
+	if (storage.generation == BorderGeneration - 1) {
+		// Generations wrapped: the stale marks could look current.
+		for (Mark &mark : storage.marks) {
+			if (mark.generation != BorderGeneration) {
+				mark.generation = 0;
+			}
+		}
+		storage.generation = 0;
 	}
-	memset(&m_values[(height + 1) * width_ext], '\xFF', width_ext * sizeof(dataType));
+	m_generation = ++storage.generation;
+	m_head = 0;
+	m_tail = 0;
 }
 
 void TerrainTraversal::PushPos(const Vec2i &pos)
 {
 	if (IsVisited(pos) == false) {
-		m_queue.push(PosNode(pos, pos));
+		Assert(m_tail < m_storage->frontier.size());
+		m_frontier[m_tail++] = {pos, pos};
 		Set(pos, 1);
 	}
 }
@@ -96,15 +204,18 @@ void TerrainTraversal::PushNeighboor(const Vec2i &pos)
 	const Vec2i offsets[] = {Vec2i(0, -1), Vec2i(-1, 0), Vec2i(1, 0), Vec2i(0, 1),
 							 Vec2i(-1, -1), Vec2i(1, -1), Vec2i(-1, 1), Vec2i(1, 1)
 							};
+	const unsigned int index = Index(pos);
+	const Mark newMark = {m_generation, dataType(m_marks[index].value + 1)};
 
 	for (int i = 0; i != 8; ++i) {
-		const Vec2i newPos = pos + offsets[i];
+		Mark &mark = m_marks[index + offsets[i].y * int(m_extented_width) + offsets[i].x];
 
-		if (IsVisited(newPos) == false) {
-			m_queue.push(PosNode(newPos, pos));
-			Set(newPos, Get(pos) + 1);
+		if (mark.generation < m_generation) {
+			m_frontier[m_tail++] = {pos + offsets[i], pos};
+			mark = newMark;
 		}
 	}
+	Assert(m_tail <= m_storage->frontier.size());
 }
 
 void TerrainTraversal::PushUnitPosAndNeighboor(const CUnit &unit)
@@ -122,31 +233,6 @@ void TerrainTraversal::PushUnitPosAndNeighboor(const CUnit &unit)
 	}
 }
 
-bool TerrainTraversal::IsVisited(const Vec2i &pos) const
-{
-	return Get(pos) != 0;
-}
-
-bool TerrainTraversal::IsReached(const Vec2i &pos) const
-{
-	return Get(pos) != 0 && Get(pos) != -1;
-}
-
-bool TerrainTraversal::IsInvalid(const Vec2i &pos) const
-{
-	return Get(pos) != -1;
-}
-
-TerrainTraversal::dataType TerrainTraversal::Get(const Vec2i &pos) const
-{
-	return m_values[m_extented_width + 1 + pos.y * m_extented_width + pos.x];
-}
-
-void TerrainTraversal::Set(const Vec2i &pos, TerrainTraversal::dataType value)
-{
-	m_values[m_extented_width + 1 + pos.y * m_extented_width + pos.x] = value;
-}
-
 /*----------------------------------------------------------------------------
 --  Functions
 ----------------------------------------------------------------------------*/
@@ -157,6 +243,9 @@ void TerrainTraversal::Set(const Vec2i &pos, TerrainTraversal::dataType value)
 void InitPathfinder()
 {
 	InitAStar(Map.Info.MapWidth, Map.Info.MapHeight);
+	InitHPAStar();
+	InitPathCache();
+	InitRegions();
 }
 
 /**
@@ -164,7 +253,25 @@ void InitPathfinder()
 */
 void FreePathfinder()
 {
+	PathfinderQueue.clear();
 	FreeAStar();
+	FreeHPAStar();
+	FreePathCache();
+	FreeRegions();
+}
+
+/**
+**  Passability of the map area changed.
+**
+**  @param pos  Top left tile of the area.
+**  @param w    Width of the area.
+**  @param h    Height of the area.
+*/
+void PathfinderTerrainChanged(const Vec2i &pos, int w, int h)
+{
+	HPAStarTerrainChanged(pos, w, h);
+	PathCacheTerrainChanged(pos, w, h);
+	RegionsTerrainChanged(pos, w, h);
 }
 
 /*----------------------------------------------------------------------------
@@ -191,9 +298,13 @@ int PlaceReachable(const CUnit &src, const Vec2i &goalPos, int w, int h, int min
 	int srcTW = src.Type->TileWidth;
 	int srcTH = src.Type->TileHeight;
 	if (!from_outside_container || !src.Container) {
-		i = AStarFindPath(srcTilePos, goalPos, w, h,
-						  srcTW, srcTH,
-						  minrange, range, nullptr, 0, src);
+		if (RegionsMayReach(srcTilePos, goalPos, w, h, srcTW, srcTH, range, src)) {
+			i = AStarFindPath(srcTilePos, goalPos, w, h,
+							  srcTW, srcTH,
+							  minrange, range, nullptr, 0, src);
+		} else {
+			i = PF_UNREACHABLE;
+		}
 	} else {
 		const CUnit *first_container = GetFirstContainer(src);
 
@@ -217,6 +328,9 @@ int PlaceReachable(const CUnit &src, const Vec2i &goalPos, int w, int h, int min
 					//ignore tiles to which the unit cannot be dropped from its container
 					continue;
 				}
+				if (!RegionsMayReach(tile_pos, goalPos, w, h, srcTW, srcTH, range, src)) {
+					continue;
+				}
 
 				i = AStarFindPath(tile_pos, goalPos, w, h,
 					srcTW, srcTH,
@@ -284,6 +398,12 @@ int UnitReachable(const CUnit &src, const CUnit &dst, int range, bool from_outsi
 
 int CalcPathLengthToUnit(const CUnit &src, const CUnit &dst, const int minrange, const int range)
 {
+	if (!RegionsMayReach(src.tilePos, dst.tilePos,
+						 dst.Type->TileWidth, dst.Type->TileHeight,
+						 src.Type->TileWidth, src.Type->TileHeight,
+						 range, src)) {
+		return -1;
+	}
 	SetAStarFixedEnemyUnitsUnpassable(true); /// change Path Finder setting to don't count tiles with enemy units as passable
 	int length = AStarFindPath(src.tilePos, dst.tilePos,
 							   dst.Type->TileWidth, dst.Type->TileHeight,
@@ -371,6 +491,90 @@ PathFinderOutput::PathFinderOutput()
 	memset(this, 0, sizeof(*this));
 }
 
+/**
+**  Find a path with the pathfinders which share their data between the searches.
+**  Searches between disconnected regions are answered here too.
+**
+**  @param input     What the unit looks for.
+**  @param path      Where to store the directions.
+**  @param useCache  Whether the shared flow fields may be used.
+**
+**  @return          The path length or an error code, PF_FAILED if no
+**                   shared pathfinder handles this search.
+*/
+static int SharedFindPath(const PathFinderInput &input, char *path, bool useCache)
+{
+	if (!RegionsMayReach(input.GetUnitPos(), input.GetGoalPos(),
+						 input.GetGoalSize().x, input.GetGoalSize().y,
+						 input.GetUnitSize().x, input.GetUnitSize().y,
+						 input.GetMaxRange(), *input.GetUnit())) {
+		return PF_UNREACHABLE;
+	}
+	int i = PF_FAILED;
+	if (useCache) {
+		i = PathCacheFindPath(input.GetUnitPos(),
+							  input.GetGoalPos(),
+							  input.GetGoalSize().x, input.GetGoalSize().y,
+							  input.GetUnitSize().x, input.GetUnitSize().y,
+							  input.GetMinRange(), input.GetMaxRange(),
+							  path, PathFinderOutput::MAX_PATH_LENGTH,
+							  *input.GetUnit());
+	}
+	if (i == PF_FAILED) {
+		i = HPAStarFindPath(input.GetUnitPos(),
+							input.GetGoalPos(),
+							input.GetGoalSize().x, input.GetGoalSize().y,
+							input.GetUnitSize().x, input.GetUnitSize().y,
+							input.GetMinRange(), input.GetMaxRange(),
+							path, PathFinderOutput::MAX_PATH_LENGTH,
+							*input.GetUnit());
+	}
+	return i;
+}
+
+/**
+**  Find a path with a plain a* search. Safe to call from several threads.
+*/
+static int LocalFindPath(const PathFinderInput &input, char *path)
+{
+	return AStarFindPath(input.GetUnitPos(),
+						 input.GetGoalPos(),
+						 input.GetGoalSize().x, input.GetGoalSize().y,
+						 input.GetUnitSize().x, input.GetUnitSize().y,
+						 input.GetMinRange(), input.GetMaxRange(),
+						 path, PathFinderOutput::MAX_PATH_LENGTH,
+						 *input.GetUnit());
+}
+
+/**
+**  Store the result of a search in the path finder data of the unit.
+**
+**  @param input   What the unit looked for.
+**  @param output  Where the path directions were stored.
+**  @param i       Result of the search.
+**
+**  @return        >0 remaining path length, -1 reached goal, -2 can't reach the goal.
+*/
+static int ApplyNewPath(PathFinderInput &input, PathFinderOutput &output, int i)
+{
+	input.PathRecalculated();
+	if (i == PF_FAILED) {
+		i = PF_UNREACHABLE;
+	}
+
+	if (i >= 0) {
+		output.Length = std::min<int>(i, PathFinderOutput::MAX_PATH_LENGTH);
+		output.OverflowLength = std::min<int>(i - output.Length, PathFinderOutput::MAX_OVERFLOW);
+		if (output.Length == 0) {
+			++output.Length;
+		}
+	} else {
+		output.Length = 0;
+		output.OverflowLength = 0;
+	}
+	return i;
+}
+
 /**
 **  Find new path.
 **
@@ -379,41 +583,83 @@ PathFinderOutput::PathFinderOutput()
 **
 **  @note  The destination could become negative coordinates!
 **
-**  @param unit  Path for this unit.
+**  @param unit      Path for this unit.
+**  @param useCache  Whether the shared flow fields may be used.
 **
 **  @return      >0 remaining path length, 0 wait for path, -1
 **               reached goal, -2 can't reach the goal.
 */
-static int NewPath(PathFinderInput &input, PathFinderOutput &output)
+static int NewPath(PathFinderInput &input, PathFinderOutput &output, bool useCache = true)
 {
-	char *path = output.Path;
-	int i = AStarFindPath(input.GetUnitPos(),
-						  input.GetGoalPos(),
-						  input.GetGoalSize().x, input.GetGoalSize().y,
-						  input.GetUnitSize().x, input.GetUnitSize().y,
-						  input.GetMinRange(), input.GetMaxRange(),
-						  path, PathFinderOutput::MAX_PATH_LENGTH,
-						  *input.GetUnit());
-	input.PathRecalculated();
+	int i = SharedFindPath(input, output.Path, useCache);
 	if (i == PF_FAILED) {
-		i = PF_UNREACHABLE;
+		i = LocalFindPath(input, output.Path);
 	}
+	return ApplyNewPath(input, output, i);
+}
 
-	// Update path if it was requested. Otherwise we may only want
-	// to know if there exists a path.
-	if (path != nullptr) {
-		if (i >= 0) {
-			output.Length = std::min<int>(i, PathFinderOutput::MAX_PATH_LENGTH);
-			output.OverflowLength = std::min<int>(i - output.Length, PathFinderOutput::MAX_OVERFLOW);
-			if (output.Length == 0) {
-				++output.Length;
-			}
+/**
+**  Find the paths requested by NextPathElement during this cycle.
+**
+**  The searches which use shared data (flow fields, hierarchical graph) are
+**  done first, one after the other. The remaining a* searches only read the
+**  map, each thread has its own search data, so they are spread over the
+**  threads, except in debug builds. The results are stored in unit slot
+**  order, so the game state does not depend on the number of threads.
+*/
+void PathfinderSolveBatch()
+{
+	if (PathfinderQueue.empty()) {
+		return;
+	}
+	std::vector<CUnit *> units;
+	units.reserve(PathfinderQueue.size());
+	for (CUnit *unit : PathfinderQueue) {
+		if (unit->Destroyed || unit->Removed) {
+			unit->pathFinderData->output.Queued = 0;
 		} else {
-			output.Length = 0;
-			output.OverflowLength = 0;
+			units.push_back(unit);
 		}
 	}
-	return i;
+	ranges::sort(units, [](const CUnit *lhs, const CUnit *rhs) { return UnitNumber(*lhs) < UnitNumber(*rhs); });
+
+	std::vector<int> results(units.size());
+	std::vector<size_t> local;
+	for (size_t i = 0; i != units.size(); ++i) {
+		PathFinderData &data = *units[i]->pathFinderData;
+		results[i] = SharedFindPath(data.input, data.output.Path, true);
+		if (results[i] == PF_FAILED) {
+			local.push_back(i);
+		}
+	}
+
+	const int localCount = local.size();
+#ifdef DEBUG
+	// a* writes its debugging data in the map fields and the profiler tables
+	const bool parallel = false;
+#else
+	const bool parallel = PathfinderBatchParallel;
+#endif
+	#pragma omp parallel if(parallel && localCount > 1)
+	{
+		const int thisThread = omp_get_thread_num();
+		const int numOfThreads = omp_get_num_threads();
+
+		for (int k = thisThread; k < localCount; k += numOfThreads) {
+			const size_t i = local[k];
+			PathFinderData &data = *units[i]->pathFinderData;
+			results[i] = LocalFindPath(data.input, data.output.Path);
+		}
+	} // pragma omp parallel
+
+	for (size_t i = 0; i != units.size(); ++i) {
+		PathFinderData &data = *units[i]->pathFinderData;
+		const int result = ApplyNewPath(data.input, data.output, results[i]);
+		data.output.Queued = 0;
+		data.output.Ready = 1;
+		data.output.ReadyReached = result == PF_REACHED;
+	}
+	PathfinderQueue.clear();
 }
 
 /**
@@ -434,8 +680,25 @@ std::pair<int, Vec2i> NextPathElement(CUnit &unit)
 	// Attempt to use path cache
 	// FIXME: If there is a goal, it may have moved, ruining the cache
 
-	// Goal has moved, need to recalculate path or no cached path
-	if (output.Length <= 0 || input.IsRecalculateNeeded()) {
+	if (output.Ready && !input.IsRecalculateNeeded()) {
+		// Path found by PathfinderSolveBatch
+		output.Ready = 0;
+		if (output.ReadyReached) {
+			return {PF_REACHED, {}};
+		}
+		if (output.Length == 0) {
+			return {PF_UNREACHABLE, {}};
+		}
+	} else if (output.Length <= 0 || input.IsRecalculateNeeded()) {
+		// Goal has moved, need to recalculate path or no cached path
+		output.Ready = 0;
+		if (PathfinderBatch) {
+			if (!output.Queued) {
+				output.Queued = 1;
+				PathfinderQueue.emplace_back(&unit);
+			}
+			return {PF_WAIT, {}};
+		}
 		const int result = NewPath(input, output);
 
 		if (result == PF_UNREACHABLE) {
@@ -465,7 +728,8 @@ std::pair<int, Vec2i> NextPathElement(CUnit &unit)
 		}
 		if (output.Fast == 0 && result != 0) {
 			AstarDebugPrint("WAIT expired\n");
-			result = NewPath(input, output);
+			// The flow fields ignore the units, which may be the blocking ones
+			result = NewPath(input, output, false);
 			if (result > 0) {
 				dir.x = Heading2X[(int)output.Path[output.Length - 1]];
 				dir.y = Heading2Y[(int)output.Path[output.Length - 1]];
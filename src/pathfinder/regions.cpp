@@ -0,0 +1,472 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name regions.cpp - Connected regions of the map. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+// Each passable tile gets the label of its region: the tiles which can be
+// reached from it by a 1x1 unit, considering only the static obstacles
+// (terrain, walls and buildings). When the start and the goal of a search
+// are in different regions, the search would explore the whole start region
+// before giving up, so it is not started at all.
+//
+// Labels are merged with a union-find when tiles become passable (chopped
+// wood, destroyed wall or building). A tile becoming unpassable can only cut
+// its region when its passable neighbours are not connected to each other
+// around it; only then the whole map is labeled again, on the next query.
+// So the labels always match the current terrain, and the answers do not
+// depend on the history of the game (loaded games stay in sync).
+
+//@{
+
+/*----------------------------------------------------------------------------
+--  Includes
+----------------------------------------------------------------------------*/
+
+#include "stratagus.h"
+
+#include "pathfinder.h"
+
+#include "font.h"
+#include "map.h"
+#include "unit.h"
+#include "unittype.h"
+#include "video.h"
+#include "viewport.h"
+
+#include <map>
+
+/*----------------------------------------------------------------------------
+--  Declarations
+----------------------------------------------------------------------------*/
+
+namespace
+{
+
+/// Areas bigger than that are assumed connected, checking them costs too much
+constexpr int RegionMaxCheckedArea = 64 * 64;
+
+/**
+**  Region labels of the map for one movement mask.
+*/
+class RegionLayer
+{
+public:
+	explicit RegionLayer(tile_flags mask);
+
+	void TerrainChanged(const Vec2i &pos, int w, int h);
+	unsigned int RegionOf(unsigned int index);
+	unsigned int CurrentRegionOf(unsigned int index);
+
+private:
+	bool IsPassable(unsigned int index) const { return !Map.Field(index)->CheckMask(Mask); }
+	unsigned int Find(unsigned int label);
+	void Merge(unsigned int label1, unsigned int label2);
+	void Relabel();
+	void Fill(unsigned int index, unsigned int label);
+	bool MayCut(int x, int y) const;
+
+private:
+	tile_flags Mask;
+	std::vector<unsigned int> Labels;  /// label of each tile, 0 for unpassable tiles
+	std::vector<unsigned int> Parents; /// union-find of the labels, 0 is unused
+	bool NeedRelabel = true;           /// no labels yet, or a region may have been cut
+};
+
+} // namespace
+
+/*----------------------------------------------------------------------------
+--  Variables
+----------------------------------------------------------------------------*/
+
+/// see pathfinder.h
+bool AStarRegions = false;
+unsigned int RegionRejectedSearches;
+
+/// One labeling per movement mask, built on demand
+static std::map<tile_flags, RegionLayer> RegionLayers;
+
+/*----------------------------------------------------------------------------
+--  Methods
+----------------------------------------------------------------------------*/
+
+RegionLayer::RegionLayer(tile_flags mask) : Mask(mask)
+{
+}
+
+/**
+**  Representative label of a region.
+*/
+unsigned int RegionLayer::Find(unsigned int label)
+{
+	while (Parents[label] != label) {
+		Parents[label] = Parents[Parents[label]];
+		label = Parents[label];
+	}
+	return label;
+}
+
+void RegionLayer::Merge(unsigned int label1, unsigned int label2)
+{
+	label1 = Find(label1);
+	label2 = Find(label2);
+	if (label1 != label2) {
+		Parents[std::max(label1, label2)] = std::min(label1, label2);
+	}
+}
+
+/**
+**  Give label to all the tiles connected to index.
+*/
+void RegionLayer::Fill(unsigned int index, unsigned int label)
+{
+	const int width = Map.Info.MapWidth;
+	const int height = Map.Info.MapHeight;
+	std::vector<unsigned int> stack{index};
+
+	Labels[index] = label;
+	while (!stack.empty()) {
+		const unsigned int current = stack.back();
+		stack.pop_back();
+		const int x = current % width;
+		const int y = current / width;
+
+		for (int i = 0; i != 8; ++i) {
+			const int nx = x + Heading2X[i];
+			const int ny = y + Heading2Y[i];
+			if (nx < 0 || ny < 0 || nx >= width || ny >= height) {
+				continue;
+			}
+			const unsigned int next = nx + ny * width;
+			if (Labels[next] == 0 && IsPassable(next)) {
+				Labels[next] = label;
+				stack.push_back(next);
+			}
+		}
+	}
+}
+
+/**
+**  Compute all the labels again.
+*/
+void RegionLayer::Relabel()
+{
+	const unsigned int size = Map.Info.MapWidth * Map.Info.MapHeight;
+
+	Labels.assign(size, 0);
+	Parents.assign(1, 0);
+	for (unsigned int index = 0; index != size; ++index) {
+		if (Labels[index] == 0 && IsPassable(index)) {
+			const unsigned int label = Parents.size();
+			Parents.push_back(label);
+			Fill(index, label);
+		}
+	}
+	NeedRelabel = false;
+}
+
+/**
+**  Whether removing the tile may cut its region in two.
+**
+**  True when the labeled neighbours of the tile are not all connected to
+**  each other without it.
+*/
+bool RegionLayer::MayCut(int x, int y) const
+{
+	Vec2i neighbours[8];
+	int count = 0;
+	for (int i = 0; i != 8; ++i) {
+		const Vec2i pos(x + Heading2X[i], y + Heading2Y[i]);
+		if (Map.Info.IsPointOnMap(pos) && Labels[Map.getIndex(pos)] != 0) {
+			neighbours[count++] = pos;
+		}
+	}
+	// Grow a group from the first neighbour, with the 8-connectivity
+	unsigned int grouped = count ? 1 : 0;
+	for (bool grown = true; grown;) {
+		grown = false;
+		for (int i = 0; i != count; ++i) {
+			if (grouped & (1 << i)) {
+				continue;
+			}
+			for (int j = 0; j != count; ++j) {
+				if ((grouped & (1 << j))
+					&& std::abs(neighbours[i].x - neighbours[j].x) <= 1
+					&& std::abs(neighbours[i].y - neighbours[j].y) <= 1) {
+					grouped |= 1 << i;
+					grown = true;
+					break;
+				}
+			}
+		}
+	}
+	return grouped != (1u << count) - 1;
+}
+
+/**
+**  Passability of the area changed, update the labels.
+*/
+void RegionLayer::TerrainChanged(const Vec2i &pos, int w, int h)
+{
+	if (NeedRelabel) {
+		return;
+	}
+	const int width = Map.Info.MapWidth;
+	const int height = Map.Info.MapHeight;
+	const int x0 = std::max<int>(pos.x, 0);
+	const int y0 = std::max<int>(pos.y, 0);
+	const int x1 = std::min(pos.x + w, width);
+	const int y1 = std::min(pos.y + h, height);
+
+	for (int y = y0; y < y1; ++y) {
+		for (int x = x0; x < x1; ++x) {
+			const unsigned int index = x + y * width;
+			const bool passable = IsPassable(index);
+
+			if (!passable) {
+				if (Labels[index] != 0) {
+					if (MayCut(x, y)) {
+						NeedRelabel = true;
+						return;
+					}
+					Labels[index] = 0;
+				}
+				continue;
+			}
+			if (Labels[index] != 0) {
+				continue;
+			}
+			// New passable tile, join all its neighbour regions
+			for (int i = 0; i != 8; ++i) {
+				const int nx = x + Heading2X[i];
+				const int ny = y + Heading2Y[i];
+				if (nx < 0 || ny < 0 || nx >= width || ny >= height) {
+					continue;
+				}
+				const unsigned int label = Labels[nx + ny * width];
+				if (label == 0) {
+					continue;
+				}
+				if (Labels[index] == 0) {
+					Labels[index] = label;
+				} else {
+					Merge(Labels[index], label);
+				}
+			}
+			if (Labels[index] == 0) {
+				Labels[index] = Parents.size();
+				Parents.push_back(Labels[index]);
+			}
+		}
+	}
+}
+
+/**
+**  Region of the tile, 0 for unpassable tiles.
+*/
+unsigned int RegionLayer::RegionOf(unsigned int index)
+{
+	if (NeedRelabel) {
+		Relabel();
+	}
+	return CurrentRegionOf(index);
+}
+
+/**
+**  Region of the tile without labeling the map again, 0 if unknown.
+*/
+unsigned int RegionLayer::CurrentRegionOf(unsigned int index)
+{
+	if (NeedRelabel) {
+		return 0;
+	}
+	const unsigned int label = Labels[index];
+	return label ? Find(label) : 0;
+}
+
+/*----------------------------------------------------------------------------
+--  Functions
+----------------------------------------------------------------------------*/
+
+/// Mask of the obstacles considered by the labels
+static tile_flags RegionStaticMask(tile_flags mask)
+{
+	return mask & ~(MapFieldLandUnit | MapFieldAirUnit | MapFieldSeaUnit);
+}
+
+static RegionLayer &GetRegionLayer(tile_flags mask)
+{
+	auto it = RegionLayers.find(mask);
+	if (it == RegionLayers.end()) {
+		it = RegionLayers.try_emplace(mask, mask).first;
+	}
+	return it->second;
+}
+
+/**
+**  Init the region labels
+*/
+void InitRegions()
+{
+	RegionLayers.clear();
+	RegionRejectedSearches = 0;
+}
+
+/**
+**  Free the region labels
+*/
+void FreeRegions()
+{
+	RegionLayers.clear();
+}
+
+/**
+**  Passability of the area changed, update the labels.
+**
+**  @param pos  Top left tile of the changed area.
+**  @param w    Width of the area.
+**  @param h    Height of the area.
+*/
+void RegionsTerrainChanged(const Vec2i &pos, int w, int h)
+{
+	for (auto &[mask, layer] : RegionLayers) {
+		layer.TerrainChanged(pos, w, h);
+	}
+}
+
+/**
+**  Whether the unit may walk from a tile of the start area to a tile of the goal area.
+**
+**  Only the static obstacles are considered: a true answer does not mean
+**  that a path exists, only that a search is needed to know.
+**
+**  @param unit       Unit which would walk, for its movement mask.
+**  @param startPos   Top left tile of the start area.
+**  @param startSize  Size of the start area.
+**  @param goalPos    Top left tile of the goal area.
+**  @param goalSize   Size of the goal area.
+**
+**  @return           false when no tile of the goal area is connected to
+**                    a passable tile of the start area.
+*/
+bool RegionsMayConnect(const CUnit &unit, const Vec2i &startPos, const Vec2i &startSize,
+					   const Vec2i &goalPos, const Vec2i &goalSize)
+{
+	const tile_flags mask = RegionStaticMask(unit.Type->MovementMask);
+	if (!AStarRegions || mask == 0) {
+		return true;
+	}
+	Vec2i startMin = startPos;
+	Vec2i startMax = startPos + startSize - Vec2i(1, 1);
+	Vec2i goalMin = goalPos;
+	Vec2i goalMax = goalPos + goalSize - Vec2i(1, 1);
+	Map.Clamp(startMin);
+	Map.Clamp(startMax);
+	Map.Clamp(goalMin);
+	Map.Clamp(goalMax);
+	const Vec2i startArea = startMax - startMin + Vec2i(1, 1);
+	const Vec2i goalArea = goalMax - goalMin + Vec2i(1, 1);
+
+	if (startArea.x * startArea.y > RegionMaxCheckedArea || goalArea.x * goalArea.y > RegionMaxCheckedArea) {
+		return true;
+	}
+	RegionLayer &layer = GetRegionLayer(mask);
+	std::vector<unsigned int> startRegions;
+	for (int y = startMin.y; y <= startMax.y; ++y) {
+		for (int x = startMin.x; x <= startMax.x; ++x) {
+			const unsigned int region = layer.RegionOf(Map.getIndex(x, y));
+			if (region != 0 && !ranges::contains(startRegions, region)) {
+				startRegions.push_back(region);
+			}
+		}
+	}
+	if (startRegions.empty()) {
+		// Standing on an obstacle, the search knows better
+		return true;
+	}
+	for (int y = goalMin.y; y <= goalMax.y; ++y) {
+		for (int x = goalMin.x; x <= goalMax.x; ++x) {
+			if (ranges::contains(startRegions, layer.RegionOf(Map.getIndex(x, y)))) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/**
+**  Whether a search from startPos may reach the goal, same parameters as AStarFindPath.
+**
+**  @return  false when no tile in range of the goal is connected to startPos.
+*/
+bool RegionsMayReach(const Vec2i &startPos, const Vec2i &goalPos, int gw, int gh,
+					 int tilesizex, int tilesizey, int maxrange, const CUnit &unit)
+{
+	// Top left tiles of the unit placements in range of the goal
+	const Vec2i goalMin = goalPos - Vec2i(maxrange + tilesizex - 1, maxrange + tilesizey - 1);
+	const Vec2i goalMax = goalPos + Vec2i(std::max(gw, 1) - 1 + maxrange, std::max(gh, 1) - 1 + maxrange);
+
+	if (RegionsMayConnect(unit, startPos, {1, 1}, goalMin, goalMax - goalMin + Vec2i(1, 1))) {
+		return true;
+	}
+	++RegionRejectedSearches;
+	return false;
+}
+
+/**
+**  Draw the region of each tile, for the movement of the first selected unit.
+**
+**  The labels are not updated here: that would make the game depend on what
+**  is drawn.
+*/
+void DrawRegions(const CViewport &vp)
+{
+	if (!AStarRegions || Selected.empty()) {
+		return;
+	}
+	auto it = RegionLayers.find(RegionStaticMask(Selected[0]->Type->MovementMask));
+	if (it == RegionLayers.end()) {
+		return;
+	}
+	RegionLayer &layer = it->second;
+	CLabel label(GetSmallFont());
+
+	for (int y = vp.MapPos.y; y < vp.MapPos.y + vp.MapHeight; ++y) {
+		for (int x = vp.MapPos.x; x < vp.MapPos.x + vp.MapWidth; ++x) {
+			const Vec2i pos(x, y);
+			if (!Map.Info.IsPointOnMap(pos)) {
+				continue;
+			}
+			const unsigned int region = layer.CurrentRegionOf(Map.getIndex(pos));
+			if (region != 0) {
+				const PixelPos pixel = vp.TilePosToScreen_Center(pos);
+				label.Draw(pixel.x - 8, pixel.y - 4, region);
+			}
+		}
+	}
+}
+
+//@}
@@ -97,6 +97,42 @@ static int CclAStar(lua_State *l)
 			} else {
 				AStarMaxSearchIterations = i;
 			}
+		} else if (value == "hierarchical") {
+			AStarHierarchical = true;
+		} else if (value == "no-hierarchical") {
+			AStarHierarchical = false;
+		} else if (value == "hierarchical-cluster-size") {
+			++j;
+			i = LuaToNumber(l, j + 1);
+			if (i < 4) {
+				LuaError(l, "Hierarchical cluster size must be >= 4\n");
+			} else {
+				AStarHierarchicalClusterSize = i;
+			}
+		} else if (value == "path-cache") {
+			AStarPathCache = true;
+		} else if (value == "no-path-cache") {
+			AStarPathCache = false;
+		} else if (value == "path-cache-size") {
+			++j;
+			i = LuaToNumber(l, j + 1);
+			if (i <= 0) {
+				LuaError(l, "Path cache size must be strictly > 0\n");
+			} else {
+				AStarPathCacheSize = i;
+			}
+		} else if (value == "regions") {
+			AStarRegions = true;
+		} else if (value == "no-regions") {
+			AStarRegions = false;
+		} else if (value == "batch") {
+			PathfinderBatch = true;
+		} else if (value == "no-batch") {
+			PathfinderBatch = false;
+		} else if (value == "batch-parallel") {
+			PathfinderBatchParallel = true;
+		} else if (value == "batch-serial") {
+			PathfinderBatchParallel = false;
 		} else {
 			LuaError(l, "Unsupported tag: %s", value.data());
 		}
@@ -105,6 +141,22 @@ static int CclAStar(lua_State *l)
 	return 0;
 }
 
+/**
+**  Get the statistics of the flow field cache.
+**
+**  @param l  Lua state.
+**
+**  @return   Number of hits, misses and evictions.
+*/
+static int CclGetPathCacheStatistics(lua_State *l)
+{
+	LuaCheckArgs(l, 0);
+	lua_pushnumber(l, PathCacheHits);
+	lua_pushnumber(l, PathCacheMisses);
+	lua_pushnumber(l, PathCacheEvictions);
+	return 3;
+}
+
 #ifdef DEBUG
 bool DumpNextAStar = false;
 
@@ -122,6 +174,7 @@ static int CclDumpNextAStar(lua_State *l)
 void PathfinderCclRegister()
 {
 	lua_register(Lua, "AStar", CclAStar);
+	lua_register(Lua, "GetPathCacheStatistics", CclGetPathCacheStatistics);
 #ifdef DEBUG
 	lua_register(Lua, "DumpNextAStar", CclDumpNextAStar);
 #endif
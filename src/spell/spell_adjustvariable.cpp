@@ -35,6 +35,7 @@
 #include "spell/spell_adjustvariable.h"
 
 #include "script.h"
+#include "ui.h"
 #include "unit.h"
 
 
@@ -146,6 +147,7 @@ int Spell_AdjustVariable::Cast(CUnit &caster,
 		unit->Variable[i].Increase += this->Var[i].AddIncrease;
 
 		// Value field
+		const bool invisible = i == INVISIBLE_INDEX && unit->Variable[i].Value > 0;
 		if (this->Var[i].ModifValue) {
 			unit->Variable[i].Value = this->Var[i].Value;
 		}
@@ -153,6 +155,9 @@ int Spell_AdjustVariable::Cast(CUnit &caster,
 		unit->Variable[i].Value += this->Var[i].IncreaseTime * unit->Variable[i].Increase;
 
 		clamp(&unit->Variable[i].Value, 0, unit->Variable[i].Max);
+		if (i == INVISIBLE_INDEX && invisible != (unit->Variable[i].Value > 0)) {
+			UI.Minimap.UpdateUnit(*unit);
+		}
 	}
 	return 1;
 }
@@ -480,7 +480,7 @@ int SpellCast(CUnit &caster, const SpellType &spell, CUnit *target, const Vec2i
 {
 	Vec2i pos = goalPos;
 
-	caster.Variable[INVISIBLE_INDEX].Value = 0;// unit is invisible until attacks // FIXME: Must be configurable
+	UnHideUnit(caster); // unit is invisible until attacks // FIXME: Must be configurable
 	if (target) {
 		pos = target->tilePos;
 	}
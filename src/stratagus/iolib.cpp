@@ -63,7 +63,8 @@ enum class ClfType
 	Invalid, /// invalid file handle
 	Plain, /// plain text file handle
 	Gzip, /// gzip file handle
-	Bzip2 /// bzip2 file handle
+	Bzip2, /// bzip2 file handle
+	Memory /// buffer in memory
 };
 
 class CFile::PImpl
@@ -81,10 +82,12 @@ class CFile::PImpl
 	int seek(long offset, int whence);
 	long tell();
 	int write(const void *buf, size_t len);
+	std::string takeData();
 
 private:
 	ClfType cl_type = ClfType::Invalid; /// type of CFile
 	FILE *cl_plain = nullptr;  /// standard file pointer
+	std::string cl_memory;     /// data written into memory
 #ifdef USE_ZLIB
 	gzFile cl_gz;    /// gzip file pointer
 #endif // !USE_ZLIB
@@ -165,6 +168,14 @@ void CFile::write(std::string_view data)
 	pimpl->write(data.data(), data.size());
 }
 
+/**
+**  Take the data written into a memory file, and empty it.
+*/
+std::string CFile::takeData()
+{
+	return pimpl->takeData();
+}
+
 static Sint64 sdl_size(SDL_RWops *context)
 {
 	CFile *self = reinterpret_cast<CFile*>(context->hidden.unknown.data1);
@@ -292,7 +303,10 @@ int CFile::PImpl::open(const char *name, long openflags)
 
 	cl_type = ClfType::Invalid;
 
-	if (openflags & CL_OPEN_WRITE) {
+	if ((openflags & CL_OPEN_WRITE) && (openflags & CL_WRITE_MEMORY)) {
+		cl_memory.clear();
+		cl_type = ClfType::Memory;
+	} else if (openflags & CL_OPEN_WRITE) {
 #ifdef USE_BZ2LIB
 		if ((openflags & CL_WRITE_BZ2)
 			&& (cl_bz = BZ2_bzopen((std::string(name) + ".bz2").c_str(), openstring))) {
@@ -375,6 +389,9 @@ int CFile::PImpl::close()
 		if (tp == ClfType::Plain) {
 			ret = fclose(cl_plain);
 		}
+		if (tp == ClfType::Memory) {
+			ret = 0;
+		}
 #ifdef USE_ZLIB
 		if (tp == ClfType::Gzip) {
 			ret = gzclose(cl_gz);
@@ -447,6 +464,10 @@ int CFile::PImpl::write(const void *buf, size_t size)
 		if (tp == ClfType::Plain) {
 			ret = fwrite(buf, size, 1, cl_plain);
 		}
+		if (tp == ClfType::Memory) {
+			cl_memory.append(static_cast<const char *>(buf), size);
+			ret = size;
+		}
 #ifdef USE_ZLIB
 		if (tp == ClfType::Gzip) {
 			ret = gzwrite(cl_gz, buf, size);
@@ -463,6 +484,14 @@ int CFile::PImpl::write(const void *buf, size_t size)
 	return ret;
 }
 
+std::string CFile::PImpl::takeData()
+{
+	Assert(cl_type == ClfType::Memory || cl_type == ClfType::Invalid);
+	std::string data;
+	data.swap(cl_memory);
+	return data;
+}
+
 int CFile::PImpl::seek(long offset, int whence)
 {
 	int ret = -1;
@@ -498,6 +527,9 @@ long CFile::PImpl::tell()
 		if (tp == ClfType::Plain) {
 			ret = ftell(cl_plain);
 		}
+		if (tp == ClfType::Memory) {
+			ret = cl_memory.size();
+		}
 #ifdef USE_ZLIB
 		if (tp == ClfType::Gzip) {
 			ret = gztell(cl_gz);
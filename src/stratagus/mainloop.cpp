@@ -37,6 +37,8 @@
 #include "stratagus.h"
 
 #include "actions.h"
+#include "ai.h"
+#include "ai_processor.h"
 #include "editor.h"
 #include "fow.h"
 #include "game.h"
@@ -51,9 +53,15 @@
 #include "trigger.h"
 #include "ui.h"
 #include "unit.h"
+#include "unit_manager.h"
 #include "video.h"
 #include "parameters.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <vector>
+
 #ifdef HAVE_COZ_PROFILER
 # include <coz.h>
 #endif
@@ -173,6 +181,9 @@ void DrawMapArea(const fieldHighlightChecker highlightChecker = nullptr)
 			}
 		}
 		vp->Draw(highlightChecker);
+		const PixelPos topLeft = vp->GetTopLeftPos();
+		const PixelPos bottomRight = vp->GetBottomRightPos();
+		InvalidateArea(topLeft.x, topLeft.y, bottomRight.x - topLeft.x + 1, bottomRight.y - topLeft.y + 1);
 	}
 }
 
@@ -187,6 +198,11 @@ void UpdateDisplay()
 	if (GameRunning || Editor.Running == EditorEditing) {
 		// to prevent empty spaces in the UI
 		Video.FillRectangleClip(ColorBlack, 0, 0, Video.Width, Video.Height);
+		// The panels around the map area; the viewports are invalidated by DrawMapArea
+		InvalidateArea(0, 0, Video.Width, UI.MapArea.Y);
+		InvalidateArea(0, UI.MapArea.EndY + 1, Video.Width, Video.Height - UI.MapArea.EndY - 1);
+		InvalidateArea(0, UI.MapArea.Y, UI.MapArea.X, UI.MapArea.EndY - UI.MapArea.Y + 1);
+		InvalidateArea(UI.MapArea.EndX + 1, UI.MapArea.Y, Video.Width - UI.MapArea.EndX - 1, UI.MapArea.EndY - UI.MapArea.Y + 1);
 		DrawMapArea();
 		// TODO: for e.g. environmental effects, we want to push to the renderer here with appropriate shaders set,
 		// then do the rest.
@@ -230,11 +246,6 @@ void UpdateDisplay()
 	if (CursorState != CursorStates::Rectangle) {
 		DrawCursor();
 	}
-
-	//
-	// Update changes to display.
-	//
-	Invalidate();
 }
 
 static void InitGameCallbacks()
@@ -249,6 +260,106 @@ static void InitGameCallbacks()
 	GameCallbacks.NetworkEvent = NetworkEvent;
 }
 
+namespace
+{
+
+/// Parts of the game logic timed in headless mode
+enum ELogicParts { cLogicTriggers,
+                   cLogicUnits,
+                   cLogicMissiles,
+                   cLogicPlayers,
+                   cLogicEachSecond,
+                   cLogicPartsCount };
+
+const char *const LogicPartNames[cLogicPartsCount] = {"triggers", "units", "missiles", "players", "each-second"};
+
+/// Time spent in each part of the game logic during one cycle, in nanoseconds
+using LogicCycleTimes = std::array<uint32_t, cLogicPartsCount>;
+
+/// Call func, and store the time it took into times when they are measured
+template <typename Func>
+void TimeLogicPart(LogicCycleTimes *times, ELogicParts part, Func &&func)
+{
+	if (!times) {
+		func();
+		return;
+	}
+	const auto start = std::chrono::steady_clock::now();
+	func();
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	(*times)[part] = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+} // namespace
+
+/**
+**  Work todo each second.
+**  Split into different frames, to reduce cpu time.
+**  Increment mana of magic units.
+**  Update mini-map.
+**  Update map fog of war.
+**  Call AI.
+**  Check game goals.
+**  Check rescue of units.
+*/
+static void GameLogicEachSecond()
+{
+	switch (GameCycle % CYCLES_PER_SECOND) {
+		case 0: // At cycle 0, start all ai players...
+			if (GameCycle == 0) {
+				for (int player = 0; player < NumPlayers; ++player) {
+					PlayersEachSecond(player);
+				}
+			}
+			break;
+		case 1:
+			break;
+		case 2:
+			break;
+		case 3: // minimap update
+			UI.Minimap.UpdateCache = true;
+			break;
+		case 4:
+			break;
+		case 5: // forest grow
+			Map.RegenerateForest();
+			break;
+		case 6: // overtaking units
+			RescueUnits();
+			break;
+		default: {
+			// FIXME: assume that NumPlayers < (CYCLES_PER_SECOND - 7)
+			int player = (GameCycle % CYCLES_PER_SECOND) - 7;
+			Assert(player >= 0);
+			if (player < NumPlayers) {
+				PlayersEachSecond(player);
+			}
+		}
+	}
+}
+
+/**
+**  Play one cycle of the game logic.
+**
+**  @param times  Where to store the time spent in each part, or nullptr to not measure it.
+*/
+static void GameLogicCycle(LogicCycleTimes *times)
+{
+	SinglePlayerReplayEachCycle();
+	++GameCycle;
+	MultiPlayerReplayEachCycle();
+	NetworkCommands(); // Get network commands
+	TimeLogicPart(times, cLogicTriggers, TriggersEachCycle); // handle triggers
+	TimeLogicPart(times, cLogicUnits, UnitActions);          // handle units
+	TimeLogicPart(times, cLogicMissiles, MissileActions);    // handle missiles
+	TimeLogicPart(times, cLogicPlayers, PlayersEachCycle);   // handle players
+	UpdateTimer();      // update game timer
+
+	TimeLogicPart(times, cLogicEachSecond, GameLogicEachSecond);
+
+	CAiProcessor::EndCycleAll(); // send the states of the external AIs
+}
+
 static void GameLogicLoop()
 {
 	// Can't find a better place.
@@ -259,64 +370,12 @@ static void GameLogicLoop()
 	// Game logic part
 	//
 	if (!GamePaused && NetworkInSync && SkipGameCycle < 1) {
-		SinglePlayerReplayEachCycle();
-		++GameCycle;
-		MultiPlayerReplayEachCycle();
-		NetworkCommands(); // Get network commands
-		TriggersEachCycle();// handle triggers
-		UnitActions();      // handle units
-		MissileActions();   // handle missiles
-		PlayersEachCycle(); // handle players
-		UpdateTimer();      // update game timer
-
-
-		//
-		// Work todo each second.
-		// Split into different frames, to reduce cpu time.
-		// Increment mana of magic units.
-		// Update mini-map.
-		// Update map fog of war.
-		// Call AI.
-		// Check game goals.
-		// Check rescue of units.
-		//
-		switch (GameCycle % CYCLES_PER_SECOND) {
-			case 0: // At cycle 0, start all ai players...
-				if (GameCycle == 0) {
-					for (int player = 0; player < NumPlayers; ++player) {
-						PlayersEachSecond(player);
-					}
-				}
-				break;
-			case 1:
-				break;
-			case 2:
-				break;
-			case 3: // minimap update
-				UI.Minimap.UpdateCache = true;
-				break;
-			case 4:
-				break;
-			case 5: // forest grow
-				Map.RegenerateForest();
-				break;
-			case 6: // overtaking units
-				RescueUnits();
-				break;
-			default: {
-				// FIXME: assume that NumPlayers < (CYCLES_PER_SECOND - 7)
-				int player = (GameCycle % CYCLES_PER_SECOND) - 7;
-				Assert(player >= 0);
-				if (player < NumPlayers) {
-					PlayersEachSecond(player);
-				}
-			}
-		}
+		GameLogicCycle(nullptr);
 
 		if (Preference.AutosaveMinutes != 0 && !IsNetworkGame() && !IsReplayGame() && GameCycle > 0 && (GameCycle % (CYCLES_PER_SECOND * 60 * Preference.AutosaveMinutes)) == 0) { // autosave every X minutes (default is 5), if the option is enabled
 		//Wyrmgus end
 			UI.StatusLine.Set(_("Autosave"));
-			SaveGame("autosave.sav");
+			SaveGameInBackground("autosave.sav");
 		}
 	}
 
@@ -406,6 +465,7 @@ void GameMainLoop()
 	CclCommand("if (GameStarting ~= nil) then GameStarting() end");
 
 	long ticks = SDL_GetTicks();
+	ResetVideoUploadStats();
 
 	MultiPlayerReplayEachCycle();
 
@@ -435,6 +495,11 @@ void GameMainLoop()
 		           ticks,
 		           FrameCounter,
 		           GameCycle);
+		const VideoUploadStats uploads = GetVideoUploadStats();
+		ErrorPrint("BENCHMARK UPLOADS: %lu frames uploaded, %lu whole, %.1f KB per frame\n",
+		           uploads.Frames,
+		           uploads.FullUploads,
+		           uploads.Frames ? uploads.Bytes / 1024.0 / uploads.Frames : 0.0);
 	}
 
 	GameCycle = 0;
@@ -447,4 +512,93 @@ void GameMainLoop()
 	SetCallbacks(old_callbacks);
 }
 
+/**
+**  Print the percentiles of the time per cycle of each part of the logic.
+**
+**  @param times  Time spent in each part of the logic by cycle (reordered).
+*/
+static void PrintLogicTimings(std::vector<LogicCycleTimes> &times)
+{
+	printf("\"timings\": {");
+	for (int part = 0; part != cLogicPartsCount && !times.empty(); ++part) {
+		const auto byPart = [part](const LogicCycleTimes &lhs, const LogicCycleTimes &rhs) {
+			return lhs[part] < rhs[part];
+		};
+		const auto percentile = [&](size_t percent) {
+			const auto nth = times.begin() + std::min(times.size() - 1, times.size() * percent / 100);
+			std::nth_element(times.begin(), nth, times.end(), byPart);
+			return (*nth)[part] / 1000.;
+		};
+		const double p50 = percentile(50);
+		const double p99 = percentile(99);
+		const double max = (*std::max_element(times.begin(), times.end(), byPart))[part] / 1000.;
+
+		printf("%s\"%s\": {\"p50\": %.3f, \"p99\": %.3f, \"max\": %.3f}",
+		       part ? ", " : "", LogicPartNames[part], p50, p99, max);
+	}
+	printf("}");
+}
+
+/**
+**  Headless game loop.
+**
+**  Play the game logic of the created game as fast as possible, without
+**  display, sound nor input, until the game or the replay ends, or for the
+**  given number of cycles. Then print a JSON report on the standard output:
+**  the time per cycle in microseconds of each part of the logic, the
+**  histograms of the time of the AI tasks, the final SyncHash, the number
+**  of units and missiles, the peak memory and for replays the result of the
+**  sync checks.
+**
+**  @param cycles  Maximum number of game cycles to play.
+**
+**  @return false if the replay got out of sync.
+*/
+bool HeadlessGameLoop(unsigned long cycles)
+{
+	GameCycle = 0;
+	GameRunning = true;
+
+	CclCommand("if (GameStarting ~= nil) then GameStarting() end");
+
+	MultiPlayerReplayEachCycle();
+
+	std::vector<LogicCycleTimes> times;
+	// cycles may be huge to play until the end, reserve at most an hour of game
+	times.reserve(std::min<unsigned long>(cycles, 60 * 60 * CYCLES_PER_SECOND));
+	AiResetTaskTimings();
+	const auto start = std::chrono::steady_clock::now();
+	while (GameRunning && times.size() != cycles && !IsReplayOver()) {
+		SaveGameLoading = false;
+		GameLogicCycle(&times.emplace_back());
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	const ReplaySyncCheck syncCheck = GetReplaySyncCheck();
+	const bool isReplay = IsReplayGame();
+	EndReplayLog();
+
+	printf("{\"cycles\": %zu, \"seconds\": %.3f, \"cyclesPerSecond\": %.1f, \"syncHash\": \"%08X\", ",
+	       times.size(), elapsed.count(), times.size() / std::max(elapsed.count(), 1e-9), SyncHash);
+	printf("\"units\": %zu, \"missiles\": %zu, \"forestRegrowth\": %zu, \"peakMemoryKiB\": %zu, ",
+	       UnitManager->GetUnits().size(), MissilesCount(), Map.ForestRegrowth.size(), GetPeakResidentMemory());
+	if (isReplay) {
+		printf("\"replay\": {\"checkedSteps\": %lu, \"desyncCycle\": ", syncCheck.CheckedSteps);
+		if (syncCheck.DesyncCycle) {
+			printf("%lu}, ", *syncCheck.DesyncCycle);
+		} else {
+			printf("null}, ");
+		}
+	}
+	PrintLogicTimings(times);
+	printf(", ");
+	AiPrintTaskTimings();
+	printf("}\n");
+	fflush(stdout);
+
+	GameCycle = 0;
+	GameRunning = false;
+	return !syncCheck.DesyncCycle;
+}
+
 //@}
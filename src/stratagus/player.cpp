@@ -360,6 +360,7 @@ std::string_view ToString(EDiplomacy e)
 void CPlayer::SetRevelationType(const RevealTypes type)
 {
 	CPlayer::RevelationFor = type;
+	UI.Minimap.Invalidate();
 }
 
 /**
@@ -459,6 +460,7 @@ void CPlayer::SetRevealed(const bool revealed)
 		/// Remove element from vector;
 		ranges::erase(revealedPlayers, this);
 	}
+	UI.Minimap.Invalidate();
 }
 
 void CPlayer::Save(CFile &file) const
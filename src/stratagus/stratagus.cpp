@@ -459,6 +459,8 @@ static void Usage()
 		"\t-g\t\tForce software rendering (implies no shaders)\n"
 		"\t-G \"options\"\tGame options (passed to game scripts)\n"
 		"\t-h\t\tHelp shows this page\n"
+		"\t-H cycles\tHeadless mode. Plays the given map, savegame or replay for some cycles\n"
+		"\t\t\twithout display, sound nor input, and prints the game logic timings in JSON.\n"
 		"\t-i\t\tEnables unit info dumping into log (for debugging)\n"
 		"\t-I addr\t\tNetwork address to use\n"
 		"\t-l\t\tDisable command log\n"
@@ -523,7 +525,7 @@ void ParseCommandLine(int argc, char **argv, Parameters &parameters)
 #endif
 	char *sep;
 	for (;;) {
-		switch (getopt(argc, argv, "abc:d:D:eE:FgG:hiI:lN:oOP:prs:S:u:v:W?-")) {
+		switch (getopt(argc, argv, "abc:d:D:eE:FgG:hH:iI:lN:oOP:prs:S:u:v:W?-")) {
 			case 'a':
 				EnableAssert = true;
 				continue;
@@ -563,6 +565,14 @@ void ParseCommandLine(int argc, char **argv, Parameters &parameters)
 			case 'G':
 				parameters.luaScriptArguments = optarg;
 				continue;
+			case 'H':
+				parameters.headlessCycles = to_number(optarg);
+				if (!parameters.headlessCycles) {
+					ErrorPrint("%s: incorrect number of headless cycles -- '%s'\n", argv[0], optarg);
+					Usage();
+					exit(-1);
+				}
+				continue;
 			case 'i':
 				EnableUnitDebug = true;
 				continue;
@@ -664,6 +674,12 @@ void ParseCommandLine(int argc, char **argv, Parameters &parameters)
 			CliMapName[index] = '/';
 		}
 	}
+
+	if (parameters.headlessCycles && CliMapName.empty()) {
+		ErrorPrint("%s: headless mode needs a map, a savegame or a replay\n", argv[0]);
+		Usage();
+		exit(-1);
+	}
 }
 
 #ifdef USE_WIN32
@@ -748,7 +764,7 @@ try {
 
 	// Setup sound card, must be done before loading sounds, so that
 	// SDL_mixer can auto-convert to the target format
-	if (InitSound()) {
+	if (!parameters.headlessCycles && InitSound()) {
 		InitMusic();
 	}
 
@@ -760,6 +776,10 @@ try {
 	LoadCcl(parameters.luaStartFilename, parameters.luaScriptArguments);
 
 	// Setup video display
+	if (parameters.headlessCycles) {
+		// Graphics are still loaded, but into a window which is never shown
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+	}
 	InitVideo();
 
 	PrintHeader();
@@ -774,7 +794,7 @@ try {
 	LoadFonts();
 	SetClipping(0, 0, Video.Width - 1, Video.Height - 1);
 	Video.ClearScreen();
-	if (!IsRestart) {
+	if (!IsRestart && !parameters.headlessCycles) {
 		ShowTitleScreens();
 	}
 
@@ -785,6 +805,11 @@ try {
 	NumPlayers = 0;
 
 	UnitManager->Init(); // Units memory management
+	if (parameters.headlessCycles) {
+		const int status = StartHeadlessGame(CliMapName, parameters.headlessCycles) ? 0 : 1;
+		Exit(status);
+		return status;
+	}
 	PreMenuSetup();     // Load everything needed for menus
 
 	MenuLoop();
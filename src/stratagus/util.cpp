@@ -45,6 +45,9 @@
 #ifdef WIN32
 #include <windows.h>
 #include <intrin.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
 #endif
 
 #ifdef USE_STACKTRACE
@@ -539,6 +542,17 @@ static void __cpuid(unsigned int* cpuinfo, int info)
 	);
 }
 
+static void __cpuidex(unsigned int* cpuinfo, int info, int subinfo)
+{
+	__asm__ __volatile__(
+		"xchg %%ebx, %%edi;"
+		"cpuid;"
+		"xchg %%ebx, %%edi;"
+		:"=a" (cpuinfo[0]), "=D" (cpuinfo[1]), "=c" (cpuinfo[2]), "=d" (cpuinfo[3])
+		:"0" (info), "2" (subinfo)
+	);
+}
+
 static unsigned long long _my_xgetbv(unsigned int index)
 {
 	unsigned int eax, edx;
@@ -566,6 +580,7 @@ struct SIMDSupport {
 	bool sse4aSupportted = false;
 	bool sse5Supportted = false;
 	bool avxSupportted = false;
+	bool avx2Supportted = false;
 };
 
 static struct SIMDSupport checkSIMDSupport() {
@@ -598,6 +613,14 @@ static struct SIMDSupport checkSIMDSupport() {
 		s.avxSupportted = (xcrFeatureMask & 0x6) == 0x6;
 	}
 
+	// Check AVX2 support, it needs the OS support of AVX as well
+	__cpuid(cpuinfo, 0);
+	if (cpuinfo[0] >= 7 && s.avxSupportted)
+	{
+		__cpuidex(cpuinfo, 7, 0);
+		s.avx2Supportted = (cpuinfo[1] & (1 << 5)) != 0;
+	}
+
 	// ----------------------------------------------------------------------
 
 	// Check SSE4a and SSE5 support
@@ -629,6 +652,12 @@ bool supportsAVX()
 	return s.avxSupportted;
 }
 
+bool supportsAVX2()
+{
+	static struct SIMDSupport s = checkSIMDSupport();
+	return s.avx2Supportted;
+}
+
 #else // __x86_64__
 
 bool supportsSSE2()
@@ -641,8 +670,22 @@ bool supportsAVX()
 	return false;
 }
 
+bool supportsAVX2()
+{
+	return false;
+}
+
 #endif // __x86_64__
 
+bool supportsNEON()
+{
+#ifdef __ARM_NEON
+	return true; // Part of the base instruction set of AArch64
+#else
+	return false;
+#endif
+}
+
 void *aligned_malloc(size_t alignment, size_t size)
 {
 #ifdef WIN32
@@ -675,3 +718,24 @@ fs::path GetExecutablePath()
 #endif
 	return executable_path;
 }
+
+size_t GetPeakResidentMemory()
+{
+#ifdef WIN32
+	PROCESS_MEMORY_COUNTERS counters{};
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return 0;
+	}
+	return counters.PeakWorkingSetSize / 1024;
+#else
+	struct rusage usage{};
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+# ifdef __APPLE__
+	return usage.ru_maxrss / 1024; // in bytes
+# else
+	return usage.ru_maxrss; // in KiB
+# endif
+#endif
+}
@@ -111,7 +111,7 @@ static bool CanBuildOnArea(const CUnit &unit, const Vec2i &pos)
 	for (int j = 0; j < unit.Type->TileHeight; ++j) {
 		for (int i = 0; i < unit.Type->TileWidth; ++i) {
 			const Vec2i tempPos(i, j);
-			if (!Map.Field(pos + tempPos)->playerInfo.IsExplored(*ThisPlayer)) {
+			if (!Map.Field(pos + tempPos)->playerInfo().IsExplored(*ThisPlayer)) {
 				return false;
 			}
 		}
@@ -249,7 +249,7 @@ DoRightButton_Harvest_Unit(CUnit &unit, CUnit &dest, EFlushMode flush, int &ackn
 static bool
 DoRightButton_Harvest_Pos(CUnit &unit, const Vec2i &pos, EFlushMode flush, int &acknowledged)
 {
-	if (!Map.Field(pos)->playerInfo.IsExplored(*unit.Player)) {
+	if (!Map.Field(pos)->playerInfo().IsExplored(*unit.Player)) {
 		return false;
 	}
 	const CUnitType &type = *unit.Type;
@@ -496,7 +496,7 @@ static bool DoRightButton_NewOrder(
 	}
 	// FIXME: support harvesting more types of terrain.
 	const CMapField &mf = *Map.Field(pos);
-	if (mf.playerInfo.IsExplored(*unit.Player) && mf.IsTerrainResourceOnMap()) {
+	if (mf.playerInfo().IsExplored(*unit.Player) && mf.IsTerrainResourceOnMap()) {
 		if (!acknowledged) {
 			PlayUnitSound(unit, EUnitVoice::Acknowledging);
 			acknowledged = 1;
@@ -1089,7 +1089,7 @@ void UIHandleMouseMove(const PixelPos &cursorPos)
 		if (show == false) {
 			CMapField &mf = *Map.Field(tilePos);
 			for (int i = 0; i < PlayerMax; ++i) {
-				if (mf.playerInfo.IsExplored(Players[i])
+				if (mf.playerInfo().IsExplored(Players[i])
 					&& (i == ThisPlayer->Index || Players[i].HasSharedVisionWith(*ThisPlayer))) {
 					show = true;
 					break;
@@ -1104,7 +1104,7 @@ void UIHandleMouseMove(const PixelPos &cursorPos)
 	} else if (CursorOn == ECursorOn::Minimap) {
 		const Vec2i tilePos = UI.Minimap.ScreenToTilePos(cursorPos);
 
-		if (Map.Field(tilePos)->playerInfo.IsExplored(*ThisPlayer) || ReplayRevealMap) {
+		if (Map.Field(tilePos)->playerInfo().IsExplored(*ThisPlayer) || ReplayRevealMap) {
 			UnitUnderCursor = UnitOnMapTile(tilePos, std::nullopt);
 		}
 	}
@@ -1361,7 +1361,7 @@ static int SendResource(const Vec2i &pos)
 				for (res = 0; res < MaxCosts; ++res) {
 					if (unit->Type->ResInfo[res]
 						&& unit->Type->ResInfo[res]->TerrainHarvester
-						&& mf.playerInfo.IsExplored(*unit->Player)
+						&& mf.playerInfo().IsExplored(*unit->Player)
 						/// By disabling this, we allow the harvester to find the nearest tile with a resource by itself, in case mf is empty.
 						/*&& mf.IsTerrainResourceOnMap(res)*/
 						&& unit->ResourcesHeld < unit->Type->ResInfo[res]->ResourceCapacity
@@ -1383,7 +1383,7 @@ static int SendResource(const Vec2i &pos)
 				ret = 1;
 				continue;
 			}
-			if (mf.playerInfo.IsExplored(*unit->Player) && mf.IsTerrainResourceOnMap()) {
+			if (mf.playerInfo().IsExplored(*unit->Player) && mf.IsTerrainResourceOnMap()) {
 				SendCommandResourceLoc(*unit, pos, flush);
 				ret = 1;
 				continue;
@@ -2114,7 +2114,7 @@ void UIHandleButtonUp(unsigned button)
 			// FIXME: johns: only complete invisibile units
 			const Vec2i cursorTilePos = UI.MouseViewport->ScreenToTilePos(CursorScreenPos);
 			CUnit *unit = nullptr;
-			if (ReplayRevealMap || Map.Field(cursorTilePos)->playerInfo.IsTeamVisible(*ThisPlayer)) {
+			if (ReplayRevealMap || Map.Field(cursorTilePos)->playerInfo().IsTeamVisible(*ThisPlayer)) {
 				const PixelPos cursorMapPos = UI.MouseViewport->ScreenToMapPixelPos(CursorScreenPos);
 
 				unit = UnitOnScreen(cursorMapPos.x, cursorMapPos.y);
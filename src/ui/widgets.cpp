@@ -242,6 +242,10 @@ void DrawGuichanWidgets()
 		TheScreen = static_cast<gcn::SDLGraphics*>(Gui->getGraphics())->getTarget();
 		Gui->draw();
 		TheScreen = oldScreen;
+		if (gcn::Widget *top = Gui->getTop()) {
+			const gcn::Rectangle area = top->getDimension();
+			InvalidateArea(area.x, area.y, area.width, area.height);
+		}
 	}
 }
 
@@ -338,7 +338,7 @@ bool CBuildRestrictionAddOn::Check(const CUnit *, const CUnitType &, const Vec2i
 	}
 	functor f(Parent, pos1);
 
-	return ranges::any_of(Map.Field(pos1)->UnitCache, f);
+	return ranges::any_of(Map.Field(pos1)->UnitCache(), f);
 }
 
 /**
@@ -391,7 +391,7 @@ bool CBuildRestrictionOnTop::Check(const CUnit *builder, const CUnitType &, cons
 	Assert(Map.Info.IsPointOnMap(pos));
 
 	ontoptarget = nullptr;
-	auto &cache = Map.Field(pos)->UnitCache;
+	auto &cache = Map.Field(pos)->UnitCache();
 
 	auto it = ranges::find_if(cache, AliveConstructedAndSameTypeAs(*this->Parent));
 
@@ -552,7 +552,7 @@ CanBuildUnitType(const CUnit *unit, const CUnitType &type, const Vec2i &pos, int
 				ontop = std::nullopt;
 				break;
 			}
-			if (player && !mf.playerInfo.IsExplored(*player)) {
+			if (player && !mf.playerInfo().IsExplored(*player)) {
 				h = type.TileHeight;
 				ontop = std::nullopt;
 				break;
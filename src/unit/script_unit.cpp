@@ -49,6 +49,7 @@
 #include "script.h"
 #include "spells.h"
 #include "trigger.h"
+#include "ui.h"
 #include "unit_find.h"
 #include "unit_manager.h"
 #include "unittype.h"
@@ -251,6 +252,10 @@ void PathFinderOutput::Load(lua_State *l)
 			this->Fast = LuaToNumber(l, -1, i);
 		} else if (tag == "overflow-length") {
 			this->OverflowLength = LuaToNumber(l, -1, i);
+		} else if (tag == "ready") {
+			const std::string_view value = LuaToString(l, -1, i);
+			this->Ready = 1;
+			this->ReadyReached = value == "reached";
 		} else if (tag == "path") {
 			lua_rawgeti(l, -1, i);
 			if (!lua_istable(l, -1)) {
@@ -1477,6 +1482,9 @@ static int CclSetUnitVariable(lua_State *l)
 				LuaError(l, "Bad variable type '%s'\n", type.data());
 			}
 		}
+		if (index == INVISIBLE_INDEX) {
+			UI.Minimap.UpdateUnit(*unit);
+		}
 	}
 	lua_pushnumber(l, value);
 	return 1;
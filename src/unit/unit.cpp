@@ -50,6 +50,7 @@
 #include "map.h"
 #include "missile.h"
 #include "network.h"
+#include "pathfinder.h"
 #include "player.h"
 #include "script.h"
 #include "settings.h"
@@ -431,6 +432,7 @@ void CUnit::Init()
 	Active = 0;
 	Boarded = 0;
 	CacheLock = 0;
+	InfluenceThreat = 0;
 	Waiting = 0;
 	MineLow = 0;
 	ZDisplaced = 0;
@@ -851,6 +853,66 @@ void MapUnmarkUnitSight(CUnit &unit)
 	}
 }
 
+/**
+**  Move on vision table the Sight of the unit (and units inside for
+**  transporter (recursively)) for a step to a neighbour tile.
+**
+**  @param unit    Unit to move the sight of.
+**  @param oldPos  coord of first container of unit before the step.
+**  @param pos     coord of first container of unit after the step.
+**  @param width   Width of the first container of unit.
+**  @param height  Height of the first container of unit.
+*/
+static void MapStepUnitSightRec(const CUnit &unit, const Vec2i &oldPos, const Vec2i &pos, int width, int height)
+{
+	const int range = unit.Container ? unit.Container->CurrentSightRange : unit.CurrentSightRange;
+
+	MapSightStep(*unit.Player, unit, oldPos, pos, width, height, range, MapUnmarkTileSight, MapMarkTileSight);
+
+	if (unit.Type && unit.Type->BoolFlag[DETECTCLOAK_INDEX].value) {
+		MapSightStep(*unit.Player, unit, oldPos, pos, width, height, range,
+					 MapUnmarkTileDetectCloak, MapMarkTileDetectCloak);
+	}
+
+	for (const CUnit *unit_inside : unit.InsideUnits) {
+		MapStepUnitSightRec(*unit_inside, oldPos, pos, width, height);
+	}
+}
+
+/**
+**  Move on vision table the Sight of the unit which stepped to a neighbour
+**  tile (and units inside for transporter). It ends as MapUnmarkUnitSight
+**  before the step and MapMarkUnitSight after it, but only updates the
+**  tiles which leave or enter the sight.
+**
+**  @param unit    unit placed on the map, already at its new position.
+**  @param oldPos  position of the unit before the step.
+**  @see MapMarkUnitSight.
+*/
+void MapStepUnitSight(CUnit &unit, const Vec2i &oldPos)
+{
+	Assert(unit.Type);
+	Assert(unit.Container == nullptr);
+
+	MapStepUnitSightRec(unit, oldPos, unit.tilePos, unit.Type->TileWidth, unit.Type->TileHeight);
+
+	// Radar is not worth a step: mark it again.
+	if (!unit.IsUnusable()) {
+		if (unit.Stats->Variables[RADAR_INDEX].Value) {
+			MapUnmarkRadar(*unit.Player, unit, oldPos, unit.Type->TileWidth,
+						   unit.Type->TileHeight, unit.Stats->Variables[RADAR_INDEX].Value);
+			MapMarkRadar(*unit.Player, unit, unit.tilePos, unit.Type->TileWidth,
+						 unit.Type->TileHeight, unit.Stats->Variables[RADAR_INDEX].Value);
+		}
+		if (unit.Stats->Variables[RADARJAMMER_INDEX].Value) {
+			MapUnmarkRadarJammer(*unit.Player, unit, oldPos, unit.Type->TileWidth,
+								 unit.Type->TileHeight, unit.Stats->Variables[RADARJAMMER_INDEX].Value);
+			MapMarkRadarJammer(*unit.Player, unit, unit.tilePos, unit.Type->TileWidth,
+							   unit.Type->TileHeight, unit.Stats->Variables[RADARJAMMER_INDEX].Value);
+		}
+	}
+}
+
 /**
 **  Mark/Unmark on vision table the Sight for the units
 **  around the tilePos
@@ -865,7 +927,7 @@ void MapRefreshUnitsSight(const Vec2i &tilePos, const bool resetSight /*= false*
 {
 	const CMapField *mapField = Map.Field(tilePos);
 	for (const CPlayer &player : Players) {
-		if(!mapField->playerInfo.Visible[player.Index]) {
+		if(!mapField->playerInfo().Visible[player.Index]) {
 			continue;
 		}
 		for (CUnit *const unit : player.GetUnits()) {
@@ -963,6 +1025,9 @@ void MarkUnitFieldFlags(const CUnit &unit)
 		} while (--w);
 		index += Map.Info.MapWidth;
 	} while (--h);
+	if (flags & MapFieldBuilding) {
+		PathfinderTerrainChanged(unit.tilePos, width, unit.Type->TileHeight);
+	}
 }
 
 class _UnmarkUnitFieldFlags
@@ -1006,13 +1071,16 @@ void UnmarkUnitFieldFlags(const CUnit &unit)
 			mf->Flags &= flags;//clean flags
 			_UnmarkUnitFieldFlags funct(unit, mf);
 
-			for (auto *unit : mf->UnitCache) {
+			for (auto *unit : mf->UnitCache()) {
 				funct(unit);
 			}
 			++mf;
 		} while (--w);
 		index += Map.Info.MapWidth;
 	} while (--h);
+	if (unit.Type->FieldFlags & MapFieldBuilding) {
+		PathfinderTerrainChanged(unit.tilePos, width, unit.Type->TileHeight);
+	}
 }
 
 /**
@@ -1082,7 +1150,13 @@ static void UnitInXY(CUnit &unit, const Vec2i &pos)
 */
 void CUnit::MoveToXY(const Vec2i &pos)
 {
-	MapUnmarkUnitSight(*this);
+	const Vec2i oldPos = this->tilePos;
+	// A step to a neighbour tile only changes the edges of the sight.
+	const bool isStep = abs(pos.x - oldPos.x) <= 1 && abs(pos.y - oldPos.y) <= 1;
+
+	if (!isStep) {
+		MapUnmarkUnitSight(*this);
+	}
 	Map.Remove(*this);
 	UnmarkUnitFieldFlags(*this);
 
@@ -1094,7 +1168,11 @@ void CUnit::MoveToXY(const Vec2i &pos)
 	MarkUnitFieldFlags(*this);
 	//  Recalculate the seen count.
 	UnitCountSeen(*this);
-	MapMarkUnitSight(*this);
+	if (isStep) {
+		MapStepUnitSight(*this, oldPos);
+	} else {
+		MapMarkUnitSight(*this);
+	}
 }
 
 /**
@@ -1469,7 +1547,7 @@ void CorrectWallDirections(CUnit &unit)
 		if (Map.Info.IsPointOnMap(pos) == false) {
 			flags |= dirFlag;
 		} else {
-			const auto &unitCache = Map.Field(pos)->UnitCache;
+			const auto &unitCache = Map.Field(pos)->UnitCache();
 
 			if (ranges::any_of(unitCache, HasSamePlayerAndTypeAs(unit))) {
 				flags |= dirFlag;
@@ -1494,7 +1572,7 @@ void CorrectWallNeighBours(CUnit &unit)
 		if (Map.Info.IsPointOnMap(pos) == false) {
 			continue;
 		}
-		auto &unitCache = Map.Field(pos)->UnitCache;
+		auto &unitCache = Map.Field(pos)->UnitCache();
 		auto it = ranges::find_if(unitCache, HasSamePlayerAndTypeAs(unit));
 
 		if (it != unitCache.end() && *it != nullptr) {
@@ -1602,11 +1680,11 @@ void UnitCountSeen(CUnit &unit)
 				int x = width;
 				do {
 					if (unit.Type->BoolFlag[PERMANENTCLOAK_INDEX].value && unit.Player != &Players[p]) {
-						if (mf->playerInfo.VisCloak[p] || Players[p].Type == PlayerTypes::PlayerNobody) {
+						if (mf->playerInfo().VisCloak[p] || Players[p].Type == PlayerTypes::PlayerNobody) {
 							newv++;
 						}
 					} else {
-						if (mf->playerInfo.IsVisible(Players[p])) {
+						if (mf->playerInfo().IsVisible(Players[p])) {
 							newv++;
 						}
 					}
@@ -1780,6 +1858,9 @@ void CUnit::ChangeOwner(CPlayer &newplayer)
 
 	MapUnmarkUnitSight(*this);
 	newplayer.AddUnit(*this);
+	if (!Removed) {
+		Map.ChangeOwner(*this, oldplayer->Index);
+	}
 	Stats = const_cast<CUnitStats *>(&Type->Stats[newplayer.Index]);
 	UpdateUnitSightRange(*this);
 	MapMarkUnitSight(*this);
@@ -34,6 +34,7 @@
 --  Includes
 ----------------------------------------------------------------------------*/
 
+#include <algorithm>
 #include <vector>
 
 #include "stratagus.h"
@@ -55,6 +56,7 @@
 #include "translate.h"
 #include "unit.h"
 #include "unit_find.h"
+#include "unit_manager.h"
 #include "unitsound.h"
 #include "unittype.h"
 #include "ui.h"
@@ -1058,24 +1060,81 @@ static inline bool DrawLevelCompare(const CUnit *c1, const CUnit *c2)
 }
 
 /**
-**  Find all units to draw in viewport.
+**  Update the units to draw in viewport.
 **
-**  @param vp     Viewport to be drawn.
-**  @return Table of units to return in sorted order
+**  The units still visible keep their order of the previous frame and are
+**  sorted again by insertion, the ones which entered the viewport are
+**  sorted apart, then both are merged. DrawLevelCompare is a total order,
+**  so the result is the same as a full sort.
 **
+**  @param vp     Viewport to be drawn.
+**  @return Table of units to draw in sorted order
 */
-std::vector<CUnit *> FindAndSortUnits(const CViewport &vp)
+const std::vector<CUnit *> &CUnitDrawList::Update(const CViewport &vp)
 {
 	//  Select all units touching the viewpoint.
 	const Vec2i offset(1, 1);
 	const Vec2i vpSize(vp.MapWidth, vp.MapHeight);
 	const Vec2i minPos = vp.MapPos - offset;
 	const Vec2i maxPos = vp.MapPos + vpSize + offset;
-	std::vector<CUnit *> table =
-		Select(minPos, maxPos, [&](const CUnit *unit) { return unit->IsVisibleInViewport(vp); });
 
-	ranges::sort(table, DrawLevelCompare);
-	return table;
+	// Stamp marks the units visible in this frame, Stamp + 1 the ones kept
+	Stamp += 2;
+	if (Stamp == 0) {
+		std::fill(Stamps.begin(), Stamps.end(), 0);
+		Stamp = 2;
+	}
+	Visible.clear();
+	Map.UnitGrid.ForEach(minPos, maxPos, CUnitGrid::AllPlayers, [&](const CUnitGrid::Entry &entry) {
+		CUnit *unit = entry.Unit;
+		if (unit->IsVisibleInViewport(vp)) {
+			const size_t slot = UnitNumber(*unit);
+			if (slot >= Stamps.size()) {
+				Stamps.resize(slot + 1, 0);
+			}
+			Stamps[slot] = Stamp;
+			Visible.push_back(unit);
+		}
+	});
+
+	// Keep the units still visible, in their previous order
+	Units.clear();
+	size_t kept = 0;
+	for (const int slot : Slots) {
+		if (size_t(slot) < Stamps.size() && Stamps[slot] == Stamp) {
+			Stamps[slot] = Stamp + 1;
+			Slots[kept++] = slot;
+			Units.push_back(&UnitManager->GetSlotUnit(slot));
+		}
+	}
+	Slots.resize(kept);
+	// Append the ones which entered the viewport
+	for (CUnit *unit : Visible) {
+		const int slot = UnitNumber(*unit);
+		if (Stamps[slot] == Stamp) {
+			Slots.push_back(slot);
+			Units.push_back(unit);
+		}
+	}
+
+	// The kept units are nearly sorted, the entered ones may be many (after a jump of the camera)
+	const auto entered = Units.begin() + kept;
+	for (auto it = Units.begin(); it != entered; ++it) {
+		CUnit *unit = *it;
+		auto hole = it;
+
+		for (; hole != Units.begin() && DrawLevelCompare(unit, *(hole - 1)); --hole) {
+			*hole = *(hole - 1);
+		}
+		*hole = unit;
+	}
+	std::sort(entered, Units.end(), DrawLevelCompare);
+	std::inplace_merge(Units.begin(), entered, Units.end(), DrawLevelCompare);
+
+	for (size_t i = 0; i != Units.size(); ++i) {
+		Slots[i] = UnitNumber(*Units[i]);
+	}
+	return Units;
 }
 
 //@}
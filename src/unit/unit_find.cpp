@@ -91,7 +91,7 @@ std::vector<CUnit *> SelectAroundUnit(const CUnit &unit, int range)
 
 CUnit *UnitFinder::FindUnitAtPos(const Vec2i &pos) const
 {
-	for (CUnit *unit : Map.Field(pos)->UnitCache) {
+	for (CUnit *unit : Map.Field(pos)->UnitCache()) {
 		if (ranges::contains(units, unit)) {
 			return unit;
 		}
@@ -101,7 +101,7 @@ CUnit *UnitFinder::FindUnitAtPos(const Vec2i &pos) const
 
 VisitResult UnitFinder::Visit(TerrainTraversal &terrainTraversal, const Vec2i &pos, const Vec2i &from)
 {
-	if (!player.AiEnabled && !Map.Field(pos)->playerInfo.IsExplored(player)) {
+	if (!player.AiEnabled && !Map.Field(pos)->playerInfo().IsExplored(player)) {
 		return VisitResult::DeadEnd;
 	}
 	// Look if found what was required.
@@ -141,7 +141,7 @@ class TerrainFinder
 
 VisitResult TerrainFinder::Visit(TerrainTraversal &terrainTraversal, const Vec2i &pos, const Vec2i &from)
 {
-	if (!player.AiEnabled && !Map.Field(pos)->playerInfo.IsExplored(player)) {
+	if (!player.AiEnabled && !Map.Field(pos)->playerInfo().IsExplored(player)) {
 		return VisitResult::DeadEnd;
 	}
 	// Look if found what was required.
@@ -317,6 +317,9 @@ class ResourceUnitFinder
 	                   int maxRange,
 	                   bool check_usage)
 	{
+		if (AStarRegions && !AnyMineMayBeReached(unit, worker, resource, maxRange)) {
+			return nullptr;
+		}
 		TerrainTraversal terrainTraversal;
 
 		terrainTraversal.SetSize(Map.Info.MapWidth, Map.Info.MapHeight);
@@ -344,6 +347,7 @@ class ResourceUnitFinder
 	}
 	VisitResult Visit(TerrainTraversal &terrainTraversal, const Vec2i &pos, const Vec2i &from);
 private:
+	static bool AnyMineMayBeReached(const CUnit &unit, const CUnit &start, int resource, int maxRange);
 	bool MineIsUsable(const CUnit &mine) const;
 
 	struct ResourceUnitFinder_Cost {
@@ -375,6 +379,34 @@ class ResourceUnitFinder
 	CUnit *resultMine = nullptr;
 };
 
+/**
+**  Whether a mine may be reached from around start, to avoid traversing the
+**  whole region of start when all the mines are out of it.
+**
+**  Only the mines in range of the traversal are looked at.
+*/
+bool ResourceUnitFinder::AnyMineMayBeReached(const CUnit &unit, const CUnit &start, int resource, int maxRange)
+{
+	const CResourceFinder res_finder(resource, 1);
+	const Vec2i startPos = start.tilePos - Vec2i(1, 1);
+	const Vec2i startSize(start.Type->TileWidth + 2, start.Type->TileHeight + 2);
+	// the traversal visits the neighbours of the tiles in range
+	const int range = std::min(maxRange, Map.Info.MapWidth + Map.Info.MapHeight) + 1;
+	const Vec2i offset(range, range);
+	Vec2i minPos = startPos - offset;
+	Vec2i maxPos = startPos + startSize + offset;
+
+	Map.FixSelectionArea(minPos, maxPos);
+	return Map.UnitGrid.AnyOf(minPos, maxPos, CUnitGrid::AllPlayers, [&](const CUnitGrid::Entry &entry) {
+		const CUnit &mine = *entry.Unit;
+
+		return res_finder(&mine)
+		    && RegionsMayConnect(unit, startPos, startSize,
+		                         mine.tilePos - Vec2i(1, 1),
+		                         Vec2i(mine.Type->TileWidth + 2, mine.Type->TileHeight + 2));
+	});
+}
+
 bool ResourceUnitFinder::MineIsUsable(const CUnit &mine) const
 {
 	return mine.Type->BoolFlag[CANHARVEST_INDEX].value && mine.ResourcesHeld
@@ -399,11 +431,11 @@ void ResourceUnitFinder::ResourceUnitFinder_Cost::SetFrom(const CUnit &mine, con
 VisitResult ResourceUnitFinder::Visit(TerrainTraversal &terrainTraversal, const Vec2i &pos, const Vec2i &from)
 {
 	const auto &field = *Map.Field(pos);
-	if (!worker.Player->AiEnabled && !field.playerInfo.IsExplored(*worker.Player)) {
+	if (!worker.Player->AiEnabled && !field.playerInfo().IsExplored(*worker.Player)) {
 		return VisitResult::DeadEnd;
 	}
-	auto it = ranges::find_if(field.UnitCache, res_finder);
-	CUnit *mine = it != field.UnitCache.end() ? *it : nullptr;
+	auto it = ranges::find_if(field.UnitCache(), res_finder);
+	CUnit *mine = it != field.UnitCache().end() ? *it : nullptr;
 
 	if (mine && mine != resultMine && MineIsUsable(*mine)) {
 		ResourceUnitFinder::ResourceUnitFinder_Cost cost;
@@ -583,8 +615,8 @@ std::vector<CUnit *> FindPlayerUnitsByType(const CPlayer &player, const CUnitTyp
 static CUnit *UnitOnMapTile(const unsigned int index, std::optional<EMovement> moveType)
 {
 	const auto &field = *Map.Field(index);
-	auto it = ranges::find_if(field.UnitCache, CUnitTypeFinder(moveType));
-	return it != field.UnitCache.end() ? *it : nullptr;
+	auto it = ranges::find_if(field.UnitCache(), CUnitTypeFinder(moveType));
+	return it != field.UnitCache().end() ? *it : nullptr;
 }
 
 /**
@@ -646,8 +678,8 @@ CUnit *TargetOnMap(const CUnit &source, const Vec2i &pos1, const Vec2i &pos2)
 CUnit *ResourceOnMap(const Vec2i &pos, int resource, bool mine_on_top)
 {
 	const auto &field = *Map.Field(pos);
-	auto it = ranges::find_if(field.UnitCache, CResourceFinder(resource, mine_on_top));
-	return it != field.UnitCache.end() ? *it : nullptr;
+	auto it = ranges::find_if(field.UnitCache(), CResourceFinder(resource, mine_on_top));
+	return it != field.UnitCache().end() ? *it : nullptr;
 }
 
 /**
@@ -664,8 +696,8 @@ CUnit *ResourceDepositOnMap(const Vec2i &pos, int resource)
 		return (unit->Type->CanStore[resource] && !unit->IsUnusable());
 	};
 	const auto &field = *Map.Field(pos);
-	auto it = ranges::find_if(field.UnitCache, isADeposit);
-	return it != field.UnitCache.end() ? *it : nullptr;
+	auto it = ranges::find_if(field.UnitCache(), isADeposit);
+	return it != field.UnitCache().end() ? *it : nullptr;
 }
 
 /*----------------------------------------------------------------------------
@@ -1114,6 +1146,23 @@ bool CheckObstaclesBetweenTiles(const Vec2i &unitPos, const Vec2i &goalPos, unsi
 	return true;
 }
 
+/**
+**  Whether more than count units matching pred are around the unit,
+**  as selected by SelectAroundUnit.
+*/
+template <typename Pred>
+static bool HasMoreUnitsAround(const CUnit &unit, int range, Pred pred, size_t count)
+{
+	Vec2i minPos = unit.tilePos - Vec2i(range, range);
+	Vec2i maxPos = unit.tilePos + Vec2i(unit.Type->TileWidth - 1 + range, unit.Type->TileHeight - 1 + range);
+	size_t found = 0;
+
+	Map.FixSelectionArea(minPos, maxPos);
+	return Map.UnitGrid.AnyOf(minPos, maxPos, CUnitGrid::AllPlayers, [&](const CUnitGrid::Entry &entry) {
+		return entry.Unit != &unit && pred(entry.Unit) && ++found > count;
+	});
+}
+
 /**
 **  Attack units in distance.
 **
@@ -1128,6 +1177,18 @@ bool CheckObstaclesBetweenTiles(const Vec2i &unitPos, const Vec2i &goalPos, unsi
 */
 CUnit *AttackUnitsInDistance(const CUnit &unit, int range, CUnitFilter pred)
 {
+	// If unit is removed, use containers x and y
+	const CUnit *firstContainer = unit.Container ? unit.Container : &unit;
+
+	// Only enemies can be chosen: nothing to do if there are none around
+	const int searchRange = range + std::max(0, unit.Type->Missile.Missile->Range - 1);
+	const Vec2i offset(searchRange, searchRange);
+	const Vec2i typeSize(firstContainer->Type->TileWidth - 1, firstContainer->Type->TileHeight - 1);
+	if ((Map.Influence.PlayersIn(firstContainer->tilePos - offset, firstContainer->tilePos + typeSize + offset)
+	     & unit.Player->GetEnemyMask()) == 0) {
+		return nullptr;
+	}
+
 	// if necessary, take possible damage on allied units into account...
 	if (unit.Type->Missile.Missile->Range > 1
 		&& (range + unit.Type->Missile.Missile->Range < 15)) {
@@ -1138,8 +1199,6 @@ CUnit *AttackUnitsInDistance(const CUnit &unit, int range, CUnitFilter pred)
 
 		Assert(2 * missile_range + 1 < 32);
 
-		// If unit is removed, use containers x and y
-		const CUnit *firstContainer = unit.Container ? unit.Container : &unit;
 		std::vector<CUnit *> table =
 			SelectAroundUnit(*firstContainer,
 		                     missile_range,
@@ -1150,15 +1209,16 @@ CUnit *AttackUnitsInDistance(const CUnit &unit, int range, CUnitFilter pred)
 		}
 		return nullptr;
 	} else {
-		// If unit is removed, use containers x and y
-		const CUnit *firstContainer = unit.Container ? unit.Container : &unit;
+		const auto notNeutral = MakeAndPredicate(HasNotSamePlayerAs(Players[PlayerNumNeutral]), pred);
+		// Only enemies can be chosen, so don't look at the other units
 		std::vector<CUnit *> table =
-			SelectAroundUnit(*firstContainer,
-		                     range,
-		                     MakeAndPredicate(HasNotSamePlayerAs(Players[PlayerNumNeutral]), pred));
+			SelectAroundUnit(*firstContainer, range, notNeutral, unit.Player->GetEnemyMask());
 
-		if (range > 25 && table.size() > 9) {
-			ranges::sort(table, CompareUnitDistance(unit));
+		if (range > 25 && table.size() > 1) {
+			// Keep choosing between equivalent targets as when all the units around were counted
+			if (table.size() > 9 || HasMoreUnitsAround(*firstContainer, range, notNeutral, 9)) {
+				ranges::sort(table, CompareUnitDistance(unit));
+			}
 		}
 
 		// Find the best unit to attack
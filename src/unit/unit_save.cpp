@@ -99,6 +99,9 @@ void PathFinderOutput::Save(CFile &file) const
 		}
 		file.printf("},");
 	}
+	if (this->Ready) {
+		file.printf("\"ready\", \"%s\", ", this->ReadyReached ? "reached" : "path");
+	}
 	file.printf("\"cycles\", %d", this->Cycles);
 
 	file.printf("},\n  ");
@@ -90,6 +90,8 @@ static unsigned int VisibleGameCursorFrame;
 
 
 static sdl2::SurfacePtr HiddenSurface;
+/// Screen area of the software cursor drawn last
+static SDL_Rect DrawnCursorArea;
 
 /*----------------------------------------------------------------------------
 --  Functions
@@ -291,7 +293,7 @@ static void DrawBuildingCursor()
 					  CanBuildOn(posIt, MapFogFilterFlags(*ThisPlayer, posIt,
 														  mask & ((!Selected.empty() && Selected[0]->tilePos == posIt) ?
 																  ~(MapFieldLandUnit | MapFieldSeaUnit) : -1))))
-				&& Map.Field(posIt)->playerInfo.IsExplored(*ThisPlayer)) {
+				&& Map.Field(posIt)->playerInfo().IsExplored(*ThisPlayer)) {
 				color = ColorGreen;
 			} else {
 				color = ColorRed;
@@ -369,6 +371,10 @@ void DrawCursor()
 			GameCursor->G->Load();
 		}
 		GameCursor->G->DrawFrameClip(GameCursor->SpriteFrame, pos.x, pos.y);
+		// Both where the cursor was and where it is now changed
+		InvalidateArea(DrawnCursorArea.x, DrawnCursorArea.y, DrawnCursorArea.w, DrawnCursorArea.h);
+		DrawnCursorArea = {pos.x, pos.y, GameCursor->G->getWidth(), GameCursor->G->getHeight()};
+		InvalidateArea(DrawnCursorArea.x, DrawnCursorArea.y, DrawnCursorArea.w, DrawnCursorArea.h);
 	} else {
 		// This is a (hardware) cursor drawn by SDL, so only should be set if something changed
 		if (ActuallyVisibleGameCursor != GameCursor || GameCursor->SpriteFrame != VisibleGameCursorFrame) {
@@ -273,8 +273,12 @@ void DrawTransHLine(Uint32 color, int x, int y,
 					int width, unsigned char alpha)
 {
 	Video.LockScreen();
-	for (int i = 0; i < width; ++i) {
-		VideoDoDrawTransPixel(color, x + i, y, alpha);
+	if (Video.Depth == 32 && width > 0) {
+		BlendRowColor_32bpp(color, alpha, &((Uint32 *)TheScreen->pixels)[x + y * Video.Width], width);
+	} else {
+		for (int i = 0; i < width; ++i) {
+			VideoDoDrawTransPixel(color, x + i, y, alpha);
+		}
 	}
 	Video.UnlockScreen();
 }
@@ -600,9 +604,15 @@ void FillTransRectangle(Uint32 color, int x, int y,
 	int sx = x;
 
 	Video.LockScreen();
-	for (; y < ey; ++y) {
-		for (x = sx; x < ex; ++x) {
-			VideoDoDrawTransPixel(color, x, y, alpha);
+	if (Video.Depth == 32 && w > 0) {
+		for (; y < ey; ++y) {
+			BlendRowColor_32bpp(color, alpha, &((Uint32 *)TheScreen->pixels)[sx + y * Video.Width], w);
+		}
+	} else {
+		for (; y < ey; ++y) {
+			for (x = sx; x < ex; ++x) {
+				VideoDoDrawTransPixel(color, x, y, alpha);
+			}
 		}
 	}
 	Video.UnlockScreen();
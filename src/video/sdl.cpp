@@ -83,8 +83,14 @@ SDL_Renderer *TheRenderer = nullptr; /// Internal screen
 SDL_Texture *TheTexture; /// Internal screen
 SDL_Surface *TheScreen; /// Internal screen
 
-static SDL_Rect Rects[100];
+/// Damaged areas of the screen, not overlapping, to upload to the texture on the next frame
+static constexpr int MaxDamageRects = 16;
+static SDL_Rect Rects[MaxDamageRects];
 static int NumRects;
+/// Percentage of the screen damaged from which it is uploaded at once
+static constexpr int FullUploadPercent = 50;
+/// Uploads of the screen to the texture
+static VideoUploadStats UploadStats;
 
 static std::map<int, std::string> Key2Str;
 static std::map<std::string, int> Str2Key;
@@ -499,16 +505,52 @@ void InitVideoSdl()
 **  @param y  screen pixel Y position.
 **  @param w  width of rectangle in pixels.
 **  @param h  height of rectangle in pixels.
+**
+**  The area is clipped to the screen.
 */
 void InvalidateArea(int x, int y, int w, int h)
 {
-	Assert(NumRects != sizeof(Rects) / sizeof(*Rects));
-	Assert(x >= 0 && y >= 0 && x + w <= Video.Width && y + h <= Video.Height);
-	Rects[NumRects].x = x;
-	Rects[NumRects].y = y;
-	Rects[NumRects].w = w;
-	Rects[NumRects].h = h;
-	++NumRects;
+	const SDL_Rect requested = {x, y, w, h};
+	const SDL_Rect screen = {0, 0, Video.Width, Video.Height};
+	SDL_Rect rect;
+	if (!SDL_IntersectRect(&requested, &screen, &rect)) {
+		return;
+	}
+	const auto touches = [](const SDL_Rect &a, const SDL_Rect &b) {
+		return a.x <= b.x + b.w && b.x <= a.x + a.w && a.y <= b.y + b.h && b.y <= a.y + a.h;
+	};
+	const auto area = [](const SDL_Rect &r) { return long(r.w) * r.h; };
+
+	while (true) {
+		// Absorb the areas it overlaps or touches, the union may reach other ones
+		for (int i = 0; i < NumRects;) {
+			if (touches(Rects[i], rect)) {
+				SDL_UnionRect(&Rects[i], &rect, &rect);
+				Rects[i] = Rects[--NumRects];
+				i = 0;
+			} else {
+				++i;
+			}
+		}
+		if (NumRects != MaxDamageRects) {
+			break;
+		}
+		// No room left: absorb the area which grows the least
+		int best = 0;
+		long bestGrowth = LONG_MAX;
+		for (int i = 0; i != NumRects; ++i) {
+			SDL_Rect merged;
+			SDL_UnionRect(&Rects[i], &rect, &merged);
+			const long growth = area(merged) - area(Rects[i]) - area(rect);
+			if (growth < bestGrowth) {
+				bestGrowth = growth;
+				best = i;
+			}
+		}
+		SDL_UnionRect(&Rects[best], &rect, &rect);
+		Rects[best] = Rects[--NumRects];
+	}
+	Rects[NumRects++] = rect;
 }
 
 /**
@@ -588,6 +630,12 @@ static void SdlDoEvent(const EventCallback &callbacks, SDL_Event &event)
 			switch (event.window.event) {
 				case SDL_WINDOWEVENT_SIZE_CHANGED:
 				SizeChangeCounter++;
+				Invalidate();
+				break;
+
+				case SDL_WINDOWEVENT_EXPOSED:
+				// Present the whole screen again, even if nothing changed
+				Invalidate();
 				break;
 
 				case SDL_WINDOWEVENT_ENTER:
@@ -796,6 +844,47 @@ static void RenderBenchmarkOverlay()
 	SDL_SetRenderDrawColor(TheRenderer, 0, 0, 0, 255);
 }
 
+/**
+**  Upload the damaged areas of the screen to the texture, or the whole
+**  screen when most of it is damaged.
+*/
+static void UploadDamagedAreas()
+{
+	const int bpp = TheScreen->format->BytesPerPixel;
+	long damaged = 0;
+	for (int i = 0; i != NumRects; ++i) {
+		damaged += long(Rects[i].w) * Rects[i].h;
+	}
+
+	++UploadStats.Frames;
+	if (damaged * 100 >= long(Video.Width) * Video.Height * FullUploadPercent) {
+		SDL_UpdateTexture(TheTexture, nullptr, TheScreen->pixels, TheScreen->pitch);
+		++UploadStats.FullUploads;
+		UploadStats.Bytes += (unsigned long long)(Video.Width) * Video.Height * bpp;
+	} else {
+		for (int i = 0; i != NumRects; ++i) {
+			const SDL_Rect &rect = Rects[i];
+			const Uint8 *pixels = static_cast<const Uint8 *>(TheScreen->pixels) + rect.y * TheScreen->pitch + rect.x * bpp;
+			SDL_UpdateTexture(TheTexture, &rect, pixels, TheScreen->pitch);
+		}
+		UploadStats.Bytes += (unsigned long long)(damaged) * bpp;
+	}
+	NumRects = 0;
+}
+
+/**
+**  Uploads of the screen to the texture since the last reset.
+*/
+VideoUploadStats GetVideoUploadStats()
+{
+	return UploadStats;
+}
+
+void ResetVideoUploadStats()
+{
+	UploadStats = VideoUploadStats();
+}
+
 void RealizeVideoMemory()
 {
 	++FrameCounter;
@@ -805,21 +894,19 @@ void RealizeVideoMemory()
 	if (Preference.FrameSkip && (FrameCounter & Preference.FrameSkip)) {
 		return;
 	}
+	// The texture keeps the areas which were not damaged, present it anyway:
+	// the frame pacing and the benchmark overlay don't depend on the damage
 	if (NumRects) {
-		//SDL_UpdateWindowSurfaceRects(TheWindow, Rects, NumRects);
-		SDL_UpdateTexture(TheTexture, nullptr, TheScreen->pixels, TheScreen->pitch);
-		if (!RenderWithShader(TheRenderer, TheWindow, TheTexture)) {
-			SDL_RenderClear(TheRenderer);
-			//for (int i = 0; i < NumRects; i++)
-			//    SDL_UpdateTexture(TheTexture, &Rects[i], TheScreen->pixels, TheScreen->pitch);
-			SDL_RenderCopy(TheRenderer, TheTexture, nullptr, nullptr);
-		}
-		if (Parameters::Instance.benchmark) {
-			RenderBenchmarkOverlay();
-		}
-		SDL_RenderPresent(TheRenderer);
-		NumRects = 0;
+		UploadDamagedAreas();
+	}
+	if (!RenderWithShader(TheRenderer, TheWindow, TheTexture)) {
+		SDL_RenderClear(TheRenderer);
+		SDL_RenderCopy(TheRenderer, TheTexture, nullptr, nullptr);
+	}
+	if (Parameters::Instance.benchmark) {
+		RenderBenchmarkOverlay();
 	}
+	SDL_RenderPresent(TheRenderer);
 	if (!Preference.HardwareCursor) {
 		HideCursor();
 	}
@@ -94,6 +94,7 @@
 
 #include <SDL.h>
 #include <SDL_image.h>
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -353,6 +354,149 @@ void VideoCclRegister()
 	lua_register(Lua, "SetVideoSyncSpeed", CclSetVideoSyncSpeed);
 }
 
+/// Instruction set used by the 32bpp blending kernels
+static BlendSimdTypes BlendSimd = supportsAVX2() ? BlendSimdTypes::cAVX2
+                                  : supportsSSE2() ? BlendSimdTypes::cSSE2
+                                  : supportsNEON() ? BlendSimdTypes::cNEON
+                                  : BlendSimdTypes::cScalar;
+
+/// Pixels under which a blit isn't worth sharing between threads (false sharing, thread wakeups)
+static constexpr int MinBlitPixelsPerThread = 64 * 64;
+
+#if defined(__x86_64__)
+// video_simd.cpp
+extern size_t BlendRowAlphaSSE2(const uint32_t *src, uint32_t *dst, size_t count);
+extern size_t BlendRowColorSSE2(uint32_t color, unsigned char alpha, uint32_t *dst, size_t count);
+extern size_t BlendRowAlphaAVX2(const uint32_t *src, uint32_t *dst, size_t count);
+extern size_t BlendRowColorAVX2(uint32_t color, unsigned char alpha, uint32_t *dst, size_t count);
+#elif defined(__ARM_NEON)
+// video_simd.cpp
+extern size_t BlendRowAlphaNEON(const uint32_t *src, uint32_t *dst, size_t count);
+extern size_t BlendRowColorNEON(uint32_t color, unsigned char alpha, uint32_t *dst, size_t count);
+#endif
+
+/**
+**  Instruction set used by the 32bpp blending kernels
+*/
+BlendSimdTypes GetBlendSimdType()
+{
+	return BlendSimd;
+}
+
+/**
+**  Select the instruction set for the 32bpp blending kernels. The best supported one is used by default.
+**
+**  @param type instruction set to use
+**
+**  @return true if success, false if the CPU doesn't support it
+*/
+bool SetBlendSimdType(const BlendSimdTypes type)
+{
+	switch (type) {
+		case BlendSimdTypes::cAVX2:
+			if (!supportsAVX2()) {
+				return false;
+			}
+			break;
+		case BlendSimdTypes::cSSE2:
+			if (!supportsSSE2()) {
+				return false;
+			}
+			break;
+		case BlendSimdTypes::cNEON:
+			if (!supportsNEON()) {
+				return false;
+			}
+			break;
+		default:
+			break;
+	}
+	BlendSimd = type;
+	return true;
+}
+
+/**
+**  Blend a row of pixels into another one with the alpha of each source
+**  pixel. The alpha of the result is cleared.
+**
+**  @param src    source pixels
+**  @param dst    target pixels, blended in place
+**  @param count  number of pixels
+*/
+void BlendRowAlpha_32bpp(const uint32_t *src, uint32_t *dst, size_t count)
+{
+	size_t x = 0;
+#if defined(__x86_64__)
+	if (BlendSimd == BlendSimdTypes::cAVX2) {
+		x = BlendRowAlphaAVX2(src, dst, count);
+	} else if (BlendSimd == BlendSimdTypes::cSSE2) {
+		x = BlendRowAlphaSSE2(src, dst, count);
+	}
+#elif defined(__ARM_NEON)
+	if (BlendSimd == BlendSimdTypes::cNEON) {
+		x = BlendRowAlphaNEON(src, dst, count);
+	}
+#endif
+	for (; x < count; x++) {
+		uint32_t &dstPixel = dst[x];
+
+		const uint8_t dstR = 0xFF & (dstPixel >> RSHIFT);
+		const uint8_t dstG = 0xFF & (dstPixel >> GSHIFT);
+		const uint8_t dstB = 0xFF & (dstPixel >> BSHIFT);
+
+		const uint32_t srcPixel = src[x];
+
+		const uint8_t alpha = 0xFF & (srcPixel >> ASHIFT);
+		const uint8_t srcR  = 0xFF & (srcPixel >> RSHIFT);
+		const uint8_t srcG  = 0xFF & (srcPixel >> GSHIFT);
+		const uint8_t srcB  = 0xFF & (srcPixel >> BSHIFT);
+
+		const uint32_t resR = ((srcR * alpha) + (dstR * (0xFF - alpha))) >> 8;
+		const uint32_t resG = ((srcG * alpha) + (dstG * (0xFF - alpha))) >> 8;
+		const uint32_t resB = ((srcB * alpha) + (dstB * (0xFF - alpha))) >> 8;
+
+		dstPixel = (resR << RSHIFT) | (resG << GSHIFT) | (resB << BSHIFT);
+	}
+}
+
+/**
+**  Blend a color into a row of pixels with a constant alpha, the same way
+**  as a transparent pixel is drawn.
+**
+**  @param color  color to blend
+**  @param alpha  alpha of the color
+**  @param dst    target pixels, blended in place
+**  @param count  number of pixels
+*/
+void BlendRowColor_32bpp(uint32_t color, unsigned char alpha, uint32_t *dst, size_t count)
+{
+	size_t x = 0;
+#if defined(__x86_64__)
+	if (BlendSimd == BlendSimdTypes::cAVX2) {
+		x = BlendRowColorAVX2(color, alpha, dst, count);
+	} else if (BlendSimd == BlendSimdTypes::cSSE2) {
+		x = BlendRowColorSSE2(color, alpha, dst, count);
+	}
+#elif defined(__ARM_NEON)
+	if (BlendSimd == BlendSimdTypes::cNEON) {
+		x = BlendRowColorNEON(color, alpha, dst, count);
+	}
+#endif
+	const unsigned long invAlpha = 255 - alpha;
+	const unsigned long sp2 = (color & 0xFF00FF00) >> 8;
+	const unsigned long sp1 = color & 0x00FF00FF;
+
+	for (; x < count; x++) {
+		unsigned long dp1 = dst[x];
+		unsigned long dp2 = (dp1 & 0xFF00FF00) >> 8;
+		dp1 &= 0x00FF00FF;
+
+		dp1 = ((((dp1 - sp1) * invAlpha) >> 8) + sp1) & 0x00FF00FF;
+		dp2 = ((((dp2 - sp2) * invAlpha) >> 8) + sp2) & 0x00FF00FF;
+		dst[x] = (dp1 | (dp2 << 8));
+	}
+}
+
 /*
 **
 **  Blit a surface into another with alpha blending
@@ -379,15 +523,19 @@ void BlitSurfaceAlphaBlending_32bpp(const SDL_Surface *srcSurface, const SDL_Rec
 		dstWrkRect.h -= yDiff;
 		srcWrkRect.h -= yDiff;
 	}
-
+	if (dstWrkRect.w <= 0 || dstWrkRect.h <= 0) {
+		return;
+	}
 
 	/// Alpha blending of the src texture into the dst
 	const uint32_t *const src = static_cast<uint32_t *>(srcSurface->pixels);
 	uint32_t *const dst = static_cast<uint32_t *>(dstSurface->pixels);
 
-	#pragma omp parallel if(enableMT)
+	/// Give each thread enough pixels to be worth it, small rectangles are blended by this one
+	const int maxThreads = std::clamp(dstWrkRect.w * dstWrkRect.h / MinBlitPixelsPerThread, 1, omp_get_max_threads());
+
+	#pragma omp parallel if(enableMT && maxThreads > 1) num_threads(maxThreads)
 	{
-		/// TODO: change numOfThreads for small rectangles to prevent False Sharing
 		const uint16_t thisThread   = omp_get_thread_num();
 		const uint16_t numOfThreads = omp_get_num_threads();
 		const uint16_t lBound = (thisThread    ) * dstWrkRect.h / numOfThreads;
@@ -397,27 +545,7 @@ void BlitSurfaceAlphaBlending_32bpp(const SDL_Surface *srcSurface, const SDL_Rec
 		size_t dstIndex = (dstWrkRect.y + lBound) * dstSurface->w + dstWrkRect.x;
 
 		for (uint16_t y = lBound; y < uBound; y++) {
-			for (uint16_t x = 0; x < dstWrkRect.w; x++) {
-
-				uint32_t &dstPixel = dst[dstIndex + x];
-
-				const uint8_t dstR = 0xFF & (dstPixel >> RSHIFT);
-				const uint8_t dstG = 0xFF & (dstPixel >> GSHIFT);
-				const uint8_t dstB = 0xFF & (dstPixel >> BSHIFT);
-
-				const uint32_t srcPixel = src[srcIndex + x];
-
-				const uint8_t alpha = 0xFF & (srcPixel >> ASHIFT);
-				const uint8_t srcR  = 0xFF & (srcPixel >> RSHIFT);
-				const uint8_t srcG  = 0xFF & (srcPixel >> GSHIFT);
-				const uint8_t srcB  = 0xFF & (srcPixel >> BSHIFT);
-
-				const uint32_t resR = ((srcR * alpha) + (dstR * (0xFF - alpha))) >> 8;
-				const uint32_t resG = ((srcG * alpha) + (dstG * (0xFF - alpha))) >> 8;
-				const uint32_t resB = ((srcB * alpha) + (dstB * (0xFF - alpha))) >> 8;
-
-				dstPixel = (resR << RSHIFT) | (resG << GSHIFT) | (resB << BSHIFT);
-			}
+			BlendRowAlpha_32bpp(&src[srcIndex], &dst[dstIndex], dstWrkRect.w);
 			srcIndex += srcSurface->w;
 			dstIndex += dstSurface->w;
 		}
@@ -542,6 +670,16 @@ void ColorCycle()
 	}
 }
 
+/**
+**  Number of color cycling steps applied to the palettes since the last
+**  restore, so the surfaces drawn with them know when to be drawn again.
+*/
+unsigned int GetColorCycleCount()
+{
+	const CColorCycling &colorCycling = CColorCycling::GetInstance();
+	return colorCycling.ColorIndexRanges.empty() ? 0 : colorCycling.cycleCount;
+}
+
 void RestoreColorCyclingSurface()
 {
 	CColorCycling &colorCycling = CColorCycling::GetInstance();
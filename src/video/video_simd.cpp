@@ -0,0 +1,237 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name video_simd.cpp - SSE2, AVX2 and NEON kernels for the 32bpp blending. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+
+// The kernels give exactly the same results as the scalar code in
+// video.cpp, which selects them at runtime. Each one processes as many
+// pixels as fit in whole vectors and returns where the scalar code has to
+// continue. The channels are widened to 16 bit lanes.
+//
+// Alpha blit: (src * alpha + dst * (255 - alpha)) >> 8 is at most 65025, so
+// it fits an unsigned 16 bit lane. The alpha channel of the result is cleared.
+//
+// Color blend: the scalar code computes ((dst - color) * (255 - alpha)) >> 8
+// + color on two packed channels, with wrapping unsigned arithmetic. Each
+// channel of the result is the low byte of color + bits 8..15 of
+// (dst - color) * (255 - alpha), which a 16 bit multiplication gives as well.
+
+//@{
+
+/*----------------------------------------------------------------------------
+--  Includes
+----------------------------------------------------------------------------*/
+
+#include "stratagus.h"
+
+#include "video.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__)
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+/// Lane of the alpha channel among the 4 lanes of a widened pixel
+constexpr int AlphaLane = ASHIFT / 8;
+
+/*----------------------------------------------------------------------------
+--  Functions
+----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------
+--  SSE2
+----------------------------------------------------------------------------*/
+
+static inline __m128i BlendAlphaSSE2(const __m128i src, const __m128i dst)
+{
+	__m128i alpha = _mm_shufflelo_epi16(src, _MM_SHUFFLE(AlphaLane, AlphaLane, AlphaLane, AlphaLane));
+	alpha = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(AlphaLane, AlphaLane, AlphaLane, AlphaLane));
+	const __m128i invAlpha = _mm_sub_epi16(_mm_set1_epi16(0xFF), alpha);
+	return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(src, alpha), _mm_mullo_epi16(dst, invAlpha)), 8);
+}
+
+static inline __m128i BlendColorSSE2(const __m128i dst, const __m128i color, const __m128i invAlpha)
+{
+	const __m128i diff = _mm_srli_epi16(_mm_mullo_epi16(_mm_sub_epi16(dst, color), invAlpha), 8);
+	return _mm_and_si128(_mm_add_epi16(diff, color), _mm_set1_epi16(0xFF));
+}
+
+/**
+**  Blend the pixels of src into dst with their alpha, 4 by 4.
+*/
+size_t BlendRowAlphaSSE2(const uint32_t *src, uint32_t *dst, size_t count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i keep = _mm_set1_epi32(~AMASK);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&src[i]));
+		const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&dst[i]));
+		const __m128i lo = BlendAlphaSSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+		const __m128i hi = BlendAlphaSSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(&dst[i]), _mm_and_si128(_mm_packus_epi16(lo, hi), keep));
+	}
+	return i;
+}
+
+/**
+**  Blend color into the pixels of dst with a constant alpha, 4 by 4.
+*/
+size_t BlendRowColorSSE2(uint32_t color, unsigned char alpha, uint32_t *dst, size_t count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i wideColor = _mm_unpacklo_epi8(_mm_set1_epi32(color), zero);
+	const __m128i invAlpha = _mm_set1_epi16(255 - alpha);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&dst[i]));
+		const __m128i lo = BlendColorSSE2(_mm_unpacklo_epi8(d, zero), wideColor, invAlpha);
+		const __m128i hi = BlendColorSSE2(_mm_unpackhi_epi8(d, zero), wideColor, invAlpha);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(&dst[i]), _mm_packus_epi16(lo, hi));
+	}
+	return i;
+}
+
+/*----------------------------------------------------------------------------
+--  AVX2
+----------------------------------------------------------------------------*/
+
+TARGET_AVX2 static inline __m256i BlendAlphaAVX2(const __m256i src, const __m256i dst)
+{
+	__m256i alpha = _mm256_shufflelo_epi16(src, _MM_SHUFFLE(AlphaLane, AlphaLane, AlphaLane, AlphaLane));
+	alpha = _mm256_shufflehi_epi16(alpha, _MM_SHUFFLE(AlphaLane, AlphaLane, AlphaLane, AlphaLane));
+	const __m256i invAlpha = _mm256_sub_epi16(_mm256_set1_epi16(0xFF), alpha);
+	return _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(src, alpha), _mm256_mullo_epi16(dst, invAlpha)), 8);
+}
+
+TARGET_AVX2 static inline __m256i BlendColorAVX2(const __m256i dst, const __m256i color, const __m256i invAlpha)
+{
+	const __m256i diff = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(dst, color), invAlpha), 8);
+	return _mm256_and_si256(_mm256_add_epi16(diff, color), _mm256_set1_epi16(0xFF));
+}
+
+/**
+**  Blend the pixels of src into dst with their alpha, 8 by 8.
+**  Unpacking and packing work within 128 bit lanes, so the pixels keep their order.
+*/
+TARGET_AVX2 size_t BlendRowAlphaAVX2(const uint32_t *src, uint32_t *dst, size_t count)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i keep = _mm256_set1_epi32(~AMASK);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&src[i]));
+		const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&dst[i]));
+		const __m256i lo = BlendAlphaAVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero));
+		const __m256i hi = BlendAlphaAVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(&dst[i]), _mm256_and_si256(_mm256_packus_epi16(lo, hi), keep));
+	}
+	return i;
+}
+
+/**
+**  Blend color into the pixels of dst with a constant alpha, 8 by 8.
+*/
+TARGET_AVX2 size_t BlendRowColorAVX2(uint32_t color, unsigned char alpha, uint32_t *dst, size_t count)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i wideColor = _mm256_unpacklo_epi8(_mm256_set1_epi32(color), zero);
+	const __m256i invAlpha = _mm256_set1_epi16(255 - alpha);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&dst[i]));
+		const __m256i lo = BlendColorAVX2(_mm256_unpacklo_epi8(d, zero), wideColor, invAlpha);
+		const __m256i hi = BlendColorAVX2(_mm256_unpackhi_epi8(d, zero), wideColor, invAlpha);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(&dst[i]), _mm256_packus_epi16(lo, hi));
+	}
+	return i;
+}
+
+#elif defined(__ARM_NEON)
+
+#include <arm_neon.h>
+
+/*----------------------------------------------------------------------------
+--  Functions
+----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------
+--  NEON
+----------------------------------------------------------------------------*/
+
+/**
+**  Blend the pixels of src into dst with their alpha, 4 by 4.
+*/
+size_t BlendRowAlphaNEON(const uint32_t *src, uint32_t *dst, size_t count)
+{
+	const uint32x4_t keep = vdupq_n_u32(~uint32_t(AMASK));
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const uint32x4_t s = vld1q_u32(&src[i]);
+		const uint32x4_t d = vld1q_u32(&dst[i]);
+		// Alpha of each pixel copied into its 4 bytes
+		const uint8x16_t alpha = vreinterpretq_u8_u32(vmulq_n_u32(vandq_u32(vshrq_n_u32(s, ASHIFT), vdupq_n_u32(0xFF)), 0x01010101));
+		const uint8x16_t invAlpha = vsubq_u8(vdupq_n_u8(0xFF), alpha);
+		const uint8x16_t s8 = vreinterpretq_u8_u32(s);
+		const uint8x16_t d8 = vreinterpretq_u8_u32(d);
+
+		const uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(s8), vget_low_u8(alpha)), vget_low_u8(d8), vget_low_u8(invAlpha));
+		const uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(s8), vget_high_u8(alpha)), vget_high_u8(d8), vget_high_u8(invAlpha));
+		const uint8x16_t res = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+		vst1q_u32(&dst[i], vandq_u32(vreinterpretq_u32_u8(res), keep));
+	}
+	return i;
+}
+
+/**
+**  Blend color into the pixels of dst with a constant alpha, 4 by 4.
+*/
+size_t BlendRowColorNEON(uint32_t color, unsigned char alpha, uint32_t *dst, size_t count)
+{
+	const uint16x8_t wideColor = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(color)));
+	const uint16x8_t invAlpha = vdupq_n_u16(255 - alpha);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(&dst[i]));
+		const uint16x8_t lo = vsraq_n_u16(wideColor, vmulq_u16(vsubq_u16(vmovl_u8(vget_low_u8(d)), wideColor), invAlpha), 8);
+		const uint16x8_t hi = vsraq_n_u16(wideColor, vmulq_u16(vsubq_u16(vmovl_u8(vget_high_u8(d)), wideColor), invAlpha), 8);
+		vst1q_u32(&dst[i], vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(lo), vmovn_u16(hi))));
+	}
+	return i;
+}
+
+#endif
+
+//@}
@@ -0,0 +1,217 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name bench_ai_processor.cpp - Throughput of the external AI connections. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+// Usage: stratagus_bench_ai_processor [cycles] [port]
+//
+// Runs a dummy agent on a local port, and plays game cycles as fast as
+// possible where AI players send their state and apply the action of the
+// agent: in lock step with the protocol of AiProcessorStep, then with
+// CAiProcessor for several batch sizes and delays. Prints the states
+// answered per second.
+
+#include "stratagus.h"
+
+#include "ai_processor.h"
+#include "net_lowlevel.h"
+#include "network/netsockets.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+constexpr int StateSize = 32;
+constexpr int ActionCount = 8;
+
+bool RecvAll(Socket socket, void *data, int size)
+{
+	char *bytes = static_cast<char *>(data);
+	while (size != 0) {
+		const int received = NetRecvTCP(socket, bytes, size);
+		if (received <= 0) {
+			return false;
+		}
+		bytes += received;
+		size -= received;
+	}
+	return true;
+}
+
+/// Agent answering the first connection on listener, with actions depending on the player and the cycle
+void DummyAgent(Socket listener)
+{
+	unsigned long clientHost;
+	int clientPort;
+	const Socket socket = NetAcceptTCP(listener, &clientHost, &clientPort);
+	NetSetNoDelay(socket);
+	std::vector<char> buffer;
+	char command;
+	int stateSize = 0;
+	int actionCount = 1;
+
+	while (RecvAll(socket, &command, 1)) {
+		if (command == 'I') {
+			uint8_t dims[2];
+			RecvAll(socket, dims, 2);
+			stateSize = dims[0];
+			actionCount = dims[1];
+		} else if (command == 'S') {
+			buffer.resize(4 * (1 + stateSize));
+			RecvAll(socket, buffer.data(), buffer.size());
+			const char action = uint8_t(buffer[4]) % actionCount;
+			NetSendTCP(socket, &action, 1);
+		} else if (command == 'B') {
+			char header[6];
+			RecvAll(socket, header, sizeof(header));
+			uint16_t count;
+			memcpy(&count, header + 4, sizeof(count));
+			count = ntohs(count);
+			buffer.resize(count * (1 + 4 * (1 + stateSize)));
+			RecvAll(socket, buffer.data(), buffer.size());
+
+			std::vector<char> answer = {'A', header[0], header[1], header[2], header[3], header[4], header[5]};
+			for (int i = 0; i != count; ++i) {
+				const uint8_t player = buffer[i * (1 + 4 * (1 + stateSize))];
+				answer.push_back(player);
+				answer.push_back((player + uint8_t(header[3])) % actionCount);
+			}
+			NetSendTCP(socket, answer.data(), answer.size());
+		} else {
+			break;
+		}
+	}
+	NetCloseTCP(socket);
+}
+
+/// Start a dummy agent on port
+std::thread StartDummyAgent(int port)
+{
+	const Socket listener = NetOpenTCP("127.0.0.1", port);
+	if (listener == static_cast<Socket>(-1) || NetListenTCP(listener) == -1) {
+		fprintf(stderr, "Can't listen on port %d\n", port);
+		exit(1);
+	}
+	return std::thread([listener]() {
+		DummyAgent(listener);
+		NetCloseTCP(listener);
+	});
+}
+
+void PrintResult(const char *name, int players, int delay, long states, std::chrono::duration<double> elapsed)
+{
+	printf("%-10s %2d players, delay %2d: %8ld states in %6.3f s: %10.1f states/s\n",
+	       name, players, delay, states, elapsed.count(), states / elapsed.count());
+}
+
+/// The protocol of AiProcessorStep: each state waits for its action
+void RunLockStep(int port, int cycles, int players)
+{
+	std::thread agent = StartDummyAgent(port);
+	CTCPSocket socket;
+	socket.Open(CHost());
+	if (!socket.Connect(CHost("127.0.0.1", port))) {
+		fprintf(stderr, "Can't connect to the dummy agent\n");
+		exit(1);
+	}
+	socket.SetNoDelay();
+	const char init[3] = {'I', StateSize, ActionCount};
+	socket.Send(init, sizeof(init));
+
+	long states = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for (int cycle = 0; cycle != cycles; ++cycle) {
+		for (int player = 0; player != players; ++player) {
+			char step[1 + 4 * (1 + StateSize)] = {'S'};
+			step[4] = char(player + cycle);
+			socket.Send(step, sizeof(step));
+			char action;
+			socket.Recv(&action, 1);
+			++states;
+		}
+	}
+	PrintResult("lock-step", players, 0, states, std::chrono::steady_clock::now() - start);
+	socket.Send("Q", 1);
+	socket.Close();
+	agent.join();
+}
+
+/// CAiProcessor: the states of a cycle are sent together, their actions taken delay cycles later
+void RunAsync(int port, int cycles, int players, int delay)
+{
+	std::thread agent = StartDummyAgent(port);
+	long states = 0;
+	const auto start = std::chrono::steady_clock::now();
+	{
+		CAiProcessor processor(StateSize, ActionCount, delay);
+		if (!processor.Connect("127.0.0.1", port)) {
+			fprintf(stderr, "Can't connect to the dummy agent\n");
+			exit(1);
+		}
+		std::vector<int32_t> state(StateSize);
+		for (int cycle = 0; cycle != cycles + delay; ++cycle) {
+			for (int player = 0; player != players; ++player) {
+				if (cycle < cycles) {
+					state[0] = player + cycle;
+					processor.PushState(cycle, player, 0, state);
+				}
+				states += processor.TakeAction(player, cycle).has_value();
+			}
+			processor.EndCycle();
+		}
+		if (processor.IsBroken()) {
+			fprintf(stderr, "Connection to the dummy agent lost\n");
+			exit(1);
+		}
+	}
+	PrintResult("async", players, delay, states, std::chrono::steady_clock::now() - start);
+	agent.join();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const int cycles = argc > 1 ? std::max(1, atoi(argv[1])) : 5000;
+	const int port = argc > 2 ? atoi(argv[2]) : 9293;
+
+	NetInit();
+	for (int players : {1, 8}) {
+		RunLockStep(port, cycles, players);
+		for (int delay : {1, 4, 16}) {
+			RunAsync(port, cycles, players, delay);
+		}
+	}
+	NetExit();
+	return 0;
+}
@@ -0,0 +1,140 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name bench_blend.cpp - Microbenchmark of the 32bpp blending kernels. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+
+// Usage: stratagus_bench_blend [frames]
+//
+// Blends a 1080p frame with the alpha blit of the fog and with transparent
+// color fills, with every instruction set supported by the CPU, and prints
+// the throughput of each of them. Also times the blit of small rectangles,
+// which must not pay for waking the OpenMP threads up.
+
+#include "stratagus.h"
+#include "video.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+constexpr int FrameWidth = 1920;
+constexpr int FrameHeight = 1080;
+
+const char *SimdName(BlendSimdTypes type)
+{
+	switch (type) {
+		case BlendSimdTypes::cScalar: return "scalar";
+		case BlendSimdTypes::cSSE2: return "sse2";
+		case BlendSimdTypes::cAVX2: return "avx2";
+		case BlendSimdTypes::cNEON: return "neon";
+	}
+	return "?";
+}
+
+/// Time in ms of one call of func, averaged over the frames
+template <typename Func>
+double Measure(int frames, Func func)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i != frames; ++i) {
+		func();
+	}
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / frames;
+}
+
+/// A surface on pixels, without SDL
+struct BenchSurface {
+	explicit BenchSurface(std::vector<uint32_t> &pixels)
+	{
+		format.Ashift = ASHIFT;
+		surface.format = &format;
+		surface.w = FrameWidth;
+		surface.h = FrameHeight;
+		surface.pixels = pixels.data();
+	}
+
+	SDL_PixelFormat format{};
+	SDL_Surface surface{};
+};
+
+void RunBench(BlendSimdTypes type, int frames)
+{
+	std::vector<uint32_t> src(FrameWidth * FrameHeight);
+	std::vector<uint32_t> dst(FrameWidth * FrameHeight);
+	uint32_t state = 42;
+	for (size_t i = 0; i != src.size(); ++i) {
+		state = state * 1103515245 + 12345;
+		src[i] = state;
+		dst[i] = state >> 8;
+	}
+	BenchSurface srcSurface(src);
+	BenchSurface dstSurface(dst);
+	const double megaPixels = FrameWidth * FrameHeight / 1e6;
+
+	const double alpha = Measure(frames, [&]() {
+		for (int y = 0; y != FrameHeight; ++y) {
+			BlendRowAlpha_32bpp(&src[y * FrameWidth], &dst[y * FrameWidth], FrameWidth);
+		}
+	});
+	const double color = Measure(frames, [&]() {
+		for (int y = 0; y != FrameHeight; ++y) {
+			BlendRowColor_32bpp(0x00406080, 96, &dst[y * FrameWidth], FrameWidth);
+		}
+	});
+	const SDL_Rect frameRect{0, 0, FrameWidth, FrameHeight};
+	const double blit = Measure(frames, [&]() {
+		BlitSurfaceAlphaBlending_32bpp(&srcSurface.surface, &frameRect, &dstSurface.surface, &frameRect);
+	});
+	const SDL_Rect smallRect{64, 64, 32, 32};
+	const double smallBlit = Measure(frames * 100, [&]() {
+		BlitSurfaceAlphaBlending_32bpp(&srcSurface.surface, &smallRect, &dstSurface.surface, &smallRect);
+	});
+
+	printf("%-7s alpha rows %7.1f Mpx/s, color rows %7.1f Mpx/s, blit 1080p %7.3f ms, blit 32x32 %7.3f us\n",
+	       SimdName(type), megaPixels / alpha * 1000, megaPixels / color * 1000, blit, smallBlit * 1000);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const int frames = argc > 1 ? std::max(1, atoi(argv[1])) : 100;
+
+	for (BlendSimdTypes type : {BlendSimdTypes::cScalar, BlendSimdTypes::cSSE2, BlendSimdTypes::cAVX2, BlendSimdTypes::cNEON}) {
+		if (SetBlendSimdType(type)) {
+			RunBench(type, frames);
+		}
+	}
+	return 0;
+}
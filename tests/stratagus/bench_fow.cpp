@@ -0,0 +1,135 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name bench_fow.cpp - Microbenchmark of the fog of war kernels. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+// Usage: stratagus_bench_fow [frames]
+//
+// Runs the enhanced fog kernels (4x4 patterns, blur and bilinear upscale into
+// a 1080p and a 4K viewport) with every instruction set supported by the CPU,
+// and prints the average time per frame of each of them.
+
+#include "fow_utils.h"
+#include "stratagus.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+constexpr uint16_t BenchMapSize = 256;
+constexpr uint16_t TileSize = 32;
+constexpr uint16_t TextureWidth = (BenchMapSize + 1) * 4;
+
+const char *SimdName(FogSimdTypes type)
+{
+	switch (type) {
+		case FogSimdTypes::cScalar: return "scalar";
+		case FogSimdTypes::cSSE2: return "sse2";
+		case FogSimdTypes::cAVX2: return "avx2";
+	}
+	return "?";
+}
+
+/// Time in ms of one call of func, averaged over the frames
+template <typename Func>
+double Measure(int frames, Func func)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i != frames; ++i) {
+		func();
+	}
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / frames;
+}
+
+void RunBench(FogSimdTypes type, int frames)
+{
+	const uint16_t visTableWidth = BenchMapSize + 2;
+	std::vector<uint8_t> visTable(visTableWidth * visTableWidth);
+	uint32_t state = 42;
+	for (uint8_t &vis : visTable) {
+		state = state * 1103515245 + 12345;
+		vis = (state >> 16) % 3;
+	}
+	std::vector<uint8_t> patternsVisible(BenchMapSize + 1);
+	std::vector<uint8_t> patternsExplored(BenchMapSize + 1);
+	std::vector<uint8_t> texture(TextureWidth * TextureWidth);
+	for (size_t i = 0; i != texture.size(); ++i) {
+		texture[i] = visTable[i % visTable.size()] * 0x7F;
+	}
+	CBlurrer blurrer;
+	blurrer.Init(TextureWidth, TextureWidth, 2.0, 3);
+
+	const double patterns = Measure(frames, [&]() {
+		for (uint16_t row = 0; row <= BenchMapSize; ++row) {
+			FogUpscalePatterns(&visTable[row * visTableWidth], &visTable[(row + 1) * visTableWidth],
+			                   BenchMapSize + 1, patternsVisible.data(), patternsExplored.data());
+		}
+	});
+	const double blur = Measure(frames, [&]() { blurrer.Blur(texture.data()); });
+
+	printf("%-7s patterns %7.3f ms, blur %7.3f ms", SimdName(type), patterns, blur);
+
+	for (const auto &[width, height] : {std::pair<int, int>{1920, 1080}, {3840, 2160}}) {
+		std::vector<uint32_t> pixels(width * height);
+		SDL_PixelFormat format{};
+		format.Ashift = 24;
+		SDL_Surface surface{};
+		surface.format = &format;
+		surface.w = width;
+		surface.h = height;
+		surface.pixels = pixels.data();
+
+		const SDL_Rect srcRect{4, 4, width / TileSize * 4, height / TileSize * 4};
+		const SDL_Rect trgRect{0, 0, width, height};
+		const double upscale = Measure(frames, [&]() {
+			FogUpscaleBilinear(texture.data(), srcRect, TextureWidth, &surface, trgRect, 0x102030);
+		});
+		printf(", upscale %dp %7.3f ms", height, upscale);
+	}
+	printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const int frames = argc > 1 ? std::max(1, atoi(argv[1])) : 100;
+
+	for (FogSimdTypes type : {FogSimdTypes::cScalar, FogSimdTypes::cSSE2, FogSimdTypes::cAVX2}) {
+		if (SetFogSimdType(type)) {
+			RunBench(type, frames);
+		}
+	}
+	return 0;
+}
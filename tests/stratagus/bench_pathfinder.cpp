@@ -0,0 +1,157 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name bench_pathfinder.cpp - Microbenchmark of the a* pathfinder. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+// Usage: stratagus_bench_pathfinder [searches]
+//
+// Runs the same pseudo random searches on an open field and on a maze, and
+// prints the number of searches per second. Run it on two builds to compare
+// pathfinder changes.
+
+#include "map.h"
+#include "pathfinder.h"
+#include "player.h"
+#include "stratagus.h"
+#include "unit.h"
+#include "unittype.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+
+extern void InitAStar(int mapWidth, int mapHeight);
+extern void FreeAStar();
+extern int AStarFindPath(const Vec2i &startPos, const Vec2i &goalPos, int gw, int gh,
+						 int tilesizex, int tilesizey, int minrange,
+						 int maxrange, char *path, int pathlen, const CUnit &unit);
+
+namespace
+{
+
+constexpr int BenchMapSize = 128;
+
+/// Deterministic generator, so that both builds run the same searches
+class BenchRandom
+{
+public:
+	int Next(int max)
+	{
+		state = state * 1103515245 + 12345;
+		return (state >> 16) % max;
+	}
+
+private:
+	uint32_t state = 42;
+};
+
+/// Vertical walls every 4 columns, with a single gap alternating at the top and the bottom
+void MakeMaze()
+{
+	for (int x = 2; x < BenchMapSize - 1; x += 4) {
+		const int gap = (x / 4) % 2 ? 0 : BenchMapSize - 1;
+		for (int y = 0; y != BenchMapSize; ++y) {
+			if (y != gap) {
+				Map.Field(x, y)->setFlag(MapFieldUnpassable);
+			}
+		}
+	}
+}
+
+/// A tile where a unit can stand
+Vec2i RandomFreeTile(BenchRandom &random)
+{
+	while (true) {
+		const Vec2i pos(random.Next(BenchMapSize), random.Next(BenchMapSize));
+		if (!Map.Field(pos)->CheckMask(MapFieldUnpassable)) {
+			return pos;
+		}
+	}
+}
+
+void RunBench(const char *name, int searches, const CUnit &unit)
+{
+	BenchRandom random;
+	char path[PathFinderOutput::MAX_PATH_LENGTH];
+	long long totalLength = 0;
+	int found = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i != searches; ++i) {
+		const Vec2i from = RandomFreeTile(random);
+		const Vec2i to = RandomFreeTile(random);
+		const int length = AStarFindPath(from, to, 0, 0, 1, 1, 0, 0, path, std::size(path), unit);
+		if (length > 0) {
+			totalLength += length;
+			++found;
+		}
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	printf("%-10s %6d searches in %7.3f s: %9.1f searches/s, %d paths, average length %.1f\n",
+	       name, searches, elapsed.count(), searches / elapsed.count(), found,
+	       found ? double(totalLength) / found : 0.);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const int searches = argc > 1 ? std::max(1, atoi(argv[1])) : 2000;
+
+	CPlayer player;
+	player.Index = 0;
+	CUnitType type;
+	type.TileWidth = 1;
+	type.TileHeight = 1;
+	type.MovementMask = MapFieldUnpassable;
+	type.BoolFlag.resize(UnitTypeVar.GetNumberBoolFlag());
+	CUnit unit;
+	unit.Player = &player;
+	unit.Type = &type;
+
+	// Fields are never explored here, walls must be known to be avoided
+	AStarKnowUnseenTerrain = true;
+	Map.Info.MapWidth = BenchMapSize;
+	Map.Info.MapHeight = BenchMapSize;
+
+	Map.Create();
+	InitAStar(Map.Info.MapWidth, Map.Info.MapHeight);
+	RunBench("open-field", searches, unit);
+	FreeAStar();
+	Map.ClearFields();
+
+	Map.Create();
+	MakeMaze();
+	InitAStar(Map.Info.MapWidth, Map.Info.MapHeight);
+	RunBench("maze", searches, unit);
+	FreeAStar();
+	Map.ClearFields();
+
+	return 0;
+}
@@ -0,0 +1,174 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name bench_terrain_traversal.cpp - Microbenchmark of the terrain traversals. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+// Usage: stratagus_bench_terrain_traversal [traversals]
+//
+// Runs the same flood fills on a 512x512 map, small ones around a point as
+// the AI does to place a building, and ones covering the whole map, and
+// prints the number of traversals per second: with a TerrainTraversal, and
+// with a copy of the traversal allocating and clearing its marks each time.
+
+#include "stratagus.h"
+
+#include "pathfinder.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+constexpr int BenchMapSize = 512;
+
+/// Deterministic generator, so that both builds run the same traversals
+class BenchRandom
+{
+public:
+	int Next(int max)
+	{
+		state = state * 1103515245 + 12345;
+		return (state >> 16) % max;
+	}
+
+private:
+	uint32_t state = 42;
+};
+
+/// Walls every 16 columns, with a gap every 16 rows
+bool IsWall(const Vec2i &pos)
+{
+	return pos.x % 16 == 15 && pos.y % 16 != 0;
+}
+
+/// Visit up to maxDist tiles away from the start, around the walls
+struct BenchVisitor
+{
+	int maxDist;
+	int visited = 0;
+
+	VisitResult Visit(TerrainTraversal &traversal, const Vec2i &pos, const Vec2i &)
+	{
+		++visited;
+		if (IsWall(pos) || traversal.Get(pos) > maxDist) {
+			return VisitResult::DeadEnd;
+		}
+		return VisitResult::Ok;
+	}
+};
+
+/// The flood fill as done before the pool: marks allocated and cleared, queue allocated
+int AllocatingFloodFill(const Vec2i &start, int maxDist)
+{
+	const int width_ext = BenchMapSize + 2;
+	std::vector<short> values(width_ext * (BenchMapSize + 2));
+	std::queue<std::pair<Vec2i, Vec2i>> queue; // position, and where it was reached from
+	auto value = [&](const Vec2i &pos) -> short & { return values[width_ext + 1 + pos.y * width_ext + pos.x]; };
+	int visited = 0;
+
+	memset(values.data(), '\xFF', width_ext * sizeof(short));
+	for (int i = 1; i < 1 + BenchMapSize; ++i) {
+		values[i * width_ext] = -1;
+		memset(&values[i * width_ext + 1], '\0', BenchMapSize * sizeof(short));
+		values[i * width_ext + BenchMapSize + 1] = -1;
+	}
+	memset(&values[(BenchMapSize + 1) * width_ext], '\xFF', width_ext * sizeof(short));
+
+	queue.push({start, start});
+	value(start) = 1;
+	for (; !queue.empty(); queue.pop()) {
+		const Vec2i pos = queue.front().first;
+
+		++visited;
+		if (IsWall(pos) || value(pos) > maxDist) {
+			value(pos) = -1;
+			continue;
+		}
+		for (int dy = -1; dy <= 1; ++dy) {
+			for (int dx = -1; dx <= 1; ++dx) {
+				const Vec2i newPos = pos + Vec2i(dx, dy);
+				if (value(newPos) == 0) {
+					queue.push({newPos, pos});
+					value(newPos) = value(pos) + 1;
+				}
+			}
+		}
+	}
+	return visited;
+}
+
+int PooledFloodFill(const Vec2i &start, int maxDist)
+{
+	TerrainTraversal traversal;
+
+	traversal.SetSize(BenchMapSize, BenchMapSize);
+	traversal.Init();
+	traversal.PushPos(start);
+	BenchVisitor visitor{maxDist};
+	traversal.Run(visitor);
+	return visitor.visited;
+}
+
+template <typename Func>
+void RunBench(const char *name, int traversals, int maxDist, Func floodFill)
+{
+	BenchRandom random;
+	long long visited = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i != traversals; ++i) {
+		Vec2i pos(random.Next(BenchMapSize), random.Next(BenchMapSize));
+		if (IsWall(pos)) {
+			--pos.x;
+		}
+		visited += floodFill(pos, maxDist);
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	printf("%-22s %6d traversals in %7.3f s: %10.1f traversals/s, %.1f tiles each\n",
+	       name, traversals, elapsed.count(), traversals / elapsed.count(),
+	       double(visited) / traversals);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const int traversals = argc > 1 ? std::max(1, atoi(argv[1])) : 2000;
+
+	RunBench("local, allocating", traversals, 8, AllocatingFloodFill);
+	RunBench("local, pooled", traversals, 8, PooledFloodFill);
+	RunBench("whole map, allocating", traversals / 10, BenchMapSize * 2, AllocatingFloodFill);
+	RunBench("whole map, pooled", traversals / 10, BenchMapSize * 2, PooledFloodFill);
+	return 0;
+}
@@ -0,0 +1,160 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name bench_unit_find.cpp - Microbenchmark of the unit proximity queries. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+// Usage: stratagus_bench_unit_find [rounds]
+//
+// Places two armies of 1000 units face to face, and times the target
+// acquisition queries of every unit for several ranges: the scan of the
+// UnitCache of each tile of the area, the selection of all the units with
+// the unit grid, and the selection of the enemies only.
+
+#include "map.h"
+#include "player.h"
+#include "stratagus.h"
+#include "unit.h"
+#include "unit_find.h"
+#include "unittype.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+namespace
+{
+
+constexpr int BenchMapSize = 128;
+constexpr int ArmySize = 1000;
+constexpr int ArmyWidth = 40;
+
+/// The selection of the units around, as done before the unit grid
+std::vector<CUnit *> ScanUnitCache(const CUnit &unit, int range)
+{
+	Vec2i minPos = unit.tilePos - Vec2i(range, range);
+	Vec2i maxPos = unit.tilePos + Vec2i(range, range);
+	Map.FixSelectionArea(minPos, maxPos);
+
+	std::vector<CUnit *> units;
+	for (Vec2i pos = minPos; pos.y <= maxPos.y; ++pos.y) {
+		for (pos.x = minPos.x; pos.x <= maxPos.x; ++pos.x) {
+			for (CUnit *other : Map.Field(pos)->UnitCache()) {
+				if (other->CacheLock == 0 && other != &unit) {
+					other->CacheLock = 1;
+					units.push_back(other);
+				}
+			}
+		}
+	}
+	for (CUnit *other : units) {
+		other->CacheLock = 0;
+	}
+	return units;
+}
+
+/// Time in us of the query of every unit, averaged over the units and the rounds
+template <typename Func>
+double Measure(CUnit *units, int rounds, Func query)
+{
+	size_t found = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for (int round = 0; round != rounds; ++round) {
+		for (int i = 0; i != 2 * ArmySize; ++i) {
+			found += query(units[i]);
+		}
+	}
+	const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	if (found == 0) {
+		printf("(nothing found) ");
+	}
+	return elapsed.count() / rounds / (2 * ArmySize);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const int rounds = argc > 1 ? std::max(1, atoi(argv[1])) : 20;
+
+	for (int i = 0; i != PlayerMax; ++i) {
+		Players[i].Index = i;
+	}
+	Players[0].SetDiplomacyEnemyWith(Players[1]);
+	Players[1].SetDiplomacyEnemyWith(Players[0]);
+
+	CUnitType type;
+	type.TileWidth = 1;
+	type.TileHeight = 1;
+	type.BoolFlag.resize(UnitTypeVar.GetNumberBoolFlag());
+
+	Map.Info.MapWidth = BenchMapSize;
+	Map.Info.MapHeight = BenchMapSize;
+	Map.Create();
+
+	// Two blocks of ArmyWidth x 25 tiles, touching in the middle of the map
+	const Vec2i origin((BenchMapSize - 2 * ArmyWidth) / 2, (BenchMapSize - ArmySize / ArmyWidth) / 2);
+	auto units = std::make_unique<CUnit[]>(2 * ArmySize);
+	for (int i = 0; i != 2 * ArmySize; ++i) {
+		CUnit &unit = units[i];
+		const int army = i / ArmySize;
+		const int rank = i % ArmySize;
+
+		unit.Player = &Players[army];
+		unit.Type = &type;
+		unit.tilePos = origin + Vec2i(army * ArmyWidth + rank % ArmyWidth, rank / ArmyWidth);
+		unit.Offset = Map.getIndex(unit.tilePos);
+		unit.Removed = 0;
+		Map.Insert(unit);
+	}
+
+	for (int range : {1, 4, 8, 16}) {
+		const double scan = Measure(units.get(), rounds, [=](const CUnit &unit) {
+			size_t enemies = 0;
+			for (const CUnit *other : ScanUnitCache(unit, range)) {
+				enemies += unit.IsEnemy(*other);
+			}
+			return enemies;
+		});
+		const double all = Measure(units.get(), rounds, [=](const CUnit &unit) {
+			size_t enemies = 0;
+			for (const CUnit *other : SelectAroundUnit(unit, range, NoFilter())) {
+				enemies += unit.IsEnemy(*other);
+			}
+			return enemies;
+		});
+		const double enemies = Measure(units.get(), rounds, [=](const CUnit &unit) {
+			return SelectAroundUnit(unit, range, NoFilter(), unit.Player->GetEnemyMask()).size();
+		});
+		printf("range %2d: tile scan %8.3f us, grid %8.3f us, grid enemies %8.3f us\n",
+		       range, scan, all, enemies);
+	}
+
+	Map.UnitGrid.Clean();
+	Map.ClearFields();
+	return 0;
+}
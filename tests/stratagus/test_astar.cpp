@@ -0,0 +1,227 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name test_astar.cpp - The test file for astar.cpp. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+#include <doctest.h>
+
+#include "map.h"
+#include "pathfinder.h"
+#include "player.h"
+#include "stratagus.h"
+#include "unit.h"
+#include "unittype.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <string>
+#include <vector>
+
+extern void InitAStar(int mapWidth, int mapHeight);
+extern void FreeAStar();
+extern int AStarFindPath(const Vec2i &startPos, const Vec2i &goalPos, int gw, int gh,
+						 int tilesizex, int tilesizey, int minrange,
+						 int maxrange, char *path, int pathlen, const CUnit &unit);
+
+namespace
+{
+
+constexpr int TestMapSize = 64;
+
+/// Number of steps from the tile to each tile, -1 if it cannot be reached
+std::vector<int> StepsFrom(const Vec2i &start)
+{
+	std::vector<int> steps(TestMapSize * TestMapSize, -1);
+	std::deque<Vec2i> open{start};
+	steps[start.y * TestMapSize + start.x] = 0;
+	while (!open.empty()) {
+		const Vec2i pos = open.front();
+		open.pop_front();
+		for (int i = 0; i != 8; ++i) {
+			const Vec2i next(pos.x + Heading2X[i], pos.y + Heading2Y[i]);
+			if (!Map.Info.IsPointOnMap(next) || Map.Field(next)->CheckMask(MapFieldUnpassable)
+				|| steps[next.y * TestMapSize + next.x] != -1) {
+				continue;
+			}
+			steps[next.y * TestMapSize + next.x] = steps[pos.y * TestMapSize + pos.x] + 1;
+			open.push_back(next);
+		}
+	}
+	return steps;
+}
+
+/// Vertical walls every 4 columns with alternating gaps, and a walled room
+void MakeMaze()
+{
+	for (int x = 2; x < TestMapSize - 1; x += 4) {
+		const int gap = (x / 4) % 2 ? 0 : TestMapSize - 1;
+		for (int y = 0; y != TestMapSize; ++y) {
+			if (y != gap) {
+				Map.Field(x, y)->setFlag(MapFieldUnpassable);
+			}
+		}
+	}
+	for (int i = 20; i != 29; ++i) {
+		Map.Field(i, 20)->setFlag(MapFieldUnpassable);
+		Map.Field(i, 28)->setFlag(MapFieldUnpassable);
+		Map.Field(20, i)->setFlag(MapFieldUnpassable);
+		Map.Field(28, i)->setFlag(MapFieldUnpassable);
+	}
+}
+
+Vec2i FreeTile(int i)
+{
+	while (true) {
+		const Vec2i pos((i * 37) % TestMapSize, (i * 53 + i / 7) % TestMapSize);
+		if (!Map.Field(pos)->CheckMask(MapFieldUnpassable)) {
+			return pos;
+		}
+		++i;
+	}
+}
+
+/// Run a search and return the directions of the path, in order
+std::string FindPath(const Vec2i &from, const Vec2i &to, const CUnit &unit, int *length)
+{
+	char path[TestMapSize * TestMapSize];
+	*length = AStarFindPath(from, to, 0, 0, 1, 1, 0, 0, path, std::size(path), unit);
+	std::string res;
+	for (int i = *length - 1; i >= 0; --i) {
+		res += char('0' + path[i]);
+	}
+	return res;
+}
+
+/// Follow the directions of a path, checking each step
+Vec2i FollowPath(const Vec2i &from, const std::string &directions)
+{
+	Vec2i pos = from;
+	for (char direction : directions) {
+		pos.x += Heading2X[direction - '0'];
+		pos.y += Heading2Y[direction - '0'];
+		REQUIRE(Map.Info.IsPointOnMap(pos));
+		REQUIRE_FALSE(Map.Field(pos)->CheckMask(MapFieldUnpassable));
+	}
+	return pos;
+}
+
+} // namespace
+
+TEST_CASE("AStar finds the same paths as a full search")
+{
+	CPlayer player;
+	player.Index = 0;
+	CUnitType type;
+	type.TileWidth = 1;
+	type.TileHeight = 1;
+	type.MovementMask = MapFieldUnpassable;
+	type.BoolFlag.resize(UnitTypeVar.GetNumberBoolFlag());
+	CUnit unit;
+	unit.Player = &player;
+	unit.Type = &type;
+
+	const bool knowUnseenTerrain = AStarKnowUnseenTerrain;
+	const int maxSearchIterations = AStarMaxSearchIterations;
+	AStarKnowUnseenTerrain = true;
+	AStarMaxSearchIterations = TestMapSize * TestMapSize;
+	Map.Info.MapWidth = TestMapSize;
+	Map.Info.MapHeight = TestMapSize;
+
+	SUBCASE("open field")
+	{
+		Map.Create();
+		InitAStar(Map.Info.MapWidth, Map.Info.MapHeight);
+		for (int i = 0; i != 200; ++i) {
+			const Vec2i from = FreeTile(i);
+			const Vec2i to = FreeTile(i + 1000);
+			int length;
+			const std::string path = FindPath(from, to, unit, &length);
+			const int distance = std::max(std::abs(to.x - from.x), std::abs(to.y - from.y));
+
+			if (distance == 0) {
+				CHECK(length == PF_REACHED);
+				continue;
+			}
+			REQUIRE(length == distance);
+			CHECK(FollowPath(from, path) == to);
+		}
+		FreeAStar();
+		Map.ClearFields();
+	}
+
+	SUBCASE("maze")
+	{
+		Map.Create();
+		MakeMaze();
+		InitAStar(Map.Info.MapWidth, Map.Info.MapHeight);
+		for (int i = 0; i != 100; ++i) {
+			const Vec2i from = FreeTile(i);
+			const Vec2i to = FreeTile(i + 1000);
+			const int steps = StepsFrom(from)[to.y * TestMapSize + to.x];
+			int length;
+			const std::string path = FindPath(from, to, unit, &length);
+
+			if (steps == -1) {
+				CHECK(length == PF_UNREACHABLE);
+			} else if (steps == 0) {
+				CHECK(length == PF_REACHED);
+			} else {
+				REQUIRE(length >= steps);
+				CHECK(FollowPath(from, path) == to);
+			}
+		}
+		FreeAStar();
+		Map.ClearFields();
+	}
+
+	SUBCASE("searches do not depend on the previous ones")
+	{
+		Map.Create();
+		MakeMaze();
+		InitAStar(Map.Info.MapWidth, Map.Info.MapHeight);
+		std::vector<std::string> paths;
+		for (int i = 0; i != 50; ++i) {
+			int length;
+			paths.push_back(FindPath(FreeTile(i), FreeTile(i + 1000), unit, &length));
+		}
+		// Same searches in the reverse order, on a fresh matrix for the last one
+		for (int i = 49; i >= 0; --i) {
+			if (i == 0) {
+				FreeAStar();
+				InitAStar(Map.Info.MapWidth, Map.Info.MapHeight);
+			}
+			int length;
+			CHECK(FindPath(FreeTile(i), FreeTile(i + 1000), unit, &length) == paths[i]);
+		}
+		FreeAStar();
+		Map.ClearFields();
+	}
+
+	AStarKnowUnseenTerrain = knowUnseenTerrain;
+	AStarMaxSearchIterations = maxSearchIterations;
+}
@@ -0,0 +1,104 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name test_blend.cpp - The test file for the 32bpp blending kernels. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+
+#include <doctest.h>
+
+#include "stratagus.h"
+#include "video.h"
+
+#include <vector>
+
+namespace
+{
+	/// Random pixels, with every alpha value
+	std::vector<uint32_t> MakePixels(size_t count, uint32_t seed)
+	{
+		std::vector<uint32_t> pixels(count);
+		uint32_t state = seed;
+		for (uint32_t &pixel : pixels) {
+			state = state * 1103515245 + 12345;
+			pixel = state ^ (state >> 16) << 8;
+		}
+		return pixels;
+	}
+
+	/// Blend rows of all the lengths up to 40, at every start modulo 8, with the current kernels
+	std::vector<uint32_t> BlendRows(bool color)
+	{
+		const std::vector<uint32_t> src = MakePixels(48, 7);
+		std::vector<uint32_t> result;
+		for (size_t count = 0; count <= 40; ++count) {
+			for (size_t start = 0; start != 8; ++start) {
+				std::vector<uint32_t> dst = MakePixels(48, uint32_t(count * 8 + start));
+				if (color) {
+					BlendRowColor_32bpp(src[count], uint8_t(count * 37 + start), &dst[start], count);
+				} else {
+					BlendRowAlpha_32bpp(&src[start], &dst[start], count);
+				}
+				result.insert(result.end(), dst.begin(), dst.end());
+			}
+		}
+		return result;
+	}
+
+	void CheckKernels(bool color)
+	{
+		const BlendSimdTypes bestType = GetBlendSimdType();
+
+		REQUIRE(SetBlendSimdType(BlendSimdTypes::cScalar));
+		const std::vector<uint32_t> rows = BlendRows(color);
+
+		for (BlendSimdTypes type : {BlendSimdTypes::cSSE2, BlendSimdTypes::cAVX2, BlendSimdTypes::cNEON}) {
+			if (SetBlendSimdType(type)) {
+				CHECK(BlendRows(color) == rows);
+			}
+		}
+		SetBlendSimdType(bestType);
+	}
+
+} // namespace
+
+TEST_CASE("alpha blending kernels")
+{
+	uint32_t dst[] = {0x00000000, 0x00FFFFFF, 0x00102030, 0xFF808080};
+	const uint32_t src[] = {0xFFFFFFFF, 0x00000000, 0x80FF0000, 0x40000000};
+	BlendRowAlpha_32bpp(src, dst, 4);
+	CHECK(dst[0] == 0x00FEFEFE);
+	CHECK(dst[1] == 0x00FEFEFE);
+	CHECK(dst[2] == 0x00870F17);
+	CHECK(dst[3] == 0x005F5F5F);
+
+	CheckKernels(false);
+}
+
+TEST_CASE("transparent color kernels")
+{
+	CheckKernels(true);
+}
@@ -0,0 +1,190 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name test_forest_regrowth.cpp - The test file for the forest regrowth of map.cpp. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+
+#include <doctest.h>
+
+#include "map.h"
+#include "script.h"
+#include "stratagus.h"
+#include "tileset.h"
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+constexpr int TestMapSize = 32;
+constexpr graphic_index TestWoodTile = 1;
+
+/// Deterministic generator, so that failures can be reproduced
+class TestRandom
+{
+public:
+	int Next(int max)
+	{
+		state = state * 1103515245 + 12345;
+		return (state >> 16) % max;
+	}
+
+private:
+	uint32_t state = 11;
+};
+
+/// Chop some wood fields, as ClearWoodTile does.
+/// Only even rows are chopped, so that no wood grows back in the test.
+void ChopWood(TestRandom &random, int count)
+{
+	for (int i = 0; i != count; ++i) {
+		const Vec2i pos(random.Next(TestMapSize), 2 * random.Next(TestMapSize / 2));
+		CMapField &mf = *Map.Field(pos);
+
+		mf.setGraphicTile(Map.Tileset.getRemovedTreeTile());
+		mf.Value = 0;
+		Map.ForestRegrowth.insert(Map.getIndex(pos));
+	}
+}
+
+/// Regenerate the forest, from the list or by a scan of the whole map as before the list
+void Regrow(bool fullScan, int count)
+{
+	for (int i = 0; i != count; ++i) {
+		if (!fullScan) {
+			Map.RegenerateForest();
+			continue;
+		}
+		for (Vec2i pos(0, 0); pos.y != TestMapSize; ++pos.y) {
+			for (pos.x = 0; pos.x != TestMapSize; ++pos.x) {
+				Map.RegenerateForestTile(pos);
+			}
+		}
+	}
+}
+
+/// Run the "forest-regrowth" entry of a savegame, return the status of the call
+int LoadForestRegrowth(const std::string &indexes)
+{
+	const std::string content = "StratagusMap(\"the-map\", {\"forest-regrowth\", {" + indexes + "}})";
+
+	InitLua();
+	MapCclRegister();
+	REQUIRE(luaL_loadbuffer(Lua, content.data(), content.size(), "test") == 0);
+	const int status = LuaCall(Lua, 0, 0, lua_gettop(Lua), false);
+	lua_close(Lua);
+	Lua = nullptr;
+	return status;
+}
+
+/// Save and load the list of the fields to regrow
+void SaveAndLoad()
+{
+	std::string indexes;
+	for (const unsigned int index : Map.ForestRegrowth) {
+		indexes += std::to_string(index) + ", ";
+	}
+	Map.ForestRegrowth.clear();
+	CHECK(LoadForestRegrowth(indexes) == 0);
+}
+
+/// Tile and wood value of each field after chops and regrowth
+std::vector<std::pair<graphic_index, int>> RunForest(bool fullScan)
+{
+	Map.Create();
+	for (int i = 0; i != TestMapSize * TestMapSize; ++i) {
+		Map.Field(i)->setGraphicTile(TestWoodTile);
+		Map.Field(i)->Value = 100;
+	}
+	TestRandom random;
+
+	ChopWood(random, 60);
+	Regrow(fullScan, 20);
+	ChopWood(random, 60);
+	if (!fullScan) {
+		const std::set<unsigned int> regrowth = Map.ForestRegrowth;
+		SaveAndLoad();
+		CHECK(Map.ForestRegrowth == regrowth);
+	}
+	Regrow(fullScan, 60);
+
+	std::vector<std::pair<graphic_index, int>> fields;
+	for (int i = 0; i != TestMapSize * TestMapSize; ++i) {
+		fields.emplace_back(Map.Field(i)->getGraphicTile(), Map.Field(i)->Value);
+	}
+	Map.ClearFields();
+	return fields;
+}
+
+} // namespace
+
+TEST_CASE("Forest regrowth from the list matches the scan of the whole map")
+{
+	const unsigned int regeneration = ForestRegeneration;
+	const int frequency = ForestRegenerationFrequency;
+	ForestRegeneration = 50;
+	ForestRegenerationFrequency = 1;
+	Map.Info.MapWidth = TestMapSize;
+	Map.Info.MapHeight = TestMapSize;
+
+	SUBCASE("chop, save, load and regrow")
+	{
+		const auto fromList = RunForest(false);
+		const auto fromScan = RunForest(true);
+		CHECK(fromList == fromScan);
+	}
+
+	SUBCASE("list rebuilt from the fields")
+	{
+		Map.Create();
+		for (int i = 0; i != TestMapSize * TestMapSize; ++i) {
+			Map.Field(i)->setGraphicTile(TestWoodTile);
+		}
+		TestRandom random;
+		ChopWood(random, 60);
+		const std::set<unsigned int> regrowth = Map.ForestRegrowth;
+		Map.InitForestRegrowth();
+		CHECK(Map.ForestRegrowth == regrowth);
+		Map.ClearFields();
+	}
+
+	SUBCASE("indexes out of the map are rejected")
+	{
+		Map.Create();
+		CHECK(LoadForestRegrowth(std::to_string(TestMapSize * TestMapSize - 1)) == 0);
+		CHECK(LoadForestRegrowth(std::to_string(TestMapSize * TestMapSize)) != 0);
+		CHECK(LoadForestRegrowth("-1") != 0);
+		Map.ClearFields();
+	}
+
+	ForestRegeneration = regeneration;
+	ForestRegenerationFrequency = frequency;
+}
@@ -0,0 +1,177 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name test_fov.cpp - The sight updates of the units which step. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+#include <doctest.h>
+
+#include "stratagus.h"
+#include "fov.h"
+#include "map.h"
+#include "player.h"
+#include "unit.h"
+#include "unit_manager.h"
+#include "unittype.h"
+
+#include <vector>
+
+namespace
+{
+	constexpr int MapSize = 40;
+
+	std::vector<int> Counts;
+
+	void CountMark(const CPlayer &, const unsigned int index) { ++Counts[index]; }
+	void CountUnmark(const CPlayer &, const unsigned int index) { --Counts[index]; }
+
+	/// Marks of a whole sight at pos, computed by a unit without slot so never cached
+	std::vector<int> WholeSight(const CUnit &reference, const Vec2i &pos, uint16_t size, uint16_t range)
+	{
+		Counts.assign(MapSize * MapSize, 0);
+		FieldOfView.Refresh(Players[0], reference, pos, size, size, range, CountMark);
+		return Counts;
+	}
+
+	/// Check a step from oldPos against a whole unmark at oldPos and a whole mark at pos
+	void CheckStep(const CUnit &unit, const CUnit &reference, const Vec2i &oldPos, const Vec2i &pos,
+	               uint16_t size, uint16_t range)
+	{
+		const std::vector<int> expected = WholeSight(reference, pos, size, range);
+
+		Counts.assign(MapSize * MapSize, 0);
+		FieldOfView.Refresh(Players[0], unit, oldPos, size, size, range, CountMark);
+		FieldOfView.RefreshStep(Players[0], unit, oldPos, pos, size, size, range, CountUnmark, CountMark);
+		CHECK(Counts == expected);
+	}
+
+	void ToggleOpaque(CMapField &mf)
+	{
+		if (mf.isFlag(MapFieldOpaque)) {
+			mf.resetFlag(MapFieldOpaque);
+		} else {
+			mf.setFlag(MapFieldOpaque);
+		}
+		FieldOfView.TerrainChanged();
+	}
+
+	/// Check a step from oldPos when the opacity of a field near it changed since the sight was marked
+	void CheckStepAfterTerrainChange(const CUnit &unit, const CUnit &reference, const Vec2i &oldPos,
+	                                 const Vec2i &pos, uint16_t size, uint16_t range)
+	{
+		for (const Vec2i offset : {Vec2i(-1, 0), Vec2i(size, 1), Vec2i(1, -2), Vec2i(0, size + 1)}) {
+			const Vec2i fieldPos = oldPos + offset;
+			if (!Map.Info.IsPointOnMap(fieldPos)) {
+				continue;
+			}
+			CMapField &mf = *Map.Field(fieldPos);
+
+			Counts.assign(MapSize * MapSize, 0);
+			FieldOfView.Refresh(Players[0], unit, oldPos, size, size, range, CountMark);
+			// As CMap::ClearTile: unmark, change the field, mark again
+			FieldOfView.Refresh(Players[0], unit, oldPos, size, size, range, CountUnmark);
+			ToggleOpaque(mf);
+			FieldOfView.Refresh(Players[0], unit, oldPos, size, size, range, CountMark);
+			FieldOfView.RefreshStep(Players[0], unit, oldPos, pos, size, size, range, CountUnmark, CountMark);
+			const std::vector<int> stepped = Counts;
+
+			CHECK(stepped == WholeSight(reference, pos, size, range));
+
+			ToggleOpaque(mf);
+		}
+	}
+
+	template <typename Check>
+	void CheckSteps(const CUnit &unit, const CUnit &reference, Check check)
+	{
+		for (uint16_t size : {1, 2, 3}) {
+			for (uint16_t range : {1, 4, 9}) {
+				// In the middle of the map, and against each border
+				for (Vec2i oldPos : {Vec2i(18, 18), Vec2i(0, 5), Vec2i(5, 0), Vec2i(37, 20), Vec2i(20, 37)}) {
+					oldPos.x = std::min<short>(oldPos.x, MapSize - size);
+					oldPos.y = std::min<short>(oldPos.y, MapSize - size);
+					for (Vec2i step(-1, -1); step.y <= 1; ++step.y) {
+						for (step.x = -1; step.x <= 1; ++step.x) {
+							const Vec2i pos = oldPos + step;
+							if (pos.x >= 0 && pos.y >= 0 && pos.x + size <= MapSize && pos.y + size <= MapSize) {
+								check(unit, reference, oldPos, pos, size, range);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+} // namespace
+
+TEST_CASE("sight step")
+{
+	CUnitType type;
+	type.BoolFlag.resize(UnitTypeVar.GetNumberBoolFlag());
+	// The unit has a slot, so its sight is cached; the reference has none and computes it each time
+	CUnitManager unitManager;
+	CUnit &unit = *unitManager.AllocUnit();
+	unit.Type = &type;
+	REQUIRE(UnitNumber(unit) >= 0);
+	CUnit reference;
+	reference.Type = &type;
+
+	Map.Info.MapWidth = MapSize;
+	Map.Info.MapHeight = MapSize;
+	Map.Create();
+	// Some opaque fields for the shadow casting
+	uint32_t state = 7;
+	for (CMapField &mf : Map.Fields) {
+		state = state * 1103515245 + 12345;
+		if ((state >> 16) % 5 == 0) {
+			mf.setFlag(MapFieldOpaque);
+		}
+	}
+
+	const FieldOfViewTypes fovType = GameSettings.FoV;
+	SUBCASE("simple radial")
+	{
+		GameSettings.FoV = FieldOfViewTypes::cSimpleRadial;
+		CheckSteps(unit, reference, CheckStep);
+	}
+	SUBCASE("shadow casting")
+	{
+		GameSettings.FoV = FieldOfViewTypes::cShadowCasting;
+		CheckSteps(unit, reference, CheckStep);
+	}
+	SUBCASE("shadow casting after a terrain change")
+	{
+		GameSettings.FoV = FieldOfViewTypes::cShadowCasting;
+		CheckSteps(unit, reference, CheckStepAfterTerrainChange);
+	}
+	GameSettings.FoV = fovType;
+	FieldOfView.Clean();
+	Map.ClearFields();
+	unit.PlayerSlot = static_cast<size_t>(-1);
+	unitManager.ReleaseUnit(unit);
+	unitManager.Init();
+}
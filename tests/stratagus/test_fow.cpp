@@ -0,0 +1,134 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name test_fow.cpp - The test file for fog of war kernels. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+#include <doctest.h>
+
+#include "stratagus.h"
+#include "fow_utils.h"
+
+#include <vector>
+
+namespace
+{
+	constexpr uint16_t MapSize = 128;
+	constexpr uint16_t TileSize = 32;
+
+	/// Blurred fog texture of the map, with random visible and explored tiles
+	std::vector<uint8_t> MakeFogTexture()
+	{
+		const uint16_t visTableWidth = MapSize + 2;
+		std::vector<uint8_t> visTable(visTableWidth * visTableWidth);
+		uint32_t state = 42;
+		for (uint16_t y = 1; y <= MapSize; ++y) {
+			for (uint16_t x = 1; x <= MapSize; ++x) {
+				state = state * 1103515245 + 12345;
+				visTable[y * visTableWidth + x] = (state >> 16) % 3;
+			}
+		}
+
+		const uint16_t textureWidth = (MapSize + 1) * 4;
+		std::vector<uint8_t> texture(textureWidth * textureWidth);
+		std::vector<uint8_t> patternsVisible(MapSize + 1);
+		std::vector<uint8_t> patternsExplored(MapSize + 1);
+		for (uint16_t row = 0; row <= MapSize; ++row) {
+			FogUpscalePatterns(&visTable[row * visTableWidth], &visTable[(row + 1) * visTableWidth], MapSize + 1,
+			                   patternsVisible.data(), patternsExplored.data());
+			for (uint16_t col = 0; col <= MapSize; ++col) {
+				for (uint16_t i = 0; i < 16; ++i) {
+					texture[(row * 4 + i / 4) * textureWidth + col * 4 + i % 4] =
+						((patternsVisible[col] >> (i % 4)) & 1) * 0x7F + ((patternsExplored[col] >> (i / 4)) & 1) * 0x7F;
+				}
+			}
+		}
+
+		CBlurrer blurrer;
+		blurrer.Init(textureWidth, textureWidth, 2.0, 3);
+		blurrer.Blur(texture.data());
+		return texture;
+	}
+
+	/// Fog of the top left part of the map, bilinear upscaled into a viewport
+	std::vector<uint32_t> UpscaleFog(const std::vector<uint8_t> &texture, uint16_t width, uint16_t height)
+	{
+		const uint16_t tilesX = (width + TileSize - 1) / TileSize;
+		const uint16_t tilesY = (height + TileSize - 1) / TileSize;
+
+		std::vector<uint32_t> pixels(tilesX * TileSize * tilesY * TileSize);
+		SDL_PixelFormat format{};
+		format.Ashift = 24;
+		SDL_Surface surface{};
+		surface.format = &format;
+		surface.w = tilesX * TileSize;
+		surface.h = tilesY * TileSize;
+		surface.pixels = pixels.data();
+
+		const SDL_Rect srcRect{4, 4, tilesX * 4, tilesY * 4};
+		const SDL_Rect trgRect{0, 0, surface.w, surface.h};
+		FogUpscaleBilinear(texture.data(), srcRect, (MapSize + 1) * 4, &surface, trgRect, 0x102030);
+		return pixels;
+	}
+
+	uint32_t Hash(const std::vector<uint32_t> &pixels)
+	{
+		uint32_t hash = 2166136261u;
+		for (uint32_t pixel : pixels) {
+			hash = (hash ^ pixel) * 16777619u;
+		}
+		return hash;
+	}
+
+	void CheckViewport(uint16_t width, uint16_t height, uint32_t goldenHash)
+	{
+		const FogSimdTypes bestType = GetFogSimdType();
+
+		REQUIRE(SetFogSimdType(FogSimdTypes::cScalar));
+		const std::vector<uint8_t> texture = MakeFogTexture();
+		const std::vector<uint32_t> image = UpscaleFog(texture, width, height);
+		CHECK(Hash(image) == goldenHash);
+
+		for (FogSimdTypes type : {FogSimdTypes::cSSE2, FogSimdTypes::cAVX2}) {
+			if (SetFogSimdType(type)) {
+				CHECK(MakeFogTexture() == texture);
+				CHECK(UpscaleFog(texture, width, height) == image);
+			}
+		}
+		SetFogSimdType(bestType);
+	}
+
+} // namespace
+
+TEST_CASE("fog of war kernels 1080p")
+{
+	CheckViewport(1920, 1080, 0x4ab61dc5u);
+}
+
+TEST_CASE("fog of war kernels 4K")
+{
+	CheckViewport(3840, 2160, 0x00e29dc5u);
+}
@@ -0,0 +1,105 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name test_influence_map.cpp - The test file for influence_map.cpp. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+#include <doctest.h>
+
+#include "influence_map.h"
+#include "player.h"
+#include "stratagus.h"
+#include "unit.h"
+#include "unittype.h"
+
+TEST_CASE("Influence map keeps the threat of a unit until it is removed")
+{
+	CPlayer player;
+	player.Index = 2;
+	CUnitType peasant;
+	peasant.TileWidth = 2;
+	peasant.TileHeight = 2;
+	CUnitType tower;
+	tower.TileWidth = 2;
+	tower.TileHeight = 2;
+	tower.CanTarget = ECanTargetFlag::Land;
+
+	CInfluenceMap influence;
+	influence.Init(32, 32);
+	const Vec2i ltPos(0, 0);
+	const Vec2i rbPos(31, 31);
+
+	CUnit unit;
+	unit.Player = &player;
+	unit.tilePos = {9, 9};
+
+	SUBCASE("upgraded to a threat")
+	{
+		unit.Type = &peasant;
+		influence.Insert(unit);
+		CHECK(influence.PlayersIn(ltPos, rbPos) == 1u << 2);
+		CHECK(influence.ThreatsIn(ltPos, rbPos) == 0);
+
+		// The upgrade changes the type of the unit left on the map
+		unit.Type = &tower;
+		influence.Remove(unit);
+		CHECK(influence.PlayersIn(ltPos, rbPos) == 0);
+		CHECK(influence.ThreatsIn(ltPos, rbPos) == 0);
+		CHECK(influence.PlayersOnMap() == 0);
+
+		influence.Insert(unit);
+		CHECK(influence.ThreatsIn(ltPos, rbPos) == 1u << 2);
+		influence.Remove(unit);
+		CHECK(influence.ThreatsIn(ltPos, rbPos) == 0);
+	}
+
+	SUBCASE("upgraded to a harmless unit")
+	{
+		unit.Type = &tower;
+		influence.Insert(unit);
+		CHECK(influence.ThreatsIn(ltPos, rbPos) == 1u << 2);
+
+		unit.Type = &peasant;
+		influence.Remove(unit);
+		CHECK(influence.PlayersIn(ltPos, rbPos) == 0);
+		CHECK(influence.ThreatsIn(ltPos, rbPos) == 0);
+	}
+
+	SUBCASE("upgraded after a change of owner")
+	{
+		CPlayer other;
+		other.Index = 3;
+
+		unit.Type = &peasant;
+		influence.Insert(unit);
+		unit.Player = &other;
+		influence.ChangeOwner(unit, player.Index);
+		unit.Type = &tower;
+		influence.Remove(unit);
+		CHECK(influence.PlayersIn(ltPos, rbPos) == 0);
+		CHECK(influence.ThreatsIn(ltPos, rbPos) == 0);
+	}
+}
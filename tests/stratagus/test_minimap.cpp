@@ -0,0 +1,241 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name test_minimap.cpp - The changed blocks of the minimap against its full composition. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+#include <doctest.h>
+
+#include "stratagus.h"
+#include "actions.h"
+#include "fow.h"
+#include "map.h"
+#include "minimap.h"
+#include "player.h"
+#include "settings.h"
+#include "ui.h"
+#include "unit.h"
+#include "unittype.h"
+#include "video.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace
+{
+	constexpr int MapSize = 64;
+	constexpr int UnitCount = 150;
+	constexpr int NumTiles = 16;
+
+	/// Deterministic generator, so that failures can be reproduced
+	class TestRandom
+	{
+	public:
+		int Next(int max)
+		{
+			state = state * 1103515245 + 12345;
+			return (state >> 16) % max;
+		}
+
+	private:
+		uint32_t state = 7;
+	};
+
+	/// The units of the other players are seen on the tiles visible to ThisPlayer
+	void UpdateVisCount(CUnit &unit)
+	{
+		bool visible = unit.Player == ThisPlayer;
+		for (int y = 0; y != unit.Type->TileHeight; ++y) {
+			for (int x = 0; x != unit.Type->TileWidth; ++x) {
+				const Vec2i pos = unit.tilePos + Vec2i(x, y);
+				visible |= Map.Field(pos)->playerInfo().Visible[ThisPlayer->Index] >= 2;
+			}
+		}
+		unit.VisCount[ThisPlayer->Index] = visible;
+	}
+
+	/// Change the vision of ThisPlayer on a tile, as the sight of a unit does
+	void SetVisible(int index, unsigned short visible)
+	{
+		Map.Field(index)->playerInfo().Visible[ThisPlayer->Index] = visible;
+		FogOfWar->MarkDirty(*ThisPlayer, index);
+		for (CUnit *unit : Map.Field(index)->UnitCache()) {
+			UpdateVisCount(*unit);
+		}
+	}
+
+	/// The pixels of the composed minimap
+	std::vector<Uint8> MinimapPixels()
+	{
+		const Uint8 *const pixels = static_cast<const Uint8 *>(MinimapSurface->pixels);
+		return std::vector<Uint8>(pixels, pixels + MinimapSurface->pitch * MinimapSurface->h);
+	}
+
+	/// Update the changed blocks of the minimap, then check them against a minimap created again
+	void CheckUpdate()
+	{
+		FogOfWar->Update(true);
+		UI.Minimap.Update();
+		const std::vector<Uint8> changed = MinimapPixels();
+
+		UI.Minimap.Destroy();
+		UI.Minimap.Create();
+		UI.Minimap.Update();
+		REQUIRE(changed == MinimapPixels());
+	}
+
+} // namespace
+
+TEST_CASE("minimap changed blocks")
+{
+	for (int i = 0; i != PlayerMax; ++i) {
+		Players[i].Index = i;
+	}
+	CPlayer *const thisPlayer = ThisPlayer;
+	ThisPlayer = &Players[0];
+	const auto playerColors = PlayerColorsRGB;
+	PlayerColorsRGB = {{CColor(200, 40, 40)}};
+	const Uint32 colorGreen = ColorGreen;
+	ColorGreen = 0x00FF00;
+
+	TestRandom random;
+	Map.Info.MapWidth = MapSize;
+	Map.Info.MapHeight = MapSize;
+	Map.Create();
+
+	// A row of tiles of random colors
+	auto tileGraphic = std::make_shared<CGraphic>();
+	tileGraphic->setSurface(SDL_CreateRGBSurface(SDL_SWSURFACE, NumTiles * PixelTileSize.x, PixelTileSize.y,
+	                                             32, RMASK, GMASK, BMASK, AMASK));
+	SDL_Surface *tileSurface = tileGraphic->getSurface();
+	for (int y = 0; y != tileSurface->h; ++y) {
+		for (int x = 0; x != tileSurface->w; ++x) {
+			static_cast<Uint32 *>(tileSurface->pixels)[y * tileSurface->w + x] = random.Next(0x1000000);
+		}
+	}
+	Map.TileGraphic = tileGraphic;
+	for (CMapField &mf : Map.Fields) {
+		mf.setGraphicTile(random.Next(NumTiles));
+	}
+	for (size_t i = 0; i != Map.Fields.size(); ++i) {
+		Map.Field(i)->playerInfo().Visible[ThisPlayer->Index] = random.Next(3);
+	}
+
+	// 1x1 and 2x2 units of 3 players
+	CUnitType types[2];
+	for (int i = 0; i != 2; ++i) {
+		types[i].TileWidth = i + 1;
+		types[i].TileHeight = i + 1;
+		types[i].BoolFlag.resize(UnitTypeVar.GetNumberBoolFlag());
+	}
+	auto units = std::make_unique<CUnit[]>(UnitCount);
+	for (int i = 0; i != UnitCount; ++i) {
+		CUnit &unit = units[i];
+		unit.Type = &types[random.Next(2)];
+		unit.Player = &Players[random.Next(3)];
+		unit.Variable.resize(UnitTypeVar.GetNumberVariable());
+		unit.Orders.push_back(COrder::NewActionStill());
+		unit.tilePos.x = random.Next(MapSize - unit.Type->TileWidth + 1);
+		unit.tilePos.y = random.Next(MapSize - unit.Type->TileHeight + 1);
+		unit.Offset = Map.getIndex(unit.tilePos);
+		unit.Removed = 0;
+		UpdateVisCount(unit);
+		Map.Insert(unit);
+	}
+
+	std::unique_ptr<CFogOfWar> fogOfWar = std::make_unique<CFogOfWar>();
+	std::swap(fogOfWar, FogOfWar);
+	FogOfWar->Init();
+	FogOfWar->Update(true);
+
+	const CMinimap minimap = UI.Minimap;
+	UI.Minimap.W = 176;
+	UI.Minimap.H = 150;
+	UI.Minimap.Transparent = false;
+	UI.Minimap.ShowSelected = false;
+
+	for (bool withTerrain : {true, false}) {
+		CAPTURE(withTerrain);
+		UI.Minimap.WithTerrain = withTerrain;
+		UI.Minimap.Create();
+		UI.Minimap.Update();
+
+		for (int round = 0; round != 20; ++round) {
+			CAPTURE(round);
+			// Moves
+			for (int i = random.Next(10); i < UnitCount; i += 10) {
+				CUnit &unit = units[i];
+				Map.Remove(unit);
+				const Vec2i step(random.Next(3) - 1, random.Next(3) - 1);
+				unit.tilePos.x = std::clamp(unit.tilePos.x + step.x, 0, MapSize - unit.Type->TileWidth);
+				unit.tilePos.y = std::clamp(unit.tilePos.y + step.y, 0, MapSize - unit.Type->TileHeight);
+				unit.Offset = Map.getIndex(unit.tilePos);
+				UpdateVisCount(unit);
+				Map.Insert(unit);
+			}
+			// Sight, around a tile as a unit which moves
+			const Vec2i center(random.Next(MapSize), random.Next(MapSize));
+			const unsigned short visible = random.Next(3);
+			for (int y = std::max(0, center.y - 3); y <= std::min(MapSize - 1, center.y + 3); ++y) {
+				for (int x = std::max(0, center.x - 3); x <= std::min(MapSize - 1, center.x + 3); ++x) {
+					SetVisible(Map.getIndex(x, y), visible);
+				}
+			}
+			// Terrain
+			const Vec2i tilePos(random.Next(MapSize), random.Next(MapSize));
+			Map.Field(tilePos)->setGraphicTile(random.Next(NumTiles));
+			UI.Minimap.UpdateXY(tilePos);
+			// Owner
+			CUnit &captured = units[random.Next(UnitCount)];
+			const int oldPlayer = captured.Player->Index;
+			captured.Player = &Players[(oldPlayer + 1) % 3];
+			UpdateVisCount(captured);
+			Map.ChangeOwner(captured, oldPlayer);
+			// Invisibility
+			CUnit &hidden = units[random.Next(UnitCount)];
+			hidden.Variable[INVISIBLE_INDEX].Value = !hidden.Variable[INVISIBLE_INDEX].Value;
+			UI.Minimap.UpdateUnit(hidden);
+
+			CheckUpdate();
+		}
+		UI.Minimap.Destroy();
+	}
+
+	for (int i = 0; i != UnitCount; ++i) {
+		Map.Remove(units[i]);
+	}
+	UI.Minimap = minimap;
+	std::swap(fogOfWar, FogOfWar);
+	fogOfWar->Clean();
+	Map.TileGraphic = nullptr;
+	Map.UnitGrid.Clean();
+	Map.Influence.Clean();
+	Map.ClearFields();
+	ColorGreen = colorGreen;
+	PlayerColorsRGB = playerColors;
+	ThisPlayer = thisPlayer;
+}
@@ -140,7 +140,7 @@ TEST_CASE("PathFinding on clear map 128x128")
 		unit.Orders.clear();
 	}
 
-	Map.Fields.clear();
+	Map.ClearFields();
 
 	extern void FreeAStar(); // free the a* data structures
 	FreeAStar();
@@ -0,0 +1,103 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name test_terrain_traversal.cpp - The test file for the TerrainTraversal of pathfinder.cpp. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+#include <doctest.h>
+
+#include "stratagus.h"
+
+#include "pathfinder.h"
+
+#include <algorithm>
+
+namespace
+{
+/// Visit the tiles up to a distance, and dead ends on the column x == wall
+struct TraversalVisitor
+{
+	int maxDist;
+	int wall;
+	int visited = 0;
+
+	VisitResult Visit(TerrainTraversal &traversal, const Vec2i &pos, const Vec2i &)
+	{
+		++visited;
+		if (pos.x == wall || traversal.Get(pos) > maxDist) {
+			return VisitResult::DeadEnd;
+		}
+		return VisitResult::Ok;
+	}
+};
+} // namespace
+
+TEST_CASE("TerrainTraversal reuses its storage")
+{
+	const size_t poolSize = TerrainTraversal::PoolSize();
+	{
+		TerrainTraversal traversal;
+		traversal.SetSize(16, 16);
+		traversal.Init();
+		traversal.PushPos({0, 0});
+		TraversalVisitor visitor{100, 8};
+		CHECK(traversal.Run(visitor) == false);
+		CHECK(visitor.visited == 9 * 16);
+		CHECK(traversal.Get({15, 15}) == 0);
+		CHECK(traversal.Get({-1, 0}) == -1);
+		CHECK(traversal.Get({8, 3}) == -1);
+		CHECK(traversal.Get({7, 15}) == 16);
+	}
+	CHECK(TerrainTraversal::PoolSize() == std::max<size_t>(poolSize, 1));
+
+	// Over more traversals than generations, from the storage of the pool
+	for (int i = 0; i != 70000; ++i) {
+		const short y = i % 16;
+		TerrainTraversal traversal;
+		traversal.SetSize(16, 16);
+		traversal.Init();
+		traversal.PushPos({15, y});
+		TraversalVisitor visitor{1, -1};
+		traversal.Run(visitor);
+		if (i % 1000 == 0 || i > 65530) {
+			REQUIRE(traversal.Get({0, 0}) == 0);
+			REQUIRE(traversal.Get({15, y}) == 1);
+			REQUIRE(traversal.IsVisited({12, y}) == false);
+			REQUIRE(traversal.Get({16, 0}) == -1);
+		}
+	}
+	{
+		TerrainTraversal first;
+		TerrainTraversal second;
+		first.SetSize(16, 16);
+		second.SetSize(16, 16);
+		first.Init();
+		second.Init();
+		first.PushPos({3, 3});
+		CHECK(first.IsVisited({3, 3}));
+		CHECK(second.IsVisited({3, 3}) == false);
+	}
+}
@@ -0,0 +1,160 @@
+//       _________ __                 __
+//      /   _____//  |_____________ _/  |______     ____  __ __  ______
+//      \_____  \\   __\_  __ \__  \\   __\__  \   / ___\|  |  \/  ___/
+//      /        \|  |  |  | \// __ \|  |  / __ \_/ /_/  >  |  /\___ |
+//     /_______  /|__|  |__|  (____  /__| (____  /\___  /|____//____  >
+//             \/                  \/          \//_____/            \/
+//  ______________________                           ______________________
+//                        T H E   W A R   B E G I N S
+//         Stratagus - A free fantasy real time strategy game engine
+//
+/**@name test_unit_grid.cpp - The test file for unit_grid.cpp. */
+//
+//      (c) Copyright 2026 by the Stratagus Developers
+//
+//      This program is free software; you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation; only version 2 of the License.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program; if not, write to the Free Software
+//      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+//      02111-1307, USA.
+//
+
+#include <doctest.h>
+
+#include "map.h"
+#include "player.h"
+#include "stratagus.h"
+#include "unit.h"
+#include "unit_find.h"
+#include "unittype.h"
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+
+constexpr int TestMapSize = 64;
+constexpr int TestUnitCount = 400;
+
+/// The selection of the units of the area, as done before the unit grid
+std::vector<CUnit *> ScanUnitCache(const Vec2i &ltPos, const Vec2i &rbPos, unsigned int playerMask)
+{
+	std::vector<CUnit *> units;
+	for (Vec2i pos = ltPos; pos.y <= rbPos.y; ++pos.y) {
+		for (pos.x = ltPos.x; pos.x <= rbPos.x; ++pos.x) {
+			for (CUnit *unit : Map.Field(pos)->UnitCache()) {
+				if (unit->CacheLock == 0 && (playerMask & (1u << unit->Player->Index))) {
+					unit->CacheLock = 1;
+					units.push_back(unit);
+				}
+			}
+		}
+	}
+	for (CUnit *unit : units) {
+		unit->CacheLock = 0;
+	}
+	return units;
+}
+
+/// Deterministic generator, so that failures can be reproduced
+class TestRandom
+{
+public:
+	int Next(int max)
+	{
+		state = state * 1103515245 + 12345;
+		return (state >> 16) % max;
+	}
+
+private:
+	uint32_t state = 7;
+};
+
+/// Compare Select with the tile scan on areas of all sizes, for several player masks
+void CheckSelections(TestRandom &random)
+{
+	for (int i = 0; i != 200; ++i) {
+		const Vec2i ltPos(random.Next(TestMapSize), random.Next(TestMapSize));
+		const Vec2i rbPos(std::min(TestMapSize - 1, ltPos.x + random.Next(20)),
+		                  std::min(TestMapSize - 1, ltPos.y + random.Next(20)));
+
+		for (unsigned int playerMask : {CUnitGrid::AllPlayers, 1u, 0x6u, 0u}) {
+			REQUIRE(Select(ltPos, rbPos, NoFilter(), playerMask) == ScanUnitCache(ltPos, rbPos, playerMask));
+		}
+	}
+}
+
+} // namespace
+
+TEST_CASE("Unit grid selects the units of the tile scan in the same order")
+{
+	for (int i = 0; i != PlayerMax; ++i) {
+		Players[i].Index = i;
+	}
+	// 1x1 to 4x4 units
+	CUnitType types[4];
+	for (int i = 0; i != 4; ++i) {
+		types[i].TileWidth = i + 1;
+		types[i].TileHeight = i + 1;
+		types[i].BoolFlag.resize(UnitTypeVar.GetNumberBoolFlag());
+	}
+
+	Map.Info.MapWidth = TestMapSize;
+	Map.Info.MapHeight = TestMapSize;
+	Map.Create();
+
+	TestRandom random;
+	auto units = std::make_unique<CUnit[]>(TestUnitCount);
+	for (int i = 0; i != TestUnitCount; ++i) {
+		CUnit &unit = units[i];
+		const CUnitType &type = types[random.Next(4)];
+
+		unit.Player = &Players[random.Next(4)];
+		unit.Type = &type;
+		unit.tilePos.x = random.Next(TestMapSize - type.TileWidth + 1);
+		unit.tilePos.y = random.Next(TestMapSize - type.TileHeight + 1);
+		unit.Offset = Map.getIndex(unit.tilePos);
+		unit.Removed = 0;
+		Map.Insert(unit);
+	}
+	CheckSelections(random);
+
+	SUBCASE("after moves and owner changes")
+	{
+		for (int i = 0; i < TestUnitCount; i += 3) {
+			CUnit &unit = units[i];
+
+			Map.Remove(unit);
+			unit.tilePos.x = random.Next(TestMapSize - unit.Type->TileWidth + 1);
+			unit.tilePos.y = random.Next(TestMapSize - unit.Type->TileHeight + 1);
+			unit.Offset = Map.getIndex(unit.tilePos);
+			Map.Insert(unit);
+		}
+		for (int i = 1; i < TestUnitCount; i += 5) {
+			CUnit &unit = units[i];
+			const int oldPlayer = unit.Player->Index;
+
+			unit.Player = &Players[(oldPlayer + 1) % 4];
+			Map.ChangeOwner(unit, oldPlayer);
+		}
+		CheckSelections(random);
+	}
+
+	for (int i = 0; i != TestUnitCount; ++i) {
+		Map.Remove(units[i]);
+	}
+	CHECK(Select(Vec2i(0, 0), Vec2i(TestMapSize - 1, TestMapSize - 1), NoFilter()).empty());
+
+	Map.UnitGrid.Clean();
+	Map.Influence.Clean();
+	Map.ClearFields();
+}
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""
+Replay regression benchmark.
+
+Plays each replay of a corpus with the headless mode of stratagus (-H), which
+checks the SyncHash and SyncRandSeed logged with each command, and collects
+the cycles per second and the peak memory of each replay into a JSON report.
+
+It fails when a replay gets out of sync, crashes, or when its cycles per
+second drop by more than the threshold below the ones of the baseline.
+A baseline is a report written by a previous run with --update-baseline.
+
+Example:
+    replay_bench.py --stratagus build/stratagus --data ~/wargus \\
+        --baseline replays/baseline.json --output report.json replays/
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+
+def find_replays(paths):
+    "returns the replay files given directly or found in the given directories"
+    replays = []
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, files in os.walk(path):
+                replays += [os.path.join(root, f) for f in files
+                            if f.endswith(('.log', '.log.gz', '.log.bz2'))]
+        else:
+            replays.append(path)
+    return sorted(os.path.abspath(replay) for replay in replays)
+
+
+def play(args, replay):
+    "plays a replay headlessly and returns its result"
+    command = [args.stratagus, '-H', str(args.cycles)]
+    if args.data:
+        command += ['-d', args.data]
+    command.append(replay)
+
+    result = {'name': os.path.basename(replay)}
+    try:
+        process = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                                 universal_newlines=True, timeout=args.timeout)
+    except subprocess.TimeoutExpired:
+        result['error'] = 'timeout after %d s' % args.timeout
+        return result
+
+    for line in process.stdout.splitlines():
+        if line.startswith('{"cycles"'):
+            result.update(json.loads(line))
+            break
+    else:
+        result['error'] = 'no report, exit code %d: %s' % (process.returncode,
+                                                           process.stderr.strip()[-500:])
+    return result
+
+
+def check(result, baseline, threshold):
+    "returns the reasons why a replay result is a regression"
+    failures = []
+    if 'error' in result:
+        failures.append(result['error'])
+        return failures
+    desync = result.get('replay', {}).get('desyncCycle')
+    if desync is not None:
+        failures.append('out of sync at cycle %d' % desync)
+    reference = baseline.get(result['name'])
+    if reference and 'cyclesPerSecond' in reference:
+        minimum = reference['cyclesPerSecond'] * (1 - threshold)
+        if result['cyclesPerSecond'] < minimum:
+            failures.append('%.1f cycles/s, below %.1f (baseline %.1f)' %
+                            (result['cyclesPerSecond'], minimum, reference['cyclesPerSecond']))
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('replays', nargs='+', help='replay files or directories of replays')
+    parser.add_argument('--stratagus', default='stratagus', help='stratagus executable')
+    parser.add_argument('--data', help='path to the game data (-d option of stratagus)')
+    parser.add_argument('--cycles', type=int, default=1000000,
+                        help='maximum number of cycles played for each replay')
+    parser.add_argument('--timeout', type=int, default=3600, help='seconds allowed for each replay')
+    parser.add_argument('--baseline', help='report of a previous run to compare with')
+    parser.add_argument('--threshold', type=float, default=0.1,
+                        help='allowed drop of the cycles per second (default 0.1 = 10%%)')
+    parser.add_argument('--update-baseline', action='store_true',
+                        help='write the results into the baseline instead of comparing them')
+    parser.add_argument('--output', help='where to write the JSON report (default stdout)')
+    args = parser.parse_args()
+
+    baseline = {}
+    if args.baseline and not args.update_baseline and os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            baseline = {result['name']: result for result in json.load(f)['results']}
+
+    results = []
+    failed = False
+    for replay in find_replays(args.replays):
+        result = play(args, replay)
+        failures = check(result, baseline, args.threshold)
+        if failures:
+            result['failures'] = failures
+            failed = True
+        results.append(result)
+        print('%-40s %s' % (result['name'], '; '.join(failures) if failures else
+                            '%.1f cycles/s, %d KiB' % (result['cyclesPerSecond'],
+                                                       result['peakMemoryKiB'])),
+              file=sys.stderr)
+
+    report = json.dumps({'threshold': args.threshold, 'results': results}, indent=2)
+    if args.update_baseline and args.baseline:
+        with open(args.baseline, 'w') as f:
+            f.write(report + '\n')
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(report + '\n')
+    else:
+        print(report)
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())